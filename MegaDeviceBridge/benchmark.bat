@@ -0,0 +1,6 @@
+@ECHO OFF
+CLS
+echo #### START BENCHMARK ######################################################################################
+echo "pio test -v -e native -f native/test_capture_benchmark"
+pio test -v -e native -f native/test_capture_benchmark
+echo #### END   BENCHMARK ######################################################################################
@@ -0,0 +1,229 @@
+// SPI bus, HD44780 LCD, DS1307 RTC, internal EEPROM and I2C stubs for the native build.
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <LiquidCrystal.h>
+#include <RTClib.h>
+#include <SPI.h>
+#include <Wire.h>
+
+SPIClass SPI;
+TwoWire Wire;
+EEPROMClass EEPROM;
+
+// ---------------------------------------------------------------------------
+// SPI
+// ---------------------------------------------------------------------------
+void SPIClass::begin() { pinMode(53, OUTPUT); }
+
+void SPIClass::end() {}
+
+void SPIClass::beginTransaction(const SPISettings &settings)
+{
+    _settings = settings;
+    _transactions++;
+    NativeHal::advanceCycles(12);
+}
+
+void SPIClass::endTransaction() { NativeHal::advanceCycles(4); }
+
+void NativeHal::spiReset() { SPI = SPIClass(); }
+
+uint8_t SPIClass::transfer(uint8_t data) { return NativeHal::spiTransfer(data, _settings.clock); }
+
+void SPIClass::transfer(void *buf, size_t count)
+{
+    uint8_t *p = static_cast<uint8_t *>(buf);
+    for (size_t i = 0; i < count; i++) {
+        p[i] = NativeHal::spiTransfer(p[i], _settings.clock, true);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Internal EEPROM
+// ---------------------------------------------------------------------------
+namespace {
+
+struct EepromImage {
+    uint8_t bytes[NativeHal::EEPROM_SIZE];
+    EepromImage() { memset(bytes, 0xFF, sizeof(bytes)); }
+};
+
+EepromImage &eeprom()
+{
+    static EepromImage image;
+    return image;
+}
+
+} // namespace
+
+uint8_t *NativeHal::eepromData() { return eeprom().bytes; }
+
+void NativeHal::eraseEeprom() { memset(eeprom().bytes, 0xFF, sizeof(eeprom().bytes)); }
+
+uint8_t EEPROMClass::read(int address)
+{
+    NativeHal::advanceCycles(NativeHal::costs().eepromRead);
+    return address >= 0 && address < NativeHal::EEPROM_SIZE ? eeprom().bytes[address] : 0xFF;
+}
+
+void EEPROMClass::write(int address, uint8_t value)
+{
+    if (address < 0 || address >= NativeHal::EEPROM_SIZE) {
+        return;
+    }
+    NativeHal::chargeDelay(NativeHal::microsToCycles(NativeHal::costs().eepromWriteUs));
+    eeprom().bytes[address] = value;
+}
+
+void EEPROMClass::update(int address, uint8_t value)
+{
+    if (read(address) != value) {
+        write(address, value);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// LiquidCrystal
+// ---------------------------------------------------------------------------
+LiquidCrystal::LiquidCrystal(uint8_t rs, uint8_t enable, uint8_t d0, uint8_t d1, uint8_t d2, uint8_t d3)
+    : _col(0), _row(0)
+{
+    memset(_frame, ' ', sizeof(_frame));
+    _frame[0][16] = '\0';
+    _frame[1][16] = '\0';
+}
+
+void LiquidCrystal::begin(uint8_t cols, uint8_t rows)
+{
+    NativeHal::advanceMicros(50000); // power-on wait + 4-bit init sequence
+    clear();
+}
+
+void LiquidCrystal::clear()
+{
+    memset(_frame[0], ' ', 16);
+    memset(_frame[1], ' ', 16);
+    _col = 0;
+    _row = 0;
+    NativeHal::advanceMicros(NativeHal::costs().lcdClearUs);
+}
+
+void LiquidCrystal::home()
+{
+    _col = 0;
+    _row = 0;
+    NativeHal::advanceMicros(NativeHal::costs().lcdClearUs);
+}
+
+void LiquidCrystal::setCursor(uint8_t col, uint8_t row)
+{
+    _col = col;
+    _row = row < 2 ? row : 1;
+    NativeHal::advanceMicros(NativeHal::costs().lcdCommandUs);
+}
+
+size_t LiquidCrystal::write(uint8_t c)
+{
+    if (_col < 16) {
+        _frame[_row][_col] = (char)c;
+    }
+    _col++;
+    NativeHal::advanceMicros(NativeHal::costs().lcdCommandUs);
+    return 1;
+}
+
+// ---------------------------------------------------------------------------
+// RTClib
+// ---------------------------------------------------------------------------
+namespace {
+
+const uint8_t DAYS_IN_MONTH[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30};
+const uint32_t SECONDS_FROM_1970_TO_2000 = 946684800UL;
+
+uint32_t rtcEpoch = 1735732800UL; // 2025-01-01 12:00:00
+
+uint16_t dateToDays(uint16_t y, uint8_t m, uint8_t d)
+{
+    if (y >= 2000U) {
+        y -= 2000U;
+    }
+    uint16_t days = d;
+    for (uint8_t i = 1; i < m; ++i) {
+        days += DAYS_IN_MONTH[i - 1];
+    }
+    if (m > 2 && y % 4 == 0) {
+        ++days;
+    }
+    return days + 365 * y + (y + 3) / 4 - 1;
+}
+
+} // namespace
+
+namespace NativeHal {
+void setRtcEpoch(uint32_t unixTime) { rtcEpoch = unixTime; }
+} // namespace NativeHal
+
+DateTime::DateTime(uint32_t t)
+{
+    t -= SECONDS_FROM_1970_TO_2000;
+    _ss = t % 60;
+    t /= 60;
+    _mm = t % 60;
+    t /= 60;
+    _hh = t % 24;
+    uint16_t days = t / 24;
+    uint8_t leap;
+    for (_y = 0;; ++_y) {
+        leap = _y % 4 == 0;
+        if (days < 365U + leap) {
+            break;
+        }
+        days -= 365 + leap;
+    }
+    for (_m = 1; _m < 12; ++_m) {
+        uint8_t daysPerMonth = DAYS_IN_MONTH[_m - 1];
+        if (leap && _m == 2) {
+            ++daysPerMonth;
+        }
+        if (days < daysPerMonth) {
+            break;
+        }
+        days -= daysPerMonth;
+    }
+    _d = days + 1;
+}
+
+DateTime::DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t min, uint8_t sec)
+{
+    _y = (uint8_t)(year >= 2000U ? year - 2000U : year);
+    _m = month;
+    _d = day;
+    _hh = hour;
+    _mm = min;
+    _ss = sec;
+}
+
+uint8_t DateTime::dayOfTheWeek() const
+{
+    uint16_t day = dateToDays(_y, _m, _d);
+    return (day + 6) % 7; // Jan 1, 2000 is a Saturday
+}
+
+uint32_t DateTime::unixtime() const
+{
+    uint32_t days = dateToDays(_y, _m, _d);
+    return ((days * 24UL + _hh) * 60 + _mm) * 60 + _ss + SECONDS_FROM_1970_TO_2000;
+}
+
+void RTC_DS1307::adjust(const DateTime &dt)
+{
+    NativeHal::advanceMicros(NativeHal::costs().rtcReadUs);
+    rtcEpoch = dt.unixtime() - (uint32_t)NativeHal::cyclesToSeconds(NativeHal::cycles());
+}
+
+DateTime RTC_DS1307::now()
+{
+    NativeHal::advanceMicros(NativeHal::costs().rtcReadUs);
+    return DateTime(rtcEpoch + (uint32_t)NativeHal::cyclesToSeconds(NativeHal::cycles()));
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * @brief Arduino EEPROM library over NativeHal's 4KB internal EEPROM
+ *
+ * Reads cost a few cycles. Each byte actually changed costs the erase/write
+ * time as a busy-wait, as on the AVR, so update()/put() only pay for bytes
+ * that differ.
+ */
+class EEPROMClass {
+public:
+    uint8_t read(int address);
+    void write(int address, uint8_t value);
+    void update(int address, uint8_t value);
+    uint16_t length() const { return NativeHal::EEPROM_SIZE; }
+
+    template <typename T> T &get(int address, T &value)
+    {
+        uint8_t *bytes = reinterpret_cast<uint8_t *>(&value);
+        for (size_t i = 0; i < sizeof(T); i++) {
+            bytes[i] = read(address + (int)i);
+        }
+        return value;
+    }
+
+    template <typename T> const T &put(int address, const T &value)
+    {
+        const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&value);
+        for (size_t i = 0; i < sizeof(T); i++) {
+            update(address + (int)i, bytes[i]);
+        }
+        return value;
+    }
+};
+
+extern EEPROMClass EEPROM;
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Print.h"
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+    String readStringUntil(char terminator);
+    String readString();
+    size_t readBytes(char *buffer, size_t length);
+
+protected:
+    unsigned long _timeout = 1000;
+};
+
+/**
+ * @brief USART0 model: output is captured (and optionally echoed) and paced at the configured baud rate
+ */
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud) { _baud = baud ? baud : 115200; }
+    void begin(unsigned long baud, uint8_t) { begin(baud); }
+    void end() {}
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    int availableForWrite() override;
+    void flush() override;
+    size_t write(uint8_t c) override;
+    using Print::write;
+
+    operator bool() const { return true; }
+
+    unsigned long baud() const { return _baud; }
+
+private:
+    unsigned long _baud = 115200;
+};
+
+extern HardwareSerial Serial;
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * @brief HD44780 model: keeps the 16x2 frame for assertions and charges controller timing
+ */
+class LiquidCrystal : public Print {
+public:
+    LiquidCrystal(uint8_t rs, uint8_t enable, uint8_t d0, uint8_t d1, uint8_t d2, uint8_t d3);
+
+    void begin(uint8_t cols, uint8_t rows);
+    void clear();
+    void home();
+    void setCursor(uint8_t col, uint8_t row);
+    void noDisplay() {}
+    void display() {}
+    size_t write(uint8_t c) override;
+    using Print::write;
+
+    const char *line(uint8_t row) const { return row < 2 ? _frame[row] : ""; }
+
+private:
+    char _frame[2][17];
+    uint8_t _col;
+    uint8_t _row;
+};
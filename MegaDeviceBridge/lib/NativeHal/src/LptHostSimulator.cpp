@@ -0,0 +1,192 @@
+#include "LptHostSimulator.h"
+#include "SD.h"
+
+namespace NativeHal {
+
+namespace {
+
+uint64_t nsToCycles(uint64_t ns) { return (ns * CYCLES_PER_US + 999) / 1000; }
+
+} // namespace
+
+LptHostSimulator::LptHostSimulator(const Pins &pins, const Timing &timing)
+    : _pins(pins), _timing(timing), _stats(), _state(State::Idle), _next(UINT64_MAX), _waitStart(0), _lastPoll(0),
+      _byteStart(0), _ackFall(0),
+      _acked(false), _jobIndex(0), _offset(0)
+{
+    drivePin(_pins.strobe, true);
+    if (_timing.initPulseNs > 0) {
+        drivePin(_pins.init, true);
+    }
+    presentByte(0);
+}
+
+void LptHostSimulator::addJob(const std::vector<uint8_t> &bytes)
+{
+    _jobs.push_back(bytes);
+    _strobes.push_back(std::vector<uint64_t>(bytes.size(), 0));
+    _jobEnd.push_back(0);
+}
+
+void LptHostSimulator::start(uint64_t atCycle)
+{
+    _jobIndex = 0;
+    _offset = 0;
+    if (_jobs.empty()) {
+        _state = State::Done;
+        _next = UINT64_MAX;
+        return;
+    }
+    beginJob(atCycle);
+}
+
+void LptHostSimulator::beginJob(uint64_t now)
+{
+    if (_timing.initPulseNs > 0) {
+        drivePin(_pins.init, false);
+        _state = State::InitLow;
+        _next = now + nsToCycles(_timing.initPulseNs);
+        return;
+    }
+    _state = State::WaitReady;
+    _waitStart = now;
+    _next = now;
+}
+
+bool LptHostSimulator::finished() const { return _state == State::Done; }
+
+void LptHostSimulator::presentByte(uint8_t value)
+{
+    for (uint8_t bit = 0; bit < 8; bit++) {
+        drivePin(_pins.data[bit], (value >> bit) & 0x01);
+    }
+}
+
+void LptHostSimulator::byteComplete(uint64_t now)
+{
+    _offset++;
+    if (_offset >= _jobs[_jobIndex].size()) {
+        _jobEnd[_jobIndex] = now;
+        _jobIndex++;
+        _offset = 0;
+        if (_jobIndex >= _jobs.size()) {
+            _state = State::Done;
+            _next = UINT64_MAX;
+        } else {
+            _state = State::Gap;
+            _next = now + (uint64_t)_timing.jobGapMs * (CPU_HZ / 1000);
+        }
+        return;
+    }
+    uint64_t earliest = _byteStart + nsToCycles(_timing.minBytePeriodNs);
+    _state = State::WaitReady;
+    _waitStart = earliest > now ? earliest : now;
+    _next = _waitStart;
+}
+
+void LptHostSimulator::onEvent(uint64_t now)
+{
+    switch (_state) {
+    case State::InitLow:
+        drivePin(_pins.init, true);
+        _state = State::WaitReady;
+        _waitStart = now + microsToCycles(_timing.initRecoveryUs);
+        _next = _waitStart;
+        return;
+
+    case State::WaitReady:
+        // Attribute each poll interval to the SD model's state as it ends
+        if (now > _lastPoll && _lastPoll >= _waitStart && sdBusy()) {
+            _stats.busyWaitSdCycles += now - _lastPoll;
+        }
+        _lastPoll = now;
+        if (readPin(_pins.busy)) {
+            if (now - _waitStart < (uint64_t)_timing.busyTimeoutMs * (CPU_HZ / 1000)) {
+                _next = now + nsToCycles(_timing.pollNs);
+                return;
+            }
+            _stats.busyTimeouts++;
+        }
+        _stats.busyWaitCycles += now - _waitStart;
+        _byteStart = now;
+        _acked = false;
+        presentByte(_jobs[_jobIndex][_offset]);
+        _state = State::Setup;
+        _next = now + nsToCycles(_timing.setupNs);
+        return;
+
+    case State::Setup:
+        _strobes[_jobIndex][_offset] = now;
+        if (_stats.bytesSent == 0) {
+            _stats.firstStrobeCycle = now;
+        }
+        _stats.lastStrobeCycle = now;
+        _stats.bytesSent++;
+        _state = State::StrobeLow;
+        _next = now + nsToCycles(_timing.strobeNs);
+        drivePin(_pins.strobe, false);
+        return;
+
+    case State::StrobeLow:
+        _state = State::StrobeHigh;
+        _next = now + nsToCycles(_timing.holdNs);
+        drivePin(_pins.strobe, true);
+        return;
+
+    case State::StrobeHigh:
+        if (!_timing.waitForAck || _acked) {
+            byteComplete(now);
+        } else {
+            _state = State::WaitAck;
+            _next = _byteStart + microsToCycles(_timing.ackTimeoutUs);
+            if (_next < now) {
+                _next = now;
+            }
+        }
+        return;
+
+    case State::WaitAck:
+        _stats.ackTimeouts++;
+        byteComplete(now);
+        return;
+
+    case State::Gap:
+        beginJob(now);
+        return;
+
+    default:
+        _next = UINT64_MAX;
+        return;
+    }
+}
+
+void LptHostSimulator::acknowledged(uint64_t now)
+{
+    if (_state == State::StrobeLow || _state == State::StrobeHigh) {
+        _acked = true;
+    } else if (_state == State::WaitAck) {
+        byteComplete(now);
+    }
+}
+
+void LptHostSimulator::onOutputChange(uint8_t pin, bool level, uint64_t now)
+{
+    if (pin != _pins.ack) {
+        return;
+    }
+    if (_timing.minAckNs == 0) {
+        if (!level) {
+            acknowledged(now);
+        }
+        return;
+    }
+    if (!level) {
+        _ackFall = now;
+    } else if (now - _ackFall >= nsToCycles(_timing.minAckNs)) {
+        acknowledged(now);
+    } else {
+        _stats.shortAcks++;
+    }
+}
+
+} // namespace NativeHal
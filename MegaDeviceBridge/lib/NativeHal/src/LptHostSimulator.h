@@ -0,0 +1,97 @@
+#pragma once
+
+#include "NativeHal.h"
+#include <vector>
+
+namespace NativeHal {
+
+/**
+ * @brief Simulated Centronics host (e.g. the TDS2024 print port) driving the bridge's LPT pins
+ *
+ * Per byte: wait for BUSY low, present data, pulse /STROBE low, then wait for
+ * the /ACK falling edge (or a timeout) before the next byte. With minAckNs set
+ * the sender only notices an /ACK pulse at least that wide, at its rising edge. Jobs are separated
+ * by an idle gap so the firmware sees each one as a new file; with initPulseNs each job also starts
+ * with an /INIT pulse, as print spoolers send one. Every strobe is
+ * timestamped so benchmarks can compute end-to-end latency against the SD model.
+ */
+class LptHostSimulator : public Peripheral {
+public:
+    struct Pins {
+        uint8_t strobe;
+        uint8_t data[8];
+        uint8_t ack;
+        uint8_t busy;
+        uint8_t init = 0xFF;              // /INIT, driven only with initPulseNs
+    };
+
+    struct Timing {
+        uint32_t setupNs = 1000;          // data valid before /STROBE falls
+        uint32_t strobeNs = 1000;         // /STROBE low width
+        uint32_t holdNs = 1000;           // data held after /STROBE rises
+        uint32_t pollNs = 1000;           // BUSY sampling interval while stalled
+        bool waitForAck = true;
+        uint32_t ackTimeoutUs = 100;      // give up on /ACK and move on
+        uint32_t minAckNs = 0;            // shorter /ACK pulses go unseen; >0 takes /ACK at its rising edge
+        uint32_t busyTimeoutMs = 5000;    // printer-port timeout: send anyway
+        uint32_t minBytePeriodNs = 0;     // host-side cap on transfer rate
+        uint32_t jobGapMs = 3000;         // idle time after each job
+        uint32_t initPulseNs = 0;         // >0: pulse /INIT low this long before each job
+        uint32_t initRecoveryUs = 100;    // after /INIT rises, before the job's first byte
+    };
+
+    struct Stats {
+        uint32_t bytesSent;
+        uint32_t ackTimeouts;
+        uint32_t shortAcks;               // /ACK pulses below minAckNs
+        uint32_t busyTimeouts;
+        uint64_t busyWaitCycles;          // time spent waiting for BUSY to drop
+        uint64_t busyWaitSdCycles;        // part of busyWaitCycles while the SD model was busy
+        uint64_t firstStrobeCycle;
+        uint64_t lastStrobeCycle;
+    };
+
+    LptHostSimulator(const Pins &pins, const Timing &timing);
+
+    void addJob(const std::vector<uint8_t> &bytes);
+    void start(uint64_t atCycle);
+    bool finished() const;
+
+    const Stats &stats() const { return _stats; }
+    size_t jobCount() const { return _jobs.size(); }
+    const std::vector<uint8_t> &job(size_t index) const { return _jobs[index]; }
+    /** Cycle at which byte `offset` of job `index` was strobed */
+    uint64_t strobeCycle(size_t index, size_t offset) const { return _strobes[index][offset]; }
+    /** Cycle at which the last byte of job `index` was acknowledged or given up on */
+    uint64_t jobEndCycle(size_t index) const { return _jobEnd[index]; }
+
+    uint64_t nextEventCycle() const override { return _next; }
+    void onEvent(uint64_t now) override;
+    void onOutputChange(uint8_t pin, bool level, uint64_t now) override;
+
+private:
+    enum class State : uint8_t { Idle, InitLow, WaitReady, Setup, StrobeLow, StrobeHigh, WaitAck, Gap, Done };
+
+    void beginJob(uint64_t now);
+    void presentByte(uint8_t value);
+    void byteComplete(uint64_t now);
+    void acknowledged(uint64_t now);
+
+    Pins _pins;
+    Timing _timing;
+    Stats _stats;
+    State _state;
+    uint64_t _next;
+    uint64_t _waitStart;
+    uint64_t _lastPoll;
+    uint64_t _byteStart;
+    uint64_t _ackFall;
+    bool _acked;
+    size_t _jobIndex;
+    size_t _offset;
+    std::vector<std::vector<uint8_t>> _jobs;
+    std::vector<std::vector<uint64_t>> _strobes;
+    std::vector<uint64_t> _jobEnd;
+};
+
+} // namespace NativeHal
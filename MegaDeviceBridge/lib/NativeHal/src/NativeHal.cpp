@@ -0,0 +1,924 @@
+#include <Arduino.h>
+#include <SD.h>
+#include <SPI.h>
+#include <algorithm>
+#include <stdio.h>
+#include <vector>
+
+// Symbols the firmware's free-RAM probes reference on AVR
+int __heap_start;
+int *__brkval = nullptr;
+
+HardwareSerial Serial;
+
+namespace NativeHal {
+
+namespace {
+
+struct PinInfo {
+    uint8_t port;
+    uint8_t bit;
+};
+
+// Arduino Mega 2560 digital pin -> (port, bit); ports are A=0 ... L=10
+const PinInfo PIN_MAP[PIN_COUNT] = {
+    {4, 0}, {4, 1}, {4, 4}, {4, 5}, {6, 5}, {4, 3}, {7, 3}, {7, 4}, {7, 5}, {7, 6},   // 0-9
+    {1, 4}, {1, 5}, {1, 6}, {1, 7}, {8, 1}, {8, 0}, {7, 1}, {7, 0}, {3, 3}, {3, 2},   // 10-19
+    {3, 1}, {3, 0}, {0, 0}, {0, 1}, {0, 2}, {0, 3}, {0, 4}, {0, 5}, {0, 6}, {0, 7},   // 20-29
+    {2, 7}, {2, 6}, {2, 5}, {2, 4}, {2, 3}, {2, 2}, {2, 1}, {2, 0}, {3, 7}, {6, 2},   // 30-39
+    {6, 1}, {6, 0}, {10, 7}, {10, 6}, {10, 5}, {10, 4}, {10, 3}, {10, 2}, {10, 1}, {10, 0}, // 40-49
+    {1, 3}, {1, 2}, {1, 1}, {1, 0}, {5, 0}, {5, 1}, {5, 2}, {5, 3}, {5, 4}, {5, 5},   // 50-59
+    {5, 6}, {5, 7}, {9, 0}, {9, 1}, {9, 2}, {9, 3}, {9, 4}, {9, 5}, {9, 6}, {9, 7},   // 60-69
+};
+
+// Arduino attachInterrupt() number -> INTn
+const uint8_t ARDUINO_INT_TO_INTN[6] = {4, 5, 0, 1, 2, 3};
+
+// Timer1/3/4/5 -> TIMERn_COMPA vector
+const uint8_t TIMER_COMPA_VECTOR[TIMER_COUNT] = {17, 32, 42, 47};
+const uint8_t OCFA_MASK = 0x02;
+
+struct TimerState {
+    uint8_t tccra;
+    uint8_t tccrb;
+    uint8_t timsk;
+    uint8_t tifr;
+    uint16_t ocra;
+    uint16_t baseCount;  // TCNT at baseCycle
+    uint64_t baseCycle;
+    uint64_t matchCycle = UINT64_MAX; // next compare A match, UINT64_MAX when stopped
+};
+
+struct PinTrack {
+    bool level;
+    uint64_t lastChange;
+    uint64_t highCycles;
+    uint32_t edges;
+};
+
+struct State {
+    uint64_t now = 0;
+    PortState ports[PORT_COUNT] = {};
+    PinTrack pins[PIN_COUNT] = {};
+    bool interruptsEnabled = true;
+    bool inIsr = false;
+    bool servicing = false;
+    uint8_t eifr = 0;
+    uint8_t eimsk = 0;
+    void (*handlers[INT_COUNT])() = {};
+    void (*vectors[VECTOR_COUNT])() = {}; // ISR() registrations, kept across reset()
+    TimerState timers[TIMER_COUNT] = {};
+    uint32_t serviced = 0;
+    uint64_t isrCycles = 0;
+    uint64_t isrDelayCycles = 0;
+    uint64_t loopDelayCycles = 0;
+    std::vector<Peripheral *> peripherals;
+    std::vector<SpiDevice *> spiDevices;
+    std::string serialOut;
+    std::string serialIn;
+    bool serialEcho = false;
+    uint64_t serialTxFreeAt = 0;
+    CostModel costs;
+};
+
+State &state()
+{
+    static State s;
+    return s;
+}
+
+int8_t pinFor(uint8_t port, uint8_t bit)
+{
+    for (uint8_t pin = 0; pin < PIN_COUNT; pin++) {
+        if (PIN_MAP[pin].port == port && PIN_MAP[pin].bit == bit) {
+            return (int8_t)pin;
+        }
+    }
+    return -1;
+}
+
+bool computeLevel(const PortState &p, uint8_t mask)
+{
+    if (p.ddr & mask) {
+        return (p.out & mask) != 0;
+    }
+    if (p.driven & mask) {
+        return (p.external & mask) != 0;
+    }
+    return (p.out & mask) != 0; // pull-up enabled -> HIGH, otherwise floating reads LOW
+}
+
+uint8_t edgeMode(uint8_t intn)
+{
+    uint8_t reg = intn < 4 ? eicra.peek() : eicrb.peek();
+    return (reg >> ((intn & 3) * 2)) & 0x03;
+}
+
+void recordLevel(uint8_t pin, bool level)
+{
+    State &s = state();
+    PinTrack &t = s.pins[pin];
+    if (t.level == level) {
+        return;
+    }
+    if (t.level) {
+        t.highCycles += s.now - t.lastChange;
+    }
+    t.level = level;
+    t.lastChange = s.now;
+    t.edges++;
+
+    uint8_t intn = pinInterrupt(pin);
+    if (intn < INT_COUNT) {
+        uint8_t mode = edgeMode(intn);
+        bool fire = (mode == 1) || (mode == 2 && !level) || (mode == 3 && level);
+        if (fire) {
+            s.eifr |= (uint8_t)(1 << intn);
+        }
+    }
+}
+
+void chargeCycles(uint64_t c) { advanceCycles(c); }
+
+uint16_t prescaler(uint8_t tccrb)
+{
+    switch (tccrb & 0x07) {
+    case 1: return 1;
+    case 2: return 8;
+    case 3: return 64;
+    case 4: return 256;
+    case 5: return 1024;
+    default: return 0; // stopped or external clock
+    }
+}
+
+uint16_t timerCount(const TimerState &t)
+{
+    uint16_t div = prescaler(t.tccrb);
+    if (!div) {
+        return t.baseCount;
+    }
+    return (uint16_t)(t.baseCount + (state().now - t.baseCycle) / div);
+}
+
+// First compare A match after now, counting from the current base
+void scheduleMatch(TimerState &t)
+{
+    uint16_t div = prescaler(t.tccrb);
+    if (!div) {
+        t.matchCycle = UINT64_MAX;
+        return;
+    }
+    uint64_t now = state().now;
+    uint64_t period = 0x10000ULL * div;
+    uint64_t match = t.baseCycle + (uint64_t)(uint16_t)(t.ocra - t.baseCount) * div;
+    if (match <= now) {
+        match += ((now - match) / period + 1) * period;
+    }
+    t.matchCycle = match;
+}
+
+void rebaseTimer(TimerState &t, uint16_t count)
+{
+    t.baseCount = count;
+    t.baseCycle = state().now;
+    scheduleMatch(t);
+}
+
+uint64_t nextTimerMatch()
+{
+    State &s = state();
+    uint64_t next = UINT64_MAX;
+    for (uint8_t i = 0; i < TIMER_COUNT; i++) {
+        next = std::min(next, s.timers[i].matchCycle);
+    }
+    return next;
+}
+
+void runTimerMatches()
+{
+    State &s = state();
+    for (uint8_t i = 0; i < TIMER_COUNT; i++) {
+        TimerState &t = s.timers[i];
+        while (t.matchCycle <= s.now) {
+            t.tifr |= OCFA_MASK;
+            t.matchCycle += 0x10000ULL * prescaler(t.tccrb);
+        }
+    }
+}
+
+int8_t pendingTimer()
+{
+    State &s = state();
+    for (uint8_t i = 0; i < TIMER_COUNT; i++) {
+        if (s.timers[i].tifr & s.timers[i].timsk & OCFA_MASK) {
+            return (int8_t)i;
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
+CostModel &costs() { return state().costs; }
+
+uint64_t cycles() { return state().now; }
+
+void advanceCycles(uint64_t count)
+{
+    State &s = state();
+    uint64_t target = s.now + count;
+    while (true) {
+        uint64_t next = nextTimerMatch();
+        for (Peripheral *p : s.peripherals) {
+            next = std::min(next, p->nextEventCycle());
+        }
+        if (next > target) {
+            break;
+        }
+        if (next > s.now) {
+            s.now = next;
+        }
+        runTimerMatches();
+        for (size_t i = 0; i < s.peripherals.size(); i++) {
+            Peripheral *p = s.peripherals[i];
+            if (p->nextEventCycle() <= s.now) {
+                p->onEvent(s.now);
+            }
+        }
+        if (s.now < target) {
+            // An interrupt taken here steals cycles from the interrupted code
+            uint64_t before = s.now;
+            serviceInterrupts();
+            target += s.now - before;
+        }
+    }
+    if (target > s.now) {
+        s.now = target;
+    }
+    serviceInterrupts();
+}
+
+void reset()
+{
+    State &s = state();
+    CostModel keep = s.costs;
+    std::vector<Peripheral *> none;
+    s.now = 0;
+    for (uint8_t i = 0; i < PORT_COUNT; i++) {
+        s.ports[i] = PortState{0, 0, 0, 0};
+    }
+    for (uint8_t i = 0; i < PIN_COUNT; i++) {
+        s.pins[i] = PinTrack{false, 0, 0, 0};
+    }
+    s.interruptsEnabled = true;
+    s.inIsr = false;
+    s.servicing = false;
+    s.eifr = 0;
+    s.eimsk = 0;
+    eicra.poke(0);
+    eicrb.poke(0);
+    for (uint8_t i = 0; i < INT_COUNT; i++) {
+        s.handlers[i] = nullptr;
+    }
+    for (uint8_t i = 0; i < TIMER_COUNT; i++) {
+        s.timers[i] = TimerState{0, 0, 0, 0, 0, 0, 0, UINT64_MAX};
+    }
+    s.serviced = 0;
+    s.isrCycles = 0;
+    s.isrDelayCycles = 0;
+    s.loopDelayCycles = 0;
+    s.peripherals.swap(none);
+    s.spiDevices.clear();
+    s.serialOut.clear();
+    s.serialIn.clear();
+    s.serialTxFreeAt = 0;
+    s.costs = keep;
+    sdReset();
+    spiReset();
+}
+
+uint8_t pinPort(uint8_t pin) { return pin < PIN_COUNT ? PIN_MAP[pin].port : NO_PORT; }
+
+uint8_t pinBit(uint8_t pin) { return pin < PIN_COUNT ? PIN_MAP[pin].bit : 0; }
+
+uint8_t pinInterrupt(uint8_t pin)
+{
+    switch (pin) {
+    case 21: return 0;
+    case 20: return 1;
+    case 19: return 2;
+    case 18: return 3;
+    case 2: return 4;
+    case 3: return 5;
+    default: return 0xFF;
+    }
+}
+
+bool readPin(uint8_t pin)
+{
+    if (pin >= PIN_COUNT) {
+        return false;
+    }
+    return computeLevel(state().ports[PIN_MAP[pin].port], (uint8_t)(1 << PIN_MAP[pin].bit));
+}
+
+void drivePin(uint8_t pin, bool level)
+{
+    if (pin >= PIN_COUNT) {
+        return;
+    }
+    PortState &p = state().ports[PIN_MAP[pin].port];
+    uint8_t mask = (uint8_t)(1 << PIN_MAP[pin].bit);
+    p.driven |= mask;
+    if (level) {
+        p.external |= mask;
+    } else {
+        p.external &= (uint8_t)~mask;
+    }
+    recordLevel(pin, computeLevel(p, mask));
+}
+
+void releasePin(uint8_t pin)
+{
+    if (pin >= PIN_COUNT) {
+        return;
+    }
+    PortState &p = state().ports[PIN_MAP[pin].port];
+    uint8_t mask = (uint8_t)(1 << PIN_MAP[pin].bit);
+    p.driven &= (uint8_t)~mask;
+    recordLevel(pin, computeLevel(p, mask));
+}
+
+bool isOutput(uint8_t pin)
+{
+    if (pin >= PIN_COUNT) {
+        return false;
+    }
+    return (state().ports[PIN_MAP[pin].port].ddr & (1 << PIN_MAP[pin].bit)) != 0;
+}
+
+uint64_t pinHighCycles(uint8_t pin)
+{
+    State &s = state();
+    if (pin >= PIN_COUNT) {
+        return 0;
+    }
+    const PinTrack &t = s.pins[pin];
+    return t.highCycles + (t.level ? s.now - t.lastChange : 0);
+}
+
+uint32_t pinEdgeCount(uint8_t pin) { return pin < PIN_COUNT ? state().pins[pin].edges : 0; }
+
+void notifyPortWrite(uint8_t port, uint8_t oldOut, uint8_t oldDdr)
+{
+    State &s = state();
+    PortState &p = s.ports[port];
+    for (uint8_t bit = 0; bit < 8; bit++) {
+        uint8_t mask = (uint8_t)(1 << bit);
+        if (((oldOut ^ p.out) & mask) == 0 && ((oldDdr ^ p.ddr) & mask) == 0) {
+            continue;
+        }
+        int8_t pin = pinFor(port, bit);
+        if (pin < 0) {
+            continue;
+        }
+        bool before = s.pins[pin].level;
+        bool level = computeLevel(p, mask);
+        recordLevel((uint8_t)pin, level);
+        if ((p.ddr & mask) && level != before) {
+            for (size_t i = 0; i < s.peripherals.size(); i++) {
+                s.peripherals[i]->onOutputChange((uint8_t)pin, level, s.now);
+            }
+        }
+    }
+}
+
+PortState &portState(uint8_t port) { return state().ports[port]; }
+
+uint8_t portInputLevel(uint8_t port)
+{
+    const PortState &p = state().ports[port];
+    uint8_t value = 0;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+        if (computeLevel(p, (uint8_t)(1 << bit))) {
+            value |= (uint8_t)(1 << bit);
+        }
+    }
+    return value;
+}
+
+bool isLowIoPort(uint8_t port) { return port <= 6; }
+
+void attachPeripheral(Peripheral *peripheral)
+{
+    State &s = state();
+    if (std::find(s.peripherals.begin(), s.peripherals.end(), peripheral) == s.peripherals.end()) {
+        s.peripherals.push_back(peripheral);
+    }
+}
+
+void detachPeripheral(Peripheral *peripheral)
+{
+    State &s = state();
+    s.peripherals.erase(std::remove(s.peripherals.begin(), s.peripherals.end(), peripheral), s.peripherals.end());
+}
+
+void attachSpiDevice(SpiDevice *device)
+{
+    State &s = state();
+    if (std::find(s.spiDevices.begin(), s.spiDevices.end(), device) == s.spiDevices.end()) {
+        s.spiDevices.push_back(device);
+    }
+    attachPeripheral(device);
+}
+
+void detachSpiDevice(SpiDevice *device)
+{
+    State &s = state();
+    s.spiDevices.erase(std::remove(s.spiDevices.begin(), s.spiDevices.end(), device), s.spiDevices.end());
+    detachPeripheral(device);
+}
+
+uint8_t spiTransfer(uint8_t data, uint32_t clockHz, bool block)
+{
+    // SPCR/SPSR give F_CPU/2 .. F_CPU/128
+    uint32_t divider = 2;
+    while (divider < 128 && (uint64_t)clockHz * divider < CPU_HZ) {
+        divider <<= 1;
+    }
+    advanceCycles(8 * divider + (block ? state().costs.spiBlockTransfer : state().costs.spiTransfer));
+    for (SpiDevice *device : state().spiDevices) {
+        if (isOutput(device->chipSelectPin) && !readPin(device->chipSelectPin)) {
+            return device->transfer(data, CPU_HZ / divider);
+        }
+    }
+    return 0x00;
+}
+
+bool interruptsEnabled() { return state().interruptsEnabled; }
+
+void setInterruptsEnabled(bool enabled)
+{
+    state().interruptsEnabled = enabled;
+    if (enabled) {
+        serviceInterrupts();
+    }
+}
+
+bool inInterrupt() { return state().inIsr; }
+
+void attachExternalInterrupt(uint8_t intNumber, void (*handler)(), int mode)
+{
+    if (intNumber >= INT_COUNT) {
+        return;
+    }
+    State &s = state();
+    s.handlers[intNumber] = handler;
+    Register8 &eicr = intNumber < 4 ? eicra : eicrb;
+    uint8_t shift = (uint8_t)((intNumber & 3) * 2);
+    eicr.poke((uint8_t)((eicr.peek() & ~(0x03 << shift)) | ((mode & 0x03) << shift)));
+    s.eimsk |= (uint8_t)(1 << intNumber);
+}
+
+void detachExternalInterrupt(uint8_t intNumber)
+{
+    if (intNumber >= INT_COUNT) {
+        return;
+    }
+    State &s = state();
+    s.eimsk &= (uint8_t) ~(1 << intNumber);
+    s.handlers[intNumber] = nullptr;
+}
+
+uint8_t pendingInterrupts() { return state().eifr; }
+
+void clearPendingInterrupts(uint8_t mask) { state().eifr &= (uint8_t)~mask; }
+
+void serviceInterrupts()
+{
+    State &s = state();
+    if (s.servicing || s.inIsr) {
+        return;
+    }
+    s.servicing = true;
+    while (s.interruptsEnabled) {
+        // INT0..INT7 sit ahead of the timer vectors in the table
+        void (*handler)() = nullptr;
+        uint16_t dispatch = 0;
+        uint8_t ready = s.eifr & s.eimsk;
+        if (ready) {
+            uint8_t intn = 0;
+            while (!(ready & (1 << intn))) {
+                intn++;
+            }
+            s.eifr &= (uint8_t) ~(1 << intn);
+            handler = s.handlers[intn];
+            dispatch = s.costs.interruptDispatch;
+        } else {
+            int8_t timer = pendingTimer();
+            if (timer < 0) {
+                break;
+            }
+            s.timers[timer].tifr &= (uint8_t)~OCFA_MASK; // cleared by taking the vector
+            handler = s.vectors[TIMER_COMPA_VECTOR[timer]];
+            dispatch = s.costs.vectorDispatch;
+        }
+        uint64_t entered = s.now;
+        s.inIsr = true;
+        s.interruptsEnabled = false;
+        chargeCycles(dispatch / 2);
+        if (handler) {
+            handler();
+        }
+        chargeCycles(dispatch - dispatch / 2);
+        s.interruptsEnabled = true;
+        s.inIsr = false;
+        s.serviced++;
+        s.isrCycles += s.now - entered;
+    }
+    s.servicing = false;
+}
+
+uint32_t interruptsServiced() { return state().serviced; }
+
+void setVectorHandler(uint8_t vector, void (*handler)())
+{
+    if (vector < VECTOR_COUNT) {
+        state().vectors[vector] = handler;
+    }
+}
+
+uint64_t interruptCycles() { return state().isrCycles; }
+
+uint64_t interruptDelayCycles() { return state().isrDelayCycles; }
+
+uint64_t loopDelayCycles() { return state().loopDelayCycles; }
+
+void chargeDelay(uint64_t count)
+{
+    if (state().inIsr) {
+        state().isrDelayCycles += count;
+    } else {
+        state().loopDelayCycles += count;
+    }
+    advanceCycles(count);
+}
+
+std::string &serialOutput() { return state().serialOut; }
+
+void setSerialEcho(bool echo) { state().serialEcho = echo; }
+
+void pushSerialInput(const char *text) { state().serialIn += text; }
+
+// ---------------------------------------------------------------------------
+// Registers
+// ---------------------------------------------------------------------------
+PortRegister pinRegisters[PORT_COUNT] = {
+    {PortRegister::Role::Input, 0}, {PortRegister::Role::Input, 1}, {PortRegister::Role::Input, 2},
+    {PortRegister::Role::Input, 3}, {PortRegister::Role::Input, 4}, {PortRegister::Role::Input, 5},
+    {PortRegister::Role::Input, 6}, {PortRegister::Role::Input, 7}, {PortRegister::Role::Input, 8},
+    {PortRegister::Role::Input, 9}, {PortRegister::Role::Input, 10}};
+PortRegister ddrRegisters[PORT_COUNT] = {
+    {PortRegister::Role::Direction, 0}, {PortRegister::Role::Direction, 1}, {PortRegister::Role::Direction, 2},
+    {PortRegister::Role::Direction, 3}, {PortRegister::Role::Direction, 4}, {PortRegister::Role::Direction, 5},
+    {PortRegister::Role::Direction, 6}, {PortRegister::Role::Direction, 7}, {PortRegister::Role::Direction, 8},
+    {PortRegister::Role::Direction, 9}, {PortRegister::Role::Direction, 10}};
+PortRegister portRegisters[PORT_COUNT] = {
+    {PortRegister::Role::Output, 0}, {PortRegister::Role::Output, 1}, {PortRegister::Role::Output, 2},
+    {PortRegister::Role::Output, 3}, {PortRegister::Role::Output, 4}, {PortRegister::Role::Output, 5},
+    {PortRegister::Role::Output, 6}, {PortRegister::Role::Output, 7}, {PortRegister::Role::Output, 8},
+    {PortRegister::Role::Output, 9}, {PortRegister::Role::Output, 10}};
+StatusRegister sreg;
+InterruptFlagRegister eifr;
+InterruptMaskRegister eimsk;
+Register8 eicra(true);
+Register8 eicrb(true);
+Register8 gpior0;
+
+Timer0Counter tcnt0;
+
+#define NATIVEHAL_TIMER_REGISTERS(role) \
+    {TimerRegister::Role::role, 0}, {TimerRegister::Role::role, 1}, {TimerRegister::Role::role, 2}, \
+    {TimerRegister::Role::role, 3}
+TimerRegister tccraRegisters[TIMER_COUNT] = {NATIVEHAL_TIMER_REGISTERS(ControlA)};
+TimerRegister tccrbRegisters[TIMER_COUNT] = {NATIVEHAL_TIMER_REGISTERS(ControlB)};
+TimerRegister tcntRegisters[TIMER_COUNT] = {NATIVEHAL_TIMER_REGISTERS(Counter)};
+TimerRegister ocraRegisters[TIMER_COUNT] = {NATIVEHAL_TIMER_REGISTERS(CompareA)};
+TimerRegister timskRegisters[TIMER_COUNT] = {NATIVEHAL_TIMER_REGISTERS(Mask)};
+TimerRegister tifrRegisters[TIMER_COUNT] = {NATIVEHAL_TIMER_REGISTERS(Flags)};
+#undef NATIVEHAL_TIMER_REGISTERS
+
+void PortRegister::chargeAccess() const
+{
+    chargeCycles(isLowIoPort(_port) ? state().costs.ioAccess : state().costs.extIoAccess);
+}
+
+uint8_t PortRegister::load() const
+{
+    const PortState &p = state().ports[_port];
+    switch (_role) {
+    case Role::Input: return portInputLevel(_port);
+    case Role::Direction: return p.ddr;
+    default: return p.out;
+    }
+}
+
+void PortRegister::store(uint8_t value)
+{
+    PortState &p = state().ports[_port];
+    uint8_t oldOut = p.out;
+    uint8_t oldDdr = p.ddr;
+    switch (_role) {
+    case Role::Input: p.out ^= value; break; // writing PINx toggles PORTx
+    case Role::Direction: p.ddr = value; break;
+    default: p.out = value; break;
+    }
+    notifyPortWrite(_port, oldOut, oldDdr);
+}
+
+PortRegister::operator uint8_t() const
+{
+    chargeAccess();
+    return load();
+}
+
+PortRegister &PortRegister::operator=(uint8_t value)
+{
+    chargeAccess();
+    store(value);
+    return *this;
+}
+
+PortRegister &PortRegister::operator|=(uint8_t value)
+{
+    // SBI (2 cycles) in low I/O space, LDS/ORI/STS otherwise
+    chargeCycles(isLowIoPort(_port) ? 2 : 5);
+    store((uint8_t)(load() | value));
+    return *this;
+}
+
+PortRegister &PortRegister::operator&=(uint8_t value)
+{
+    chargeCycles(isLowIoPort(_port) ? 2 : 5);
+    store((uint8_t)(load() & value));
+    return *this;
+}
+
+PortRegister &PortRegister::operator^=(uint8_t value)
+{
+    chargeCycles(isLowIoPort(_port) ? 3 : 5);
+    store((uint8_t)(load() ^ value));
+    return *this;
+}
+
+Register8::operator uint8_t() const
+{
+    chargeCycles(_extended ? state().costs.extIoAccess : state().costs.ioAccess);
+    return _value;
+}
+
+Register8 &Register8::operator=(uint8_t value)
+{
+    chargeCycles(_extended ? state().costs.extIoAccess : state().costs.ioAccess);
+    uint8_t old = _value;
+    _value = value;
+    if (_hook) {
+        _hook(*this, old);
+    }
+    return *this;
+}
+
+StatusRegister::operator uint8_t() const
+{
+    chargeCycles(1);
+    return state().interruptsEnabled ? 0x80 : 0x00;
+}
+
+StatusRegister &StatusRegister::operator=(uint8_t value)
+{
+    chargeCycles(1);
+    setInterruptsEnabled((value & 0x80) != 0);
+    return *this;
+}
+
+InterruptFlagRegister::operator uint8_t() const
+{
+    chargeCycles(1);
+    return state().eifr;
+}
+
+InterruptFlagRegister &InterruptFlagRegister::operator=(uint8_t value)
+{
+    chargeCycles(1);
+    state().eifr &= (uint8_t)~value;
+    return *this;
+}
+
+InterruptMaskRegister::operator uint8_t() const
+{
+    chargeCycles(1);
+    return state().eimsk;
+}
+
+InterruptMaskRegister &InterruptMaskRegister::operator=(uint8_t value)
+{
+    chargeCycles(1);
+    state().eimsk = value;
+    serviceInterrupts();
+    return *this;
+}
+
+namespace {
+
+// TIFRn is in IN/OUT space, the rest of the timer block needs LDS/STS; 16-bit registers take two
+uint16_t timerAccessCost(TimerRegister::Role role)
+{
+    const CostModel &c = state().costs;
+    switch (role) {
+    case TimerRegister::Role::Flags: return c.ioAccess;
+    case TimerRegister::Role::Counter:
+    case TimerRegister::Role::CompareA: return (uint16_t)(2 * c.extIoAccess);
+    default: return c.extIoAccess;
+    }
+}
+
+} // namespace
+
+Timer0Counter::operator uint8_t() const
+{
+    chargeCycles(state().costs.ioAccess);
+    return (uint8_t)(state().now / 64);
+}
+
+uint16_t TimerRegister::peek() const
+{
+    const TimerState &t = state().timers[_timer];
+    switch (_role) {
+    case Role::ControlA: return t.tccra;
+    case Role::ControlB: return t.tccrb;
+    case Role::Counter: return timerCount(t);
+    case Role::CompareA: return t.ocra;
+    case Role::Mask: return t.timsk;
+    default: return t.tifr;
+    }
+}
+
+TimerRegister::operator uint16_t() const
+{
+    chargeCycles(timerAccessCost(_role));
+    return peek();
+}
+
+TimerRegister &TimerRegister::operator=(uint16_t value)
+{
+    chargeCycles(timerAccessCost(_role));
+    TimerState &t = state().timers[_timer];
+    switch (_role) {
+    case Role::ControlA: t.tccra = (uint8_t)value; break;
+    case Role::ControlB: {
+        uint16_t count = timerCount(t);
+        t.tccrb = (uint8_t)value;
+        rebaseTimer(t, count);
+        break;
+    }
+    case Role::Counter: rebaseTimer(t, value); break; // also defers the next match a full period
+    case Role::CompareA: t.ocra = value; scheduleMatch(t); break;
+    case Role::Mask: t.timsk = (uint8_t)value; serviceInterrupts(); break;
+    default: t.tifr &= (uint8_t)~value; break; // writing a one clears the flag
+    }
+    return *this;
+}
+
+// ---------------------------------------------------------------------------
+// Serial pacing
+// ---------------------------------------------------------------------------
+void serialWrite(uint8_t c)
+{
+    State &s = state();
+    const uint64_t charCycles = (uint64_t)CPU_HZ * 10 / Serial.baud();
+    const uint64_t queueLimit = 64 * charCycles; // TX ring buffer depth
+    chargeCycles(s.costs.serialCharCpu);
+    if (s.serialTxFreeAt < s.now) {
+        s.serialTxFreeAt = s.now;
+    }
+    s.serialTxFreeAt += charCycles;
+    if (s.serialTxFreeAt - s.now > queueLimit) {
+        chargeCycles(s.serialTxFreeAt - s.now - queueLimit);
+    }
+    if (s.serialOut.size() > (1u << 20)) {
+        s.serialOut.erase(0, s.serialOut.size() / 2);
+    }
+    s.serialOut.push_back((char)c);
+    if (s.serialEcho) {
+        fputc(c, stdout);
+    }
+}
+
+void serialDrain()
+{
+    State &s = state();
+    if (s.serialTxFreeAt > s.now) {
+        chargeCycles(s.serialTxFreeAt - s.now);
+    }
+}
+
+std::string &serialInput() { return state().serialIn; }
+
+} // namespace NativeHal
+
+// ---------------------------------------------------------------------------
+// Arduino core API
+// ---------------------------------------------------------------------------
+using NativeHal::costs;
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    NativeHal::advanceCycles(costs().pinMode);
+    uint8_t port = NativeHal::pinPort(pin);
+    if (port == NativeHal::NO_PORT) {
+        return;
+    }
+    NativeHal::PortState &p = NativeHal::portState(port);
+    uint8_t mask = (uint8_t)(1 << NativeHal::pinBit(pin));
+    uint8_t oldOut = p.out;
+    uint8_t oldDdr = p.ddr;
+    if (mode == OUTPUT) {
+        p.ddr |= mask;
+    } else {
+        p.ddr &= (uint8_t)~mask;
+        if (mode == INPUT_PULLUP) {
+            p.out |= mask;
+        } else {
+            p.out &= (uint8_t)~mask;
+        }
+    }
+    NativeHal::notifyPortWrite(port, oldOut, oldDdr);
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+    NativeHal::advanceCycles(costs().digitalWrite);
+    uint8_t port = NativeHal::pinPort(pin);
+    if (port == NativeHal::NO_PORT) {
+        return;
+    }
+    NativeHal::PortState &p = NativeHal::portState(port);
+    uint8_t mask = (uint8_t)(1 << NativeHal::pinBit(pin));
+    uint8_t oldOut = p.out;
+    if (value == LOW) {
+        p.out &= (uint8_t)~mask;
+    } else {
+        p.out |= mask;
+    }
+    NativeHal::notifyPortWrite(port, oldOut, p.ddr);
+}
+
+int digitalRead(uint8_t pin)
+{
+    NativeHal::advanceCycles(costs().digitalRead);
+    return NativeHal::readPin(pin) ? HIGH : LOW;
+}
+
+int analogRead(uint8_t pin)
+{
+    NativeHal::advanceCycles(costs().analogRead);
+    return 1023; // no keypad button pressed
+}
+
+void analogWrite(uint8_t pin, int value) { digitalWrite(pin, value >= 128 ? HIGH : LOW); }
+
+unsigned long millis()
+{
+    NativeHal::advanceCycles(costs().millis);
+    return (unsigned long)(NativeHal::cycles() / (NativeHal::CPU_HZ / 1000UL));
+}
+
+unsigned long micros()
+{
+    NativeHal::advanceCycles(costs().micros);
+    return (unsigned long)(NativeHal::cycles() / NativeHal::CYCLES_PER_US);
+}
+
+void delay(unsigned long ms) { NativeHal::chargeDelay((uint64_t)ms * (NativeHal::CPU_HZ / 1000UL)); }
+
+void delayMicroseconds(unsigned int us)
+{
+    NativeHal::chargeDelay(us == 0 ? 4 : (uint64_t)us * NativeHal::CYCLES_PER_US);
+}
+
+void yield() {}
+
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode)
+{
+    if (interruptNum < 6) {
+        NativeHal::attachExternalInterrupt(NativeHal::ARDUINO_INT_TO_INTN[interruptNum], userFunc, mode);
+    }
+}
+
+void detachInterrupt(uint8_t interruptNum)
+{
+    if (interruptNum < 6) {
+        NativeHal::detachExternalInterrupt(NativeHal::ARDUINO_INT_TO_INTN[interruptNum]);
+    }
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+/**
+ * @brief Host-side model of the ATmega2560 used by the native build
+ *
+ * The firmware is compiled unchanged against this shim. Time is virtual: every
+ * Arduino call, register access and delay charges an approximate AVR cycle cost
+ * to a 16MHz clock, so measurements are deterministic and comparable between
+ * runs. Simulated peripherals (the LPT host, SD card, ...) are scheduled on the
+ * same clock and may raise external interrupts while the firmware is "busy".
+ */
+namespace NativeHal {
+
+constexpr uint32_t CPU_HZ = 16000000UL;
+constexpr uint32_t CYCLES_PER_US = CPU_HZ / 1000000UL;
+constexpr uint8_t PIN_COUNT = 70;
+constexpr uint8_t PORT_COUNT = 11;   // A B C D E F G H J K L
+constexpr uint8_t INT_COUNT = 8;     // INT0..INT7
+constexpr uint8_t TIMER_COUNT = 4;   // 16-bit Timer1, Timer3, Timer4, Timer5
+constexpr uint8_t VECTOR_COUNT = 57; // ATmega2560 vector table, reset = 0
+constexpr uint8_t NO_PORT = 0xFF;
+
+/**
+ * @brief Approximate cycle cost of core calls on a 16MHz Mega (tunable per test)
+ */
+struct CostModel {
+    uint16_t digitalWrite = 56;        // pin table lookups + SREG save/restore
+    uint16_t digitalRead = 50;
+    uint16_t pinMode = 64;
+    uint16_t analogRead = 1792;        // 13 ADC clocks at 125kHz
+    uint16_t millis = 20;
+    uint16_t micros = 34;
+    uint16_t ioAccess = 1;             // IN/OUT to low I/O space
+    uint16_t extIoAccess = 2;          // LDS/STS to extended I/O space
+    uint16_t interruptDispatch = 88;   // vector + WInterrupts prologue/epilogue + icall
+    uint16_t vectorDispatch = 30;      // ISR(): response + JMP + short prologue/epilogue + RETI
+    uint16_t spiTransfer = 8;          // call overhead per byte, on top of 8 SCK periods
+    uint16_t spiBlockTransfer = 2;     // per byte in SPI.transfer(buf, count): the next byte goes out as SPIF sets
+    uint16_t serialCharCpu = 40;       // HardwareSerial::write bookkeeping
+    uint32_t lcdCommandUs = 40;
+    uint32_t lcdClearUs = 1600;
+    uint32_t rtcReadUs = 900;          // DS1307 over 100kHz I2C
+    uint16_t eepromRead = 4;           // EEAR/EECR/EEDR sequence
+    uint32_t eepromWriteUs = 3400;     // erase + write, busy-waited by the EEPROM library
+};
+
+CostModel &costs();
+
+// ---------------------------------------------------------------------------
+// Clock
+// ---------------------------------------------------------------------------
+uint64_t cycles();
+inline uint64_t microsToCycles(uint64_t us) { return us * CYCLES_PER_US; }
+inline double cyclesToSeconds(uint64_t c) { return (double)c / (double)CPU_HZ; }
+
+/**
+ * @brief Advance virtual time, running peripheral events and pending interrupts
+ */
+void advanceCycles(uint64_t count);
+inline void advanceMicros(uint64_t us) { advanceCycles(microsToCycles(us)); }
+
+/**
+ * @brief Reset clock, registers, interrupts, peripherals, serial and SD state
+ */
+void reset();
+
+// ---------------------------------------------------------------------------
+// Pins (Arduino Mega numbering)
+// ---------------------------------------------------------------------------
+uint8_t pinPort(uint8_t pin);     // 0 = PORTA ... 10 = PORTL, NO_PORT if unknown
+uint8_t pinBit(uint8_t pin);
+uint8_t pinInterrupt(uint8_t pin); // INTn number or 0xFF
+
+bool readPin(uint8_t pin);             // electrical level as seen from outside the chip
+void drivePin(uint8_t pin, bool level); // external driver, e.g. the simulated host
+void releasePin(uint8_t pin);
+bool isOutput(uint8_t pin);
+
+/**
+ * @brief Accumulated cycles an output pin has spent HIGH since reset
+ */
+uint64_t pinHighCycles(uint8_t pin);
+uint32_t pinEdgeCount(uint8_t pin);
+
+// Called by the register model when port outputs change
+void notifyPortWrite(uint8_t port, uint8_t oldOut, uint8_t oldDdr);
+
+// ---------------------------------------------------------------------------
+// Peripherals
+// ---------------------------------------------------------------------------
+class Peripheral {
+public:
+    virtual ~Peripheral() = default;
+    /** Next cycle at which onEvent() must run, UINT64_MAX when idle */
+    virtual uint64_t nextEventCycle() const = 0;
+    virtual void onEvent(uint64_t now) = 0;
+    /** Output pin driven by the firmware changed level */
+    virtual void onOutputChange(uint8_t pin, bool level, uint64_t now) {}
+};
+
+void attachPeripheral(Peripheral *peripheral);
+void detachPeripheral(Peripheral *peripheral);
+
+/**
+ * @brief Device on the SPI bus, selected while the firmware drives its chip select low
+ */
+class SpiDevice : public Peripheral {
+public:
+    explicit SpiDevice(uint8_t chipSelectPin) : chipSelectPin(chipSelectPin) {}
+    uint64_t nextEventCycle() const override { return UINT64_MAX; }
+    void onEvent(uint64_t now) override {}
+    /** One byte clocked while selected: MOSI in, MISO out */
+    virtual uint8_t transfer(uint8_t data, uint32_t clockHz) = 0;
+    const uint8_t chipSelectPin;
+};
+
+/** Also attaches it as a Peripheral, so it sees its chip select edges */
+void attachSpiDevice(SpiDevice *device);
+void detachSpiDevice(SpiDevice *device);
+/**
+ * @brief One byte over SPI: 8 SCK periods at the AVR divider nearest below `clockHz`
+ * (F_CPU/2 at most) plus the call or block loop overhead, through the selected device;
+ * 0x00 with none selected
+ */
+uint8_t spiTransfer(uint8_t data, uint32_t clockHz, bool block = false);
+
+// ---------------------------------------------------------------------------
+// Interrupts
+// ---------------------------------------------------------------------------
+bool interruptsEnabled();
+void setInterruptsEnabled(bool enabled);
+bool inInterrupt();
+void attachExternalInterrupt(uint8_t intNumber, void (*handler)(), int mode);
+void detachExternalInterrupt(uint8_t intNumber);
+uint8_t pendingInterrupts();          // EIFR image
+void clearPendingInterrupts(uint8_t mask);
+void serviceInterrupts();
+uint32_t interruptsServiced();
+
+/**
+ * @brief Handler behind ISR(vector) on the host (see avr/interrupt.h)
+ *
+ * Registrations are static and survive reset(). Only the timer compare
+ * vectors are dispatched; external interrupts go through attachInterrupt().
+ */
+void setVectorHandler(uint8_t vector, void (*handler)());
+
+struct VectorRegistration {
+    VectorRegistration(uint8_t vector, void (*handler)()) { setVectorHandler(vector, handler); }
+};
+/** Cycles spent in interrupt context (dispatch + handler), and the part of it spent in delay()/delayMicroseconds() */
+uint64_t interruptCycles();
+uint64_t interruptDelayCycles();
+/** Cycles the main loop spent in delay()/delayMicroseconds() (interrupts taken meanwhile not included) */
+uint64_t loopDelayCycles();
+
+// ---------------------------------------------------------------------------
+// Serial
+// ---------------------------------------------------------------------------
+std::string &serialOutput();
+void setSerialEcho(bool echo);
+void pushSerialInput(const char *text);
+
+// ---------------------------------------------------------------------------
+// Internal EEPROM (see EEPROM.h); not cleared by reset(), like the real part across a reboot
+// ---------------------------------------------------------------------------
+constexpr uint16_t EEPROM_SIZE = 4096;
+uint8_t *eepromData();
+void eraseEeprom(); // back to 0xFF, as shipped
+
+// Busy-wait delays (accounted separately when in interrupt context)
+void chargeDelay(uint64_t count);
+
+// Used by HardwareSerial
+void serialWrite(uint8_t c);
+void serialDrain();
+std::string &serialInput();
+
+} // namespace NativeHal
@@ -0,0 +1,112 @@
+#include <Arduino.h>
+#include <stdio.h>
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    size_t n = 0;
+    while (size--) {
+        if (!write(*buffer++)) {
+            break;
+        }
+        n++;
+    }
+    return n;
+}
+
+size_t Print::printNumber(unsigned long long value, int base)
+{
+    if (base < 2) {
+        base = 10;
+    }
+    char buf[8 * sizeof(unsigned long long) + 1];
+    char *p = buf + sizeof(buf) - 1;
+    *p = '\0';
+    do {
+        unsigned digit = (unsigned)(value % (unsigned)base);
+        *--p = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+        value /= (unsigned)base;
+    } while (value);
+    return write(p);
+}
+
+size_t Print::printSigned(long long value, int base)
+{
+    if (base == 10 && value < 0) {
+        size_t n = print('-');
+        return n + printNumber((unsigned long long)(-(value + 1)) + 1, base);
+    }
+    // Arduino prints negative values in other bases as their 32-bit pattern
+    return printNumber(base == 10 ? (unsigned long long)value : (unsigned long long)(uint32_t)value, base);
+}
+
+size_t Print::print(double value, int digits)
+{
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", digits, value);
+    return write(buf);
+}
+
+// ---------------------------------------------------------------------------
+// Stream
+// ---------------------------------------------------------------------------
+String Stream::readStringUntil(char terminator)
+{
+    String out;
+    int c;
+    while ((c = read()) >= 0 && c != terminator) {
+        out += (char)c;
+    }
+    return out;
+}
+
+String Stream::readString()
+{
+    String out;
+    int c;
+    while ((c = read()) >= 0) {
+        out += (char)c;
+    }
+    return out;
+}
+
+size_t Stream::readBytes(char *buffer, size_t length)
+{
+    size_t n = 0;
+    int c;
+    while (n < length && (c = read()) >= 0) {
+        buffer[n++] = (char)c;
+    }
+    return n;
+}
+
+// ---------------------------------------------------------------------------
+// HardwareSerial
+// ---------------------------------------------------------------------------
+int HardwareSerial::available() { return (int)NativeHal::serialInput().size(); }
+
+int HardwareSerial::read()
+{
+    std::string &in = NativeHal::serialInput();
+    if (in.empty()) {
+        return -1;
+    }
+    uint8_t c = (uint8_t)in[0];
+    in.erase(0, 1);
+    return c;
+}
+
+int HardwareSerial::peek()
+{
+    std::string &in = NativeHal::serialInput();
+    return in.empty() ? -1 : (uint8_t)in[0];
+}
+
+int HardwareSerial::availableForWrite() { return 63; }
+
+void HardwareSerial::flush() { NativeHal::serialDrain(); }
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    NativeHal::serialWrite(c);
+    return 1;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Arduino.h>
+
+class DateTime {
+public:
+    DateTime(uint32_t unixTime = 0);
+    DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour = 0, uint8_t min = 0, uint8_t sec = 0);
+
+    uint16_t year() const { return 2000U + _y; }
+    uint8_t month() const { return _m; }
+    uint8_t day() const { return _d; }
+    uint8_t hour() const { return _hh; }
+    uint8_t minute() const { return _mm; }
+    uint8_t second() const { return _ss; }
+    uint8_t dayOfTheWeek() const;
+    uint32_t unixtime() const;
+
+private:
+    uint8_t _y, _m, _d, _hh, _mm, _ss;
+};
+
+/**
+ * @brief DS1307 model running on the virtual clock from a settable epoch
+ */
+class RTC_DS1307 {
+public:
+    bool begin() { return true; }
+    bool isrunning() { return true; }
+    void adjust(const DateTime &dt);
+    DateTime now();
+};
+
+namespace NativeHal {
+/** Unix time reported by every RTC_DS1307 at virtual cycle 0 */
+void setRtcEpoch(uint32_t unixTime);
+}
@@ -0,0 +1,820 @@
+#include <SD.h>
+#include <ctype.h>
+#include <algorithm>
+
+SDClass SD;
+
+namespace NativeHal {
+
+struct SdHandle {
+    SdNode *node = nullptr;      // nullptr for the root directory
+    bool isDirectory = false;
+    bool writable = false;
+    bool open = true;
+    uint32_t position = 0;
+    int32_t cacheBlock = -1;     // file block currently held in the shared block cache
+    bool cacheDirty = false;
+    uint32_t cacheEpoch = 0;     // SdVolume::cacheClear() since cacheBlock was loaded invalidates it
+    size_t dirIndex = 0;         // openNextFile() cursor
+    std::string dirPath;         // directory being listed
+    char name[13] = {0};
+};
+
+namespace {
+
+const uint32_t BLOCK_SIZE = 512;
+const uint32_t DIR_ENTRIES_PER_BLOCK = BLOCK_SIZE / 32;
+
+struct SdState {
+    SdTiming timing;
+    SdStats stats = {};
+    bool inserted = true;
+    std::vector<std::unique_ptr<SdNode>> nodes;
+    size_t traceIndex = 0;
+    bool busy = false;
+    uint64_t programmedAt = 0;   // a streamed block is being programmed until this cycle
+    bool cacheDirty = false;     // a File left data in the block cache
+    uint32_t cacheEpoch = 0;
+    uint32_t nextBlock = 0x8000; // next free extent for createContiguous()
+    uint8_t cache[512];          // what SdVolume::cacheClear() hands out
+};
+
+SdState &sd()
+{
+    static SdState s;
+    return s;
+}
+
+std::string normalize(const char *path)
+{
+    std::string out;
+    for (const char *p = path ? path : ""; *p; ++p) {
+        out.push_back((char)toupper((unsigned char)*p));
+    }
+    while (!out.empty() && out[0] == '/') {
+        out.erase(0, 1);
+    }
+    while (!out.empty() && out[out.size() - 1] == '/') {
+        out.erase(out.size() - 1);
+    }
+    return out;
+}
+
+std::string parentOf(const std::string &path)
+{
+    size_t slash = path.rfind('/');
+    return slash == std::string::npos ? std::string() : path.substr(0, slash);
+}
+
+SdNode *findNode(const std::string &path)
+{
+    for (auto &node : sd().nodes) {
+        if (node->path == path) {
+            return node.get();
+        }
+    }
+    return nullptr;
+}
+
+bool directoryExists(const std::string &path)
+{
+    if (path.empty()) {
+        return true;
+    }
+    SdNode *node = findNode(path);
+    return node && node->isDirectory;
+}
+
+size_t entriesIn(const std::string &dir)
+{
+    size_t count = 2; // "." and ".." (the root has a volume label instead)
+    for (auto &node : sd().nodes) {
+        if (parentOf(node->path) == dir) {
+            count++;
+        }
+    }
+    return count;
+}
+
+/** Directory blocks read while resolving every component of a path */
+void chargeLookup(const std::string &path)
+{
+    std::string walked;
+    uint32_t reads = 0;
+    size_t start = 0;
+    while (true) {
+        reads += (uint32_t)(entriesIn(walked) / DIR_ENTRIES_PER_BLOCK) + 1;
+        size_t slash = path.find('/', start);
+        if (slash == std::string::npos) {
+            break;
+        }
+        walked = path.substr(0, slash);
+        start = slash + 1;
+    }
+    sdChargeSectorReads(reads);
+}
+
+void chargeBusy(uint64_t busy)
+{
+    // Every SD library command first waits for the card to finish programming
+    if (sd().programmedAt > cycles()) {
+        sd().busy = true;
+        advanceCycles(sd().programmedAt - cycles());
+    }
+    sd().stats.busyCycles += busy;
+    sd().busy = true;
+    advanceCycles(busy);
+    sd().busy = false;
+}
+
+/** FAT read-modify-write for one cluster allocation, mirrored to both FAT copies */
+void chargeClusterAllocation()
+{
+    sdChargeSectorReads(1);
+    sdChargeSectorWrites(2, true);
+}
+
+void writeBack(SdHandle &h)
+{
+    if (h.cacheDirty) {
+        sdChargeSectorWrites(1, false);
+        h.cacheDirty = false;
+        sd().cacheDirty = false;
+    }
+}
+
+/** The SD library is about to load a block: raw data left in the cache is gone, a stale cached block is reloaded */
+void useCache(SdHandle *h = nullptr)
+{
+    memset(sd().cache, 0xA5, sizeof(sd().cache));
+    if (h && h->cacheEpoch != sd().cacheEpoch) {
+        h->cacheBlock = -1;
+        h->cacheDirty = false;
+        h->cacheEpoch = sd().cacheEpoch;
+    }
+}
+
+/** Contiguous file holding card block `block`, and the block's offset in it */
+SdNode *extentOf(uint32_t block, uint32_t &offset)
+{
+    for (auto &node : sd().nodes) {
+        if (node->extentBlocks && block >= node->firstBlock && block < node->firstBlock + node->extentBlocks) {
+            offset = (block - node->firstBlock) * BLOCK_SIZE;
+            return node.get();
+        }
+    }
+    return nullptr;
+}
+
+/** Raw block write into an extent; only the part inside the file's size is kept */
+void storeBlock(uint32_t block, const uint8_t *src)
+{
+    uint32_t offset;
+    SdNode *node = extentOf(block, offset);
+    if (!node || offset >= node->data.size()) {
+        return;
+    }
+    const uint32_t end = std::min<uint32_t>(offset + BLOCK_SIZE, (uint32_t)node->data.size());
+    memcpy(&node->data[offset], src, end - offset);
+    // A padded tail block counts as on the card to its end; the block's final write follows later
+    if (node->durability.empty() || node->durability.back().size < end) {
+        node->durability.push_back(DurabilityMark{std::max(cycles(), sd().programmedAt), end});
+    }
+}
+
+/** Counts a sector write; the card's extra latency for it (spike, trace) */
+uint64_t sectorWriteExtraUs(bool metadata)
+{
+    SdState &s = sd();
+    uint64_t us = 0;
+    s.stats.sectorWrites++;
+    if (metadata) {
+        s.stats.metadataSectorWrites++;
+    } else {
+        s.stats.dataSectorWrites++;
+    }
+    if (s.timing.spikeEvery && s.stats.sectorWrites % s.timing.spikeEvery == 0) {
+        us += s.timing.spikeUs;
+    }
+    if (s.timing.latencyTrace && s.timing.latencyTraceLength) {
+        us += s.timing.latencyTrace[s.traceIndex++ % s.timing.latencyTraceLength];
+    }
+    return us;
+}
+
+void chargeSectorWrite(uint64_t us, bool metadata)
+{
+    chargeBusy(microsToCycles(us + sectorWriteExtraUs(metadata)));
+}
+
+void setShortName(SdHandle &h, const std::string &path)
+{
+    size_t slash = path.rfind('/');
+    std::string leaf = slash == std::string::npos ? path : path.substr(slash + 1);
+    strncpy(h.name, leaf.c_str(), sizeof(h.name) - 1);
+}
+
+} // namespace
+
+SdTiming &sdTiming() { return sd().timing; }
+
+SdStats &sdStats() { return sd().stats; }
+
+bool sdBusy() { return sd().busy; }
+
+bool sdProgramming() { return sd().programmedAt > cycles(); }
+
+void sdReset()
+{
+    SdState &s = sd();
+    s.stats = SdStats{};
+    s.nodes.clear();
+    s.traceIndex = 0;
+    s.programmedAt = 0;
+    s.cacheDirty = false;
+    s.nextBlock = 0x8000;
+    s.inserted = true;
+}
+
+void sdSetInserted(bool inserted) { sd().inserted = inserted; }
+
+void sdPowerLoss()
+{
+    SdState &s = sd();
+    for (auto &node : s.nodes) {
+        if (!node->isDirectory && node->data.size() > node->committedSize) {
+            node->data.resize(node->committedSize);
+        }
+    }
+    // Open handles and the block cache belonged to the firmware that lost power
+    s.programmedAt = 0;
+    s.cacheDirty = false;
+    s.cacheEpoch++;
+    memset(s.cache, 0xA5, sizeof(s.cache));
+}
+
+std::vector<const SdNode *> sdFiles()
+{
+    std::vector<const SdNode *> out;
+    for (auto &node : sd().nodes) {
+        if (!node->isDirectory) {
+            out.push_back(node.get());
+        }
+    }
+    return out;
+}
+
+const SdNode *sdFind(const char *path) { return findNode(normalize(path)); }
+
+void sdChargeSectorWrites(uint32_t count, bool metadata)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        chargeSectorWrite(sd().timing.commandUs + sd().timing.sectorWriteUs, metadata);
+    }
+}
+
+void sdChargeSectorReads(uint32_t count)
+{
+    SdState &s = sd();
+    s.stats.sectorReads += count;
+    chargeBusy(microsToCycles((uint64_t)count * (s.timing.commandUs + s.timing.sectorReadUs)));
+}
+
+} // namespace NativeHal
+
+using namespace NativeHal;
+
+// ---------------------------------------------------------------------------
+// SDClass
+// ---------------------------------------------------------------------------
+namespace {
+// SDClass members on the board; begin() binds the volume's block cache to this card
+Sd2Card libraryCard;
+SdVolume libraryVolume;
+}
+
+bool SDClass::begin(uint8_t csPin)
+{
+    return libraryCard.init(SPI_HALF_SPEED, csPin) && libraryVolume.init(&libraryCard);
+}
+
+File SDClass::open(const char *filename, uint8_t mode)
+{
+    if (!sd().inserted) {
+        return File();
+    }
+    std::string path = normalize(filename);
+    useCache();
+    chargeLookup(path);
+    sd().stats.opens++;
+
+    auto handle = std::make_shared<SdHandle>();
+    if (path.empty()) {
+        handle->isDirectory = true;
+        strcpy(handle->name, "/");
+        return File(handle);
+    }
+
+    SdNode *node = findNode(path);
+    bool write = (mode & 0x02) != 0;
+    if (!node) {
+        if (!write || !directoryExists(parentOf(path))) {
+            return File();
+        }
+        std::unique_ptr<SdNode> created(new SdNode());
+        created->path = path;
+        created->createdCycle = cycles();
+        node = created.get();
+        sd().nodes.push_back(std::move(created));
+        sdChargeSectorWrites(1, true); // new directory entry
+    }
+    if (node->isDirectory) {
+        handle->isDirectory = true;
+        handle->dirPath = path;
+    } else if (write && (mode & 0x04)) {
+        handle->position = (uint32_t)node->data.size(); // O_APPEND
+    }
+    handle->node = node;
+    handle->writable = write && !node->isDirectory;
+    setShortName(*handle, path);
+    return File(handle);
+}
+
+bool SDClass::exists(const char *filepath)
+{
+    std::string path = normalize(filepath);
+    useCache();
+    chargeLookup(path);
+    return path.empty() || findNode(path) != nullptr;
+}
+
+bool SDClass::mkdir(const char *filepath)
+{
+    std::string path = normalize(filepath);
+    if (!sd().inserted || path.empty()) {
+        return false;
+    }
+    useCache();
+    chargeLookup(path);
+    std::string walked;
+    size_t start = 0;
+    while (true) {
+        size_t slash = path.find('/', start);
+        walked = slash == std::string::npos ? path : path.substr(0, slash);
+        if (!findNode(walked)) {
+            std::unique_ptr<SdNode> dir(new SdNode());
+            dir->path = walked;
+            dir->isDirectory = true;
+            dir->createdCycle = cycles();
+            sd().nodes.push_back(std::move(dir));
+            sd().stats.mkdirs++;
+            chargeClusterAllocation();
+            sdChargeSectorWrites(sd().timing.blocksPerCluster, true); // zero the new directory cluster
+            sdChargeSectorReads(1);
+            sdChargeSectorWrites(1, true); // entry in the parent directory
+        }
+        if (slash == std::string::npos) {
+            return true;
+        }
+        start = slash + 1;
+    }
+}
+
+bool SDClass::remove(const char *filepath)
+{
+    std::string path = normalize(filepath);
+    useCache();
+    chargeLookup(path);
+    auto &nodes = sd().nodes;
+    for (auto it = nodes.begin(); it != nodes.end(); ++it) {
+        if ((*it)->path == path && !(*it)->isDirectory) {
+            nodes.erase(it);
+            sdChargeSectorWrites(1, true);
+            chargeClusterAllocation();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SDClass::rmdir(const char *filepath)
+{
+    std::string path = normalize(filepath);
+    if (entriesIn(path) > 2) {
+        return false;
+    }
+    auto &nodes = sd().nodes;
+    for (auto it = nodes.begin(); it != nodes.end(); ++it) {
+        if ((*it)->path == path && (*it)->isDirectory) {
+            nodes.erase(it);
+            sdChargeSectorWrites(1, true);
+            chargeClusterAllocation();
+            return true;
+        }
+    }
+    return false;
+}
+
+// ---------------------------------------------------------------------------
+// File
+// ---------------------------------------------------------------------------
+size_t File::write(uint8_t b) { return write(&b, 1); }
+
+size_t File::write(const uint8_t *buf, size_t size)
+{
+    if (!_handle || !_handle->open || !_handle->writable) {
+        return 0;
+    }
+    SdHandle &h = *_handle;
+    SdNode &node = *h.node;
+    useCache(&h);
+    const uint32_t clusterBytes = BLOCK_SIZE * sdTiming().blocksPerCluster;
+    size_t done = 0;
+    while (done < size) {
+        uint32_t block = h.position / BLOCK_SIZE;
+        uint32_t offset = h.position % BLOCK_SIZE;
+        if ((int32_t)block != h.cacheBlock) {
+            writeBack(h);
+            if (h.position % clusterBytes == 0 && h.position >= node.data.size()) {
+                chargeClusterAllocation();
+            }
+            if (offset != 0 || h.position < node.data.size()) {
+                sdChargeSectorReads(1); // partial block: read it back into the cache
+            }
+            h.cacheBlock = (int32_t)block;
+        }
+        size_t n = std::min<size_t>(size - done, BLOCK_SIZE - offset);
+        if (h.position + n > node.data.size()) {
+            node.data.resize(h.position + n);
+        }
+        memcpy(&node.data[h.position], buf + done, n);
+        advanceCycles(n * 4); // copy into the block cache
+        h.position += (uint32_t)n;
+        h.cacheDirty = true;
+        sd().cacheDirty = true;
+        done += n;
+    }
+    return done;
+}
+
+int File::read()
+{
+    uint8_t b;
+    return read(&b, 1) == 1 ? b : -1;
+}
+
+int File::read(void *buf, uint16_t nbyte)
+{
+    if (!_handle || !_handle->open || !_handle->node || _handle->isDirectory) {
+        return -1;
+    }
+    SdHandle &h = *_handle;
+    useCache(&h);
+    uint32_t size = (uint32_t)h.node->data.size();
+    uint16_t n = (uint16_t)std::min<uint32_t>(nbyte, size > h.position ? size - h.position : 0);
+    for (uint32_t pos = h.position; pos < h.position + n; pos++) {
+        if ((int32_t)(pos / BLOCK_SIZE) != h.cacheBlock) {
+            writeBack(h);
+            sdChargeSectorReads(1);
+            h.cacheBlock = (int32_t)(pos / BLOCK_SIZE);
+        }
+    }
+    memcpy(buf, h.node->data.data() + h.position, n);
+    advanceCycles(n * 4);
+    h.position += n;
+    return n;
+}
+
+int File::peek()
+{
+    if (!_handle || !_handle->node || _handle->position >= _handle->node->data.size()) {
+        return -1;
+    }
+    return _handle->node->data[_handle->position];
+}
+
+int File::available()
+{
+    if (!_handle || !_handle->node || _handle->isDirectory) {
+        return 0;
+    }
+    return (int)(_handle->node->data.size() - _handle->position);
+}
+
+void File::flush()
+{
+    if (!_handle || !_handle->open || !_handle->writable) {
+        return;
+    }
+    SdHandle &h = *_handle;
+    SdNode &node = *h.node;
+    useCache(&h);
+    sdStats().flushes++;
+    writeBack(h);
+    if (node.committedSize != node.data.size()) {
+        // Directory entry update evicts the data block from the shared cache
+        sdChargeSectorReads(1);
+        sdChargeSectorWrites(1, true);
+        h.cacheBlock = -1;
+        node.committedSize = (uint32_t)node.data.size();
+    }
+    if (node.durability.empty() || node.durability.back().size != node.committedSize) {
+        node.durability.push_back(DurabilityMark{cycles(), node.committedSize});
+    }
+}
+
+bool File::seek(uint32_t pos)
+{
+    if (!_handle || !_handle->node || pos > _handle->node->data.size()) {
+        return false;
+    }
+    _handle->position = pos;
+    return true;
+}
+
+uint32_t File::position() { return _handle ? _handle->position : 0; }
+
+uint32_t File::size() { return _handle && _handle->node ? (uint32_t)_handle->node->data.size() : 0; }
+
+void File::close()
+{
+    if (!_handle || !_handle->open) {
+        return;
+    }
+    flush();
+    if (_handle->node && _handle->writable) {
+        _handle->node->closedCycle = cycles();
+    }
+    _handle->open = false;
+}
+
+File::operator bool() const { return _handle && _handle->open; }
+
+char *File::name() { return _handle ? _handle->name : nullptr; }
+
+bool File::isDirectory() { return _handle && _handle->isDirectory; }
+
+File File::openNextFile(uint8_t mode)
+{
+    if (!_handle || !_handle->isDirectory) {
+        return File();
+    }
+    auto &nodes = sd().nodes;
+    while (_handle->dirIndex < nodes.size()) {
+        SdNode *node = nodes[_handle->dirIndex++].get();
+        if (parentOf(node->path) == _handle->dirPath) {
+            useCache();
+            if (_handle->dirIndex % DIR_ENTRIES_PER_BLOCK == 1) {
+                sdChargeSectorReads(1);
+            }
+            auto handle = std::make_shared<SdHandle>();
+            handle->node = node;
+            handle->isDirectory = node->isDirectory;
+            handle->dirPath = node->path;
+            setShortName(*handle, node->path);
+            return File(handle);
+        }
+    }
+    return File();
+}
+
+void File::rewindDirectory()
+{
+    if (_handle) {
+        _handle->dirIndex = 0;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// utility/SdFat.h
+// ---------------------------------------------------------------------------
+uint8_t Sd2Card::init(uint8_t sckRateID, uint8_t chipSelectPin)
+{
+    pinMode(chipSelectPin, OUTPUT);
+    chargeBusy(microsToCycles(sd().timing.commandUs * 10)); // CMD0/CMD8/ACMD41 handshake
+    _streaming = false;
+    _errorCode = sd().inserted ? 0 : 1;
+    return sd().inserted;
+}
+
+uint8_t Sd2Card::readBlock(uint32_t block, uint8_t *dst)
+{
+    if (!sd().inserted || _streaming) {
+        _errorCode = 1;
+        return false;
+    }
+    sdChargeSectorReads(1);
+    uint32_t offset;
+    SdNode *node = extentOf(block, offset);
+    memset(dst, 0, BLOCK_SIZE);
+    if (node && offset < node->data.size()) {
+        memcpy(dst, &node->data[offset], std::min<size_t>(BLOCK_SIZE, node->data.size() - offset));
+    }
+    return true;
+}
+
+uint8_t Sd2Card::writeBlock(uint32_t blockNumber, const uint8_t *src)
+{
+    if (!sd().inserted || _streaming) {
+        _errorCode = 1;
+        return false;
+    }
+    sdChargeSectorWrites(1, false);
+    storeBlock(blockNumber, src);
+    return true;
+}
+
+uint8_t Sd2Card::writeStart(uint32_t blockNumber, uint32_t eraseCount)
+{
+    if (!sd().inserted || _streaming) {
+        _errorCode = 1;
+        return false;
+    }
+    chargeBusy(microsToCycles(2 * sd().timing.commandUs)); // ACMD23, CMD25
+    sd().stats.streams++;
+    _streaming = true;
+    _nextBlock = blockNumber;
+    return true;
+}
+
+uint8_t Sd2Card::writeData(const uint8_t *src)
+{
+    if (!sd().inserted || !_streaming) {
+        _errorCode = 1;
+        return false;
+    }
+    sd().stats.streamedBlocks++;
+    const uint64_t programUs = sectorWriteExtraUs(false);
+    chargeBusy(microsToCycles(sd().timing.streamBlockUs));
+    if (programUs) {
+        sd().stats.busyCycles += microsToCycles(programUs);
+        sd().programmedAt = cycles() + microsToCycles(programUs);
+    }
+    storeBlock(_nextBlock++, src);
+    return true;
+}
+
+uint8_t Sd2Card::writeStop()
+{
+    if (!_streaming) {
+        return false;
+    }
+    _streaming = false;
+    chargeBusy(microsToCycles(sd().timing.commandUs + sd().timing.streamStopUs));
+    return sd().inserted;
+}
+
+uint8_t Sd2Card::isBusy()
+{
+    advanceCycles(microsToCycles(3)); // chip select, one byte at 4MHz SCK
+    return sd().inserted && sdProgramming();
+}
+
+Sd2Card *SdVolume::sdCard_ = nullptr;
+
+uint8_t SdVolume::init(Sd2Card *dev)
+{
+    if (!sd().inserted) {
+        return false;
+    }
+    sdCard_ = dev;
+    useCache();
+    sdChargeSectorReads(2); // MBR + volume boot record
+    return true;
+}
+
+uint8_t SdVolume::blocksPerCluster() const { return (uint8_t)sd().timing.blocksPerCluster; }
+
+uint8_t *SdVolume::cacheClear()
+{
+    SdState &s = sd();
+    if (s.cacheDirty) {
+        sdChargeSectorWrites(1, false);
+        s.cacheDirty = false;
+    }
+    s.cacheEpoch++;
+    return s.cache;
+}
+
+uint8_t SdFile::openRoot(SdVolume *vol)
+{
+    _handle = SD.open("/")._handle;
+    return _handle != nullptr;
+}
+
+uint8_t SdFile::open(SdFile *dirFile, const char *fileName, uint8_t oflag)
+{
+    if (!dirFile || !dirFile->isDir()) {
+        return false;
+    }
+    const std::string dir = dirFile->_handle->node ? dirFile->_handle->node->path : std::string();
+    const std::string path = dir.empty() ? normalize(fileName) : dir + "/" + normalize(fileName);
+    if ((oflag & O_EXCL) && (oflag & O_CREAT) && findNode(path)) {
+        return false;
+    }
+    if (!(oflag & O_CREAT) && !findNode(path)) {
+        return false;
+    }
+    File file = SD.open(path.c_str(), oflag);
+    _handle = file._handle;
+    return _handle != nullptr;
+}
+
+uint8_t SdFile::createContiguous(SdFile *dirFile, const char *fileName, uint32_t size)
+{
+    if (size == 0 || !open(dirFile, fileName, O_CREAT | O_EXCL | O_RDWR)) {
+        return false;
+    }
+    // Free-run search through the FAT, then the chain written to both copies and the entry sized
+    const uint32_t bpc = sd().timing.blocksPerCluster;
+    const uint32_t clusters = (size + BLOCK_SIZE * bpc - 1) / (BLOCK_SIZE * bpc);
+    const uint32_t fatBlocks = 1 + clusters / 128;
+    sdChargeSectorReads(fatBlocks);
+    sdChargeSectorWrites(2 * fatBlocks, true);
+    sdChargeSectorReads(1);
+    sdChargeSectorWrites(1, true);
+
+    SdNode &node = *_handle->node;
+    node.data.assign(size, 0);
+    node.committedSize = size;
+    node.firstBlock = sd().nextBlock;
+    node.extentBlocks = clusters * bpc;
+    sd().nextBlock += node.extentBlocks;
+    return true;
+}
+
+uint8_t SdFile::contiguousRange(uint32_t *bgnBlock, uint32_t *endBlock)
+{
+    if (!_handle || !_handle->node || !_handle->node->extentBlocks) {
+        return false;
+    }
+    *bgnBlock = _handle->node->firstBlock;
+    *endBlock = _handle->node->firstBlock + _handle->node->extentBlocks - 1;
+    return true;
+}
+
+uint8_t SdFile::truncate(uint32_t size)
+{
+    if (!_handle || !_handle->open || !_handle->writable || size > _handle->node->data.size()) {
+        return false;
+    }
+    SdNode &node = *_handle->node;
+    useCache(_handle.get());
+    const uint32_t clusterBytes = BLOCK_SIZE * sd().timing.blocksPerCluster;
+    if ((size + clusterBytes - 1) / clusterBytes < (node.data.size() + clusterBytes - 1) / clusterBytes) {
+        chargeClusterAllocation(); // free the rest of the chain
+    }
+    node.data.resize(size);
+    if (_handle->position > size) {
+        _handle->position = size;
+    }
+    _handle->cacheBlock = -1;
+    return sync();
+}
+
+uint8_t SdFile::seekSet(uint32_t pos) { return _handle && File(_handle).seek(pos); }
+
+int16_t SdFile::write(const void *buf, uint16_t nbyte)
+{
+    if (!_handle) {
+        return -1;
+    }
+    return (int16_t)File(_handle).write((const uint8_t *)buf, nbyte);
+}
+
+uint8_t SdFile::sync()
+{
+    if (!_handle || !_handle->open) {
+        return false;
+    }
+    File(_handle).flush();
+    return true;
+}
+
+uint8_t SdFile::close()
+{
+    if (!_handle) {
+        return true;
+    }
+    File(_handle).close();
+    _handle.reset();
+    return true;
+}
+
+uint8_t SdFile::remove()
+{
+    if (!_handle || !_handle->node) {
+        return false;
+    }
+    const std::string path = _handle->node->path;
+    _handle.reset();
+    return SD.remove(path.c_str());
+}
+
+uint8_t SdFile::isOpen() const { return _handle && _handle->open; }
+
+uint8_t SdFile::isDir() const { return _handle && _handle->open && _handle->isDirectory; }
+
+uint32_t SdFile::fileSize() const { return _handle && _handle->node ? (uint32_t)_handle->node->data.size() : 0; }
+
+uint32_t SdFile::curPosition() const { return _handle ? _handle->position : 0; }
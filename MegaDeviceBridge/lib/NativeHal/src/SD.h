@@ -0,0 +1,137 @@
+#pragma once
+
+// In-memory model of the Arduino SD library (FAT16/32 on an SPI card).
+//
+// Files live in host memory; the cost of each operation is charged to the
+// virtual clock using the sector traffic the real library generates: one
+// shared 512-byte block cache, directory entry rewrite on flush/close, FAT
+// updates on cluster allocation (mirrored to both FAT copies) and a full
+// cluster clear on mkdir. Interrupts stay enabled while the "card" is busy, so
+// the LPT ISR keeps running exactly as it does on hardware.
+
+#include <Arduino.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define FILE_READ 0x01
+#define FILE_WRITE 0x17   // O_READ | O_WRITE | O_CREAT | O_APPEND
+
+namespace NativeHal {
+
+struct SdTiming {
+    uint32_t sectorWriteUs = 1800;   // 512-byte transfer at 4MHz SCK + typical program time
+    uint32_t sectorReadUs = 1300;
+    uint32_t commandUs = 60;
+    uint32_t streamBlockUs = 1100;   // one block inside CMD25: the transfer, the card programs in the background
+    uint32_t streamStopUs = 700;     // stop token: busy until the card has programmed what it buffered
+    uint16_t blocksPerCluster = 64;  // 32KB clusters
+    uint32_t spikeEvery = 0;         // every Nth sector write takes spikeUs longer (0 = never)
+    uint32_t spikeUs = 0;
+    const uint32_t *latencyTrace = nullptr;  // optional extra latency per sector write, cycled
+    // Inside a multi-block write the extra latency is programming: writeData() returns after the
+    // transfer, the card stays busy and the next command waits for it (Sd2Card::isBusy() shows it)
+    size_t latencyTraceLength = 0;
+};
+
+struct SdStats {
+    uint32_t sectorWrites;
+    uint32_t sectorReads;
+    uint32_t dataSectorWrites;
+    uint32_t metadataSectorWrites;
+    uint32_t flushes;
+    uint64_t busyCycles;
+    uint32_t opens;
+    uint32_t mkdirs;
+    uint32_t streams;                // CMD25 multi-block writes started
+    uint32_t streamedBlocks;         // data blocks written inside them (also in dataSectorWrites)
+};
+
+/** Bytes of a file known to be on the card at a point in virtual time */
+struct DurabilityMark {
+    uint64_t cycle;
+    uint32_t size;
+};
+
+struct SdNode {
+    std::string path;          // upper-case, no leading slash
+    bool isDirectory = false;
+    std::vector<uint8_t> data;
+    uint32_t committedSize = 0;              // size recorded in the directory entry
+    std::vector<DurabilityMark> durability;  // data-on-card history for latency measurements
+    uint64_t createdCycle = 0;
+    uint64_t closedCycle = 0;
+    uint32_t firstBlock = 0;                 // SdFile::createContiguous() extent, card block numbers
+    uint32_t extentBlocks = 0;
+};
+
+SdTiming &sdTiming();
+SdStats &sdStats();
+/** True while a sector transfer is being charged (card busy on the SPI bus) */
+bool sdBusy();
+/** True while the card programs a streamed block in the background */
+bool sdProgramming();
+void sdReset();
+void sdSetInserted(bool inserted);
+/** Power cut: files keep the size in their directory entry, whatever was not on the card yet is gone */
+void sdPowerLoss();
+/** Regular files in creation order */
+std::vector<const SdNode *> sdFiles();
+const SdNode *sdFind(const char *path);
+void sdChargeSectorWrites(uint32_t count, bool metadata);
+void sdChargeSectorReads(uint32_t count);
+
+struct SdHandle;
+
+} // namespace NativeHal
+
+class File : public Stream {
+    friend class SdFile;
+
+public:
+    File() = default;
+    explicit File(std::shared_ptr<NativeHal::SdHandle> handle) : _handle(handle) {}
+
+    size_t write(uint8_t b) override;
+    size_t write(const uint8_t *buf, size_t size) override;
+    using Print::write;
+    int read() override;
+    int read(void *buf, uint16_t nbyte);
+    int peek() override;
+    int available() override;
+    void flush() override;
+    bool seek(uint32_t pos);
+    uint32_t position();
+    uint32_t size();
+    void close();
+    explicit operator bool() const;
+    bool operator!=(int) const { return (bool)*this; }
+    bool operator==(int) const { return !(bool)*this; }
+    char *name();
+    bool isDirectory();
+    File openNextFile(uint8_t mode = FILE_READ);
+    void rewindDirectory();
+
+private:
+    std::shared_ptr<NativeHal::SdHandle> _handle;
+};
+
+class SDClass {
+public:
+    bool begin(uint8_t csPin = 10);
+    bool begin(uint32_t clock, uint8_t csPin) { return begin(csPin); }
+    void end() {}
+    File open(const char *filename, uint8_t mode = FILE_READ);
+    File open(const String &filename, uint8_t mode = FILE_READ) { return open(filename.c_str(), mode); }
+    bool exists(const char *filepath);
+    bool exists(const String &filepath) { return exists(filepath.c_str()); }
+    bool mkdir(const char *filepath);
+    bool mkdir(const String &filepath) { return mkdir(filepath.c_str()); }
+    bool remove(const char *filepath);
+    bool remove(const String &filepath) { return remove(filepath.c_str()); }
+    bool rmdir(const char *filepath);
+};
+
+extern SDClass SD;
+
+#include "utility/SdFat.h"
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Arduino.h>
+
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+
+#define SPI_CLOCK_DIV2 0x04
+#define SPI_CLOCK_DIV4 0x00
+#define SPI_CLOCK_DIV8 0x05
+#define SPI_CLOCK_DIV16 0x01
+
+class SPISettings {
+public:
+    SPISettings() : clock(4000000UL), bitOrder(MSBFIRST), dataMode(SPI_MODE0) {}
+    SPISettings(uint32_t clockHz, uint8_t order, uint8_t mode) : clock(clockHz), bitOrder(order), dataMode(mode) {}
+
+    uint32_t clock;
+    uint8_t bitOrder;
+    uint8_t dataMode;
+};
+
+/**
+ * @brief SPI master model. Bytes take 8 SCK periods at the last transaction's clock and go to the
+ * NativeHal::SpiDevice whose chip select is low (SpiFlash.h); with none selected reads return 0x00.
+ */
+class SPIClass {
+public:
+    void begin();
+    void end();
+    void beginTransaction(const SPISettings &settings);
+    void endTransaction();
+    uint8_t transfer(uint8_t data);
+    void transfer(void *buf, size_t count);
+    void setClockDivider(uint8_t) {}
+    void setDataMode(uint8_t) {}
+    void setBitOrder(uint8_t) {}
+
+    uint32_t clockHz() const { return _settings.clock; }
+    uint32_t transactionCount() const { return _transactions; }
+
+private:
+    SPISettings _settings;
+    uint32_t _transactions = 0;
+};
+
+extern SPIClass SPI;
+
+namespace NativeHal {
+/** Back to the power-on settings (SPI registers clear on reset) */
+void spiReset();
+}
@@ -0,0 +1,147 @@
+#include "SpiFlash.h"
+#include <algorithm>
+
+namespace NativeHal {
+
+namespace {
+constexpr uint8_t WRITE_ENABLE = 0x06;
+constexpr uint8_t WRITE_DISABLE = 0x04;
+constexpr uint8_t READ_STATUS1 = 0x05;
+constexpr uint8_t JEDEC = 0x9F;
+constexpr uint8_t READ_DATA = 0x03;
+constexpr uint8_t PAGE_PROGRAM = 0x02;
+constexpr uint8_t SECTOR_ERASE = 0x20;
+constexpr uint8_t BLOCK_ERASE_32K = 0x52;
+constexpr uint8_t BLOCK_ERASE_64K = 0xD8;
+constexpr uint8_t CHIP_ERASE = 0xC7;
+constexpr uint8_t STATUS_BUSY = 0x01;
+constexpr uint8_t STATUS_WEL = 0x02;
+constexpr uint32_t PAGE_SIZE = 256;
+} // namespace
+
+SpiFlash::SpiFlash(uint8_t chipSelectPin) : SpiDevice(chipSelectPin), _memory(SIZE, 0xFF) {}
+
+bool SpiFlash::busy() const { return cycles() < _busyUntil; }
+
+uint8_t SpiFlash::transfer(uint8_t data, uint32_t clockHz)
+{
+    _stats.bytes++;
+    if (clockHz > _stats.maxClockHz) {
+        _stats.maxClockHz = clockHz;
+    }
+    const uint32_t position = _position++;
+    if (position == 0) {
+        _command = data;
+        _address = 0;
+        _ignored = busy() && data != READ_STATUS1;
+        return 0xFF;
+    }
+    if (_ignored) {
+        return 0xFF;
+    }
+
+    switch (_command) {
+    case READ_STATUS1:
+        return (uint8_t)((busy() ? STATUS_BUSY : 0) | (_writeEnabled ? STATUS_WEL : 0));
+    case JEDEC:
+        return position <= 3 ? (uint8_t)(JEDEC_ID >> (8 * (3 - position))) : 0xFF;
+    case READ_DATA:
+    case PAGE_PROGRAM:
+        if (position <= 3) {
+            _address = (_address << 8) | data;
+            return 0xFF;
+        }
+        if (_command == READ_DATA) {
+            return _memory[(_address + position - 4) % SIZE];
+        }
+        if (_writeEnabled) {
+            // The column wraps within the page; programming only clears bits
+            const uint32_t page = _address & ~(PAGE_SIZE - 1);
+            _memory[page + ((_address + position - 4) % PAGE_SIZE)] &= data;
+        }
+        return 0xFF;
+    case SECTOR_ERASE:
+    case BLOCK_ERASE_32K:
+    case BLOCK_ERASE_64K:
+        if (position <= 3) {
+            _address = (_address << 8) | data;
+        }
+        return 0xFF;
+    default:
+        return 0xFF;
+    }
+}
+
+void SpiFlash::onOutputChange(uint8_t pin, bool level, uint64_t now)
+{
+    if (pin != chipSelectPin) {
+        return;
+    }
+    if (!level) {
+        _position = 0;
+        return;
+    }
+    if (_position > 0) {
+        endFrame();
+    }
+    _position = 0;
+}
+
+void SpiFlash::endFrame()
+{
+    _stats.frames++;
+    if (_ignored) {
+        _stats.ignoredWhileBusy++;
+        return;
+    }
+    // Program and erase start as the chip select rises, once the command is complete
+    uint32_t busyUs = 0;
+    uint32_t eraseSize = 0;
+    switch (_command) {
+    case WRITE_ENABLE:
+        _writeEnabled = true;
+        return;
+    case WRITE_DISABLE:
+        _writeEnabled = false;
+        return;
+    case PAGE_PROGRAM:
+        if (_writeEnabled && _position > 4) {
+            _stats.pagesProgrammed++;
+            busyUs = _timing.pageProgramUs;
+        }
+        break;
+    case SECTOR_ERASE:
+        eraseSize = 4096;
+        busyUs = _timing.sectorEraseUs;
+        break;
+    case BLOCK_ERASE_32K:
+        eraseSize = 32768;
+        busyUs = _timing.block32EraseUs;
+        break;
+    case BLOCK_ERASE_64K:
+        eraseSize = 65536;
+        busyUs = _timing.block64EraseUs;
+        break;
+    case CHIP_ERASE:
+        eraseSize = SIZE;
+        busyUs = _timing.chipEraseUs;
+        break;
+    default:
+        return;
+    }
+    if (!_writeEnabled) {
+        return;
+    }
+    if (eraseSize) {
+        if (_command != CHIP_ERASE && _position != 4) {
+            return;
+        }
+        const uint32_t start = _command == CHIP_ERASE ? 0 : (_address % SIZE) & ~(eraseSize - 1);
+        std::fill(_memory.begin() + start, _memory.begin() + start + eraseSize, 0xFF);
+        _stats.erases++;
+    }
+    _writeEnabled = false;
+    _busyUntil = cycles() + microsToCycles(busyUs);
+}
+
+} // namespace NativeHal
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "NativeHal.h"
+#include <vector>
+
+namespace NativeHal {
+
+/**
+ * @brief W25Q128 serial flash on the SPI bus
+ *
+ * 16MB, erased to 0xFF. Commands start on the first byte after the chip
+ * select falls and end when it rises: JEDEC ID, status register 1, write
+ * enable/disable, read data (0x03), page program (wraps inside the 256-byte
+ * page, clears bits only), 4KB/32KB/64KB and chip erase. Program and erase
+ * take the datasheet's typical time; the status register reads busy until
+ * then and any other command meanwhile is ignored and counted.
+ */
+class SpiFlash : public SpiDevice {
+public:
+    struct Timing {
+        uint32_t pageProgramUs = 700;
+        uint32_t sectorEraseUs = 45000;
+        uint32_t block32EraseUs = 120000;
+        uint32_t block64EraseUs = 150000;
+        uint32_t chipEraseUs = 40000000;
+    };
+
+    struct Stats {
+        uint32_t frames;               // chip select low to high
+        uint32_t bytes;
+        uint32_t maxClockHz;
+        uint32_t ignoredWhileBusy;     // commands other than a status read during program/erase
+        uint32_t pagesProgrammed;
+        uint32_t erases;
+    };
+
+    static constexpr uint32_t SIZE = 16UL * 1024 * 1024;
+    static constexpr uint32_t JEDEC_ID = 0xEF4018;
+
+    explicit SpiFlash(uint8_t chipSelectPin);
+
+    uint8_t transfer(uint8_t data, uint32_t clockHz) override;
+    void onOutputChange(uint8_t pin, bool level, uint64_t now) override;
+
+    Timing &timing() { return _timing; }
+    const Stats &stats() const { return _stats; }
+    const uint8_t *data() const { return _memory.data(); }
+    bool busy() const;
+
+private:
+    void endFrame();
+
+    std::vector<uint8_t> _memory;
+    Timing _timing;
+    Stats _stats = {};
+    uint8_t _command = 0;
+    uint32_t _position = 0;   // bytes of the frame so far
+    uint32_t _address = 0;
+    bool _writeEnabled = false;
+    bool _ignored = false;    // frame started while busy
+    uint64_t _busyUntil = 0;
+};
+
+} // namespace NativeHal
@@ -0,0 +1,185 @@
+#include "TraceReplayer.h"
+#include <string.h>
+
+namespace NativeHal {
+
+namespace {
+
+// src/Parallel/CaptureTrace.h
+const uint8_t MAGIC[4] = {'D', 'B', 'T', 'R'};
+const uint8_t FORMAT_VERSION = 1;
+const size_t HEADER_SIZE = 8;
+
+uint64_t nsToCycles(uint64_t ns) { return (ns * CYCLES_PER_US + 999) / 1000; }
+
+} // namespace
+
+bool TraceReplayer::decode(const std::vector<uint8_t> &file, Trace &out)
+{
+    out = Trace();
+    if (file.size() < HEADER_SIZE || memcmp(file.data(), MAGIC, sizeof(MAGIC)) != 0 || file[4] != FORMAT_VERSION ||
+        file[5] == 0) {
+        return false;
+    }
+    out.ticksPerUs = file[5];
+
+    size_t at = HEADER_SIZE;
+    while (at < file.size()) {
+        uint32_t delta = 0;
+        uint8_t shift = 0;
+        uint8_t byte;
+        do {
+            if (at >= file.size() || shift > 21) {
+                return false;
+            }
+            byte = file[at++];
+            delta |= (uint32_t)(byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        if (at >= file.size()) {
+            return false;
+        }
+        out.deltaTicks.push_back(delta);
+        out.data.push_back(file[at++]);
+    }
+    return true;
+}
+
+TraceReplayer::TraceReplayer(const LptHostSimulator::Pins &pins, const Trace &trace, const Options &options)
+    : _pins(pins), _trace(trace), _options(options), _stats(), _state(State::Idle), _next(UINT64_MAX), _byteStart(0),
+      _acked(false), _index(0), _due(trace.data.size(), 0), _strobes(trace.data.size(), 0)
+{
+    drivePin(_pins.strobe, true);
+    presentByte(0);
+}
+
+void TraceReplayer::start(uint64_t atCycle)
+{
+    // Due times up front: the recorded clock, not the replayed one, sets the pace
+    const uint64_t keepTicks = (uint64_t)_options.keepGapMs * 1000 * (_trace.ticksPerUs ? _trace.ticksPerUs : 1);
+    double offset = 0;
+    for (size_t i = 0; i < _trace.data.size(); i++) {
+        if (i > 0) {
+            const double cycles = (double)_trace.deltaTicks[i] * CYCLES_PER_US / _trace.ticksPerUs;
+            offset += _trace.deltaTicks[i] >= keepTicks ? cycles : cycles / _options.speed;
+        }
+        _due[i] = atCycle + (uint64_t)offset;
+    }
+
+    _index = 0;
+    if (_trace.data.empty()) {
+        _state = State::Done;
+        _next = UINT64_MAX;
+        return;
+    }
+    _state = State::Due;
+    _next = _due[0];
+}
+
+void TraceReplayer::presentByte(uint8_t value)
+{
+    for (uint8_t bit = 0; bit < 8; bit++) {
+        drivePin(_pins.data[bit], (value >> bit) & 0x01);
+    }
+}
+
+void TraceReplayer::nextByte(uint64_t now)
+{
+    _index++;
+    if (_index >= _trace.data.size()) {
+        _state = State::Done;
+        _next = UINT64_MAX;
+        return;
+    }
+    _state = State::Due;
+    _next = _due[_index] > now ? _due[_index] : now;
+}
+
+void TraceReplayer::onEvent(uint64_t now)
+{
+    switch (_state) {
+    case State::Due:
+        if (_options.handshake && readPin(_pins.busy)) {
+            _next = now + nsToCycles(_options.pollNs);
+            return;
+        }
+        if (!_options.handshake && readPin(_pins.busy)) {
+            _stats.strobesWhileBusy++;
+        }
+        _byteStart = now;
+        _acked = false;
+        presentByte(_trace.data[_index]);
+        _state = State::Setup;
+        _next = now + nsToCycles(_options.setupNs);
+        return;
+
+    case State::Setup: {
+        // Late against the due time plus the setup every byte needs
+        const uint64_t due = _due[_index] + nsToCycles(_options.setupNs);
+        if (now > due) {
+            _stats.lateBytes++;
+            _stats.lateCycles += now - due;
+            if (now - due > _stats.maxLateCycles) {
+                _stats.maxLateCycles = now - due;
+            }
+        }
+        _strobes[_index] = now;
+        if (_stats.bytesSent == 0) {
+            _stats.firstStrobeCycle = now;
+        }
+        _stats.lastStrobeCycle = now;
+        _stats.bytesSent++;
+        _state = State::StrobeLow;
+        _next = now + nsToCycles(_options.strobeNs);
+        drivePin(_pins.strobe, false);
+        return;
+    }
+
+    case State::StrobeLow:
+        _state = State::StrobeHigh;
+        _next = now + nsToCycles(_options.holdNs);
+        drivePin(_pins.strobe, true);
+        return;
+
+    case State::StrobeHigh:
+        if (_acked) {
+            nextByte(now);
+        } else if (!_options.handshake) {
+            // Open loop: an /ACK still missing when the next byte is due counts as a timeout
+            const bool last = _index + 1 >= _trace.data.size();
+            const uint64_t deadline = last ? _byteStart + microsToCycles(_options.ackTimeoutUs) : _due[_index + 1];
+            _state = State::WaitAck;
+            _next = deadline > now ? deadline : now;
+        } else {
+            _state = State::WaitAck;
+            _next = _byteStart + microsToCycles(_options.ackTimeoutUs);
+            if (_next < now) {
+                _next = now;
+            }
+        }
+        return;
+
+    case State::WaitAck:
+        _stats.ackTimeouts++;
+        nextByte(now);
+        return;
+
+    default:
+        _next = UINT64_MAX;
+        return;
+    }
+}
+
+void TraceReplayer::onOutputChange(uint8_t pin, bool level, uint64_t now)
+{
+    if (pin != _pins.ack || level) {
+        return;
+    }
+    if (_state == State::StrobeLow || _state == State::StrobeHigh) {
+        _acked = true;
+    } else if (_state == State::WaitAck) {
+        nextByte(now);
+    }
+}
+
+} // namespace NativeHal
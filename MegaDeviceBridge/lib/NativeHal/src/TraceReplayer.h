@@ -0,0 +1,92 @@
+#pragma once
+
+#include "NativeHal.h"
+#include "LptHostSimulator.h"
+#include <vector>
+
+namespace NativeHal {
+
+/**
+ * @brief Plays a capture trace (.trc, see src/Parallel/CaptureTrace.h) back into the bridge's LPT pins
+ *
+ * Every record becomes one byte on the data lines and a /STROBE pulse, so it
+ * goes through whichever capture path Port has attached, at the time the
+ * trace says it was strobed: record i is due `speed` times sooner than it was
+ * recorded, counted from the first record. Gaps of at least keepGapMs (the
+ * idle time between jobs) are kept at their recorded length so the firmware
+ * still splits files where it did.
+ *
+ * With handshake set the sender behaves like the one recorded: a byte that is
+ * due waits for BUSY low and for the previous /ACK (or ackTimeoutUs), and a
+ * late byte does not push back the ones after it. Without it, bytes go out on
+ * the recorded clock regardless, and the stats count the strobes sent into a
+ * high BUSY or never acknowledged.
+ */
+class TraceReplayer : public Peripheral {
+public:
+    struct Trace {
+        uint8_t ticksPerUs = 0;
+        std::vector<uint8_t> data;
+        std::vector<uint32_t> deltaTicks;  // since the previous record; [0] counts from trace start
+    };
+
+    struct Options {
+        double speed = 1.0;
+        bool handshake = true;
+        uint32_t keepGapMs = 500;
+        uint32_t setupNs = 1000;
+        uint32_t strobeNs = 1000;
+        uint32_t holdNs = 1000;
+        uint32_t pollNs = 1000;
+        uint32_t ackTimeoutUs = 100;
+    };
+
+    struct Stats {
+        uint32_t bytesSent;
+        uint32_t ackTimeouts;             // handshake: gave up waiting; otherwise: no /ACK before the next strobe
+        uint32_t strobesWhileBusy;        // without handshake
+        uint32_t lateBytes;               // strobed after they were due
+        uint64_t lateCycles;              // sum of the delays
+        uint64_t maxLateCycles;
+        uint64_t firstStrobeCycle;
+        uint64_t lastStrobeCycle;
+    };
+
+    /** Header and records of a .trc file; false if it is not one or a record is cut short */
+    static bool decode(const std::vector<uint8_t> &file, Trace &out);
+
+    TraceReplayer(const LptHostSimulator::Pins &pins, const Trace &trace, const Options &options);
+
+    void start(uint64_t atCycle);
+    bool finished() const { return _state == State::Done; }
+
+    const Stats &stats() const { return _stats; }
+    const Trace &trace() const { return _trace; }
+    /** Cycle record `index` was due at and the cycle it was strobed at */
+    uint64_t dueCycle(size_t index) const { return _due[index]; }
+    uint64_t strobeCycle(size_t index) const { return _strobes[index]; }
+
+    uint64_t nextEventCycle() const override { return _next; }
+    void onEvent(uint64_t now) override;
+    void onOutputChange(uint8_t pin, bool level, uint64_t now) override;
+
+private:
+    enum class State : uint8_t { Idle, Due, Setup, StrobeLow, StrobeHigh, WaitAck, Done };
+
+    void presentByte(uint8_t value);
+    void nextByte(uint64_t now);
+
+    LptHostSimulator::Pins _pins;
+    Trace _trace;
+    Options _options;
+    Stats _stats;
+    State _state;
+    uint64_t _next;
+    uint64_t _byteStart;
+    bool _acked;
+    size_t _index;
+    std::vector<uint64_t> _due;
+    std::vector<uint64_t> _strobes;
+};
+
+} // namespace NativeHal
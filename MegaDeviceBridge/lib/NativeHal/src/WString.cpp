@@ -0,0 +1,173 @@
+#include "WString.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+#include <algorithm>
+
+std::string String::format(unsigned long value, unsigned char base)
+{
+    if (base < 2) {
+        base = 10;
+    }
+    char buf[8 * sizeof(unsigned long) + 1];
+    char *p = buf + sizeof(buf) - 1;
+    *p = '\0';
+    do {
+        unsigned long digit = value % base;
+        *--p = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+        value /= base;
+    } while (value);
+    return std::string(p);
+}
+
+std::string String::formatSigned(long value, unsigned char base)
+{
+    if (base == 10 && value < 0) {
+        return "-" + format((unsigned long)(-(value + 1)) + 1, base);
+    }
+    return format((unsigned long)value, base);
+}
+
+std::string String::formatDouble(double value, unsigned char decimalPlaces)
+{
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, value);
+    return std::string(buf);
+}
+
+bool String::equalsIgnoreCase(const String &s) const
+{
+    return _s.size() == s._s.size() && strcasecmp(_s.c_str(), s._s.c_str()) == 0;
+}
+
+bool String::startsWith(const String &prefix, unsigned int offset) const
+{
+    if (offset > _s.size()) {
+        return false;
+    }
+    return _s.compare(offset, prefix._s.size(), prefix._s) == 0;
+}
+
+bool String::endsWith(const String &suffix) const
+{
+    if (suffix._s.size() > _s.size()) {
+        return false;
+    }
+    return _s.compare(_s.size() - suffix._s.size(), suffix._s.size(), suffix._s) == 0;
+}
+
+void String::getBytes(unsigned char *buf, unsigned int bufsize, unsigned int index) const
+{
+    if (!bufsize || !buf) {
+        return;
+    }
+    if (index >= _s.size()) {
+        buf[0] = 0;
+        return;
+    }
+    unsigned int n = std::min<unsigned int>(bufsize - 1, (unsigned int)_s.size() - index);
+    memcpy(buf, _s.data() + index, n);
+    buf[n] = 0;
+}
+
+int String::indexOf(char ch, unsigned int fromIndex) const
+{
+    size_t pos = _s.find(ch, fromIndex);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const String &s, unsigned int fromIndex) const
+{
+    size_t pos = _s.find(s._s, fromIndex);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(char ch) const
+{
+    size_t pos = _s.rfind(ch);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(const String &s) const
+{
+    size_t pos = _s.rfind(s._s);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+String String::substring(unsigned int beginIndex) const { return substring(beginIndex, (unsigned int)_s.size()); }
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const
+{
+    if (beginIndex > endIndex) {
+        std::swap(beginIndex, endIndex);
+    }
+    String out;
+    if (beginIndex >= _s.size()) {
+        return out;
+    }
+    endIndex = std::min<unsigned int>(endIndex, (unsigned int)_s.size());
+    out._s = _s.substr(beginIndex, endIndex - beginIndex);
+    return out;
+}
+
+void String::replace(char find, char replaceWith) { std::replace(_s.begin(), _s.end(), find, replaceWith); }
+
+void String::replace(const String &find, const String &replaceWith)
+{
+    if (find._s.empty()) {
+        return;
+    }
+    size_t pos = 0;
+    while ((pos = _s.find(find._s, pos)) != std::string::npos) {
+        _s.replace(pos, find._s.size(), replaceWith._s);
+        pos += replaceWith._s.size();
+    }
+}
+
+void String::remove(unsigned int index)
+{
+    if (index < _s.size()) {
+        _s.erase(index);
+    }
+}
+
+void String::remove(unsigned int index, unsigned int count)
+{
+    if (index < _s.size()) {
+        _s.erase(index, count);
+    }
+}
+
+void String::toLowerCase()
+{
+    for (char &c : _s) {
+        c = (char)tolower((unsigned char)c);
+    }
+}
+
+void String::toUpperCase()
+{
+    for (char &c : _s) {
+        c = (char)toupper((unsigned char)c);
+    }
+}
+
+void String::trim()
+{
+    size_t begin = 0;
+    while (begin < _s.size() && isspace((unsigned char)_s[begin])) {
+        begin++;
+    }
+    size_t end = _s.size();
+    while (end > begin && isspace((unsigned char)_s[end - 1])) {
+        end--;
+    }
+    _s = _s.substr(begin, end - begin);
+}
+
+long String::toInt() const { return atol(_s.c_str()); }
+
+float String::toFloat() const { return (float)atof(_s.c_str()); }
+
+double String::toDouble() const { return atof(_s.c_str()); }
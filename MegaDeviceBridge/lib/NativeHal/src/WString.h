@@ -0,0 +1,101 @@
+#pragma once
+
+// Arduino String on top of std::string for the native build.
+
+#include <stdint.h>
+#include <string>
+#include "avr/pgmspace.h"
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(PSTR(string_literal)))
+
+class String {
+public:
+    String(const char *cstr = "") : _s(cstr ? cstr : "") {}
+    String(const String &other) = default;
+    String(const __FlashStringHelper *str) : _s(reinterpret_cast<const char *>(str)) {}
+    explicit String(char c) : _s(1, c) {}
+    explicit String(unsigned char value, unsigned char base = 10) : _s(format((unsigned long)value, base)) {}
+    explicit String(int value, unsigned char base = 10) : _s(formatSigned(value, base)) {}
+    explicit String(unsigned int value, unsigned char base = 10) : _s(format(value, base)) {}
+    explicit String(long value, unsigned char base = 10) : _s(formatSigned(value, base)) {}
+    explicit String(unsigned long value, unsigned char base = 10) : _s(format(value, base)) {}
+    explicit String(float value, unsigned char decimalPlaces = 2) : _s(formatDouble(value, decimalPlaces)) {}
+    explicit String(double value, unsigned char decimalPlaces = 2) : _s(formatDouble(value, decimalPlaces)) {}
+
+    String &operator=(const String &other) = default;
+    String &operator=(const char *cstr) { _s = cstr ? cstr : ""; return *this; }
+
+    unsigned int length() const { return (unsigned int)_s.size(); }
+    const char *c_str() const { return _s.c_str(); }
+    bool reserve(unsigned int size) { _s.reserve(size); return true; }
+
+    bool concat(const String &s) { _s += s._s; return true; }
+    bool concat(const char *cstr) { _s += cstr ? cstr : ""; return true; }
+    bool concat(char c) { _s += c; return true; }
+    bool concat(int v) { _s += formatSigned(v, 10); return true; }
+    bool concat(unsigned int v) { _s += format(v, 10); return true; }
+    bool concat(long v) { _s += formatSigned(v, 10); return true; }
+    bool concat(unsigned long v) { _s += format(v, 10); return true; }
+
+    template <typename T> String &operator+=(const T &rhs) { concat(rhs); return *this; }
+
+    bool equals(const String &s) const { return _s == s._s; }
+    bool equalsIgnoreCase(const String &s) const;
+    bool startsWith(const String &prefix) const { return _s.compare(0, prefix._s.size(), prefix._s) == 0; }
+    bool startsWith(const String &prefix, unsigned int offset) const;
+    bool endsWith(const String &suffix) const;
+    int compareTo(const String &s) const { return _s.compare(s._s); }
+
+    char charAt(unsigned int index) const { return index < _s.size() ? _s[index] : 0; }
+    void setCharAt(unsigned int index, char c) { if (index < _s.size()) _s[index] = c; }
+    char operator[](unsigned int index) const { return charAt(index); }
+    char &operator[](unsigned int index) { return _s[index]; }
+    void getBytes(unsigned char *buf, unsigned int bufsize, unsigned int index = 0) const;
+    void toCharArray(char *buf, unsigned int bufsize, unsigned int index = 0) const
+    {
+        getBytes(reinterpret_cast<unsigned char *>(buf), bufsize, index);
+    }
+
+    int indexOf(char ch, unsigned int fromIndex = 0) const;
+    int indexOf(const String &s, unsigned int fromIndex = 0) const;
+    int lastIndexOf(char ch) const;
+    int lastIndexOf(const String &s) const;
+    String substring(unsigned int beginIndex) const;
+    String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+    void replace(char find, char replaceWith);
+    void replace(const String &find, const String &replaceWith);
+    void remove(unsigned int index);
+    void remove(unsigned int index, unsigned int count);
+    void toLowerCase();
+    void toUpperCase();
+    void trim();
+
+    long toInt() const;
+    float toFloat() const;
+    double toDouble() const;
+
+    friend bool operator==(const String &a, const String &b) { return a._s == b._s; }
+    friend bool operator==(const String &a, const char *b) { return a._s == (b ? b : ""); }
+    friend bool operator!=(const String &a, const String &b) { return a._s != b._s; }
+    friend bool operator!=(const String &a, const char *b) { return !(a == b); }
+    friend bool operator<(const String &a, const String &b) { return a._s < b._s; }
+
+    friend String operator+(const String &a, const String &b) { String r(a); r._s += b._s; return r; }
+    friend String operator+(const String &a, const char *b) { String r(a); r.concat(b); return r; }
+    friend String operator+(const char *a, const String &b) { String r(a); r._s += b._s; return r; }
+    friend String operator+(const String &a, char b) { String r(a); r._s += b; return r; }
+    friend String operator+(const String &a, int b) { String r(a); r.concat(b); return r; }
+    friend String operator+(const String &a, unsigned int b) { String r(a); r.concat(b); return r; }
+    friend String operator+(const String &a, long b) { String r(a); r.concat(b); return r; }
+    friend String operator+(const String &a, unsigned long b) { String r(a); r.concat(b); return r; }
+    friend String operator+(const String &a, const __FlashStringHelper *b) { return a + String(b); }
+
+private:
+    static std::string format(unsigned long value, unsigned char base);
+    static std::string formatSigned(long value, unsigned char base);
+    static std::string formatDouble(double value, unsigned char decimalPlaces);
+
+    std::string _s;
+};
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "io.h"
+
+#define cli() NativeHal::setInterruptsEnabled(false)
+#define sei() NativeHal::setInterruptsEnabled(true)
+
+// ISR(TIMERn_COMPA_vect) registers the body with the host vector table. The
+// vector name is pasted, not expanded, so io.h defines <name>_num instead.
+#define ISR(vector, ...)                                                                      \
+    static void vector##_handler();                                                           \
+    static NativeHal::VectorRegistration vector##_registration(vector##_num, vector##_handler); \
+    static void vector##_handler()
@@ -0,0 +1,264 @@
+#pragma once
+
+// Host model of the ATmega2560 special function registers used by the firmware.
+// Registers are objects rather than memory addresses: every access charges the
+// AVR instruction cost to the virtual clock and output changes are observed by
+// the simulated peripherals.
+
+#include <stdint.h>
+#include "../NativeHal.h"
+
+namespace NativeHal {
+
+struct PortState {
+    uint8_t out;       // PORTx latch
+    uint8_t ddr;       // DDRx
+    uint8_t external;  // level driven from outside
+    uint8_t driven;    // bits currently driven from outside
+};
+
+PortState &portState(uint8_t port);
+uint8_t portInputLevel(uint8_t port);
+bool isLowIoPort(uint8_t port);   // PORTA..PORTG sit in SBI/CBI-addressable I/O space
+
+class PortRegister {
+public:
+    enum class Role : uint8_t { Input, Direction, Output };
+
+    constexpr PortRegister(Role role, uint8_t port) : _role(role), _port(port) {}
+
+    operator uint8_t() const;
+    PortRegister &operator=(uint8_t value);
+    PortRegister &operator|=(uint8_t value);
+    PortRegister &operator&=(uint8_t value);
+    PortRegister &operator^=(uint8_t value);
+
+private:
+    uint8_t load() const;
+    void store(uint8_t value);
+    void chargeAccess() const;
+
+    Role _role;
+    uint8_t _port;
+};
+
+/**
+ * @brief Plain 8-bit register with optional write hook (timers, EIMSK, ...)
+ */
+class Register8 {
+public:
+    typedef void (*WriteHook)(Register8 &reg, uint8_t oldValue);
+
+    explicit Register8(bool extended = false, WriteHook hook = nullptr)
+        : _value(0), _extended(extended), _hook(hook) {}
+
+    operator uint8_t() const;
+    Register8 &operator=(uint8_t value);
+    Register8 &operator|=(uint8_t value) { return *this = (uint8_t)(peek() | value); }
+    Register8 &operator&=(uint8_t value) { return *this = (uint8_t)(peek() & value); }
+    Register8 &operator^=(uint8_t value) { return *this = (uint8_t)(peek() ^ value); }
+
+    uint8_t peek() const { return _value; }
+    void poke(uint8_t value) { _value = value; }
+
+private:
+    uint8_t _value;
+    bool _extended;
+    WriteHook _hook;
+};
+
+/** SREG: bit 7 mirrors the global interrupt enable */
+class StatusRegister {
+public:
+    operator uint8_t() const;
+    StatusRegister &operator=(uint8_t value);
+};
+
+/** EIFR: writing a one clears the corresponding flag */
+class InterruptFlagRegister {
+public:
+    operator uint8_t() const;
+    InterruptFlagRegister &operator=(uint8_t value);
+};
+
+/** EIMSK: enabling a line may dispatch an already pending flag */
+class InterruptMaskRegister {
+public:
+    operator uint8_t() const;
+    InterruptMaskRegister &operator=(uint8_t value);
+    InterruptMaskRegister &operator|=(uint8_t value) { return *this = (uint8_t)((uint8_t)*this | value); }
+    InterruptMaskRegister &operator&=(uint8_t value) { return *this = (uint8_t)((uint8_t)*this & value); }
+};
+
+/**
+ * @brief Registers of the 16-bit timers (1, 3, 4, 5) in normal mode
+ *
+ * TCNTn counts from the virtual clock at the TCCRnB prescaler (external clock
+ * selects stop it). A compare A match sets OCFnA in TIFRn and, with OCIEnA
+ * set in TIMSKn, runs ISR(TIMERn_COMPA_vect), which clears the flag. WGM,
+ * compare B/C, overflow and the OCnx pins are not modelled.
+ */
+class TimerRegister {
+public:
+    enum class Role : uint8_t { ControlA, ControlB, Counter, CompareA, Mask, Flags };
+
+    constexpr TimerRegister(Role role, uint8_t timer) : _role(role), _timer(timer) {}
+
+    operator uint16_t() const;
+    TimerRegister &operator=(uint16_t value);
+    TimerRegister &operator|=(uint16_t value) { return *this = (uint16_t)(peek() | value); }
+    TimerRegister &operator&=(uint16_t value) { return *this = (uint16_t)(peek() & value); }
+
+    uint16_t peek() const;
+
+private:
+    Role _role;
+    uint8_t _timer; // 0..3 = Timer1, Timer3, Timer4, Timer5
+};
+
+/** TCNT0: Timer0 free-running at clk/64 as the Arduino core sets it up for millis(); read-only */
+class Timer0Counter {
+public:
+    operator uint8_t() const;
+};
+
+extern PortRegister pinRegisters[PORT_COUNT];
+extern PortRegister ddrRegisters[PORT_COUNT];
+extern PortRegister portRegisters[PORT_COUNT];
+extern StatusRegister sreg;
+extern InterruptFlagRegister eifr;
+extern InterruptMaskRegister eimsk;
+extern Register8 eicra;
+extern Register8 eicrb;
+extern Register8 gpior0;
+extern Timer0Counter tcnt0;
+extern TimerRegister tccraRegisters[TIMER_COUNT];
+extern TimerRegister tccrbRegisters[TIMER_COUNT];
+extern TimerRegister tcntRegisters[TIMER_COUNT];
+extern TimerRegister ocraRegisters[TIMER_COUNT];
+extern TimerRegister timskRegisters[TIMER_COUNT];
+extern TimerRegister tifrRegisters[TIMER_COUNT];
+
+} // namespace NativeHal
+
+#define PINA  (NativeHal::pinRegisters[0])
+#define PINB  (NativeHal::pinRegisters[1])
+#define PINC  (NativeHal::pinRegisters[2])
+#define PIND  (NativeHal::pinRegisters[3])
+#define PINE  (NativeHal::pinRegisters[4])
+#define PINF  (NativeHal::pinRegisters[5])
+#define PING  (NativeHal::pinRegisters[6])
+#define PINH  (NativeHal::pinRegisters[7])
+#define PINJ  (NativeHal::pinRegisters[8])
+#define PINK  (NativeHal::pinRegisters[9])
+#define PINL  (NativeHal::pinRegisters[10])
+
+#define DDRA  (NativeHal::ddrRegisters[0])
+#define DDRB  (NativeHal::ddrRegisters[1])
+#define DDRC  (NativeHal::ddrRegisters[2])
+#define DDRD  (NativeHal::ddrRegisters[3])
+#define DDRE  (NativeHal::ddrRegisters[4])
+#define DDRF  (NativeHal::ddrRegisters[5])
+#define DDRG  (NativeHal::ddrRegisters[6])
+#define DDRH  (NativeHal::ddrRegisters[7])
+#define DDRJ  (NativeHal::ddrRegisters[8])
+#define DDRK  (NativeHal::ddrRegisters[9])
+#define DDRL  (NativeHal::ddrRegisters[10])
+
+#define PORTA (NativeHal::portRegisters[0])
+#define PORTB (NativeHal::portRegisters[1])
+#define PORTC (NativeHal::portRegisters[2])
+#define PORTD (NativeHal::portRegisters[3])
+#define PORTE (NativeHal::portRegisters[4])
+#define PORTF (NativeHal::portRegisters[5])
+#define PORTG (NativeHal::portRegisters[6])
+#define PORTH (NativeHal::portRegisters[7])
+#define PORTJ (NativeHal::portRegisters[8])
+#define PORTK (NativeHal::portRegisters[9])
+#define PORTL (NativeHal::portRegisters[10])
+
+#define SREG   (NativeHal::sreg)
+#define EIFR   (NativeHal::eifr)
+#define EIMSK  (NativeHal::eimsk)
+#define EICRA  (NativeHal::eicra)
+#define EICRB  (NativeHal::eicrb)
+#define GPIOR0 (NativeHal::gpior0)
+
+#define TCNT0  (NativeHal::tcnt0)
+#define TCCR1A (NativeHal::tccraRegisters[0])
+#define TCCR1B (NativeHal::tccrbRegisters[0])
+#define TCNT1  (NativeHal::tcntRegisters[0])
+#define OCR1A  (NativeHal::ocraRegisters[0])
+#define TIMSK1 (NativeHal::timskRegisters[0])
+#define TIFR1  (NativeHal::tifrRegisters[0])
+#define TCCR3A (NativeHal::tccraRegisters[1])
+#define TCCR3B (NativeHal::tccrbRegisters[1])
+#define TCNT3  (NativeHal::tcntRegisters[1])
+#define OCR3A  (NativeHal::ocraRegisters[1])
+#define TIMSK3 (NativeHal::timskRegisters[1])
+#define TIFR3  (NativeHal::tifrRegisters[1])
+#define TCCR4A (NativeHal::tccraRegisters[2])
+#define TCCR4B (NativeHal::tccrbRegisters[2])
+#define TCNT4  (NativeHal::tcntRegisters[2])
+#define OCR4A  (NativeHal::ocraRegisters[2])
+#define TIMSK4 (NativeHal::timskRegisters[2])
+#define TIFR4  (NativeHal::tifrRegisters[2])
+#define TCCR5A (NativeHal::tccraRegisters[3])
+#define TCCR5B (NativeHal::tccrbRegisters[3])
+#define TCNT5  (NativeHal::tcntRegisters[3])
+#define OCR5A  (NativeHal::ocraRegisters[3])
+#define TIMSK5 (NativeHal::timskRegisters[3])
+#define TIFR5  (NativeHal::tifrRegisters[3])
+
+// Same bit positions on every 16-bit timer
+#define CS10 0
+#define CS11 1
+#define CS12 2
+#define CS30 0
+#define CS31 1
+#define CS32 2
+#define CS40 0
+#define CS41 1
+#define CS42 2
+#define CS50 0
+#define CS51 1
+#define CS52 2
+#define OCIE1A 1
+#define OCIE3A 1
+#define OCIE4A 1
+#define OCIE5A 1
+#define OCF1A 1
+#define OCF3A 1
+#define OCF4A 1
+#define OCF5A 1
+
+// Vector numbers for ISR(); see avr/interrupt.h
+#define TIMER1_COMPA_vect_num 17
+#define TIMER3_COMPA_vect_num 32
+#define TIMER4_COMPA_vect_num 42
+#define TIMER5_COMPA_vect_num 47
+
+#define INT0 0
+#define INT1 1
+#define INT2 2
+#define INT3 3
+#define INT4 4
+#define INT5 5
+#define INT6 6
+#define INT7 7
+#define INTF0 0
+#define INTF1 1
+#define INTF2 2
+#define INTF3 3
+#define INTF4 4
+#define INTF5 5
+#define INTF6 6
+#define INTF7 7
+#define ISC30 6
+#define ISC31 7
+#define ISC20 4
+#define ISC21 5
+
+#ifndef _BV
+#define _BV(bit) (1 << (bit))
+#endif
@@ -0,0 +1,30 @@
+#pragma once
+
+// Flash and RAM share one address space on the host, so the program-memory
+// accessors collapse to ordinary loads.
+
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_ptr(addr) (*(void *const *)(addr))
+#define pgm_read_byte_near(addr) pgm_read_byte(addr)
+#define pgm_read_word_near(addr) pgm_read_word(addr)
+
+#define strcpy_P(dest, src) strcpy((dest), (src))
+#define strncpy_P(dest, src, n) strncpy((dest), (src), (n))
+#define strlen_P(src) strlen(src)
+#define strcmp_P(a, b) strcmp((a), (b))
+#define strncmp_P(a, b, n) strncmp((a), (b), (n))
+#define strcasecmp_P(a, b) strcasecmp((a), (b))
+#define memcpy_P(dest, src, n) memcpy((dest), (src), (n))
+#define memcmp_P(a, b, n) memcmp((a), (b), (n))
+#define sprintf_P sprintf
+#define snprintf_P snprintf
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <stdint.h>
+#include "../NativeHal.h"
+
+// avr-libc's 3-cycle busy loop; a count of 0 runs 256 times
+inline void _delay_loop_1(uint8_t count)
+{
+    NativeHal::chargeDelay(3ULL * (count ? count : 256));
+}
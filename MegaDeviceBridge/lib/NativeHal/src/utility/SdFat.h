@@ -0,0 +1,90 @@
+#pragma once
+
+// Block-level layer of the Arduino SD library (utility/SdFat.h), as far as
+// the firmware uses it next to SD/File: the card's single and multi-block
+// commands, the volume's shared 512-byte block cache and contiguous files.
+//
+// Blocks only exist inside contiguous extents (SdFile::createContiguous());
+// raw reads and writes elsewhere are charged but not stored. Every SD library
+// operation reuses the block cache, so whatever was left in the buffer from
+// SdVolume::cacheClear() is overwritten, as on the card.
+
+#include <Arduino.h>
+#include <memory>
+
+// Sd2Card::init() SCK rates
+#define SPI_FULL_SPEED 0
+#define SPI_HALF_SPEED 1
+#define SPI_QUARTER_SPEED 2
+
+// SdFile::open() flags
+#ifndef O_READ
+#define O_READ 0x01
+#define O_WRITE 0x02
+#define O_APPEND 0x04
+#define O_SYNC 0x08
+#define O_CREAT 0x10
+#define O_EXCL 0x20
+#define O_TRUNC 0x40
+#endif
+#ifndef O_RDWR
+#define O_RDWR (O_READ | O_WRITE)
+#endif
+
+namespace NativeHal {
+struct SdHandle;
+}
+
+class Sd2Card {
+public:
+    uint8_t init(uint8_t sckRateID = SPI_FULL_SPEED, uint8_t chipSelectPin = 10);
+    uint8_t readBlock(uint32_t block, uint8_t *dst);
+    uint8_t writeBlock(uint32_t blockNumber, const uint8_t *src);
+    /** CMD25 from blockNumber, after ACMD23 pre-erases eraseCount blocks */
+    uint8_t writeStart(uint32_t blockNumber, uint32_t eraseCount);
+    uint8_t writeData(const uint8_t *src);
+    uint8_t writeStop();
+    /** One byte with the card selected: anything but 0xFF while it programs */
+    uint8_t isBusy();
+    uint8_t errorCode() const { return _errorCode; }
+
+private:
+    uint8_t _errorCode = 0;
+    bool _streaming = false;
+    uint32_t _nextBlock = 0;
+};
+
+class SdVolume {
+public:
+    uint8_t init(Sd2Card *dev);
+    uint8_t blocksPerCluster() const;
+    /** Writes back a dirty cache block and hands the 512-byte buffer out for raw transfers */
+    static uint8_t *cacheClear();
+    /** Card the block cache belongs to: the last one a volume was initialized on */
+    Sd2Card *sdCard() { return sdCard_; }
+
+private:
+    static Sd2Card *sdCard_;
+};
+
+class SdFile {
+public:
+    uint8_t openRoot(SdVolume *vol);
+    uint8_t open(SdFile *dirFile, const char *fileName, uint8_t oflag);
+    /** New file of `size` bytes on consecutive clusters; fails if the name exists or no run is free */
+    uint8_t createContiguous(SdFile *dirFile, const char *fileName, uint32_t size);
+    uint8_t contiguousRange(uint32_t *bgnBlock, uint32_t *endBlock);
+    uint8_t truncate(uint32_t size);
+    uint8_t seekSet(uint32_t pos);
+    int16_t write(const void *buf, uint16_t nbyte);
+    uint8_t sync();
+    uint8_t close();
+    uint8_t remove();
+    uint8_t isOpen() const;
+    uint8_t isDir() const;
+    uint32_t fileSize() const;
+    uint32_t curPosition() const;
+
+private:
+    std::shared_ptr<NativeHal::SdHandle> _handle;
+};
@@ -2,8 +2,19 @@
 
 #include <stdint.h>
 
+// Parallel ports captured at once (build with -D DEVICEBRIDGE_PARALLEL_PORTS=2 or 3)
+#ifndef DEVICEBRIDGE_PARALLEL_PORTS
+#define DEVICEBRIDGE_PARALLEL_PORTS 1
+#endif
+
 namespace DeviceBridge::Common {
 
+// Simultaneous capture: one Port, ring buffer and ParallelPortManager per printer port, sharing one storage backend
+namespace ParallelPorts {
+  constexpr uint8_t COUNT = DEVICEBRIDGE_PARALLEL_PORTS;
+  static_assert(COUNT >= 1 && COUNT <= 3, "Port has three /STROBE ISR slots (isr0..isr2)");
+}
+
 // Loop-based Architecture Configuration (formerly FreeRTOS)
 namespace RTOS {
   // Timing constants (in milliseconds) for cooperative multitasking
@@ -32,9 +43,31 @@ namespace Limits {
 namespace FileSystem {
   constexpr char DEFAULT_FILE_PREFIX[] = "capture";
   constexpr char DEFAULT_FILE_EXTENSION[] = ".bin";
+  constexpr char CAPTURE_RECORD_EXTENSION[] = ".cap";  // Per-file capture statistics next to the data file
   constexpr uint32_t SD_TIMEOUT_MS = 1000;
   constexpr uint32_t EEPROM_TIMEOUT_MS = 500;
   constexpr uint8_t MAX_RETRIES = 3;
+  constexpr uint32_t EXTENT_BYTES = 256UL * 1024;     // Contiguous clusters reserved per SD capture (Storage::ContiguousFile); a TDS2024 BMP is ~76KB
+  constexpr uint16_t BLOCK_SIZE = 512;                // SD block, the unit of the multi-block writes
+}
+
+// SD commit policy (FileSystemManager): when captured data is made to survive a power loss
+namespace Commit {
+  constexpr uint16_t DEFAULT_KB = 16;                 // Commit every 16KB written; `commit kb 0` is every chunk
+  constexpr uint16_t DEFAULT_INTERVAL_MS = 1000;      // `commit ms` without a value
+  constexpr char JOURNAL_NAME[] = "COMMIT.JNL";       // SD root: one block naming the open files and their committed sizes
+}
+
+// SD capture catalog (Storage::CaptureCatalog): file counts and listings without a directory walk
+namespace Catalog {
+  constexpr char FILE_NAME[] = "CATALOG.DAT";         // SD root: one 32-byte record per capture file, appended on close
+  constexpr uint8_t REBUILD_BATCH = 8;                // Records per write while rebuilding (on the stack)
+}
+
+// Shared SPI bus (Storage::SpiBus): the SD card on Pins::SD_CS, the W25Q128 on Pins::EEPROM_CS
+namespace Spi {
+  constexpr uint32_t FLASH_CLOCK_HZ = 8000000UL;      // F_CPU/2, the fastest AVR SCK; the W25Q128 reads (0x03) up to 50MHz
+  constexpr uint32_t SD_CLOCK_HZ = 4000000UL;         // SPI_HALF_SPEED, applied by the SD library in its own transactions
 }
 
 // Display Configuration
@@ -102,6 +135,48 @@ namespace Pins {
   constexpr uint8_t LPT_D5 = 35;
   constexpr uint8_t LPT_D6 = 37;
   constexpr uint8_t LPT_D7 = 39;
+
+  // Line not connected on this port (second and third ports only)
+  constexpr uint8_t NOT_WIRED = 0xFF;
+
+  // Second parallel port (DEVICEBRIDGE_PARALLEL_PORTS >= 2): data on A8-A15 (PK0-PK7)
+  constexpr uint8_t LPT2_STROBE = 19;   // INT2
+  constexpr uint8_t LPT2_AUTO_FEED = 23;
+  constexpr uint8_t LPT2_INITIALIZE = 48;
+  constexpr uint8_t LPT2_SELECT_IN = 49;
+  constexpr uint8_t LPT2_ACK = 38;
+  constexpr uint8_t LPT2_BUSY = 40;
+  constexpr uint8_t LPT2_PAPER_OUT = 42;
+  constexpr uint8_t LPT2_SELECT = 44;
+  constexpr uint8_t LPT2_ERROR = 46;
+  constexpr uint8_t LPT2_D0 = 62;
+  constexpr uint8_t LPT2_D1 = 63;
+  constexpr uint8_t LPT2_D2 = 64;
+  constexpr uint8_t LPT2_D3 = 65;
+  constexpr uint8_t LPT2_D4 = 66;
+  constexpr uint8_t LPT2_D5 = 67;
+  constexpr uint8_t LPT2_D6 = 68;
+  constexpr uint8_t LPT2_D7 = 69;
+
+  // Third parallel port (DEVICEBRIDGE_PARALLEL_PORTS == 3): data on A1-A7 (PF1-PF7) and 12 (PB6);
+  // no pins left for /AUTO-FEED, /INIT or /SELECT-IN, so its files end by content or idle timeout only
+  constexpr uint8_t LPT3_STROBE = 2;    // INT4
+  constexpr uint8_t LPT3_AUTO_FEED = NOT_WIRED;
+  constexpr uint8_t LPT3_INITIALIZE = NOT_WIRED;
+  constexpr uint8_t LPT3_SELECT_IN = NOT_WIRED;
+  constexpr uint8_t LPT3_ACK = 14;
+  constexpr uint8_t LPT3_BUSY = 15;
+  constexpr uint8_t LPT3_PAPER_OUT = 16;
+  constexpr uint8_t LPT3_SELECT = 17;
+  constexpr uint8_t LPT3_ERROR = 11;
+  constexpr uint8_t LPT3_D0 = 55;
+  constexpr uint8_t LPT3_D1 = 56;
+  constexpr uint8_t LPT3_D2 = 57;
+  constexpr uint8_t LPT3_D3 = 58;
+  constexpr uint8_t LPT3_D4 = 59;
+  constexpr uint8_t LPT3_D5 = 60;
+  constexpr uint8_t LPT3_D6 = 61;
+  constexpr uint8_t LPT3_D7 = 12;
 }
 
 // Timing Configuration (Microseconds and Milliseconds)
@@ -123,6 +198,23 @@ namespace Timing {
   constexpr uint16_t FLOW_CONTROL_DELAY_US = 5;       // Flow control timing
   constexpr uint16_t MODERATE_FLOW_DELAY_US = 25;     // Moderate delay to slow down sender
   constexpr uint16_t CRITICAL_FLOW_DELAY_US = 50;     // Extended delay in critical state
+  constexpr uint16_t FAST_ACK_PULSE_US = 1;           // /ACK width in the optimized capture path
+  constexpr uint8_t WRITE_LED_FLASH_MS = 2;           // Shortest L2 flash per chunk, turned off from update()
+  
+  // Timer-generated /ACK (ackmode timer): Timer5 compare A ends the pulse
+  constexpr uint16_t ACK_TIMER_PULSE_US = 20;         // Default /ACK width, matches ACK_PULSE_US
+  constexpr uint16_t ACK_TIMER_MAX_PULSE_US = 1000;   // Longest width accepted at runtime
+  constexpr bool ACK_TIMER_RELEASES_BUSY = true;      // Drop BUSY with the /ACK rising edge
+  
+  // Burst capture (burst on): the optimized ISR polls for the next /STROBE before returning
+  constexpr uint8_t BURST_POLL_STEPS = 16;            // Poll window, ~8 cycles per step on AVR (8us)
+  constexpr uint8_t BURST_MAX_BYTES = 32;             // Bytes per interrupt before letting Timer0/serial in
+  constexpr uint8_t BURST_PROBE_INTERVAL = 16;        // Single-byte interrupts between re-probes once idle
+  
+  // Polled capture (capture polled): ParallelPortManager polls /STROBE with interrupts masked
+  constexpr uint16_t POLLED_ENTRY_BYTES = 32;         // Ring backlog at an update that counts as a sustained transfer
+  constexpr uint16_t POLLED_IDLE_TIMEOUT_US = 100;    // No strobe for this long ends the session
+  constexpr uint16_t POLLED_MAX_SESSION_US = 900;     // Masked drain + session < one Timer0 overflow (1024us), so millis() keeps time
   
   // Millisecond delays for recovery operations
   constexpr uint16_t EMERGENCY_RECOVERY_MS = 100;     // Emergency recovery delay
@@ -134,11 +226,12 @@ namespace Timing {
 // Buffer and Memory Configuration
 namespace Buffer {
   constexpr uint16_t RING_BUFFER_SIZE = 512;          // Main parallel port ring buffer
-  constexpr uint16_t DATA_CHUNK_SIZE = 512;           // Data chunk size (matches ring buffer for optimal transfer)
+  constexpr uint16_t DATA_CHUNK_SIZE = ParallelPorts::COUNT == 1 ? 512 : 256; // Data chunk size (matches ring buffer for optimal transfer; halved per port in multi-port builds to save SRAM)
   constexpr uint16_t EEPROM_BUFFER_SIZE = 32;         // EEPROM write buffer (32 * 4 bytes = 128 bytes) - OPTIMIZED
   constexpr uint32_t CRITICAL_TIMEOUT_MS = 20000;     // 20 seconds emergency timeout
   constexpr uint32_t CHUNK_SEND_TIMEOUT_MS = 50;      // Send partial chunks after 50ms of data collection
   constexpr uint16_t MIN_CHUNK_SIZE = 64;             // Minimum chunk size to send (unless timeout or EOF)
+  constexpr uint8_t CHUNK_QUEUE_DEPTH = 2;            // DataChunk slots: one fills from the ring while the card programs the other's block
   
   // Flow control thresholds (percentages as fractions) - OPTIMIZED FOR TDS2024
   constexpr uint8_t FLOW_CONTROL_50_PERCENT = 1;      // 1/2 = 50% moderate threshold (was 60%)
@@ -249,6 +342,55 @@ namespace FlowControl {
   constexpr uint16_t MODERATE_THRESHOLD = (RING_BUFFER_SIZE * MODERATE_THRESHOLD_PERCENT) / 100;        // 256 bytes  
   constexpr uint16_t CRITICAL_THRESHOLD = (RING_BUFFER_SIZE * CRITICAL_THRESHOLD_PERCENT) / 100;        // 358 bytes
   constexpr uint16_t RECOVERY_THRESHOLD = (RING_BUFFER_SIZE * RECOVERY_THRESHOLD_PERCENT) / 100;        // 205 bytes
+  
+  // Predictive thresholds (HardwareFlowControl::setPredictiveEnabled): BUSY as late as the
+  // measured overshoot (bytes the host still sends once BUSY is up) allows
+  constexpr uint16_t PREDICT_INTERVAL_MS = 8;           // Threshold update period (main loop)
+  constexpr uint8_t PREDICT_OVERSHOOT_DECAY_SHIFT = 4;  // Peak overshoot loses 1/16 per drain
+  constexpr uint8_t PREDICT_OVERSHOOT_MARGIN_SHIFT = 1; // Room kept above BUSY: twice the peak overshoot
+  constexpr uint16_t PREDICT_RESERVE_BYTES = 32;         // Least room kept above BUSY
+  constexpr uint16_t PREDICT_HYSTERESIS_BYTES = 32;      // BUSY level minus this releases
+  constexpr uint16_t PREDICT_MIN_BUSY_LEVEL = 48;        // Floor for a host that runs on well past BUSY
+}
+
+// Handshake calibration (calibrate <sender>): learned /ACK and BUSY timings per sending instrument
+namespace Calibration {
+  constexpr uint16_t PROFILE_EEPROM_ADDRESS = 0;      // Profile table in the ATmega2560's internal EEPROM
+  constexpr uint8_t PROFILE_SLOTS = 8;                // Senders remembered
+  constexpr uint8_t SENDER_NAME_LENGTH = 12;          // Including the terminator
+  constexpr uint8_t WINDOW_GAPS = 64;                 // Strobe gaps measured per candidate /ACK width
+  constexpr uint8_t GAP_SLACK_SHIFT = 3;              // A width is honored while the mean gap stays within 1/8
+  constexpr uint16_t STROBE_TIMEOUT_US = 50;          // Longest /STROBE low time measured
+}
+
+// ========== JOB BOUNDARY CONFIGURATION ==========
+namespace JobBoundary {
+  constexpr uint8_t SIGNAL_INIT = 0x01;               // /INIT asserted: the host is starting a new job
+  constexpr uint8_t SIGNAL_SELECT_IN = 0x02;          // /SELECT-IN released: the host has finished with the printer
+  constexpr uint8_t DEFAULT_SIGNALS = 0;              // Off: Timer3 sampling delays INT3 while a tick runs (jobsplit init turns it on)
+  constexpr uint8_t SAMPLE_PERIOD_US = 40;            // Timer3 sampling; IEEE 1284 /INIT pulses last >= 50us
+  constexpr uint8_t MAX_PENDING = 4;                  // Edges the ring can hold jobs for before older bytes are read
+}
+
+// Content-aware end of document (Parallel::DocumentEnd): close a capture as soon as its own format says it is whole
+namespace DocumentEnd {
+  constexpr bool DEFAULT_ENABLED = true;
+  constexpr uint8_t BMP_HEADER_BYTES = 14;            // BITMAPFILEHEADER; bfSize covers the whole file
+  constexpr uint8_t BMP_MIN_SIZE = 26;                // File header + the smallest (OS/2) info header
+  constexpr uint8_t PCX_HEADER_BYTES = 128;
+  constexpr uint8_t PCX_PALETTE_MARKER = 0x0C;        // Version 5, 8-bit, 1 plane: marker + 256 RGB entries follow the image
+  constexpr uint16_t PCX_PALETTE_BYTES = 768;
+  constexpr uint8_t TIFF_PENDING_READS = 4;           // IFDs and strip tables ahead of the stream
+  constexpr uint16_t TIFF_MAX_ENTRIES = 512;          // Larger IFD entry counts are taken as damage
+}
+
+// Capture traces (trace start, built with -D DEVICEBRIDGE_CAPTURE_TRACE): the first port's strobe timing and data for host replay
+namespace CaptureTrace {
+  constexpr char EXTENSION[] = ".trc";
+  constexpr uint8_t TICKS_PER_US = 2;                 // Timer4 at clk/8; deltas are stored in these ticks
+  constexpr uint16_t RING_SIZE = 2048;                // Encoded records between the ISR and the trace file (power of two);
+                                                      // a full port ring while a file opens is 512 records of 2-3 bytes
+  constexpr uint16_t WRITE_BLOCK = 128;               // FileSystemManager::update() writes once this much is waiting
 }
 
 } // namespace DeviceBridge::Common
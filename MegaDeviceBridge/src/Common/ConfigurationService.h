@@ -24,6 +24,8 @@ public:
     static constexpr uint16_t getAckPulseUs() { return Timing::ACK_PULSE_US; }
     static constexpr uint16_t getRecoveryDelayUs() { return Timing::RECOVERY_DELAY_US; }
     static constexpr uint16_t getHardwareDelayUs() { return Timing::HARDWARE_DELAY_US; }
+    static constexpr uint16_t getAckTimerPulseUs() { return Timing::ACK_TIMER_PULSE_US; }
+    static constexpr bool getAckTimerReleasesBusy() { return Timing::ACK_TIMER_RELEASES_BUSY; }
     static constexpr uint16_t getTds2024TimingUs() { return Timing::TDS2024_TIMING_US; }
     static constexpr uint16_t getFlowControlDelayUs() { return Timing::FLOW_CONTROL_DELAY_US; }
     static constexpr uint16_t getModerateFlowDelayUs() { return Timing::MODERATE_FLOW_DELAY_US; }
@@ -42,6 +44,7 @@ public:
     static constexpr uint32_t getCriticalTimeoutMs() { return Buffer::CRITICAL_TIMEOUT_MS; }
     static constexpr uint32_t getChunkSendTimeoutMs() { return Buffer::CHUNK_SEND_TIMEOUT_MS; }
     static constexpr uint16_t getMinChunkSize() { return Buffer::MIN_CHUNK_SIZE; }
+    static constexpr uint8_t getChunkQueueDepth() { return Buffer::CHUNK_QUEUE_DEPTH; }
     
     // Flow control threshold calculation - OPTIMIZED FOR TDS2024 with compile-time evaluation
     static constexpr uint16_t getPreWarningFlowThreshold(uint16_t bufferSize = Buffer::RING_BUFFER_SIZE) {
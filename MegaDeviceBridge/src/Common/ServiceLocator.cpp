@@ -16,7 +16,7 @@ namespace DeviceBridge {
 ServiceLocator* ServiceLocator::_instance = nullptr;
 
 ServiceLocator::ServiceLocator() 
-    : _parallelPortManager(nullptr)
+    : _parallelPortManagers()
     , _fileSystemManager(nullptr)
     , _displayManager(nullptr)
     , _timeManager(nullptr)
@@ -45,13 +45,13 @@ void ServiceLocator::destroy() {
 }
 
 // Component registration methods
-void ServiceLocator::registerParallelPortManager(Components::ParallelPortManager* manager) {
-    if (!manager) {
+void ServiceLocator::registerParallelPortManager(Components::ParallelPortManager* manager, uint8_t port) {
+    if (!manager || port >= Common::ParallelPorts::COUNT) {
         Serial.print(F("FATAL: Null ParallelPortManager registration detected\r\n"));
         triggerSOSError(F("NULL PPM"));
         return;
     }
-    _parallelPortManager = manager;
+    _parallelPortManagers[port] = manager;
 }
 
 void ServiceLocator::registerFileSystemManager(Components::FileSystemManager* manager) {
@@ -145,8 +145,10 @@ bool ServiceLocator::validateAllDependencies() const {
     printComponentStatus(F("Display"), _display);
     if (!_display) allValid = false;
     
-    printComponentStatus(F("ParallelPortManager"), _parallelPortManager);
-    if (!_parallelPortManager) allValid = false;
+    for (uint8_t port = 0; port < Common::ParallelPorts::COUNT; port++) {
+        printComponentStatus(F("ParallelPortManager"), _parallelPortManagers[port]);
+        if (!_parallelPortManagers[port]) allValid = false;
+    }
     
     printComponentStatus(F("FileSystemManager"), _fileSystemManager);
     if (!_fileSystemManager) allValid = false;
@@ -226,7 +228,7 @@ bool ServiceLocator::runSystemSelfTest() const {
 bool ServiceLocator::isComponentRegistered(const char* componentName) const {
     // Simple string-based component checking
     if (strcmp(componentName, "Display") == 0) return _display != nullptr;
-    if (strcmp(componentName, "ParallelPortManager") == 0) return _parallelPortManager != nullptr;
+    if (strcmp(componentName, "ParallelPortManager") == 0) return _parallelPortManagers[0] != nullptr;
     if (strcmp(componentName, "FileSystemManager") == 0) return _fileSystemManager != nullptr;
     if (strcmp(componentName, "DisplayManager") == 0) return _displayManager != nullptr;
     if (strcmp(componentName, "TimeManager") == 0) return _timeManager != nullptr;
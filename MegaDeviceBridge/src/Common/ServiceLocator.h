@@ -31,7 +31,7 @@ namespace User {
 class ServiceLocator {
 private:
     // Component instances
-    Components::ParallelPortManager* _parallelPortManager;
+    Components::ParallelPortManager* _parallelPortManagers[Common::ParallelPorts::COUNT]; // One per printer port
     Components::FileSystemManager* _fileSystemManager;
     Components::DisplayManager* _displayManager;
     Components::TimeManager* _timeManager;
@@ -53,7 +53,7 @@ public:
     static void destroy();
     
     // Component registration
-    void registerParallelPortManager(Components::ParallelPortManager* manager);
+    void registerParallelPortManager(Components::ParallelPortManager* manager, uint8_t port = 0);
     void registerFileSystemManager(Components::FileSystemManager* manager);
     void registerDisplayManager(Components::DisplayManager* manager);
     void registerTimeManager(Components::TimeManager* manager);
@@ -64,7 +64,7 @@ public:
     void registerDisplay(User::Display* display);
     
     // Component access - inlined for maximum performance
-    inline Components::ParallelPortManager* getParallelPortManager() const { return _parallelPortManager; }
+    inline Components::ParallelPortManager* getParallelPortManager(uint8_t port = 0) const { return _parallelPortManagers[port]; }
     inline Components::FileSystemManager* getFileSystemManager() const { return _fileSystemManager; }
     inline Components::DisplayManager* getDisplayManager() const { return _displayManager; }
     inline Components::TimeManager* getTimeManager() const { return _timeManager; }
@@ -84,7 +84,7 @@ public:
     inline uint8_t getRegisteredComponentCount() const {
         uint8_t count = 0;
         if (_display) count++;
-        if (_parallelPortManager) count++;
+        if (_parallelPortManagers[0]) count++;
         if (_fileSystemManager) count++;
         if (_displayManager) count++;
         if (_timeManager) count++;
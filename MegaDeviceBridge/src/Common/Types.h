@@ -150,6 +150,18 @@ struct __attribute__((packed)) DataChunk {
   uint8_t isEndOfFile;  // Use uint8_t instead of bool for consistent size
 };
 
+// Per-file capture accounting, handed to the file manager with the end-of-file chunk
+// Lossless when nothing was dropped or discarded and every captured byte was written
+struct CaptureStatistics {
+  uint32_t bytesCaptured;    // Acknowledged into the ring buffer
+  uint32_t bytesDelivered;   // Drained from the ring into chunks
+  uint32_t bytesDropped;     // Strobes not acknowledged (ring full)
+  uint32_t bytesDiscarded;   // Acknowledged, then cleared from the ring
+  uint32_t overflowEvents;   // Runs of dropped strobes
+  uint32_t flowStateUs[4];   // Ring occupancy residency: NORMAL, WARNING, CRITICAL, EMERGENCY
+  uint32_t durationMs;       // First drain to last drain (residency runs on to end of file)
+};
+
 // Display message types for user feedback
 struct DisplayMessage {
   enum Type { 
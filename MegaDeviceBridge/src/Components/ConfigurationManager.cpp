@@ -5,6 +5,9 @@
 #include "SystemManager.h"
 #include "TimeManager.h"
 #include "../Common/ConfigurationService.h"
+#include "../Parallel/OptimizedTiming.h"
+#include "../Parallel/CaptureTrace.h"
+#include "../Storage/SpiBus.h"
 #include <Arduino.h>
 #include <string.h>
 
@@ -114,8 +117,36 @@ void ConfigurationManager::processCommand(const String &command) {
         resetCriticalState();
     } else if (command.startsWith(F("flowcontrol "))) {
         handleFlowControlCommand(command);
+    } else if (command.equalsIgnoreCase(F("capture")) || command.startsWith(F("capture "))) {
+        handleCaptureCommand(command);
+    } else if (command.equalsIgnoreCase(F("burst")) || command.startsWith(F("burst "))) {
+        handleBurstCommand(command);
+    } else if (command.equalsIgnoreCase(F("ackmode")) || command.startsWith(F("ackmode "))) {
+        handleAckModeCommand(command);
+    } else if (command.equalsIgnoreCase(F("jobsplit")) || command.startsWith(F("jobsplit "))) {
+        handleJobSplitCommand(command);
+    } else if (command.equalsIgnoreCase(F("docend")) || command.startsWith(F("docend "))) {
+        handleDocumentEndCommand(command);
+    } else if (command.equalsIgnoreCase(F("trace")) || command.startsWith(F("trace "))) {
+        handleTraceCommand(command);
+    } else if (command.equalsIgnoreCase(F("commit")) || command.startsWith(F("commit "))) {
+        handleCommitCommand(command);
+    } else if (command.equalsIgnoreCase(F("catalog")) || command.startsWith(F("catalog "))) {
+        handleCatalogCommand(command);
+    } else if (command.equalsIgnoreCase(F("ports"))) {
+        printPortsStatus();
+    } else if (command.equalsIgnoreCase(F("calibrate")) || command.startsWith(F("calibrate "))) {
+        handleCalibrateCommand(command);
+    } else if (command.equalsIgnoreCase(F("profile")) || command.startsWith(F("profile "))) {
+        handleProfileCommand(command);
     } else if (command.equalsIgnoreCase(F("flowstats")) || command.equalsIgnoreCase(F("flowstatus"))) {
         printFlowControlStatistics();
+    } else if (command.equalsIgnoreCase(F("queuestats")) || command.equalsIgnoreCase(F("queuestats reset"))) {
+        printChunkQueueStatistics(command.endsWith(F("reset")));
+    } else if (command.equalsIgnoreCase(F("isrstats")) || command.equalsIgnoreCase(F("isrstats reset"))) {
+        printIsrStatistics(command.endsWith(F("reset")));
+    } else if (command.equalsIgnoreCase(F("spistats")) || command.equalsIgnoreCase(F("spistats reset"))) {
+        printSpiStatistics(command.endsWith(F("reset")));
     } else if (command.startsWith(F("lcdthrottle "))) {
         handleLCDThrottleCommand(command);
     } else if (command.startsWith(F("led "))) {
@@ -156,7 +187,22 @@ void ConfigurationManager::printHelpMenu() {
     Serial.print(F("  clearbuffer       - Clear LPT data buffer and reset state\r\n"));
     Serial.print(F("  resetcritical     - Reset critical flow control state\r\n"));
     Serial.print(F("  flowcontrol on/off - Enable/disable hardware flow control\r\n"));
+    Serial.print(F("  flowcontrol predictive/fixed - BUSY level from measured overshoot or Config.h\r\n"));
+    Serial.print(F("  ackmode delay/timer [us] - /ACK from ISR delays or Timer5 one-shot\r\n"));
+    Serial.print(F("  burst on/off      - Take back-to-back strobes in one interrupt\r\n"));
+    Serial.print(F("  capture isr/polled - Poll /STROBE with interrupts masked during transfers\r\n"));
+    Serial.print(F("  jobsplit init/selectin/both/off - Start a new file on /INIT or /SELECT-IN release\r\n"));
+    Serial.print(F("  docend on/off/status - Close BMP/PCX/TIFF/PCL files at their own end\r\n"));
+    Serial.print(F("  trace start/stop/status - Record the first port's strobe timing for host replay\r\n"));
+    Serial.print(F("  commit kb <n>/ms [t]/close/status - When SD capture data is made power-loss safe\r\n"));
+    Serial.print(F("  catalog status/rebuild [crc] - SD capture catalog behind list sd and file counts\r\n"));
+    Serial.print(F("  ports             - Show each parallel port's capture and open file\r\n"));
+    Serial.print(F("  calibrate <sender>/status/stop - Learn the shortest /ACK the sender honors\r\n"));
+    Serial.print(F("  profile list/use <sender>/default/delete <sender> - Saved handshake timings\r\n"));
     Serial.print(F("  flowstats         - Show hardware flow control statistics\r\n"));
+    Serial.print(F("  queuestats [reset] - Show chunk queue backpressure statistics\r\n"));
+    Serial.print(F("  isrstats [reset]  - Show /STROBE ISR duration and strobe-to-ACK latency\r\n"));
+    Serial.print(F("  spistats [reset]  - Show SPI bus time held by the SD card and the flash\r\n"));
     Serial.print(F("  lcdthrottle on/off - Control LCD refresh throttling for storage ops\r\n"));
     Serial.print(F("  led l1/l2 on/off  - Control L1 (LPT) and L2 (Write) LEDs\r\n"));
     Serial.print(F("  debug lcd on/off      - Enable/disable LCD debug output to serial\r\n"));
@@ -355,8 +401,11 @@ void ConfigurationManager::printParallelPortStatus() {
     Serial.print(_cachedParallelPortManager->getDataCount());
     Serial.print(F("\r\n"));
     
-    // Data integrity check
-    uint32_t totalRead = _cachedParallelPortManager->getTotalBytesReceived();
+    // Data integrity check (every port writes into the same total)
+    uint32_t totalRead = 0;
+    for (uint8_t port = 0; port < Common::ParallelPorts::COUNT; port++) {
+        totalRead += getServices().getParallelPortManager(port)->getTotalBytesReceived();
+    }
     uint32_t totalWritten = _cachedFileSystemManager->getTotalBytesWritten();
     Serial.print(F("Data Integrity: "));
     if (totalRead == totalWritten) {
@@ -952,6 +1001,32 @@ void ConfigurationManager::printLastFileInfo() {
         Serial.print(F("Write Errors: "));
         Serial.print(_cachedFileSystemManager->getWriteErrors());
         Serial.print(F("\r\n"));
+
+        // Per-file accounting from the last end of file (also in the .cap record on SD)
+        const Common::CaptureStatistics &capture = _cachedFileSystemManager->getCaptureStatistics();
+        Serial.print(F("Last Capture: "));
+        Serial.print(capture.bytesCaptured);
+        Serial.print(F(" captured, "));
+        Serial.print(capture.bytesDropped);
+        Serial.print(F(" dropped, "));
+        Serial.print(capture.bytesDiscarded);
+        Serial.print(F(" discarded, "));
+        Serial.print(capture.overflowEvents);
+        Serial.print(F(" overflows in "));
+        Serial.print(capture.durationMs);
+        Serial.print(F("ms "));
+        Serial.print(capture.bytesDropped == 0 && capture.bytesDiscarded == 0 ? F("✅") : F("❌"));
+        Serial.print(F("\r\n"));
+
+        Serial.print(F("Flow States (ms): normal "));
+        Serial.print(capture.flowStateUs[0] / 1000);
+        Serial.print(F(", warning "));
+        Serial.print(capture.flowStateUs[1] / 1000);
+        Serial.print(F(", critical "));
+        Serial.print(capture.flowStateUs[2] / 1000);
+        Serial.print(F(", emergency "));
+        Serial.print(capture.flowStateUs[3] / 1000);
+        Serial.print(F("\r\n"));
     } else {
         Serial.print(F("No files saved yet.\r\n"));
     }
@@ -1069,72 +1144,39 @@ void ConfigurationManager::handleListCommand(const String &command) {
             return;
         }
 
-        // List files on SD card
-        File root = SD.open("/");
-        if (!root) {
-            Serial.print(F("Failed to open root directory\r\n"));
+        // One sequential read of the capture catalog, no directory walk
+        if (!Storage::CaptureCatalog::isReady()) {
+            Serial.print(F("No capture catalog - try 'catalog rebuild'\r\n"));
             Serial.print(F("=============================\r\n"));
             return;
         }
 
-        uint16_t fileCount = 0;
-        uint32_t totalSize = 0;
-
         Serial.print(F("SD Card Files:\r\n"));
-
-       while (true) {
-    File entry = root.openNextFile();
-    if (!entry) break;
-
-    if (entry.isDirectory()) {
-        Serial.print(F("Dir: "));
-        Serial.println(entry.name());
-
-        File subDir = SD.open(entry.name());
-        if (subDir && subDir.isDirectory()) {
-            while (true) {
-                File subEntry = subDir.openNextFile();
-                if (!subEntry) break;
-
-                if (!subEntry.isDirectory()) {
-                    fileCount++;
-                    uint32_t fileSize = subEntry.size();
-                    totalSize += fileSize;
-
-                    Serial.print(F("  "));
-                    Serial.print(subEntry.name());
-                    Serial.print(F(" ("));
-                    Serial.print(fileSize);
-                    Serial.println(F(" bytes)"));
+        Storage::CaptureCatalog::forEach(
+            [](const Storage::CaptureCatalog::Entry &entry, void *) {
+                char path[DeviceBridge::Common::Limits::MAX_FILENAME_LENGTH];
+                Storage::CaptureCatalog::formatPath(entry, path, sizeof(path));
+                Serial.print(F("  "));
+                Serial.print(path);
+                Serial.print(F(" ("));
+                Serial.print(entry.size);
+                Serial.print(F(" bytes, "));
+                Serial.print(DeviceBridge::Common::FileType((DeviceBridge::Common::FileType::Value)entry.type).toString());
+                if (entry.flags & Storage::CaptureCatalog::CRC_VALID) {
+                    char crc[12];
+                    snprintf(crc, sizeof(crc), ", crc %04X", entry.crc);
+                    Serial.print(crc);
                 }
-                subEntry.close();
-            }
-            subDir.close();
-        } else {
-            Serial.println(F("Failed to open subdirectory"));
-        }
-    } else {
-        fileCount++;
-        uint32_t fileSize = entry.size();
-        totalSize += fileSize;
-
-        Serial.print(F("  "));
-        Serial.print(entry.name());
-        Serial.print(F(" ("));
-        Serial.print(fileSize);
-        Serial.println(F(" bytes)"));
-    }
-    entry.close();
-}
-
-        root.close();
+                Serial.print(F(")\r\n"));
+            },
+            nullptr);
 
         Serial.print(F("\r\nSummary:\r\n"));
         Serial.print(F("  Files: "));
-        Serial.print(fileCount);
+        Serial.print(Storage::CaptureCatalog::count());
         Serial.print(F("\r\n"));
         Serial.print(F("  Total Size: "));
-        Serial.print(totalSize);
+        Serial.print(Storage::CaptureCatalog::totalBytes());
         Serial.print(F(" bytes\r\n"));
         Serial.print(F("=============================\r\n"));
     } else if (target == F("eeprom")) {
@@ -1483,15 +1525,508 @@ void ConfigurationManager::handleFlowControlCommand(const String& command) {
     } else if (param.equalsIgnoreCase(F("off")) || param.equalsIgnoreCase(F("disable"))) {
         _cachedParallelPortManager->setHardwareFlowControlEnabled(false);
         Serial.print(F("Hardware flow control disabled\r\n"));
+    } else if (param.equalsIgnoreCase(F("predictive"))) {
+        if (!_cachedParallelPortManager->isHardwareFlowControlEnabled()) {
+            _cachedParallelPortManager->setHardwareFlowControlEnabled(true);
+        }
+        _cachedParallelPortManager->setFlowPredictionEnabled(true);
+        Serial.print(F("Hardware flow control enabled, BUSY level predicted from the measured host overshoot\r\n"));
+    } else if (param.equalsIgnoreCase(F("fixed"))) {
+        _cachedParallelPortManager->setFlowPredictionEnabled(false);
+        Serial.print(F("Hardware flow control thresholds: fixed (Config.h)\r\n"));
     } else if (param.equalsIgnoreCase(F("status")) || param.length() == 0) {
         Serial.print(F("Hardware flow control: "));
         Serial.print(_cachedParallelPortManager->isHardwareFlowControlEnabled() ? F("ENABLED") : F("DISABLED"));
+        Serial.print(_cachedParallelPortManager->isFlowPredictionEnabled() ? F(", predictive") : F(", fixed thresholds"));
+        Serial.print(F("\r\n"));
+    } else {
+        Serial.print(F("Usage: flowcontrol on/off/predictive/fixed/status\r\n"));
+    }
+}
+
+void ConfigurationManager::handleAckModeCommand(const String& command) {
+    String param = command.substring(7); // Skip "ackmode"
+    param.trim();
+
+    if (param.equalsIgnoreCase(F("delay"))) {
+        _cachedParallelPortManager->setTimedAcknowledgeEnabled(false, 0);
+        Serial.print(F("ACK mode: delay (busy-wait pulse in ISR)\r\n"));
+    } else if (param.equalsIgnoreCase(F("timer")) || param.startsWith(F("timer "))) {
+        String width = param.substring(5);
+        width.trim();
+        uint16_t pulseUs = width.length() > 0 ? (uint16_t)width.toInt()
+                                              : _cachedConfigurationService->getAckTimerPulseUs();
+        if (pulseUs == 0 || pulseUs > DeviceBridge::Common::Timing::ACK_TIMER_MAX_PULSE_US) {
+            Serial.print(F("❌ Pulse width must be 1-"));
+            Serial.print(DeviceBridge::Common::Timing::ACK_TIMER_MAX_PULSE_US);
+            Serial.print(F("us\r\n"));
+        } else if (_cachedParallelPortManager->setTimedAcknowledgeEnabled(true, pulseUs)) {
+            Serial.print(F("✅ ACK mode: timer, "));
+            Serial.print(_cachedParallelPortManager->getAcknowledgePulseUs());
+            Serial.print(F("us pulse\r\n"));
+        } else {
+            Serial.print(F("❌ Timer ACK unavailable (status pins differ from Config.h)\r\n"));
+        }
+    } else if (param.equalsIgnoreCase(F("status")) || param.length() == 0) {
+        Serial.print(F("ACK mode: "));
+        Serial.print(_cachedParallelPortManager->isTimedAcknowledgeEnabled() ? F("timer") : F("delay"));
+        Serial.print(F(", "));
+        Serial.print(_cachedParallelPortManager->getAcknowledgePulseUs());
+        Serial.print(F("us pulse\r\n"));
+    } else {
+        Serial.print(F("Usage: ackmode delay/timer [width_us]/status\r\n"));
+    }
+}
+
+void ConfigurationManager::handleBurstCommand(const String& command) {
+    String param = command.substring(5); // Skip "burst"
+    param.trim();
+
+    if (param.equalsIgnoreCase(F("on")) || param.equalsIgnoreCase(F("enable"))) {
+        if (_cachedParallelPortManager->setBurstCaptureEnabled(true)) {
+            Serial.print(F("✅ Burst capture enabled (optimized ISR)\r\n"));
+        } else {
+            Serial.print(F("❌ Burst capture unavailable (no external interrupt on /STROBE)\r\n"));
+        }
+    } else if (param.equalsIgnoreCase(F("off")) || param.equalsIgnoreCase(F("disable"))) {
+        _cachedParallelPortManager->setBurstCaptureEnabled(false);
+        Serial.print(F("Burst capture disabled\r\n"));
+    } else if (param.equalsIgnoreCase(F("status")) || param.length() == 0) {
+        Serial.print(F("Burst capture: "));
+        Serial.print(_cachedParallelPortManager->isBurstCaptureEnabled() ? F("ENABLED") : F("DISABLED"));
+        if (_cachedParallelPortManager->isTimedAcknowledgeEnabled()) {
+            Serial.print(F(" (inactive while ackmode timer)"));
+        }
+        Serial.print(F("\r\n  Bytes without own interrupt: "));
+        Serial.print(_cachedParallelPortManager->getBurstCaptureCount());
+        Serial.print(F("\r\n"));
+    } else {
+        Serial.print(F("Usage: burst on/off/status\r\n"));
+    }
+}
+
+void ConfigurationManager::handleCaptureCommand(const String& command) {
+    String param = command.substring(7); // Skip "capture"
+    param.trim();
+
+    if (param.equalsIgnoreCase(F("isr")) || param.equalsIgnoreCase(F("interrupt"))) {
+        _cachedParallelPortManager->setPolledCaptureEnabled(false);
+        Serial.print(F("Capture mode: interrupt\r\n"));
+    } else if (param.equalsIgnoreCase(F("polled")) || param.equalsIgnoreCase(F("poll"))) {
+        if (_cachedParallelPortManager->setPolledCaptureEnabled(true)) {
+            Serial.print(F("✅ Capture mode: polled during sustained transfers\r\n"));
+        } else {
+            Serial.print(F("❌ Polled capture unavailable (no external interrupt on /STROBE)\r\n"));
+        }
+    } else if (param.equalsIgnoreCase(F("status")) || param.equalsIgnoreCase(F("reset")) || param.length() == 0) {
+        DeviceBridge::Parallel::Port::PolledCaptureStatistics stats =
+            _cachedParallelPortManager->getPolledCaptureStatistics();
+        Serial.print(F("Capture mode: "));
+        Serial.print(_cachedParallelPortManager->isPolledCaptureEnabled() ? F("polled") : F("interrupt"));
+        if (_cachedParallelPortManager->isPolledCaptureEnabled() && _cachedParallelPortManager->isTimedAcknowledgeEnabled()) {
+            Serial.print(F(" (inactive while ackmode timer)"));
+        }
+        Serial.print(F("\r\n  Polled sessions: "));
+        Serial.print(stats.sessions);
+        Serial.print(F(", bytes: "));
+        Serial.print(stats.bytes);
+        Serial.print(F("\r\n  Exits - idle: "));
+        Serial.print(stats.idleExits);
+        Serial.print(F(", high-water: "));
+        Serial.print(stats.highWaterExits);
+        Serial.print(F(", time limit: "));
+        Serial.print(stats.timeLimitExits);
+        Serial.print(F("\r\n"));
+        if (param.equalsIgnoreCase(F("reset"))) {
+            _cachedParallelPortManager->resetPolledCaptureStatistics();
+            Serial.print(F("Polled capture statistics reset\r\n"));
+        }
+    } else {
+        Serial.print(F("Usage: capture isr/polled/status/reset\r\n"));
+    }
+}
+
+void ConfigurationManager::handleJobSplitCommand(const String& command) {
+    namespace JobBoundary = DeviceBridge::Common::JobBoundary;
+    String param = command.substring(8); // Skip "jobsplit"
+    param.trim();
+
+    if (param.equalsIgnoreCase(F("init"))) {
+        _cachedParallelPortManager->setJobSignals(JobBoundary::SIGNAL_INIT);
+    } else if (param.equalsIgnoreCase(F("selectin"))) {
+        _cachedParallelPortManager->setJobSignals(JobBoundary::SIGNAL_SELECT_IN);
+    } else if (param.equalsIgnoreCase(F("both"))) {
+        _cachedParallelPortManager->setJobSignals(JobBoundary::SIGNAL_INIT | JobBoundary::SIGNAL_SELECT_IN);
+    } else if (param.equalsIgnoreCase(F("off"))) {
+        _cachedParallelPortManager->setJobSignals(0);
+    } else if (!param.equalsIgnoreCase(F("status")) && param.length() != 0) {
+        Serial.print(F("Usage: jobsplit init/selectin/both/off/status\r\n"));
+        return;
+    }
+
+    const uint8_t signals = _cachedParallelPortManager->getJobSignals();
+    Serial.print(F("Job split: "));
+    if (signals == 0) {
+        Serial.print(F("off (idle timeout only)"));
+    } else {
+        if (signals & JobBoundary::SIGNAL_INIT) {
+            Serial.print(F("/INIT "));
+        }
+        if (signals & JobBoundary::SIGNAL_SELECT_IN) {
+            Serial.print(F("/SELECT-IN "));
+        }
+        Serial.print(F("+ idle timeout"));
+    }
+    Serial.print(F(", boundaries seen: "));
+    Serial.print(_cachedParallelPortManager->getJobBoundaryCount());
+    Serial.print(F("\r\n"));
+}
+
+void ConfigurationManager::printPortsStatus() {
+    Serial.print(F("\r\n=== Parallel Ports ("));
+    Serial.print(Common::ParallelPorts::COUNT);
+    Serial.print(F(") ===\r\n"));
+
+    for (uint8_t port = 0; port < Common::ParallelPorts::COUNT; port++) {
+        ParallelPortManager *manager = getServices().getParallelPortManager(port);
+        const ParallelPortManager::ChunkQueueStatistics queue = manager->getChunkQueueStatistics();
+
+        Serial.print(F("LPT"));
+        Serial.print(port + 1);
+        Serial.print(F(": "));
+        Serial.print(manager->getTotalBytesReceived());
+        Serial.print(F(" bytes, "));
+        Serial.print(manager->getFilesReceived());
+        Serial.print(F(" files, buffer "));
+        Serial.print(manager->getBufferLevel());
+        Serial.print(F(", chunks "));
+        Serial.print(queue.chunksQueued);
+        Serial.print(F(" ("));
+        Serial.print(queue.queued);
+        Serial.print(F(" queued)"));
+        if (_cachedFileSystemManager->isFileOpen(port)) {
+            Serial.print(F(", writing "));
+            Serial.print(_cachedFileSystemManager->getCurrentFilename(port));
+            Serial.print(F(" ("));
+            Serial.print(_cachedFileSystemManager->getCurrentFileBytesWritten(port));
+            Serial.print(F(" bytes)"));
+        }
+        Serial.print(F("\r\n"));
+    }
+
+    Serial.print(F("Storage turns yielded: "));
+    Serial.print(_cachedFileSystemManager->getStorageYields());
+    Serial.print(F("\r\nSD file opens: "));
+    Serial.print(_cachedFileSystemManager->getFileOpenCount());
+    Serial.print(F(", mean "));
+    Serial.print(_cachedFileSystemManager->getFileOpenMeanUs());
+    Serial.print(F("us, max "));
+    Serial.print(_cachedFileSystemManager->getFileOpenMaxUs());
+    Serial.print(F("us\r\n"));
+}
+
+void ConfigurationManager::handleDocumentEndCommand(const String& command) {
+    using Format = DeviceBridge::Parallel::DocumentEnd::Format;
+    String param = command.substring(6); // Skip "docend"
+    param.trim();
+
+    if (param.equalsIgnoreCase(F("on"))) {
+        _cachedParallelPortManager->setDocumentEndEnabled(true);
+    } else if (param.equalsIgnoreCase(F("off"))) {
+        _cachedParallelPortManager->setDocumentEndEnabled(false);
+    } else if (!param.equalsIgnoreCase(F("status")) && param.length() != 0) {
+        Serial.print(F("Usage: docend on/off/status\r\n"));
+        return;
+    }
+
+    Serial.print(F("Document end: "));
+    Serial.print(_cachedParallelPortManager->isDocumentEndEnabled() ? F("✅ BMP/PCX/TIFF/PCL + idle timeout")
+                                                                    : F("❌ idle timeout only"));
+    Serial.print(F(", files closed early: "));
+    Serial.print(_cachedParallelPortManager->getDocumentEndCount());
+
+    const DeviceBridge::Parallel::DocumentEnd &document = _cachedParallelPortManager->getDocumentEnd();
+    Serial.print(F("\r\nLast document: "));
+    switch (document.getFormat()) {
+        case Format::DETECTING:
+            Serial.print(F("none"));
+            break;
+        case Format::UNKNOWN:
+            Serial.print(F("unknown format"));
+            break;
+        case Format::BMP:
+            Serial.print(F("BMP"));
+            break;
+        case Format::PCX:
+            Serial.print(F("PCX"));
+            break;
+        case Format::TIFF:
+            Serial.print(F("TIFF"));
+            break;
+        case Format::PCL:
+            Serial.print(F("PCL"));
+            break;
+    }
+    Serial.print(F(", "));
+    Serial.print(document.getPosition());
+    Serial.print(document.isComplete() ? F(" bytes, complete\r\n") : F(" bytes\r\n"));
+}
+
+void ConfigurationManager::handleCommitCommand(const String& command) {
+    using CommitPolicy = FileSystemManager::CommitPolicy;
+    String param = command.substring(6); // Skip "commit"
+    param.trim();
+
+    if (param.startsWith(F("kb "))) {
+        String value = param.substring(3);
+        value.trim();
+        const long kb = value.toInt();
+        if (kb < 0 || kb > 1024 || (kb == 0 && value != F("0"))) {
+            Serial.print(F("❌ Commit size must be 0-1024 KB\r\n"));
+            return;
+        }
+        _cachedFileSystemManager->setCommitPolicy(CommitPolicy::BYTES, (uint16_t)kb);
+    } else if (param.equalsIgnoreCase(F("ms")) || param.startsWith(F("ms "))) {
+        String value = param.substring(2);
+        value.trim();
+        const long ms = value.length() > 0 ? value.toInt() : DeviceBridge::Common::Commit::DEFAULT_INTERVAL_MS;
+        if (ms < 1 || ms > 60000) {
+            Serial.print(F("❌ Commit interval must be 1-60000 ms\r\n"));
+            return;
+        }
+        _cachedFileSystemManager->setCommitPolicy(CommitPolicy::INTERVAL, (uint16_t)ms);
+    } else if (param.equalsIgnoreCase(F("close"))) {
+        _cachedFileSystemManager->setCommitPolicy(CommitPolicy::CLOSE, 0);
+    } else if (!param.equalsIgnoreCase(F("status")) && param.length() != 0) {
+        Serial.print(F("Usage: commit kb <n>/ms [t]/close/status\r\n"));
+        return;
+    }
+
+    const uint16_t value = _cachedFileSystemManager->getCommitValue();
+    Serial.print(F("SD commit: "));
+    switch (_cachedFileSystemManager->getCommitPolicy()) {
+        case CommitPolicy::BYTES:
+            if (value == 0) {
+                Serial.print(F("every chunk"));
+            } else {
+                Serial.print(F("every "));
+                Serial.print(value);
+                Serial.print(F("KB"));
+            }
+            break;
+        case CommitPolicy::INTERVAL:
+            Serial.print(F("every "));
+            Serial.print(value);
+            Serial.print(F("ms"));
+            break;
+        case CommitPolicy::CLOSE:
+            Serial.print(F("on close only"));
+            break;
+    }
+    Serial.print(F(", "));
+    Serial.print(_cachedFileSystemManager->getCommitCount());
+    Serial.print(F(" commits\r\nJournal: "));
+    if (_cachedFileSystemManager->isCommitJournalReady()) {
+        Serial.print(F("✅ "));
+        Serial.print(DeviceBridge::Common::Commit::JOURNAL_NAME);
+    } else {
+        Serial.print(F("❌ none, files keep their last flush"));
+    }
+    Serial.print(F(", files recovered at mount: "));
+    Serial.print(_cachedFileSystemManager->getRecoveredFiles());
+    Serial.print(F("\r\n"));
+}
+
+void ConfigurationManager::handleCatalogCommand(const String& command) {
+    String param = command.substring(7); // Skip "catalog"
+    param.trim();
+
+    if (param.equalsIgnoreCase(F("rebuild")) || param.equalsIgnoreCase(F("rebuild crc"))) {
+        if (!_cachedFileSystemManager->isSDAvailable()) {
+            Serial.print(F("❌ SD card not available\r\n"));
+            return;
+        }
+        // An open file is cataloged when it closes
+        for (uint8_t port = 0; port < DeviceBridge::Common::ParallelPorts::COUNT; port++) {
+            if (_cachedFileSystemManager->isFileOpen(port)) {
+                Serial.print(F("❌ Capture in progress, try again once it ends\r\n"));
+                return;
+            }
+        }
+        const bool withCrc = param.length() > 7;
+        Serial.print(withCrc ? F("Rebuilding SD catalog, reading every file...\r\n") : F("Rebuilding SD catalog...\r\n"));
+        const int32_t files = Storage::CaptureCatalog::rebuild(withCrc);
+        if (files < 0) {
+            Serial.print(F("❌ Rebuild failed (write-protected or full?)\r\n"));
+            return;
+        }
+    } else if (!param.equalsIgnoreCase(F("status")) && param.length() != 0) {
+        Serial.print(F("Usage: catalog status/rebuild [crc]\r\n"));
+        return;
+    }
+
+    Serial.print(F("SD catalog: "));
+    if (!Storage::CaptureCatalog::isReady()) {
+        Serial.print(F("❌ none, 'catalog rebuild' writes one\r\n"));
+        return;
+    }
+    Serial.print(F("✅ "));
+    Serial.print(DeviceBridge::Common::Catalog::FILE_NAME);
+    Serial.print(F(", "));
+    Serial.print(Storage::CaptureCatalog::count());
+    Serial.print(F(" files, "));
+    Serial.print(Storage::CaptureCatalog::totalBytes());
+    Serial.print(F(" bytes\r\n"));
+}
+
+void ConfigurationManager::handleTraceCommand(const String& command) {
+#ifndef DEVICEBRIDGE_CAPTURE_TRACE
+    (void)command;
+    Serial.print(F("Capture trace not built in (use env megaatmega2560_trace)\r\n"));
+#else
+    String param = command.substring(5); // Skip "trace"
+    param.trim();
+
+    if (param.equalsIgnoreCase(F("start"))) {
+        if (!_cachedFileSystemManager->startTrace()) {
+            Serial.print(F("❌ Trace needs an SD card\r\n"));
+            return;
+        }
+    } else if (param.equalsIgnoreCase(F("stop"))) {
+        _cachedFileSystemManager->stopTrace();
+    } else if (!param.equalsIgnoreCase(F("status")) && param.length() != 0) {
+        Serial.print(F("Usage: trace start/stop/status\r\n"));
+        return;
+    }
+
+    DeviceBridge::Parallel::CaptureTrace::Statistics stats;
+    DeviceBridge::Parallel::CaptureTrace::snapshot(stats);
+    Serial.print(F("Trace: "));
+    Serial.print(stats.recording ? F("✅ recording") : F("stopped"));
+    if (stats.overflowed) {
+        Serial.print(F(" (❌ ring overflowed, trace ends early)"));
+    }
+    Serial.print(F("\r\nFile: "));
+    Serial.print(_cachedFileSystemManager->getTraceFilename()[0] ? _cachedFileSystemManager->getTraceFilename() : "none");
+    Serial.print(F(", "));
+    Serial.print(stats.records);
+    Serial.print(F(" strobes, "));
+    Serial.print(_cachedFileSystemManager->getTraceBytesWritten());
+    Serial.print(F(" bytes written\r\n"));
+#endif
+}
+
+void ConfigurationManager::handleCalibrateCommand(const String& command) {
+    String param = command.substring(9); // Skip "calibrate"
+    param.trim();
+
+    if (param.equalsIgnoreCase(F("stop")) || param.equalsIgnoreCase(F("cancel"))) {
+        _cachedParallelPortManager->stopCalibration();
+        Serial.print(F("Calibration stopped\r\n"));
+    } else if (param.equalsIgnoreCase(F("status")) || param.length() == 0) {
+        auto status = _cachedParallelPortManager->getCalibrationStatus();
+        Serial.print(F("Calibration: "));
+        switch (status.state) {
+            case DeviceBridge::Parallel::HandshakeCalibrator::State::IDLE:
+                Serial.print(F("idle\r\n"));
+                return;
+            case DeviceBridge::Parallel::HandshakeCalibrator::State::MEASURING:
+                Serial.print(F("measuring "));
+                break;
+            case DeviceBridge::Parallel::HandshakeCalibrator::State::DONE:
+                Serial.print(F("✅ done "));
+                break;
+            case DeviceBridge::Parallel::HandshakeCalibrator::State::FAILED:
+                Serial.print(F("❌ profile table full "));
+                break;
+        }
+        Serial.print(status.sender);
+        Serial.print(F("\r\n  Trying /ACK: "));
+        Serial.print(status.candidateUs);
+        Serial.print(F("us ("));
+        Serial.print(status.windowGaps);
+        Serial.print(F("/"));
+        Serial.print(DeviceBridge::Common::Calibration::WINDOW_GAPS);
+        Serial.print(F(" gaps), best: "));
+        Serial.print(status.bestUs);
+        Serial.print(F("us at "));
+        Serial.print(status.bestGapCycles / (F_CPU / 1000000UL));
+        Serial.print(F("us/byte\r\n  Strobes: "));
+        Serial.print(status.strobes);
+        Serial.print(F(", mean width: "));
+        Serial.print(status.strobeWidthNs);
+        Serial.print(F("ns\r\n"));
+    } else if (param.length() >= DeviceBridge::Common::Calibration::SENDER_NAME_LENGTH) {
+        Serial.print(F("❌ Sender name is limited to "));
+        Serial.print(DeviceBridge::Common::Calibration::SENDER_NAME_LENGTH - 1);
+        Serial.print(F(" characters\r\n"));
+    } else if (_cachedParallelPortManager->startCalibration(param.c_str())) {
+        Serial.print(F("✅ Calibrating "));
+        Serial.print(param);
+        Serial.print(F(" - send a long capture now\r\n"));
+    } else {
+        Serial.print(F("❌ Calibration unavailable (ackmode timer, status pins differ from Config.h)\r\n"));
+    }
+}
+
+void ConfigurationManager::handleProfileCommand(const String& command) {
+    String param = command.substring(7); // Skip "profile"
+    param.trim();
+
+    if (param.equalsIgnoreCase(F("list")) || param.length() == 0) {
+        const char *active = DeviceBridge::Parallel::OptimizedTiming::getProfileSender();
+        Serial.print(F("Active timings: "));
+        Serial.print(active[0] != '\0' ? active : "Config.h defaults");
         Serial.print(F("\r\n"));
+        DeviceBridge::Parallel::TimingProfiles::Profile profile;
+        for (uint8_t slot = 0; slot < DeviceBridge::Common::Calibration::PROFILE_SLOTS; slot++) {
+            if (DeviceBridge::Parallel::TimingProfiles::get(slot, profile)) {
+                printTimingProfile(profile);
+            }
+        }
+    } else if (param.equalsIgnoreCase(F("default")) || param.equalsIgnoreCase(F("none"))) {
+        if (_cachedParallelPortManager->useTimingProfile(nullptr)) {
+            Serial.print(F("Timing profile: Config.h defaults\r\n"));
+        } else {
+            Serial.print(F("❌ Calibration in progress\r\n"));
+        }
+    } else if (param.startsWith(F("use "))) {
+        String sender = param.substring(4);
+        sender.trim();
+        if (_cachedParallelPortManager->useTimingProfile(sender.c_str())) {
+            Serial.print(F("✅ Timing profile: "));
+            Serial.print(sender);
+            Serial.print(F("\r\n"));
+        } else {
+            Serial.print(F("❌ No profile for "));
+            Serial.print(sender);
+            Serial.print(F(" (or calibration in progress)\r\n"));
+        }
+    } else if (param.startsWith(F("delete "))) {
+        String sender = param.substring(7);
+        sender.trim();
+        if (_cachedParallelPortManager->deleteTimingProfile(sender.c_str())) {
+            Serial.print(F("Profile deleted: "));
+            Serial.print(sender);
+            Serial.print(F("\r\n"));
+        } else {
+            Serial.print(F("❌ No profile for "));
+            Serial.print(sender);
+            Serial.print(F(" (or calibration in progress)\r\n"));
+        }
     } else {
-        Serial.print(F("Usage: flowcontrol on/off/status\r\n"));
+        Serial.print(F("Usage: profile list/use <sender>/default/delete <sender>\r\n"));
     }
 }
 
+void ConfigurationManager::printTimingProfile(const DeviceBridge::Parallel::TimingProfiles::Profile& profile) {
+    char line[96];
+    snprintf(line, sizeof(line), "  %-11s /ACK %uus, BUSY setup %uus, strobe %uns, %uus/byte (%u strobes)\r\n",
+             profile.sender, profile.ackPulseUs, profile.busySetupUs, profile.strobeWidthNs, profile.strobeGapUs,
+             profile.samples);
+    Serial.print(line);
+}
+
 void ConfigurationManager::printFlowControlStatistics() {
     if (!_cachedParallelPortManager->isHardwareFlowControlEnabled()) {
         Serial.print(F("Hardware flow control is disabled\r\n"));
@@ -1537,6 +2072,152 @@ void ConfigurationManager::printFlowControlStatistics() {
             break;
     }
     Serial.print(F("\r\n"));
+
+    auto prediction = _cachedParallelPortManager->getFlowPredictionStatistics();
+    if (prediction.enabled) {
+        Serial.print(F("Overshoot After BUSY (peak): "));
+        Serial.print(prediction.overshootPeak);
+        Serial.print(F(" bytes\r\n"));
+        Serial.print(F("Predicted BUSY Level: "));
+        Serial.print(prediction.busyLevel);
+        Serial.print(F(" bytes (release at "));
+        Serial.print(prediction.recoveryLevel);
+        Serial.print(F(")\r\n"));
+    }
+}
+
+void ConfigurationManager::printChunkQueueStatistics(bool reset) {
+    auto stats = _cachedParallelPortManager->getChunkQueueStatistics();
+
+    Serial.print(F("\r\n=== Chunk Queue Statistics ===\r\n"));
+    Serial.print(F("Depth: "));
+    Serial.print(stats.depth);
+    Serial.print(F(" x "));
+    Serial.print(_cachedConfigurationService->getDataChunkSize());
+    Serial.print(F(" bytes\r\n"));
+
+    Serial.print(F("Queued Now: "));
+    Serial.print(stats.queued);
+    Serial.print(F("\r\n"));
+
+    Serial.print(F("High-Water Mark: "));
+    Serial.print(stats.highWater);
+    Serial.print(F("/"));
+    Serial.print(stats.depth);
+    Serial.print(F("\r\n"));
+
+    Serial.print(F("Chunks Queued: "));
+    Serial.print(stats.chunksQueued);
+    Serial.print(F("\r\n"));
+
+    Serial.print(F("Chunks Delayed: "));
+    Serial.print(stats.chunksDelayed);
+    Serial.print(F(" (waited behind an earlier chunk)\r\n"));
+
+    Serial.print(F("Queue Full: "));
+    Serial.print(stats.fullEvents);
+    Serial.print(F(" times, "));
+    Serial.print(stats.timeFullMs);
+    Serial.print(F("ms total\r\n"));
+
+    Serial.print(F("Backpressure: "));
+    if (stats.fullEvents == 0) {
+        Serial.print(F("✅ None - storage keeps up"));
+    } else {
+        Serial.print(F("⚠️ Storage fell behind - capture waited in the ring buffer"));
+    }
+    Serial.print(F("\r\n"));
+
+    if (reset) {
+        _cachedParallelPortManager->resetChunkQueueStatistics();
+        Serial.print(F("Statistics reset\r\n"));
+    }
+}
+
+#ifdef DEVICEBRIDGE_ISR_STATS
+static void printIsrHistogramSummary(const __FlashStringHelper *label,
+                                     const DeviceBridge::Parallel::IsrStats::Histogram &histogram) {
+    Serial.print(label);
+    if (histogram.count == 0) {
+        Serial.print(F("no samples\r\n"));
+        return;
+    }
+    Serial.print(histogram.count);
+    Serial.print(F(" samples, min "));
+    Serial.print(histogram.min);
+    Serial.print(F(" / mean "));
+    Serial.print(histogram.sum / histogram.count);
+    Serial.print(F(" / max "));
+    Serial.print(histogram.max);
+    Serial.print(F(" cycles (max "));
+    Serial.print(histogram.max / 16.0f, 1);
+    Serial.print(F("us)\r\n"));
+}
+#endif
+
+void ConfigurationManager::printIsrStatistics(bool reset) {
+#ifndef DEVICEBRIDGE_ISR_STATS
+    (void)reset;
+    Serial.print(F("ISR statistics not built in (use env megaatmega2560_isrstats)\r\n"));
+#else
+    namespace IsrStats = DeviceBridge::Parallel::IsrStats;
+    IsrStats::Statistics stats = _cachedParallelPortManager->getIsrStatistics();
+
+    Serial.print(F("\r\n=== Strobe ISR Timing (optimized ISR, 62.5ns cycles) ===\r\n"));
+    printIsrHistogramSummary(F("Duration:    "), stats.duration);
+    printIsrHistogramSummary(F("Strobe->ACK: "), stats.latency);
+
+    Serial.print(F("ACK Deadline: "));
+    if (stats.latency.count == 0) {
+        Serial.print(F("no data"));
+    } else if (stats.latency.max <= IsrStats::ACK_LIMIT_US * 16U) {
+        Serial.print(F("✅ Within "));
+        Serial.print(IsrStats::ACK_LIMIT_US);
+        Serial.print(F("us"));
+    } else {
+        Serial.print(F("❌ Over "));
+        Serial.print(IsrStats::ACK_LIMIT_US);
+        Serial.print(F("us"));
+    }
+    Serial.print(F("\r\n"));
+
+    Serial.print(F("Cycles       Duration  Strobe->ACK\r\n"));
+    for (uint8_t i = 0; i < IsrStats::BUCKETS; i++) {
+        if (stats.duration.buckets[i] == 0 && stats.latency.buckets[i] == 0) {
+            continue;
+        }
+        char row[40];
+        snprintf(row, sizeof(row), "%5lu-%-5lu %9u %12u\r\n", i == 0 ? 0UL : 1UL << i, (2UL << i) - 1,
+                 stats.duration.buckets[i], stats.latency.buckets[i]);
+        Serial.print(row);
+    }
+
+    if (reset) {
+        _cachedParallelPortManager->resetIsrStatistics();
+        Serial.print(F("Statistics reset\r\n"));
+    }
+#endif
+}
+
+void ConfigurationManager::printSpiStatistics(bool reset) {
+    using Storage::SpiBus;
+
+    Serial.print(F("\r\n=== SPI Bus ===\r\n"));
+    Serial.print(F("Device  Clock   Claims    Busy ms   Mean us   Max us\r\n"));
+    for (uint8_t device = 0; device < SpiBus::DEVICE_COUNT; device++) {
+        const SpiBus::Statistics &stats = SpiBus::statistics((SpiBus::Device)device);
+        char row[64];
+        snprintf(row, sizeof(row), "%-6s %2luMHz %8lu %10lu %9lu %8lu\r\n", device == SpiBus::FLASH ? "Flash" : "SD",
+                 SpiBus::clockHz((SpiBus::Device)device) / 1000000UL, (unsigned long)stats.claims,
+                 (unsigned long)(stats.busyUs / 1000), stats.claims ? (unsigned long)(stats.busyUs / stats.claims) : 0UL,
+                 (unsigned long)stats.maxUs);
+        Serial.print(row);
+    }
+
+    if (reset) {
+        SpiBus::resetStatistics();
+        Serial.print(F("Statistics reset\r\n"));
+    }
 }
 
 unsigned long ConfigurationManager::getUpdateInterval() const {
@@ -4,6 +4,7 @@
 #include "../Common/Types.h"
 #include "../Common/Config.h"
 #include "../Common/ServiceLocator.h"
+#include "../Parallel/TimingProfiles.h"
 
 namespace DeviceBridge::Components {
 
@@ -34,6 +35,7 @@ private:
     void printCurrentTime();
     void printButtonStatus();
     void printParallelPortStatus();
+    void printPortsStatus();
     void testInterruptPin();
     void printLastFileInfo();
     void printStorageStatus();
@@ -70,6 +72,36 @@ private:
     // Hardware flow control commands
     void handleFlowControlCommand(const String& command);
     void printFlowControlStatistics();
+    
+    // /ACK generation mode
+    void handleAckModeCommand(const String& command);
+    
+    // Burst capture
+    void handleBurstCommand(const String& command);
+    
+    // Interrupt vs polled capture
+    void handleCaptureCommand(const String& command);
+    
+    // Job boundaries from /INIT and /SELECT-IN
+    void handleJobSplitCommand(const String& command);
+    void handleDocumentEndCommand(const String& command);
+    void handleTraceCommand(const String& command);
+    void handleCommitCommand(const String& command);
+    void handleCatalogCommand(const String& command);
+    
+    // Per-sender handshake timing
+    void handleCalibrateCommand(const String& command);
+    void handleProfileCommand(const String& command);
+    void printTimingProfile(const DeviceBridge::Parallel::TimingProfiles::Profile& profile);
+    
+    // Chunk queue backpressure
+    void printChunkQueueStatistics(bool reset);
+    
+    // Optimized ISR timing histograms
+    void printIsrStatistics(bool reset);
+    
+    // Shared SPI bus occupancy per device
+    void printSpiStatistics(bool reset);
 };
 
 } // namespace DeviceBridge::Components
\ No newline at end of file
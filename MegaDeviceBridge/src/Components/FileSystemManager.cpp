@@ -4,6 +4,8 @@
 #include "SystemManager.h"
 #include "TimeManager.h"
 #include "../Common/ConfigurationService.h"
+#include "../Parallel/CaptureTrace.h"
+#include "../Storage/SpiBus.h"
 #include <Arduino.h>
 #include <stdio.h>
 #include <string.h>
@@ -32,18 +34,36 @@ namespace FileFormatConstants {
 namespace DeviceBridge::Components {
 
 FileSystemManager::FileSystemManager()
-    : _activeFileSystem(nullptr), _eeprom(Common::Pins::EEPROM_CS), _eepromCurrentAddress(0),
+    : _activeFileSystem(nullptr), _eeprom(Common::Pins::EEPROM_CS),
+      _commitPolicy(CommitPolicy::BYTES), _commitValue(Common::Commit::DEFAULT_KB), _commits(0), _recoveredFiles(0),
+      _lastStoragePort(0xFF), _storageYields(0), _fileOpens(0), _fileOpenUsTotal(0), _fileOpenUsMax(0),
+      _lastNameTime(0), _lastNameRepeat(0), _lastSDCardCheckTime(0), _writeLedOnTime(0), _eepromCurrentAddress(0),
       _eepromBufferIndex(0), _activeStorage(Common::StorageType::AUTO_SELECT),
       _preferredStorage(Common::StorageType::SD_CARD), _fileCounter(0), _fileType(Common::FileType::AUTO_DETECT),
-      _detectedFileType(Common::FileType::AUTO_DETECT), _totalBytesWritten(0), _currentFileBytesWritten(0), 
-      _writeErrors(0), _lastSDCardCheckTime(0) {
+      _totalBytesWritten(0), _writeErrors(0) {
     // Initialize bit field flags
     _flags.sdAvailable = 0;
     _flags.eepromAvailable = 0;
     _flags.lastSDCardDetectState = 0;
-    _flags.isFileOpen = 0;
+    _flags.writeLedOn = 0;
+    _flags.traceOpen = 0;
     _flags.reserved = 0;
-    memset(_currentFilename, 0, sizeof(_currentFilename));
+    _dayDirectory[0] = '\0';
+#ifdef DEVICEBRIDGE_CAPTURE_TRACE
+    memset(_traceFilename, 0, sizeof(_traceFilename));
+    _traceBytesWritten = 0;
+#endif
+    for (CaptureFile &f : _files) {
+        memset(f.filename, 0, sizeof(f.filename));
+        memset(&f.statistics, 0, sizeof(f.statistics));
+        f.bytesWritten = 0;
+        f.committedBytes = 0;
+        f.uncommittedSince = 0;
+        f.crc = 0;
+        f.isOpen = 0;
+        f.statisticsPending = 0;
+        f.errorSent = 0;
+    }
 }
 
 FileSystemManager::~FileSystemManager() { stop(); }
@@ -52,6 +72,9 @@ bool FileSystemManager::initialize() {
     // Cache service dependencies first (performance optimization)
     cacheServiceDependencies();
     
+    // Both chip selects high before either device sees a command
+    Storage::SpiBus::begin();
+    
     // Initialize modular file system
     if (!initializeFileSystem()) {
         sendDisplayMessage(Common::DisplayMessage::ERROR, F("FileSystem Init Failed"));
@@ -87,6 +110,28 @@ bool FileSystemManager::initialize() {
 }
 
 void FileSystemManager::update(unsigned long currentTime) {
+    // End the L2 write flash started in processDataChunk()
+    if (_flags.writeLedOn && currentTime - _writeLedOnTime >= Common::Timing::WRITE_LED_FLASH_MS) {
+        digitalWrite(Common::Pins::DATA_WRITE_LED, LOW);
+        _flags.writeLedOn = 0;
+    }
+
+#ifdef DEVICEBRIDGE_CAPTURE_TRACE
+    if (_flags.traceOpen) {
+        writeTrace(Common::CaptureTrace::WRITE_BLOCK);
+    }
+#endif
+
+    // An interval commit is due even when no further chunk arrives
+    if (_commitPolicy == CommitPolicy::INTERVAL && _activeStorage.value == Common::StorageType::SD_CARD) {
+        for (const CaptureFile &f : _files) {
+            if (commitDue(f, currentTime)) {
+                commitFiles();
+                break;
+            }
+        }
+    }
+    
     // Check for SD card hot-swap every 1 second
     if (currentTime - _lastSDCardCheckTime >= 1000) {
         bool currentSDCardState = checkSDCardPresence();
@@ -105,12 +150,20 @@ void FileSystemManager::update(unsigned long currentTime) {
     }
 }
 
-void FileSystemManager::stop() { closeCurrentFile(); }
+void FileSystemManager::stop() {
+    closeAllFiles();
+    stopTrace();
+}
+
+void FileSystemManager::processDataChunk(const Common::DataChunk &chunk, uint8_t port) {
+    CaptureFile &f = _files[port];
+    ParallelPortManager *portManager = this->portManager(port);
 
-void FileSystemManager::processDataChunk(const Common::DataChunk &chunk) {
     // Debug logging for data chunk processing
     if (_cachedSystemManager->isParallelDebugEnabled()) {
-        Serial.print(F("[DEBUG-FS] PROCESSING CHUNK - Length: "));
+        Serial.print(F("[DEBUG-FS] PROCESSING CHUNK - Port: "));
+        Serial.print(port + 1);
+        Serial.print(F(", length: "));
         Serial.print(chunk.length);
         Serial.print(F(", new file: "));
         Serial.print(chunk.isNewFile ? F("YES") : F("NO"));
@@ -121,22 +174,21 @@ void FileSystemManager::processDataChunk(const Common::DataChunk &chunk) {
 
     // Handle new file
     if (chunk.isNewFile) {
-        closeCurrentFile();
+        closeFile(port);
         
         if (_cachedSystemManager->isParallelDebugEnabled()) {
             Serial.print(F("[DEBUG-FS] CREATING NEW FILE...\r\n"));
         }
         
-        if (!createNewFile()) {
+        if (!createNewFile(port)) {
             if (_cachedSystemManager->isParallelDebugEnabled()) {
                 Serial.print(F("[DEBUG-FS] FILE CREATION FAILED! Signaling error to TDS2024\r\n"));
             }
             
             // Signal error to TDS2024 to stop sending data
-            // Use cached parallel port manager pointer
-            _cachedParallelPortManager->setPrinterError(true);    // Set ERROR signal active
-            _cachedParallelPortManager->setPrinterPaperOut(true); // Set PAPER_OUT to indicate problem
-            _cachedParallelPortManager->clearBuffer();           // Clear any buffered data
+            portManager->setPrinterError(true);    // Set ERROR signal active
+            portManager->setPrinterPaperOut(true); // Set PAPER_OUT to indicate problem
+            portManager->clearBuffer();           // Clear any buffered data
             
             if (_cachedSystemManager->isParallelDebugEnabled()) {
                 Serial.print(F("[DEBUG-FS] ERROR signals sent to TDS2024, buffer cleared\r\n"));
@@ -148,22 +200,21 @@ void FileSystemManager::processDataChunk(const Common::DataChunk &chunk) {
         
         if (_cachedSystemManager->isParallelDebugEnabled()) {
             Serial.print(F("[DEBUG-FS] FILE CREATED SUCCESSFULLY: "));
-            Serial.print(_currentFilename);
+            Serial.print(f.filename);
             Serial.print(F("\r\n"));
         }
         
         // Clear any error signals to TDS2024 on successful file creation
-        // Use cached parallel port manager pointer
-        _cachedParallelPortManager->setPrinterError(false);   // Clear ERROR signal
-        _cachedParallelPortManager->setPrinterPaperOut(false); // Clear PAPER_OUT signal
+        portManager->setPrinterError(false);   // Clear ERROR signal
+        portManager->setPrinterPaperOut(false); // Clear PAPER_OUT signal
         
         sendDisplayMessage(Common::DisplayMessage::STATUS, F("Storing..."));
 
         // Detect file type from first chunk if auto-detection is enabled
         if (_fileType.value == Common::FileType::AUTO_DETECT && chunk.length > 0) {
-            _detectedFileType = detectFileType(chunk.data, chunk.length);
+            f.detectedType = detectFileType(chunk.data, chunk.length);
         } else {
-            _detectedFileType = _fileType; // Use configured type
+            f.detectedType = _fileType; // Use configured type
         }
     } else {
         // Don't spam LCD with status messages for every data chunk
@@ -179,12 +230,12 @@ void FileSystemManager::processDataChunk(const Common::DataChunk &chunk) {
             Serial.print(F("[DEBUG-FS] WRITING DATA - "));
             Serial.print(chunk.length);
             Serial.print(F(" bytes, file open: "));
-            Serial.print(_flags.isFileOpen ? F("YES") : F("NO"));
+            Serial.print(f.isOpen ? F("YES") : F("NO"));
             Serial.print(F("\r\n"));
         }
         
-        if (_flags.isFileOpen) {
-            if (!writeDataChunk(chunk)) {
+        if (f.isOpen) {
+            if (!writeDataChunk(chunk, port)) {
                 _writeErrors++;
                 if (_cachedSystemManager->isParallelDebugEnabled()) {
                     Serial.print(F("[DEBUG-FS] WRITE FAILED - Error count now: "));
@@ -210,9 +261,8 @@ void FileSystemManager::processDataChunk(const Common::DataChunk &chunk) {
             
             // Signal error to TDS2024 after multiple consecutive write errors
             if (_writeErrors >= 5) {  // After 5 errors, signal TDS2024 to stop
-                // Use cached parallel port manager pointer
-                _cachedParallelPortManager->setPrinterError(true);    // Set ERROR signal active
-                _cachedParallelPortManager->setPrinterPaperOut(true); // Set PAPER_OUT to indicate problem
+                portManager->setPrinterError(true);    // Set ERROR signal active
+                portManager->setPrinterPaperOut(true); // Set PAPER_OUT to indicate problem
                 
                 if (_cachedSystemManager->isParallelDebugEnabled()) {
                     Serial.print(F("[DEBUG-FS] Multiple write errors - signaling TDS2024 to stop\r\n"));
@@ -220,50 +270,146 @@ void FileSystemManager::processDataChunk(const Common::DataChunk &chunk) {
             }
             
             // Only send error message once per file to avoid LCD spam
-            static bool errorSent = false;
-            if (chunk.isNewFile || !errorSent) {
+            if (chunk.isNewFile || !f.errorSent) {
                 sendDisplayMessage(Common::DisplayMessage::ERROR, F("No File Open"));
-                errorSent = true;
+                f.errorSent = 1;
             }
             if (chunk.isEndOfFile) {
-                errorSent = false; // Reset for next file
+                f.errorSent = 0; // Reset for next file
             }
         }
         
-        // Brief delay to make LED flash visible, then turn off
-        delay(2);
-        digitalWrite(Common::Pins::DATA_WRITE_LED, LOW);
+        // Keep the flash visible without stalling the drain; update() turns it off
+        _flags.writeLedOn = 1;
+        _writeLedOnTime = millis();
     }
 
     // Handle end of file
     if (chunk.isEndOfFile) {
         if (_cachedSystemManager->isParallelDebugEnabled()) {
             Serial.print(F("[DEBUG-FS] END OF FILE - Closing file: "));
-            Serial.print(_currentFilename);
+            Serial.print(f.filename);
             Serial.print(F("\r\n"));
         }
         
-        if (closeCurrentFile()) {
+        bool wasOpen = f.isOpen;
+        if (closeFile(port)) {
+            if (wasOpen && !writeCaptureRecord(port) && _cachedSystemManager->isParallelDebugEnabled()) {
+                Serial.print(F("[DEBUG-FS] No capture record written for "));
+                Serial.print(f.filename);
+                Serial.print(F("\r\n"));
+            }
+
             char message[32];
-            snprintf(message, sizeof(message), "Saved: %s", _currentFilename);
+            snprintf(message, sizeof(message), "Saved: %s", f.filename);
             sendDisplayMessage(Common::DisplayMessage::INFO, message);
             
             if (_cachedSystemManager->isParallelDebugEnabled()) {
                 Serial.print(F("[DEBUG-FS] FILE CLOSED SUCCESSFULLY - "));
-                Serial.print(_currentFilename);
+                Serial.print(f.filename);
                 Serial.print(F("\r\n"));
             }
         } else {
             if (_cachedSystemManager->isParallelDebugEnabled()) {
                 Serial.print(F("[DEBUG-FS] FILE CLOSE FAILED - "));
-                Serial.print(_currentFilename);
+                Serial.print(f.filename);
                 Serial.print(F("\r\n"));
             }
             sendDisplayMessage(Common::DisplayMessage::ERROR, F("Close Failed"));
         }
+        f.statisticsPending = 0;
     }
 }
 
+void FileSystemManager::setCaptureStatistics(const Common::CaptureStatistics &stats, uint8_t port) {
+    _files[port].statistics = stats;
+    _files[port].statisticsPending = 1;
+}
+
+bool FileSystemManager::claimStorageTurn(uint8_t port) {
+    // A port that wrote the last chunk waits one update while another has chunks queued;
+    // forgetting the turn afterwards means a stalled port cannot hold everyone up
+    if (_lastStoragePort == port) {
+        for (uint8_t other = 0; other < Common::ParallelPorts::COUNT; other++) {
+            if (other != port && portManager(other)->getQueuedChunks() > 0) {
+                _lastStoragePort = 0xFF;
+                _storageYields++;
+                return false;
+            }
+        }
+    }
+    _lastStoragePort = port;
+    return true;
+}
+
+bool FileSystemManager::isStorageBusy() const {
+    if (_activeStorage.value != Common::StorageType::SD_CARD || !_flags.sdAvailable ||
+        !Storage::ContiguousFile::isReady()) {
+        return false;
+    }
+    Storage::SpiBus::Transaction bus(Storage::SpiBus::SD_CARD);
+    return Storage::ContiguousFile::isCardBusy();
+}
+
+bool FileSystemManager::writeCaptureRecord(uint8_t port) {
+    CaptureFile &f = _files[port];
+
+    // SD only: EEPROM files and serial transfers keep the counters in getCaptureStatistics()
+    if (!f.statisticsPending || _activeStorage.value != Common::StorageType::SD_CARD ||
+        !_flags.sdAvailable) {
+        return false;
+    }
+    f.statisticsPending = 0;
+
+    char path[Common::Limits::MAX_FILENAME_LENGTH + 8];
+    generateCaptureRecordPath(path, sizeof(path), port);
+    Storage::ContiguousFile::endStream();
+    File record = SD.open(path, FILE_WRITE);
+    if (!record) {
+        return false;
+    }
+
+    const Common::CaptureStatistics &s = f.statistics;
+    const uint32_t busyUs = s.flowStateUs[1] + s.flowStateUs[2] + s.flowStateUs[3];
+    const bool lossless = s.bytesDropped == 0 && s.bytesDiscarded == 0 && s.bytesCaptured == s.bytesDelivered &&
+                          s.bytesDelivered == f.bytesWritten;
+
+    // One key=value per line, readable on the PC next to the data file
+    record.print(F("file="));
+    record.print(f.filename);
+    record.print(F("\r\ncaptured="));
+    record.print(s.bytesCaptured);
+    record.print(F("\r\ndelivered="));
+    record.print(s.bytesDelivered);
+    record.print(F("\r\nwritten="));
+    record.print(f.bytesWritten);
+    record.print(F("\r\ndropped="));
+    record.print(s.bytesDropped);
+    record.print(F("\r\ndiscarded="));
+    record.print(s.bytesDiscarded);
+    record.print(F("\r\noverflows="));
+    record.print(s.overflowEvents);
+    record.print(F("\r\nduration_ms="));
+    record.print(s.durationMs);
+    record.print(F("\r\nrate_bps="));
+    record.print(s.durationMs ? (uint32_t)((uint64_t)s.bytesCaptured * 1000 / s.durationMs) : 0);
+    record.print(F("\r\nbusy_ms="));
+    record.print(busyUs / 1000);
+    record.print(F("\r\nnormal_ms="));
+    record.print(s.flowStateUs[0] / 1000);
+    record.print(F("\r\nwarning_ms="));
+    record.print(s.flowStateUs[1] / 1000);
+    record.print(F("\r\ncritical_ms="));
+    record.print(s.flowStateUs[2] / 1000);
+    record.print(F("\r\nemergency_ms="));
+    record.print(s.flowStateUs[3] / 1000);
+    record.print(F("\r\nlossless="));
+    record.print(lossless ? F("yes") : F("no"));
+    record.print(F("\r\n"));
+    record.close();
+    return true;
+}
+
 bool FileSystemManager::initializeSD() {
     // Initialize LED pins
     pinMode(Common::Pins::DATA_WRITE_LED, OUTPUT);
@@ -273,60 +419,91 @@ bool FileSystemManager::initializeSD() {
     pinMode(Common::Pins::SD_CD, INPUT_PULLUP); // Card Detect (active LOW)
     pinMode(Common::Pins::SD_WP, INPUT_PULLUP); // Write Protect (active HIGH)
 
-    return SD.begin(Common::Pins::SD_CS);
+    // A card put back may not have the day directory
+    _dayDirectory[0] = '\0';
+    if (!SD.begin(Common::Pins::SD_CS)) {
+        return false;
+    }
+    // Counts and listings come from the catalog; a card without one is walked once here
+    if (!Storage::CaptureCatalog::mount()) {
+        Serial.print(F("SD: no capture catalog (write-protected or full?)\r\n"));
+    }
+    // Without the raw block handle capture files fall back to the library's FAT-chain writes
+    if (Storage::ContiguousFile::begin()) {
+        // Files a power loss left open are cut back to their last commit; they were never cataloged
+        _recoveredFiles = Storage::CommitJournal::mount(
+            [](const char *path, uint32_t size) { Storage::CaptureCatalog::replace(path, size); });
+        if (_recoveredFiles) {
+            Serial.print(F("SD: "));
+            Serial.print(_recoveredFiles);
+            Serial.print(F(" capture file(s) cut back to their last commit\r\n"));
+        }
+    }
+    return true;
 }
 
 bool FileSystemManager::initializeEEPROM() { return _eeprom.initialize(); }
 
-bool FileSystemManager::createNewFile() {
+bool FileSystemManager::createNewFile(uint8_t port) {
+    CaptureFile &f = _files[port];
+    const unsigned long openStart = micros();
+
     // Notify display manager that storage operation is starting
     // Use cached display manager pointer
     _cachedDisplayManager->setStorageOperationActive(true);
     
-    generateFilename(_currentFilename, sizeof(_currentFilename));
+    // Another port's stream and block cache go back to the SD library for the name and directory lookups
+    if (_activeStorage.value == Common::StorageType::SD_CARD) {
+        Storage::ContiguousFile::endStream();
+    }
+    generateFilename(f.filename, sizeof(f.filename));
 
     switch (_activeStorage.value) {
     case Common::StorageType::SD_CARD:
         if (_flags.sdAvailable) {
-            sendDisplayMessage(Common::DisplayMessage::INFO, _currentFilename);
-
-            String currentPath = "/" + String(_currentFilename);
-            int lastSlash = currentPath.lastIndexOf('/');
-            if (lastSlash >= 0) {
-                String dirPath = currentPath.substring(0, lastSlash);
-                if (!SD.exists(dirPath.c_str())) {
-                    // Create directory without leading slash for Arduino SD library
-                    String createPath = dirPath.substring(1); // Remove leading '/'
-                    if (!SD.mkdir(createPath.c_str())) {
-                        // Try without subdirectory - fallback to root
-                        sendDisplayMessage(Common::DisplayMessage::ERROR, F("Dir Failed - Using Root"));
-                        // Use just the filename without directory structure
-                        auto fileName = currentPath.substring(lastSlash + 1);
-                        currentPath = "/" + fileName;
-                    } else {
-                        sendDisplayMessage(Common::DisplayMessage::INFO, F("Dir Created"));
-                    }
-                } else {
-                    sendDisplayMessage(Common::DisplayMessage::INFO, F("Dir Exists"));
-                }
+            Storage::SpiBus::Transaction bus(Storage::SpiBus::SD_CARD);
+            sendDisplayMessage(Common::DisplayMessage::INFO, f.filename);
+
+            // The day directory is looked up once a day; the name needs no lookup at all
+            if (!createParentDirectory(f.filename)) {
+                // Fall back to the root under the same name
+                sendDisplayMessage(Common::DisplayMessage::ERROR, F("Dir Failed - Using Root"));
+                const char *slash = strrchr(f.filename, '/');
+                memmove(f.filename, slash + 1, strlen(slash + 1) + 1);
             }
-            auto fileName = currentPath.substring(lastSlash + 1);
-            sendDisplayMessage(Common::DisplayMessage::INFO, ("File: " + fileName).c_str());
 
-            // Lock LPT port during SD operations to prevent interference
-            _cachedParallelPortManager->lockPort();
-            
-            _currentFile = SD.open(currentPath, FILE_WRITE);
-            
-            // Unlock LPT port immediately after SD operation
-            _cachedParallelPortManager->unlockPort();
+            // Named in the journal at 0 bytes before it exists: a power loss leaves
+            // an empty file rather than an extent of stale blocks. A name that
+            // falls back to the library never has the reserved size
+            f.committedBytes = 0;
+            f.crc = 0;
+            recordCommits(port);
+
+            // The /STROBE ISR keeps filling the ring buffer during SPI traffic;
+            // BUSY follows buffer occupancy only. A pre-allocated extent first;
+            // it is never created over an existing file
+            if (!f.contiguous.create(f.filename)) {
+                // A name taken before a restart or a clock change, or a card without
+                // a free run: FILE_WRITE appends, so only an unused name goes to the library
+                if (skipTakenNames(f.filename, sizeof(f.filename), getFileExtension())) {
+                    recordCommits(port);
+                    f.contiguous.create(f.filename);
+                }
+                if (!f.contiguous.isOpen()) {
+                    f.file = SD.open(f.filename, FILE_WRITE);
+                }
+            }
             
-            _flags.isFileOpen = (_currentFile != 0);
-            if (_flags.isFileOpen) {
-                _currentFileBytesWritten = 0; // Reset counter for new file
+            f.isOpen = f.contiguous.isOpen() || (f.file != 0);
+            if (f.isOpen) {
+                f.bytesWritten = 0; // Reset counter for new file
+                const uint32_t openUs = micros() - openStart;
+                _fileOpens++;
+                _fileOpenUsTotal += openUs;
+                _fileOpenUsMax = openUs > _fileOpenUsMax ? openUs : _fileOpenUsMax;
             }
             
-            if (_flags.isFileOpen) {
+            if (f.isOpen) {
                 sendDisplayMessage(Common::DisplayMessage::INFO, F("SD Opened"));
             } else {
                 sendDisplayMessage(Common::DisplayMessage::ERROR, F("SD Open Failed"));
@@ -340,51 +517,57 @@ bool FileSystemManager::createNewFile() {
                 }
             }
             
-            return _flags.isFileOpen;
+            return f.isOpen;
         }
         break;
 
     case Common::StorageType::EEPROM:
-        if (_flags.eepromAvailable) {
-            sendDisplayMessage(Common::DisplayMessage::INFO, _currentFilename);
+        if (_flags.eepromAvailable && isAnyFileOpen()) {
+            // The EEPROM file system writes one file at a time
+            sendDisplayMessage(Common::DisplayMessage::ERROR, F("EEPROM Busy"));
+            f.isOpen = false;
+            return false;
+        } else if (_flags.eepromAvailable) {
+            sendDisplayMessage(Common::DisplayMessage::INFO, f.filename);
             
             // Use the modular EEPROM filesystem
-            if (_eepromFileSystem.createFile(_currentFilename)) {
-                _flags.isFileOpen = true;
-                _currentFileBytesWritten = 0;
+            if (_eepromFileSystem.createFile(f.filename)) {
+                f.isOpen = true;
+                f.bytesWritten = 0;
                 _fileCounter++;
                 sendDisplayMessage(Common::DisplayMessage::INFO, F("EEPROM File Created"));
                 return true;
             } else {
                 sendDisplayMessage(Common::DisplayMessage::ERROR, F("EEPROM Create Failed"));
-                _flags.isFileOpen = false;
+                f.isOpen = false;
                 return false;
             }
         } else {
             sendDisplayMessage(Common::DisplayMessage::ERROR, F("EEPROM Not Available"));
-            _flags.isFileOpen = false;
+            f.isOpen = false;
             return false;
         }
         break;
 
     case Common::StorageType::SERIAL_TRANSFER:
         // For serial transfer, we'll send data directly
-        _flags.isFileOpen = true;
-        _currentFileBytesWritten = 0; // Reset counter for new file
+        f.isOpen = true;
+        f.bytesWritten = 0; // Reset counter for new file
         _fileCounter++; // Increment counter for serial transfer files too
         return true;
 
     default:
-        _flags.isFileOpen = false;
+        f.isOpen = false;
         return false;
     }
 
-    _flags.isFileOpen = false;
+    f.isOpen = false;
     return false;
 }
 
-bool FileSystemManager::writeDataChunk(const Common::DataChunk &chunk) {
-    if (!_flags.isFileOpen) {
+bool FileSystemManager::writeDataChunk(const Common::DataChunk &chunk, uint8_t port) {
+    CaptureFile &f = _files[port];
+    if (!f.isOpen) {
         return false;
     }
 
@@ -399,29 +582,44 @@ bool FileSystemManager::writeDataChunk(const Common::DataChunk &chunk) {
 
     switch (_activeStorage.value) {
     case Common::StorageType::SD_CARD:
-        if (_currentFile) {
-
-            // Lock LPT port during SPI operations to prevent interference
-            _cachedParallelPortManager->lockPort();
-
-            size_t written = _currentFile.write(chunk.data, chunk.length);
-            _currentFile.flush(); // Ensure data is written
+        if (f.contiguous.isOpen() || f.file) {
+            Storage::SpiBus::Transaction bus(Storage::SpiBus::SD_CARD);
+            const unsigned long now = millis();
+            if (f.bytesWritten == f.committedBytes) {
+                f.uncommittedSince = now;
+            }
 
-            // Unlock LPT port
-            _cachedParallelPortManager->unlockPort();
+            // Capture continues into the ring buffer while the card is busy. Extents take
+            // whole blocks into the open multi-block write, without FAT or directory updates
+            size_t written;
+            if (f.contiguous.isOpen()) {
+                written = f.contiguous.write(chunk.data, chunk.length);
+            } else {
+                written = f.file.write(chunk.data, chunk.length);
+            }
 
             if (written == chunk.length) {
                 _totalBytesWritten += chunk.length;
-                _currentFileBytesWritten += chunk.length;
+                f.bytesWritten += chunk.length;
                 success = true;
             }
+            f.crc = Storage::CaptureCatalog::crc16(f.crc, chunk.data, written);
+            if (commitDue(f, now)) {
+                commitFiles();
+            }
         }
+#ifdef DEVICEBRIDGE_CAPTURE_TRACE
+        // The trace grows with the first port's data; keep its ring from filling between update() calls
+        if (port == 0 && _flags.traceOpen) {
+            writeTrace(Common::CaptureTrace::WRITE_BLOCK);
+        }
+#endif
         break;
 
     case Common::StorageType::EEPROM:
         if (_eepromFileSystem.writeData(chunk.data, chunk.length)) {
             _totalBytesWritten += chunk.length;
-            _currentFileBytesWritten += chunk.length;
+            f.bytesWritten += chunk.length;
             success = true;
         } else {
             success = false;
@@ -431,7 +629,7 @@ bool FileSystemManager::writeDataChunk(const Common::DataChunk &chunk) {
     case Common::StorageType::SERIAL_TRANSFER:
         // TODO: Implement serial transfer
         _totalBytesWritten += chunk.length;
-        _currentFileBytesWritten += chunk.length;
+        f.bytesWritten += chunk.length;
         success = true;
         break;
 
@@ -446,20 +644,36 @@ bool FileSystemManager::writeDataChunk(const Common::DataChunk &chunk) {
     return success;
 }
 
-bool FileSystemManager::closeCurrentFile() {
-    if (!_flags.isFileOpen) {
+bool FileSystemManager::closeFile(uint8_t port) {
+    CaptureFile &f = _files[port];
+    if (!f.isOpen) {
         return true; // Already closed
     }
 
     bool result = true;
 
     switch (_activeStorage.value) {
-    case Common::StorageType::SD_CARD:
-        if (_currentFile) {
-            _currentFile.close();
+    case Common::StorageType::SD_CARD: {
+        Storage::SpiBus::Transaction bus(Storage::SpiBus::SD_CARD);
+        if (f.contiguous.isOpen() && f.contiguous.size() == Common::FileSystem::EXTENT_BYTES &&
+            f.committedBytes != f.bytesWritten) {
+            // Nothing to truncate, so the size would still read as reserved: journal the final one
+            f.committedBytes = f.bytesWritten;
+            recordCommits();
+        }
+        if (f.contiguous.isOpen()) {
+            result = f.contiguous.close(); // Truncated to the bytes written
+            _fileCounter++;
+        } else if (f.file) {
+            f.file.close();
             _fileCounter++; // Increment counter for successful SD card file
         }
+        if (result) {
+            Storage::CaptureCatalog::append(f.filename, f.bytesWritten, (uint8_t)f.detectedType.value, f.crc,
+                                            _cachedTimeManager->getTimestamp());
+        }
         break;
+    }
 
     case Common::StorageType::EEPROM:
         result = _eepromFileSystem.closeFile();
@@ -473,28 +687,112 @@ bool FileSystemManager::closeCurrentFile() {
         break;
     }
 
-    _flags.isFileOpen = false;
+    f.isOpen = false;
     
     // Clear any error signals to TDS2024 on successful file closure
-    // Use cached parallel port manager pointer
-        _cachedParallelPortManager->setPrinterError(false);   // Clear ERROR signal
-        _cachedParallelPortManager->setPrinterPaperOut(false); // Clear PAPER_OUT signal
+    ParallelPortManager *portManager = this->portManager(port);
+    portManager->setPrinterError(false);   // Clear ERROR signal
+    portManager->setPrinterPaperOut(false); // Clear PAPER_OUT signal
     
-    // Notify display manager that storage operation is ending
+    // Notify display manager once the last open file has closed
     // Use cached display manager pointer
-    _cachedDisplayManager->setStorageOperationActive(false);
+    if (!isAnyFileOpen()) {
+        _cachedDisplayManager->setStorageOperationActive(false);
+    }
     
     return result;
 }
 
+void FileSystemManager::setCommitPolicy(CommitPolicy policy, uint16_t value) {
+    _commitPolicy = policy;
+    _commitValue = value;
+}
+
+bool FileSystemManager::commitDue(const CaptureFile &f, unsigned long now) const {
+    if (!f.isOpen || f.bytesWritten == f.committedBytes) {
+        return false;
+    }
+    switch (_commitPolicy) {
+    case CommitPolicy::BYTES:
+        return f.bytesWritten - f.committedBytes >= (uint32_t)_commitValue * 1024;
+    case CommitPolicy::INTERVAL:
+        return now - f.uncommittedSince >= _commitValue;
+    default:
+        return false;
+    }
+}
+
+bool FileSystemManager::commitFiles() {
+    // Group commit: every open file at once, one journal block for all of them.
+    // Extent tails go to the card first; the library's flushes follow the multi-block write
+    Storage::SpiBus::Transaction bus(Storage::SpiBus::SD_CARD);
+    bool result = !Storage::ContiguousFile::isReady() || Storage::ContiguousFile::endStream();
+    bool journaled = false;
+    for (CaptureFile &f : _files) {
+        if (!f.isOpen) {
+            continue;
+        }
+        if (f.contiguous.isOpen()) {
+            result = f.contiguous.sync() && result; // Past the extent: FAT chain and directory entry
+            journaled = true;
+        } else if (f.file) {
+            f.file.flush(); // Directory entry and FAT
+        }
+        f.committedBytes = f.bytesWritten;
+    }
+    _commits++;
+    return (!journaled || recordCommits()) && result;
+}
+
+bool FileSystemManager::recordCommits(uint8_t creatingPort) {
+    if (!Storage::CommitJournal::isReady()) {
+        return true;
+    }
+    Storage::CommitJournal::Entry entries[Common::ParallelPorts::COUNT];
+    uint8_t count = 0;
+    for (uint8_t port = 0; port < Common::ParallelPorts::COUNT; port++) {
+        const CaptureFile &f = _files[port];
+        // The library's files commit through their directory entry
+        if (!f.contiguous.isOpen() && port != creatingPort) {
+            continue;
+        }
+        entries[count].size = f.committedBytes;
+        entries[count].reserved = Common::FileSystem::EXTENT_BYTES;
+        strncpy(entries[count].path, f.filename, sizeof(entries[count].path));
+        entries[count].path[sizeof(entries[count].path) - 1] = '\0';
+        count++;
+    }
+    return Storage::CommitJournal::record(entries, count);
+}
+
+bool FileSystemManager::closeAllFiles() {
+    bool result = true;
+    for (uint8_t port = 0; port < Common::ParallelPorts::COUNT; port++) {
+        result = closeFile(port) && result;
+    }
+    return result;
+}
+
+bool FileSystemManager::isAnyFileOpen() const {
+    for (const CaptureFile &f : _files) {
+        if (f.isOpen) {
+            return true;
+        }
+    }
+    return false;
+}
+
+ParallelPortManager *FileSystemManager::portManager(uint8_t port) const {
+    // The first port's manager is cached; the others are looked up
+    return port == 0 ? _cachedParallelPortManager : getServices().getParallelPortManager(port);
+}
+
 void FileSystemManager::generateFilename(char *buffer, size_t bufferSize) {
     // Use same timestamp-based filename format for all storage types
-    generateTimestampFilename(buffer, bufferSize);
+    generateTimestampFilename(buffer, bufferSize, getFileExtension());
 }
 
-void FileSystemManager::generateTimestampFilename(char *buffer, size_t bufferSize) {
-    const char *extension = getFileExtension();
-
+void FileSystemManager::generateTimestampFilename(char *buffer, size_t bufferSize, const char *extension) {
     // Use ServiceLocator to get TimeManager safely
     // Use cached time manager pointer
 
@@ -502,16 +800,65 @@ void FileSystemManager::generateTimestampFilename(char *buffer, size_t bufferSiz
         // Get formatted datetime and parse it for compact format
         auto rtc = _cachedTimeManager->getRTC();
         auto now = rtc.now();
-        snprintf(buffer, bufferSize, "%04d%02d%02d/%02d%02d%02d%s", now.year(), now.month(), now.day(), now.hour(),
-                 now.minute(), now.second(), extension);
+        // Jobs split by /INIT can start within the same second; the repeats are
+        // numbered from RAM rather than probed on the card (skipTakenNames())
+        const uint8_t repeat = nextNameRepeat(now.unixtime());
+        if (repeat) {
+            snprintf(buffer, bufferSize, "%04d%02d%02d/%02d%02d%02d%02u%s", now.year(), now.month(), now.day(),
+                     now.hour(), now.minute(), now.second(), repeat, extension);
+        } else {
+            snprintf(buffer, bufferSize, "%04d%02d%02d/%02d%02d%02d%s", now.year(), now.month(), now.day(),
+                     now.hour(), now.minute(), now.second(), extension);
+        }
     } else {
-        // Fallback to millis-based timestamp if no RTC
-        snprintf(buffer, bufferSize, "DAT%lu%s", millis(), extension);
+        // Fallback to millis-based timestamp if no RTC; ports can open files in the same millisecond
+        const unsigned long now = millis();
+        const uint8_t repeat = nextNameRepeat(now);
+        if (repeat) {
+            snprintf(buffer, bufferSize, "DAT%lu_%02u%s", now, repeat, extension);
+        } else {
+            snprintf(buffer, bufferSize, "DAT%lu%s", now, extension);
+        }
+    }
+}
+
+uint8_t FileSystemManager::nextNameRepeat(uint32_t time) {
+    if (time == _lastNameTime && _lastNameRepeat < 99) {
+        return ++_lastNameRepeat;
     }
+    _lastNameTime = time;
+    _lastNameRepeat = 0;
+    return 0;
+}
+
+bool FileSystemManager::skipTakenNames(char *buffer, size_t bufferSize, const char *extension) {
+    bool renamed = false;
+    for (uint8_t attempt = 0; attempt < 100 && SD.exists(buffer); attempt++) {
+        generateTimestampFilename(buffer, bufferSize, extension);
+        renamed = true;
+    }
+    // A new name can fall in the next day
+    if (renamed && !createParentDirectory(buffer)) {
+        const char *slash = strrchr(buffer, '/');
+        memmove(buffer, slash + 1, strlen(slash + 1) + 1);
+    }
+    return renamed;
 }
 
 const char *FileSystemManager::getFileExtension() const { return _fileType.getFileExtension(); }
 
+void FileSystemManager::generateCaptureRecordPath(char *buffer, size_t bufferSize, uint8_t port) const {
+    // "/20250101/120000.bin" -> "/20250101/120000.cap"
+    snprintf(buffer, bufferSize, "/%s", _files[port].filename);
+    char *slash = strrchr(buffer, '/');
+    char *dot = strrchr(slash, '.');
+    if (dot) {
+        *dot = '\0';
+    }
+    size_t length = strlen(buffer);
+    snprintf(buffer + length, bufferSize - length, "%s", Common::FileSystem::CAPTURE_RECORD_EXTENSION);
+}
+
 void FileSystemManager::sendDisplayMessage(Common::DisplayMessage::Type type, const char *message) {
     // Use cached display manager pointer
     _cachedDisplayManager->displayMessage(type, message);
@@ -531,7 +878,7 @@ void FileSystemManager::setStorageType(Common::StorageType type) {
             Serial.print(F("\r\n"));
         } else {
             // Fallback to legacy method for compatibility
-            closeCurrentFile(); // Close any open file before switching
+            closeAllFiles(); // Close any open files before switching
             _activeStorage.value = type.value;
 
             // Verify the new storage type is available
@@ -599,36 +946,8 @@ uint32_t FileSystemManager::getSDCardFileCount() const {
     if (!_flags.sdAvailable) {
         return 0;
     }
-
-    return countFilesRecursive("/");
-}
-
-uint32_t FileSystemManager::countFilesRecursive(const char* dirPath) const {
-    uint32_t fileCount = 0;
-    File dir = SD.open(dirPath);
-
-    if (!dir) {
-        return 0;
-    }
-
-    // Count all files and recurse into subdirectories
-    while (true) {
-        File entry = dir.openNextFile();
-        if (!entry) {
-            break; // No more files
-        }
-
-        if (entry.isDirectory()) {
-            // Recurse into subdirectory
-            fileCount += countFilesRecursive(entry.name());
-        } else {
-            fileCount++;
-        }
-        entry.close();
-    }
-
-    dir.close();
-    return fileCount;
+    // Kept by the catalog: no directory walk
+    return Storage::CaptureCatalog::count();
 }
 
 bool FileSystemManager::isSDCardPresent() const {
@@ -769,6 +1088,112 @@ unsigned long FileSystemManager::getUpdateInterval() const {
     return _cachedConfigurationService->getFileSystemInterval(); // Default 10ms
 }
 
+bool FileSystemManager::createParentDirectory(const char *path) {
+    // "20250101/120000.trc" -> "20250101"
+    const char *slash = strrchr(path, '/');
+    if (!slash || slash == path) {
+        return true;
+    }
+    const size_t length = (size_t)(slash - path);
+    if (length < sizeof(_dayDirectory) && memcmp(path, _dayDirectory, length) == 0 && _dayDirectory[length] == '\0') {
+        return true;
+    }
+    char directory[Common::Limits::MAX_FILENAME_LENGTH];
+    const size_t copied = length < sizeof(directory) - 1 ? length : sizeof(directory) - 1;
+    memcpy(directory, path, copied);
+    directory[copied] = '\0';
+    if (!SD.exists(directory) && !SD.mkdir(directory)) {
+        return false;
+    }
+    // Directories are never removed while the card is in
+    if (copied < sizeof(_dayDirectory)) {
+        memcpy(_dayDirectory, directory, copied + 1);
+    }
+    return true;
+}
+
+bool FileSystemManager::startTrace() {
+#ifndef DEVICEBRIDGE_CAPTURE_TRACE
+    return false;
+#else
+    if (!_flags.sdAvailable) {
+        return false;
+    }
+    stopTrace();
+    Storage::ContiguousFile::endStream();
+
+    generateTimestampFilename(_traceFilename, sizeof(_traceFilename), Common::CaptureTrace::EXTENSION);
+    if (!createParentDirectory(_traceFilename)) {
+        return false;
+    }
+    skipTakenNames(_traceFilename, sizeof(_traceFilename), Common::CaptureTrace::EXTENSION);
+    _traceFile = SD.open(_traceFilename, FILE_WRITE);
+    if (!_traceFile) {
+        return false;
+    }
+
+    uint8_t header[Parallel::CaptureTrace::HEADER_SIZE];
+    Parallel::CaptureTrace::writeHeader(header);
+    _traceBytesWritten = _traceFile.write(header, sizeof(header));
+    _flags.traceOpen = 1;
+    Parallel::CaptureTrace::start();
+    return true;
+#endif
+}
+
+bool FileSystemManager::stopTrace() {
+#ifndef DEVICEBRIDGE_CAPTURE_TRACE
+    return false;
+#else
+    if (!_flags.traceOpen) {
+        return false;
+    }
+    Parallel::CaptureTrace::stop();
+    Storage::ContiguousFile::endStream();
+    bool result = writeTrace(1);
+    _traceFile.close();
+    _flags.traceOpen = 0;
+    return result;
+#endif
+}
+
+const char *FileSystemManager::getTraceFilename() const {
+#ifdef DEVICEBRIDGE_CAPTURE_TRACE
+    return _traceFilename;
+#else
+    return "";
+#endif
+}
+
+uint32_t FileSystemManager::getTraceBytesWritten() const {
+#ifdef DEVICEBRIDGE_CAPTURE_TRACE
+    return _traceBytesWritten;
+#else
+    return 0;
+#endif
+}
+
+#ifdef DEVICEBRIDGE_CAPTURE_TRACE
+bool FileSystemManager::writeTrace(uint16_t minimum) {
+    Parallel::CaptureTrace::Ring &ring = Parallel::CaptureTrace::ring();
+    Parallel::CaptureTrace::Ring::Span first, second;
+    const uint16_t count = ring.peek(first, second);
+    if (count == 0 || count < minimum) {
+        return true;
+    }
+    Storage::ContiguousFile::endStream();
+
+    // Records straight from the ring; the ISR keeps appending behind them
+    size_t written = _traceFile.write(first.data, first.length);
+    if (second.length) {
+        written += _traceFile.write(second.data, second.length);
+    }
+    ring.consume(count);
+    _traceBytesWritten += written;
+    return written == count;
+}
+#endif
+
 // Hot-swap detection methods
 bool FileSystemManager::checkSDCardPresence() {
     // Use SD Card Detect pin (active LOW)
@@ -804,11 +1229,17 @@ void FileSystemManager::handleSDCardInsertion() {
 void FileSystemManager::handleSDCardRemoval() {
     Serial.print(F("SD Card removed\r\n"));
     
-    // Close any open file on SD card
-    if (_flags.isFileOpen && _activeStorage.value == Common::StorageType::SD_CARD) {
-        closeCurrentFile();
-        Serial.print(F("Closed file due to SD card removal\r\n"));
+    // The card is gone: nothing more goes over the bus for the open extents
+    Storage::ContiguousFile::end();
+    Storage::CaptureCatalog::unmount();
+    _dayDirectory[0] = '\0';
+
+    // Close any open files on SD card
+    if (isAnyFileOpen() && _activeStorage.value == Common::StorageType::SD_CARD) {
+        closeAllFiles();
+        Serial.print(F("Closed files due to SD card removal\r\n"));
     }
+    stopTrace();
     
     _flags.sdAvailable = false;
     sendDisplayMessage(Common::DisplayMessage::ERROR, F("SD Card Removed"));
@@ -8,6 +8,9 @@
 #include "../Common/ServiceLocator.h"
 #include "../Storage/IFileSystem.h"
 #include "../Storage/SDCardFileSystem.h"
+#include "../Storage/ContiguousFile.h"
+#include "../Storage/CommitJournal.h"
+#include "../Storage/CaptureCatalog.h"
 #include "../Storage/EEPROMFileSystem.h"
 #include "../Storage/SerialTransferFileSystem.h"
 
@@ -19,6 +22,14 @@ class TimeManager;
 class ParallelPortManager;
 
 class FileSystemManager : public DeviceBridge::IComponent {
+public:
+    // When data written to SD is committed: on the card, directory/FAT or commit journal up to date
+    enum class CommitPolicy : uint8_t {
+        BYTES,     // every N KB written (0 = every chunk)
+        INTERVAL,  // once the oldest uncommitted byte is N ms old
+        CLOSE      // only when the file is closed
+    };
+
 private:
     // Note: No longer storing direct references - using ServiceLocator
     
@@ -29,19 +40,70 @@ private:
     Storage::IFileSystem* _activeFileSystem;
     
     // Legacy compatibility (to be removed)
-    File _currentFile;
     W25Q128Manager _eeprom;
     
+    // One capture file per parallel port, all on the active storage
+    struct CaptureFile {
+        Storage::ContiguousFile contiguous;  // SD: pre-allocated extent, multi-block writes
+        File file;                           // SD without a free extent, through the library
+        char filename[Common::Limits::MAX_FILENAME_LENGTH];
+        uint32_t bytesWritten;
+        uint32_t committedBytes;               // Survives a power loss (CommitJournal)
+        uint32_t uncommittedSince;             // millis() of the first write after the last commit
+        uint16_t crc;                          // Of the bytes written, for the capture catalog
+        Common::CaptureStatistics statistics;  // Last file handed off by the port's ParallelPortManager
+        Common::FileType detectedType{Common::FileType::AUTO_DETECT}; // Auto-detected (if auto-detection enabled)
+        uint8_t isOpen : 1;
+        uint8_t statisticsPending : 1;         // statistics not yet written for the open file
+        uint8_t errorSent : 1;                 // "No File Open" shown for this file already
+    };
+    CaptureFile _files[Common::ParallelPorts::COUNT];
+    
+#ifdef DEVICEBRIDGE_CAPTURE_TRACE
+    // Capture trace of the first port (startTrace()), always on SD
+    File _traceFile;
+    char _traceFilename[Common::Limits::MAX_FILENAME_LENGTH];
+    uint32_t _traceBytesWritten;
+    bool writeTrace(uint16_t minimum);
+#endif
+    
+    // Commit policy for SD capture files (setCommitPolicy())
+    CommitPolicy _commitPolicy;
+    uint16_t _commitValue;      // KB for BYTES, ms for INTERVAL
+    uint32_t _commits;
+    uint8_t _recoveredFiles;    // Cut back to their last commit when the card was mounted
+    bool commitDue(const CaptureFile& f, unsigned long now) const;
+    bool commitFiles();
+    bool recordCommits(uint8_t creatingPort = 0xFF);
+    
+    // Storage turns between ports (claimStorageTurn())
+    uint8_t _lastStoragePort;   // Port that wrote the last chunk
+    uint32_t _storageYields;
+    
+    // createNewFile() on SD, from naming the file to its open
+    uint16_t _fileOpens;
+    uint32_t _fileOpenUsTotal;
+    uint32_t _fileOpenUsMax;
+    
+    // File naming without card lookups (generateTimestampFilename(), createParentDirectory())
+    char _dayDirectory[9];      // "20250101" known to exist; empty until looked up
+    uint32_t _lastNameTime;     // RTC second or millis() of the last name
+    uint8_t _lastNameRepeat;    // Names already given in that second
+    uint8_t nextNameRepeat(uint32_t time);
+    bool skipTakenNames(char* buffer, size_t bufferSize, const char* extension);
+    
     // Storage status (bit field optimization)
     struct {
         uint8_t sdAvailable : 1;
         uint8_t eepromAvailable : 1;
         uint8_t lastSDCardDetectState : 1;
-        uint8_t isFileOpen : 1;
-        uint8_t reserved : 4;  // For future flags
+        uint8_t writeLedOn : 1;  // L2 flash waiting for update() to end it
+        uint8_t traceOpen : 1;  // startTrace() file on SD
+        uint8_t reserved : 3;  // For future flags
     } _flags;
     
     uint32_t _lastSDCardCheckTime;
+    uint32_t _writeLedOnTime;
     
     // EEPROM file management
     uint32_t _eepromCurrentAddress;
@@ -52,15 +114,17 @@ private:
     
     // File management
     uint32_t _fileCounter;
-    char _currentFilename[Common::Limits::MAX_FILENAME_LENGTH];
     Common::FileType _fileType;          // Requested/configured file type
-    Common::FileType _detectedFileType;  // Auto-detected file type (if auto-detection enabled)
     
     // Storage operations (legacy)
     bool initializeSD();
     bool initializeEEPROM();
-    bool writeDataChunk(const Common::DataChunk& chunk);
-    bool closeCurrentFile();
+    bool writeDataChunk(const Common::DataChunk& chunk, uint8_t port);
+    bool closeFile(uint8_t port);
+    bool closeAllFiles();
+    bool writeCaptureRecord(uint8_t port);
+    bool isAnyFileOpen() const;
+    ParallelPortManager* portManager(uint8_t port) const;
     
     // Modular storage operations
     bool initializeFileSystem();
@@ -79,7 +143,9 @@ private:
     
     // File naming
     void generateFilename(char* buffer, size_t bufferSize);
-    void generateTimestampFilename(char* buffer, size_t bufferSize);
+    void generateTimestampFilename(char* buffer, size_t bufferSize, const char* extension);
+    bool createParentDirectory(const char* path);
+    void generateCaptureRecordPath(char* buffer, size_t bufferSize, uint8_t port) const;
     const char* getFileExtension() const;
     
     // File type detection
@@ -89,7 +155,7 @@ public:
     FileSystemManager();
     ~FileSystemManager();
     
-    bool createNewFile();
+    bool createNewFile(uint8_t port = 0);
     
     // Lifecycle management (IComponent interface)
     bool initialize() override final;
@@ -103,28 +169,56 @@ public:
     void printDependencyStatus() const override final;
     unsigned long getUpdateInterval() const override final;
     
-    // Data processing (called by ParallelPortManager)
-    void processDataChunk(const Common::DataChunk& chunk);
+    // Data processing (called by each port's ParallelPortManager)
+    void processDataChunk(const Common::DataChunk& chunk, uint8_t port = 0);
+    // Accounting for the open file, written as a sidecar record when its end-of-file chunk arrives
+    void setCaptureStatistics(const Common::CaptureStatistics& stats, uint8_t port = 0);
+    const Common::CaptureStatistics& getCaptureStatistics(uint8_t port = 0) const { return _files[port].statistics; }
+    
+    // Ports share the storage one chunk at a time: a port that wrote the last chunk
+    // lets another port with chunks queued go first (once)
+    bool claimStorageTurn(uint8_t port);
+    // The SD card is programming a streamed block: a write now would wait for it
+    bool isStorageBusy() const;
+    uint32_t getStorageYields() const { return _storageYields; }
+    uint16_t getFileOpenCount() const { return _fileOpens; }
+    uint32_t getFileOpenMeanUs() const { return _fileOpens ? _fileOpenUsTotal / _fileOpens : 0; }
+    uint32_t getFileOpenMaxUs() const { return _fileOpenUsMax; }
+    
+    // Strobe timing and data of the first port as a .trc file on SD (Parallel::CaptureTrace);
+    // false unless built with DEVICEBRIDGE_CAPTURE_TRACE and a card is present
+    bool startTrace();
+    bool stopTrace();
+    bool isTraceOpen() const { return _flags.traceOpen; }
+    const char* getTraceFilename() const;
+    uint32_t getTraceBytesWritten() const;
     
     // Configuration
     void setPreferredStorage(Common::StorageType storage) { _preferredStorage.value = storage.value; }
     void setStorageType(Common::StorageType type);
     void setFileType(Common::FileType type) { _fileType.value = type.value; }
+    void setCommitPolicy(CommitPolicy policy, uint16_t value);
+    CommitPolicy getCommitPolicy() const { return _commitPolicy; }
+    uint16_t getCommitValue() const { return _commitValue; }
+    uint32_t getCommitCount() const { return _commits; }
+    uint8_t getRecoveredFiles() const { return _recoveredFiles; }
+    bool isCommitJournalReady() const { return Storage::CommitJournal::isReady(); }
     
     // Status inquiry
     Common::StorageType getActiveStorage() const { return _activeStorage; }
     Common::StorageType getCurrentStorageType() const { return _activeStorage; }  // Alias for serial interface
     Common::FileType getFileType() const { return _fileType; }
-    Common::FileType getDetectedFileType() const { return _detectedFileType; }
+    Common::FileType getDetectedFileType(uint8_t port = 0) const { return _files[port].detectedType; }
     bool isSDAvailable() const { return _flags.sdAvailable; }
     bool isEEPROMAvailable() const { return _flags.eepromAvailable; }
     
     // Statistics
     uint32_t getFilesStored() const;  // Count files on SD card
-    uint32_t getSDCardFileCount() const;  // Explicitly count SD card files
-    const char* getCurrentFilename() const { return _currentFilename; }
+    uint32_t getSDCardFileCount() const;  // Capture files in the SD catalog
+    const char* getCurrentFilename(uint8_t port = 0) const { return _files[port].filename; }
     uint32_t getTotalBytesWritten() const { return _totalBytesWritten; }
-    uint32_t getCurrentFileBytesWritten() const { return _currentFileBytesWritten; }
+    uint32_t getCurrentFileBytesWritten(uint8_t port = 0) const { return _files[port].bytesWritten; }
+    bool isFileOpen(uint8_t port = 0) const { return _files[port].isOpen; }
     uint16_t getWriteErrors() const { return _writeErrors; }
     
     // Hardware status
@@ -136,11 +230,8 @@ public:
     bool formatEEPROM();
     
 private:
-    // Helper methods
-    uint32_t countFilesRecursive(const char* dirPath) const;
     // Statistics
     uint32_t _totalBytesWritten;      // Total bytes written across all files
-    uint32_t _currentFileBytesWritten; // Bytes written to current file
     uint16_t _writeErrors;
 };
 
@@ -3,6 +3,7 @@
 #include "DisplayManager.h"
 #include "SystemManager.h"
 #include "../Common/ConfigurationService.h"
+#include "../Parallel/OptimizedTiming.h"
 #include <string.h>
 
 // PROGMEM component name for memory optimization
@@ -16,14 +17,19 @@ namespace PerformanceConstants {
     static constexpr uint16_t MIN_CHUNK_SIZE = DeviceBridge::Common::Buffer::MIN_CHUNK_SIZE;
     static constexpr uint16_t DATA_CHUNK_SIZE = DeviceBridge::Common::Buffer::DATA_CHUNK_SIZE;
     static constexpr uint16_t KEEP_BUSY_MS = DeviceBridge::Common::Timing::KEEP_BUSY_MS;
+    static constexpr uint8_t CHUNK_QUEUE_DEPTH = DeviceBridge::Common::Buffer::CHUNK_QUEUE_DEPTH;
 }
 
 namespace DeviceBridge::Components {
 
-ParallelPortManager::ParallelPortManager(Parallel::Port &port)
-    : _port(port), _fileInProgress(false), _idleCounter(0), _lastDataTime(0), _chunkIndex(0), _chunkStartTime(0),
-      _totalBytesReceived(0), _filesReceived(0), _currentFileBytes(0) {
-    memset(&_currentChunk, 0, sizeof(_currentChunk));
+ParallelPortManager::ParallelPortManager(Parallel::Port &port, uint8_t portIndex)
+    : _port(port), _portIndex(portIndex), _fileInProgress(false), _idleCounter(0), _lastDataTime(0), _queueHead(0), _queueCount(0),
+      _chunkIndex(0), _chunkStartTime(0), _calibrator(port), _document(),
+      _documentEndEnabled(Common::DocumentEnd::DEFAULT_ENABLED), _documentsEnded(0), _drainMasked(false), _totalBytesReceived(0), _filesReceived(0), _currentFileBytes(0),
+      _fileStartTime(0), _queueHighWater(0), _chunksQueued(0), _chunksDelayed(0), _queueFullEvents(0), _queueFullMs(0),
+      _queueFullSince(0), _queueFull(false) {
+    memset(_chunkQueue, 0, sizeof(_chunkQueue));
+    memset(&_fileCounters, 0, sizeof(_fileCounters));
 }
 
 ParallelPortManager::~ParallelPortManager() { stop(); }
@@ -42,6 +48,7 @@ bool ParallelPortManager::initialize() {
 
 void ParallelPortManager::update(unsigned long currentTime) { 
     processData(); 
+    _port.processPendingOperations();
     
     // Check for critical buffer timeout
     if (checkCriticalTimeout()) {
@@ -52,182 +59,368 @@ void ParallelPortManager::update(unsigned long currentTime) {
 void ParallelPortManager::stop() {
     _fileInProgress = false;
     _idleCounter = 0;
-    _chunkIndex = 0;
+    resetChunkQueue();
     _chunkStartTime = 0;
 }
 
 void ParallelPortManager::processData() {
+    // The host started a new job (or released the printer): close the file
+    // as soon as the bytes before the edge have been read
+    _port.pollJobSignals();
+    if (_port.atJobBoundary()) {
+        if (_fileInProgress) {
+            endFile();
+        }
+        _port.clearJobBoundary();
+    }
+
     bool hasData = _port.hasData();
 
     if (hasData) {
         _idleCounter = 0;
         _lastDataTime = millis();
+        readIntoChunkAndPoll();
+    } else {
+        _idleCounter++;
 
-        // Check for new file start - only set flag once per chunk
-        if (detectNewFile()) {
-            _currentChunk.isNewFile = 1;
-            _fileInProgress = true;
-            _currentFileBytes = 0;
-            _filesReceived++;
-            _chunkIndex = 0;
-            _chunkStartTime = millis(); // Start timing for first chunk
-            
-            // Debug logging for new file detection
-            if (_cachedSystemManager->isParallelDebugEnabled()) {
-                Serial.print(F("[DEBUG-LPT] NEW FILE DETECTED - File #"));
-                Serial.print(_filesReceived);
-                Serial.print(F(" started at "));
-                Serial.print(millis());
-                Serial.print(F("ms\r\n"));
-            }
+        // Check for end of file
+        if (detectEndOfFile()) {
+            // Bytes that arrived since hasData() are the next job's first; they stay in the ring for it
+            endFile();
+            return;
         }
-        // NOTE: Don't reset isNewFile to 0 here - let it persist until chunk is sent
+    }
 
-        // Read available data into current chunk
-        if (_chunkIndex < sizeof(_currentChunk.data)) {
-            // Start timing if this is the first data in a new chunk
-            if (_chunkIndex == 0 && _chunkStartTime == 0) {
-                _chunkStartTime = millis();
-            }
-            
-            // Turn on LPT read activity LED
-            digitalWrite(Common::Pins::LPT_READ_LED, HIGH);
+    // The format says the document is whole: no need to wait for the idle timeout
+    if (_fileInProgress && _documentEndEnabled && _document.isComplete()) {
+        _documentsEnded++;
+        endFile();
+        return;
+    }
 
-            uint16_t bytesToRead = sizeof(_currentChunk.data) - _chunkIndex;
-            uint16_t bytesRead = _port.readData(_currentChunk.data, _chunkIndex, bytesToRead);
+    // Commit at most one queued chunk per update (ports with chunks queued take turns),
+    // then move whatever the port captured during the storage write into the next free slot.
+    // While the card programs the last block the chunk stays queued and the drain above
+    // fills the next slot, instead of the write waiting for the card
+    if (_queueCount > 0 && !_cachedFileSystemManager->isStorageBusy() &&
+        _cachedFileSystemManager->claimStorageTurn(_portIndex) && commitNextChunk() && _port.hasData()) {
+        _lastDataTime = millis();
+        readIntoChunkAndPoll();
+    }
+}
 
-            if (bytesRead > 0) {
-                _chunkIndex += bytesRead;
-                _totalBytesReceived += bytesRead;
-                _currentFileBytes += bytesRead;
-                
-                // Debug logging for data reading
-                if (_cachedSystemManager->isParallelDebugEnabled()) {
-                    Serial.print(F("[DEBUG-LPT] Read "));
-                    Serial.print(bytesRead);
-                    Serial.print(F(" bytes, chunk: "));
-                    Serial.print(_chunkIndex);
-                    Serial.print(F("/"));
-                    Serial.print(sizeof(_currentChunk.data));
-                    Serial.print(F(", file: "));
-                    Serial.print(_currentFileBytes);
-                    Serial.print(F(" total"));
-                    
-                    // Control signal status
-                    Serial.print(F(" | Signals: /STR="));
-                    Serial.print(_port.isStrobeLow() ? F("ACT") : F("INA"));
-                    Serial.print(F(" /AF="));
-                    Serial.print(_port.isAutoFeedLow() ? F("ACT") : F("INA"));
-                    Serial.print(F(" /INI="));
-                    Serial.print(_port.isInitializeLow() ? F("ACT") : F("INA"));
-                    Serial.print(F(" /SEL="));
-                    Serial.print(_port.isSelectInLow() ? F("ACT") : F("INA"));
-                    
-                    // Byte tracking comparison (read vs written)
-                    Serial.print(F(" | Bytes: Read="));
-                    Serial.print(_currentFileBytes);
-                    Serial.print(F(" Written="));
-                    Serial.print(_cachedFileSystemManager->getCurrentFileBytesWritten());
-                    uint32_t difference = (_currentFileBytes > _cachedFileSystemManager->getCurrentFileBytesWritten()) ? 
-                        (_currentFileBytes - _cachedFileSystemManager->getCurrentFileBytesWritten()) : 
-                        (_cachedFileSystemManager->getCurrentFileBytesWritten() - _currentFileBytes);
-                    if (difference > 0) {
-                        Serial.print(F(" DIFF="));
-                        Serial.print(difference);
-                    }
-                    
-                    // Show hex dump of first N bytes for new files once we have enough data
-                    constexpr uint8_t headerBytes = PerformanceConstants::HEADER_HEX_BYTES;
-                    if (_currentFileBytes >= headerBytes && _currentChunk.isNewFile) {
-                        Serial.print(F(" - HEADER HEX: "));
-                        for (uint8_t i = 0; i < headerBytes; i++) {
-                            if (_currentChunk.data[i] < 0x10) Serial.print(F("0"));
-                            Serial.print(_currentChunk.data[i], HEX);
-                            if (i < headerBytes - 1) Serial.print(F(" "));
-                        }
-                    }
-                    Serial.print(F("\r\n"));
-                }
+void ParallelPortManager::endFile() {
+    // Chunks still queued belong before the end-of-file chunk
+    flushChunkQueue();
+    handOffFileStatistics();
 
-                // If chunk is full, send it immediately
-                if (_chunkIndex >= sizeof(_currentChunk.data)) {
-                    sendChunk();
-                } else if (shouldSendPartialChunk()) {
-                    // Send partial chunk if timeout reached and minimum size met
-                    sendChunk();
-                }
+    // Send final chunk with end-of-file marker FIRST; a document that fits one
+    // chunk still carries its new-file flag and is created, written and closed at once
+    Common::DataChunk &chunk = fillChunk();
+    chunk.isEndOfFile = 1;
+    chunk.length = _chunkIndex;  // Use actual data length, not 0
+    chunk.timestamp = millis();
+
+    _cachedFileSystemManager->processDataChunk(chunk, _portIndex);
+
+    // Debug logging for end of file detection AFTER final chunk is written
+    if (_cachedSystemManager->isParallelDebugEnabled()) {
+        Serial.print(F("[DEBUG-LPT] END OF FILE DETECTED - File #"));
+        Serial.print(_filesReceived);
+        Serial.print(F(", bytes read: "));
+        Serial.print(_currentFileBytes);
+        Serial.print(F(", bytes written: "));
+        Serial.print(_cachedFileSystemManager->getCurrentFileBytesWritten(_portIndex));
+        Serial.print(F(", idle cycles: "));
+        Serial.print(_idleCounter);
+        
+        // Check for data loss AFTER final write
+        if (_currentFileBytes != _cachedFileSystemManager->getCurrentFileBytesWritten(_portIndex)) {
+            Serial.print(F(" **DATA MISMATCH**"));
+        }
+        Serial.print(F("\r\n"));
+    }
+
+    _fileInProgress = false;
+    _idleCounter = 0;
+    _currentFileBytes = 0;
+    _chunkStartTime = 0;
+    resetChunkQueue();
+}
+
+void ParallelPortManager::readIntoChunkAndPoll() {
+    if (_calibrator.isActive()) {
+        // Calibration sessions take the traffic instead of polled capture; each masks interrupts itself
+        readIntoChunk();
+        if (_port.getBufferSize() < Common::FlowControl::RECOVERY_THRESHOLD) {
+            _calibrator.sample();
+        }
+        if (_calibrator.update()) {
+            const Parallel::HandshakeCalibrator::Status status = _calibrator.getStatus();
+            Serial.print(F("Calibration "));
+            Serial.print(status.sender);
+            if (status.state == Parallel::HandshakeCalibrator::State::DONE) {
+                Serial.print(F(" ✅ /ACK "));
+                Serial.print(status.bestUs);
+                Serial.print(F("us\r\n"));
+            } else {
+                Serial.print(F(" ❌ profile table full\r\n"));
             }
+        }
+        return;
+    }
+    
+    // A backlog in the ring means the host is streaming (or was held off by BUSY)
+    if (!_port.isPolledCaptureEnabled() || _port.getBufferSize() < Common::Timing::POLLED_ENTRY_BYTES) {
+        readIntoChunk();
+        return;
+    }
 
-            // Turn off LPT read activity LED
-            digitalWrite(Common::Pins::LPT_READ_LED, LOW);
+    // Polled capture: mask the strobe interrupt from the drain on, so the
+    // host resumes (once readData() releases BUSY) straight into the port's
+    // polling loop instead of one interrupt per byte starving this loop.
+    // The masked drain prints no debug output and counts against the
+    // session's POLLED_MAX_SESSION_US, so millis() still misses no overflow
+    const uint8_t sreg = SREG;
+    cli();
+    const uint8_t drainStart = TCNT0;
+    _drainMasked = true;
+    readIntoChunk();
+    _drainMasked = false;
+    if (_port.getBufferSize() < Common::FlowControl::RECOVERY_THRESHOLD) {
+        _port.pollCapture((uint8_t)(TCNT0 - drainStart));
+    }
+    SREG = sreg;
+}
+
+void ParallelPortManager::readIntoChunk() {
+    if (isChunkQueueFull()) {
+        return; // Every slot is waiting for storage - leave the data in the ring buffer
+    }
+    Common::DataChunk &chunk = fillChunk();
+
+    // Check for new file start - only set flag once per chunk
+    if (detectNewFile()) {
+        chunk.isNewFile = 1;
+        _fileInProgress = true;
+        _currentFileBytes = 0;
+        _filesReceived++;
+        _chunkIndex = 0;
+        _chunkStartTime = millis(); // Start timing for first chunk
+        _document.reset();
+        beginFileStatistics();
+        
+        // Debug logging for new file detection
+        if (!_drainMasked && _cachedSystemManager->isParallelDebugEnabled()) {
+            Serial.print(F("[DEBUG-LPT] NEW FILE DETECTED - File #"));
+            Serial.print(_filesReceived);
+            Serial.print(F(" started at "));
+            Serial.print(millis());
+            Serial.print(F("ms\r\n"));
         }
-    } else {
-        _idleCounter++;
+    }
+    // NOTE: Don't reset isNewFile to 0 here - let it persist until chunk is sent
 
-        // Check for end of file
-        if (detectEndOfFile()) {
-            // Send final chunk with end-of-file marker FIRST
-            _currentChunk.isEndOfFile = 1;
-            _currentChunk.isNewFile = 0;
-            _currentChunk.length = _chunkIndex;  // Use actual data length, not 0
-            _currentChunk.timestamp = millis();
-
-            _cachedFileSystemManager->processDataChunk(_currentChunk);
-
-            // Debug logging for end of file detection AFTER final chunk is written
-            if (_cachedSystemManager->isParallelDebugEnabled()) {
-                Serial.print(F("[DEBUG-LPT] END OF FILE DETECTED - File #"));
-                Serial.print(_filesReceived);
-                Serial.print(F(", bytes read: "));
+    // Read available data into current chunk
+    if (_chunkIndex < sizeof(chunk.data)) {
+        // Start timing if this is the first data in a new chunk
+        if (_chunkIndex == 0 && _chunkStartTime == 0) {
+            _chunkStartTime = millis();
+        }
+        
+        // Turn on LPT read activity LED
+        digitalWrite(Common::Pins::LPT_READ_LED, HIGH);
+
+        uint16_t bytesToRead = sizeof(chunk.data) - _chunkIndex;
+        uint16_t bytesRead;
+        if (_documentEndEnabled) {
+            // Bytes after the end of the document stay in the ring for the next file
+            bytesRead = _port.peekData(chunk.data, _chunkIndex, bytesToRead);
+            bytesRead = _document.feed(&chunk.data[_chunkIndex], bytesRead);
+            _port.releaseData(bytesRead);
+        } else {
+            bytesRead = _port.readData(chunk.data, _chunkIndex, bytesToRead);
+        }
+
+        if (bytesRead > 0) {
+            _chunkIndex += bytesRead;
+            _totalBytesReceived += bytesRead;
+            _currentFileBytes += bytesRead;
+            
+            // Debug logging for data reading
+            if (!_drainMasked && _cachedSystemManager->isParallelDebugEnabled()) {
+                Serial.print(F("[DEBUG-LPT] Read "));
+                Serial.print(bytesRead);
+                Serial.print(F(" bytes, chunk: "));
+                Serial.print(_chunkIndex);
+                Serial.print(F("/"));
+                Serial.print(sizeof(chunk.data));
+                Serial.print(F(", file: "));
                 Serial.print(_currentFileBytes);
-                Serial.print(F(", bytes written: "));
-                Serial.print(_cachedFileSystemManager->getCurrentFileBytesWritten());
-                Serial.print(F(", idle cycles: "));
-                Serial.print(_idleCounter);
+                Serial.print(F(" total"));
                 
-                // Check for data loss AFTER final write
-                if (_currentFileBytes != _cachedFileSystemManager->getCurrentFileBytesWritten()) {
-                    Serial.print(F(" **DATA MISMATCH**"));
+                // Control signal status
+                Serial.print(F(" | Signals: /STR="));
+                Serial.print(_port.isStrobeLow() ? F("ACT") : F("INA"));
+                Serial.print(F(" /AF="));
+                Serial.print(_port.isAutoFeedLow() ? F("ACT") : F("INA"));
+                Serial.print(F(" /INI="));
+                Serial.print(_port.isInitializeLow() ? F("ACT") : F("INA"));
+                Serial.print(F(" /SEL="));
+                Serial.print(_port.isSelectInLow() ? F("ACT") : F("INA"));
+                
+                // Byte tracking comparison (read vs written)
+                Serial.print(F(" | Bytes: Read="));
+                Serial.print(_currentFileBytes);
+                Serial.print(F(" Written="));
+                Serial.print(_cachedFileSystemManager->getCurrentFileBytesWritten(_portIndex));
+                uint32_t difference = (_currentFileBytes > _cachedFileSystemManager->getCurrentFileBytesWritten(_portIndex)) ? 
+                    (_currentFileBytes - _cachedFileSystemManager->getCurrentFileBytesWritten(_portIndex)) : 
+                    (_cachedFileSystemManager->getCurrentFileBytesWritten(_portIndex) - _currentFileBytes);
+                if (difference > 0) {
+                    Serial.print(F(" DIFF="));
+                    Serial.print(difference);
+                }
+                
+                // Show hex dump of first N bytes for new files once we have enough data
+                constexpr uint8_t headerBytes = PerformanceConstants::HEADER_HEX_BYTES;
+                if (_currentFileBytes >= headerBytes && chunk.isNewFile) {
+                    Serial.print(F(" - HEADER HEX: "));
+                    for (uint8_t i = 0; i < headerBytes; i++) {
+                        if (chunk.data[i] < 0x10) Serial.print(F("0"));
+                        Serial.print(chunk.data[i], HEX);
+                        if (i < headerBytes - 1) Serial.print(F(" "));
+                    }
                 }
                 Serial.print(F("\r\n"));
             }
 
-            _fileInProgress = false;
-            _idleCounter = 0;
-            _currentFileBytes = 0;
-            _chunkIndex = 0;
-            _chunkStartTime = 0;
-            
-            // Clear any remaining data in buffer to prevent corruption of next file
-            _port.clearBuffer();
+            // If chunk is full, send it immediately
+            if (_chunkIndex >= sizeof(chunk.data)) {
+                sendChunk();
+            } else if (shouldSendPartialChunk()) {
+                // Send partial chunk if timeout reached and minimum size met
+                sendChunk();
+            }
         }
+
+        // Turn off LPT read activity LED
+        digitalWrite(Common::Pins::LPT_READ_LED, LOW);
     }
 }
 
 void ParallelPortManager::sendChunk() {
-    _currentChunk.length = _chunkIndex;
-    _currentChunk.timestamp = millis();
-    _currentChunk.isEndOfFile = 0;
+    Common::DataChunk &chunk = fillChunk();
+    chunk.length = _chunkIndex;
+    chunk.timestamp = millis();
+    chunk.isEndOfFile = 0;
     
-    // Debug logging for chunk sending
-    if (_cachedSystemManager->isParallelDebugEnabled()) {
-        Serial.print(F("[DEBUG-LPT] SENDING CHUNK - Length: "));
+    // Debug logging for chunk queueing
+    if (!_drainMasked && _cachedSystemManager->isParallelDebugEnabled()) {
+        Serial.print(F("[DEBUG-LPT] QUEUEING CHUNK - Length: "));
         Serial.print(_chunkIndex);
         Serial.print(F(" bytes, new file: "));
-        Serial.print(_currentChunk.isNewFile ? F("YES") : F("NO"));
+        Serial.print(chunk.isNewFile ? F("YES") : F("NO"));
+        Serial.print(F(", queued: "));
+        Serial.print(_queueCount + 1);
+        Serial.print(F("/"));
+        Serial.print(PerformanceConstants::CHUNK_QUEUE_DEPTH);
         Serial.print(F(", timestamp: "));
-        Serial.print(_currentChunk.timestamp);
+        Serial.print(chunk.timestamp);
         Serial.print(F("\r\n"));
     }
 
-    _cachedFileSystemManager->processDataChunk(_currentChunk);
+    if (_queueCount > 0) {
+        _chunksDelayed++; // Has to wait for the chunk ahead of it
+    }
+    _queueCount++;
+    _chunksQueued++;
+    if (_queueCount > _queueHighWater) {
+        _queueHighWater = _queueCount;
+    }
 
-    // Reset chunk for next data - ONLY reset isNewFile after processing
+    // Start the next slot, unless every slot is now waiting for storage
     _chunkIndex = 0;
-    _currentChunk.isNewFile = 0;
+    if (isChunkQueueFull()) {
+        _queueFull = true;
+        _queueFullSince = millis();
+        _queueFullEvents++;
+    } else {
+        fillChunk().isNewFile = 0;
+        fillChunk().isEndOfFile = 0;
+    }
     _chunkStartTime = millis(); // Reset timing for next chunk
 }
 
+bool ParallelPortManager::commitNextChunk() {
+    if (_queueCount == 0) {
+        return false;
+    }
+
+    _cachedFileSystemManager->processDataChunk(_chunkQueue[_queueHead], _portIndex);
+
+    // A storage failure clears the buffer (and the queue) from inside processDataChunk()
+    if (_queueCount == 0) {
+        return true;
+    }
+
+    bool wasFull = isChunkQueueFull();
+    _queueHead = (_queueHead + 1) % PerformanceConstants::CHUNK_QUEUE_DEPTH;
+    _queueCount--;
+
+    if (wasFull) {
+        // The slot just committed becomes the fill slot
+        _queueFullMs += millis() - _queueFullSince;
+        _queueFull = false;
+        fillChunk().isNewFile = 0;
+        fillChunk().isEndOfFile = 0;
+    }
+    return true;
+}
+
+void ParallelPortManager::flushChunkQueue() {
+    while (commitNextChunk()) {
+    }
+}
+
+void ParallelPortManager::resetChunkQueue() {
+    if (_queueFull) {
+        _queueFullMs += millis() - _queueFullSince;
+        _queueFull = false;
+    }
+    _queueHead = 0;
+    _queueCount = 0;
+    _chunkIndex = 0;
+    _chunkQueue[0].isNewFile = 0;
+    _chunkQueue[0].isEndOfFile = 0;
+}
+
+void ParallelPortManager::beginFileStatistics() {
+    // Bytes already waiting in the ring are this file's first bytes
+    _port.getCaptureCounters(_fileCounters);
+    _fileCounters.captured -= _port.getBufferSize();
+    _fileStartTime = millis();
+}
+
+void ParallelPortManager::handOffFileStatistics() {
+    Parallel::Port::CaptureCounters now;
+    _port.getCaptureCounters(now);
+
+    Common::CaptureStatistics stats;
+    // Bytes still in the ring at a job boundary are the next file's
+    stats.bytesCaptured = now.captured - _port.getBufferSize() - _fileCounters.captured;
+    stats.bytesDelivered = _currentFileBytes;
+    stats.bytesDropped = now.dropped - _fileCounters.dropped;
+    stats.bytesDiscarded = now.discarded - _fileCounters.discarded;
+    stats.overflowEvents = now.overflowEvents - _fileCounters.overflowEvents;
+    for (uint8_t i = 0; i < 4; i++) {
+        stats.flowStateUs[i] = now.flowStateUs[i] - _fileCounters.flowStateUs[i];
+    }
+    stats.durationMs = _lastDataTime - _fileStartTime;
+
+    _cachedFileSystemManager->setCaptureStatistics(stats, _portIndex);
+}
+
 bool ParallelPortManager::shouldSendPartialChunk() const {
     // Don't send if no data collected yet
     if (_chunkIndex == 0) {
@@ -278,6 +471,27 @@ uint32_t ParallelPortManager::getTotalBytesReceived() const { return _totalBytes
 
 uint32_t ParallelPortManager::getFilesReceived() const { return _filesReceived; }
 
+ParallelPortManager::ChunkQueueStatistics ParallelPortManager::getChunkQueueStatistics() const {
+    ChunkQueueStatistics stats;
+    stats.depth = PerformanceConstants::CHUNK_QUEUE_DEPTH;
+    stats.queued = _queueCount;
+    stats.highWater = _queueHighWater;
+    stats.chunksQueued = _chunksQueued;
+    stats.chunksDelayed = _chunksDelayed;
+    stats.fullEvents = _queueFullEvents;
+    stats.timeFullMs = _queueFullMs + (_queueFull ? millis() - _queueFullSince : 0);
+    return stats;
+}
+
+void ParallelPortManager::resetChunkQueueStatistics() {
+    _queueHighWater = _queueCount;
+    _chunksQueued = 0;
+    _chunksDelayed = 0;
+    _queueFullEvents = 0;
+    _queueFullMs = 0;
+    _queueFullSince = millis();
+}
+
 uint32_t ParallelPortManager::getInterruptCount() const { return _port.getInterruptCount(); }
 
 uint32_t ParallelPortManager::getDataCount() const { return _port.getDataCount(); }
@@ -290,12 +504,6 @@ bool ParallelPortManager::isInitializeLow() { return _port.isInitializeLow(); }
 
 bool ParallelPortManager::isSelectInLow() { return _port.isSelectInLow(); }
 
-void ParallelPortManager::lockPort() { _port.lock(); }
-
-void ParallelPortManager::unlockPort() { _port.unlock(); }
-
-bool ParallelPortManager::isPortLocked() const { return _port.isLocked(); }
-
 void ParallelPortManager::setPrinterBusy(bool busy) { _port.setBusy(busy); }
 
 void ParallelPortManager::setPrinterError(bool error) { _port.setError(error); }
@@ -308,8 +516,8 @@ void ParallelPortManager::sendPrinterAcknowledge() { _port.sendAcknowledge(); }
 
 void ParallelPortManager::clearBuffer() { 
     _port.clearBuffer(); 
-    // Also reset internal state
-    _chunkIndex = 0;
+    // Also reset internal state (queued chunks are dropped with the buffer)
+    resetChunkQueue();
     _fileInProgress = false;
     _idleCounter = 0;
     _chunkStartTime = 0;
@@ -349,17 +557,24 @@ void ParallelPortManager::handleCriticalTimeout() {
     
     // 3. Close current file if open
     if (_fileInProgress) {
+        // Chunks already queued were captured intact - store them first
+        flushChunkQueue();
+
+        // The stalled ring never reaches the file; record it as discarded
+        _port.clearBuffer();
+        handOffFileStatistics();
+
         // Send end-of-file marker to properly close the file
         Common::DataChunk endChunk;
         memset(&endChunk, 0, sizeof(endChunk));
         endChunk.isEndOfFile = 1;
         endChunk.timestamp = millis();
         
-        _cachedFileSystemManager->processDataChunk(endChunk);
+        _cachedFileSystemManager->processDataChunk(endChunk, _portIndex);
         
         _fileInProgress = false;
         _currentFileBytes = 0;
-        _chunkIndex = 0;
+        resetChunkQueue();
         
         Serial.print(F("Current file forcibly closed\r\n"));
     }
@@ -468,6 +683,130 @@ DeviceBridge::Parallel::HardwareFlowControl::Statistics ParallelPortManager::get
     return _port.getFlowControlStatistics();
 }
 
+void ParallelPortManager::setFlowPredictionEnabled(bool enabled) {
+    _port.setFlowPredictionEnabled(enabled);
+}
+
+bool ParallelPortManager::isFlowPredictionEnabled() const {
+    return _port.isFlowPredictionEnabled();
+}
+
+DeviceBridge::Parallel::HardwareFlowControl::PredictionStatistics ParallelPortManager::getFlowPredictionStatistics() const {
+    return _port.getFlowPredictionStatistics();
+}
+
+bool ParallelPortManager::setTimedAcknowledgeEnabled(bool enabled, uint16_t pulseUs) {
+    return _port.setTimedAcknowledgeEnabled(enabled, pulseUs);
+}
+
+bool ParallelPortManager::isTimedAcknowledgeEnabled() const {
+    return _port.isTimedAcknowledgeEnabled();
+}
+
+uint16_t ParallelPortManager::getAcknowledgePulseUs() const {
+    return _port.getAcknowledgePulseUs();
+}
+
+bool ParallelPortManager::setBurstCaptureEnabled(bool enabled) {
+    return _port.setBurstCaptureEnabled(enabled);
+}
+
+bool ParallelPortManager::isBurstCaptureEnabled() const {
+    return _port.isBurstCaptureEnabled();
+}
+
+uint32_t ParallelPortManager::getBurstCaptureCount() const {
+    return _port.getBurstCaptureCount();
+}
+
+bool ParallelPortManager::setPolledCaptureEnabled(bool enabled) {
+    return _port.setPolledCaptureEnabled(enabled);
+}
+
+bool ParallelPortManager::isPolledCaptureEnabled() const {
+    return _port.isPolledCaptureEnabled();
+}
+
+Parallel::Port::PolledCaptureStatistics ParallelPortManager::getPolledCaptureStatistics() const {
+    return _port.getPolledCaptureStatistics();
+}
+
+void ParallelPortManager::resetPolledCaptureStatistics() {
+    _port.resetPolledCaptureStatistics();
+}
+
+void ParallelPortManager::setJobSignals(uint8_t signals) {
+    _port.setJobSignals(signals);
+}
+
+uint8_t ParallelPortManager::getJobSignals() const {
+    return _port.getJobSignals();
+}
+
+uint32_t ParallelPortManager::getJobBoundaryCount() const {
+    return _port.getJobBoundaryCount();
+}
+
+void ParallelPortManager::setDocumentEndEnabled(bool enabled) {
+    // The parser has to see a file from its first byte
+    if (enabled && !_documentEndEnabled && _fileInProgress) {
+        _document.abandon();
+    }
+    _documentEndEnabled = enabled;
+}
+
+bool ParallelPortManager::startCalibration(const char *sender) {
+    return _calibrator.begin(sender);
+}
+
+void ParallelPortManager::stopCalibration() {
+    _calibrator.cancel();
+}
+
+Parallel::HandshakeCalibrator::Status ParallelPortManager::getCalibrationStatus() const {
+    return _calibrator.getStatus();
+}
+
+const Parallel::TimingProfiles::Profile &ParallelPortManager::getCalibrationResult() const {
+    return _calibrator.getResult();
+}
+
+bool ParallelPortManager::useTimingProfile(const char *sender) {
+    Parallel::TimingProfiles::Profile profile;
+    if (_calibrator.isActive() || (sender != nullptr && !Parallel::TimingProfiles::find(sender, profile))) {
+        return false;
+    }
+    if (!Parallel::TimingProfiles::setActive(sender)) {
+        return false;
+    }
+    Parallel::OptimizedTiming::applyProfile(sender != nullptr ? &profile : nullptr);
+    return true;
+}
+
+bool ParallelPortManager::deleteTimingProfile(const char *sender) {
+    Parallel::TimingProfiles::Profile active;
+    const bool wasActive = Parallel::TimingProfiles::getActive(active) && strcasecmp(active.sender, sender) == 0;
+    if (_calibrator.isActive() || !Parallel::TimingProfiles::remove(sender)) {
+        return false;
+    }
+    if (wasActive) {
+        Parallel::OptimizedTiming::applyProfile(nullptr);
+    }
+    return true;
+}
+
+#ifdef DEVICEBRIDGE_ISR_STATS
+Parallel::IsrStats::Statistics ParallelPortManager::getIsrStatistics() const {
+    Parallel::IsrStats::Statistics stats;
+    Parallel::IsrStats::snapshot(stats);
+    return stats;
+}
+
+void ParallelPortManager::resetIsrStatistics() {
+    Parallel::IsrStats::reset();
+}
+#endif
+
 unsigned long ParallelPortManager::getUpdateInterval() const {
     return _cachedConfigurationService->getParallelInterval(); // Default 1ms for real-time
 }
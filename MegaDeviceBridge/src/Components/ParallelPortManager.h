@@ -3,6 +3,9 @@
 #include <Arduino.h>
 #include "../Parallel/Port.h"
 #include "../Parallel/HardwareFlowControl.h"
+#include "../Parallel/HandshakeCalibrator.h"
+#include "../Parallel/DocumentEnd.h"
+#include "../Parallel/IsrStats.h"
 #include "../Common/Types.h"
 #include "../Common/Config.h"
 #include "../Common/ServiceLocator.h"
@@ -16,6 +19,7 @@ class FileSystemManager;
 class ParallelPortManager : public DeviceBridge::IComponent {
 private:
     Parallel::Port& _port;
+    const uint8_t _portIndex;  // 0 = LPT_* pins, 1 = LPT2_*, 2 = LPT3_* (Common::ParallelPorts)
     // Note: No longer storing direct references - using ServiceLocator
     
     // File detection state
@@ -23,25 +27,49 @@ private:
     uint32_t _idleCounter;
     uint32_t _lastDataTime;
     
-    // Data buffer for loop-based processing
-    Common::DataChunk _currentChunk;
-    uint16_t _chunkIndex;
+    // Chunk queue: the slot after the queued ones fills from the port while
+    // queued chunks are committed to storage one per update
+    Common::DataChunk _chunkQueue[Common::Buffer::CHUNK_QUEUE_DEPTH];
+    uint8_t _queueHead;      // oldest chunk waiting for storage
+    uint8_t _queueCount;     // chunks waiting for storage
+    uint16_t _chunkIndex;    // fill position in the fill slot
     uint32_t _chunkStartTime;
     
+    // Per-sender /ACK timing calibration
+    Parallel::HandshakeCalibrator _calibrator;
+    
+    // Content-aware end of document: the file closes when its format says it is whole
+    Parallel::DocumentEnd _document;
+    bool _documentEndEnabled;
+    uint32_t _documentsEnded;
+    bool _drainMasked;       // polled capture's drain runs with interrupts masked: no debug output
+    
     // File boundary detection
     bool detectNewFile();
     bool detectEndOfFile();
+    void endFile();
     
     // Data processing
     void processData();
+    void readIntoChunk();
+    void readIntoChunkAndPoll();
     void sendChunk();
+    bool commitNextChunk();
+    void flushChunkQueue();
+    void resetChunkQueue();
+    Common::DataChunk &fillChunk() { return _chunkQueue[(_queueHead + _queueCount) % Common::Buffer::CHUNK_QUEUE_DEPTH]; }
+    bool isChunkQueueFull() const { return _queueCount >= Common::Buffer::CHUNK_QUEUE_DEPTH; }
     bool shouldSendPartialChunk() const;
     
     // Critical timeout handling
     void handleCriticalTimeout();
     
+    // Per-file capture accounting (Common::CaptureStatistics)
+    void beginFileStatistics();
+    void handOffFileStatistics();
+    
 public:
-    ParallelPortManager(Parallel::Port& port);
+    ParallelPortManager(Parallel::Port& port, uint8_t portIndex = 0);
     ~ParallelPortManager();
     
     // Lifecycle management (IComponent interface)
@@ -66,6 +94,20 @@ public:
     uint32_t getTotalBytesReceived() const;
     uint32_t getFilesReceived() const;
     
+    // Chunk queue backpressure statistics
+    struct ChunkQueueStatistics {
+        uint8_t depth;
+        uint8_t queued;           // chunks waiting for storage right now
+        uint8_t highWater;        // most chunks ever waiting at once
+        uint32_t chunksQueued;
+        uint32_t chunksDelayed;   // chunks that waited behind an earlier one
+        uint32_t fullEvents;      // times every slot was waiting for storage
+        uint32_t timeFullMs;      // total time with no slot free to fill
+    };
+    ChunkQueueStatistics getChunkQueueStatistics() const;
+    uint8_t getQueuedChunks() const { return _queueCount; }
+    void resetChunkQueueStatistics();
+    
     // Debug methods
     uint32_t getInterruptCount() const;
     uint32_t getDataCount() const;
@@ -76,11 +118,6 @@ public:
     bool isInitializeLow();
     bool isSelectInLow();
     
-    // LPT locking for SPI/Serial operations
-    void lockPort();
-    void unlockPort();
-    bool isPortLocked() const;
-    
     // Printer protocol test methods
     void setPrinterBusy(bool busy);
     void setPrinterError(bool error);
@@ -101,12 +138,69 @@ public:
     void setHardwareFlowControlEnabled(bool enabled);
     bool isHardwareFlowControlEnabled() const;
     DeviceBridge::Parallel::HardwareFlowControl::Statistics getFlowControlStatistics() const;
+    void setFlowPredictionEnabled(bool enabled);
+    bool isFlowPredictionEnabled() const;
+    DeviceBridge::Parallel::HardwareFlowControl::PredictionStatistics getFlowPredictionStatistics() const;
+    
+    // Timer-generated /ACK pulse
+    bool setTimedAcknowledgeEnabled(bool enabled, uint16_t pulseUs);
+    bool isTimedAcknowledgeEnabled() const;
+    uint16_t getAcknowledgePulseUs() const;
+    
+    // Burst capture
+    bool setBurstCaptureEnabled(bool enabled);
+    bool isBurstCaptureEnabled() const;
+    uint32_t getBurstCaptureCount() const;
+    
+    // Polled capture
+    bool setPolledCaptureEnabled(bool enabled);
+    bool isPolledCaptureEnabled() const;
+    Parallel::Port::PolledCaptureStatistics getPolledCaptureStatistics() const;
+    void resetPolledCaptureStatistics();
+    
+    // Job boundaries from /INIT and /SELECT-IN (Common::JobBoundary)
+    void setJobSignals(uint8_t signals);
+    uint8_t getJobSignals() const;
+    uint32_t getJobBoundaryCount() const;
+    
+    // Content-aware end of document (Parallel::DocumentEnd); off leaves only the idle timeout and job signals
+    void setDocumentEndEnabled(bool enabled);
+    bool isDocumentEndEnabled() const { return _documentEndEnabled; }
+    uint32_t getDocumentEndCount() const { return _documentsEnded; }
+    const Parallel::DocumentEnd &getDocumentEnd() const { return _document; }
+    
+    // Handshake calibration (TimingProfiles)
+    bool startCalibration(const char *sender);
+    void stopCalibration();
+    Parallel::HandshakeCalibrator::Status getCalibrationStatus() const;
+    const Parallel::TimingProfiles::Profile &getCalibrationResult() const;
+    bool useTimingProfile(const char *sender);     // nullptr = Config.h timings
+    bool deleteTimingProfile(const char *sender);
+    
+#ifdef DEVICEBRIDGE_ISR_STATS
+    // Optimized ISR timing
+    Parallel::IsrStats::Statistics getIsrStatistics() const;
+    void resetIsrStatistics();
+#endif
     
 private:
     // Statistics tracking
     uint32_t _totalBytesReceived;
     uint32_t _filesReceived;
     uint32_t _currentFileBytes;
+    
+    // Port counters when the current file started
+    Parallel::Port::CaptureCounters _fileCounters;
+    uint32_t _fileStartTime;
+    
+    // Chunk queue statistics
+    uint8_t _queueHighWater;
+    uint32_t _chunksQueued;
+    uint32_t _chunksDelayed;
+    uint32_t _queueFullEvents;
+    uint32_t _queueFullMs;
+    uint32_t _queueFullSince;
+    bool _queueFull;
 };
 
 } // namespace DeviceBridge::Components
\ No newline at end of file
@@ -14,6 +14,23 @@ static const char component_name[] PROGMEM = "SystemManager";
 extern int __heap_start;
 extern int *__brkval;
 
+#if defined(__AVR__)
+// Stack painting: before the constructors run, everything from the end of
+// .bss/.noinit to the top of SRAM gets a known byte; getStackHeadroom()
+// counts how much of it the heap and stack have left untouched since.
+static constexpr uint8_t STACK_PAINT = 0xC5;
+extern uint8_t _end;
+extern uint8_t __stack;
+
+void paintStack() __attribute__((naked, used, section(".init3")));
+void paintStack() {
+    // Nothing has been pushed yet; SP is still at __stack
+    for (uint8_t *p = &_end; p <= &__stack; p++) {
+        *p = STACK_PAINT;
+    }
+}
+#endif
+
 namespace DeviceBridge::Components {
 
 SystemManager::SystemManager()
@@ -242,6 +259,9 @@ void SystemManager::printMemoryInfo() {
     Serial.print(F("Free SRAM: "));
     Serial.print(freeRam());
     Serial.print(F(" bytes\r\n"));
+    Serial.print(F("Stack headroom: "));
+    Serial.print(getStackHeadroom());
+    Serial.print(F(" bytes never used since reset\r\n"));
 }
 
 uint16_t SystemManager::freeRam() {
@@ -254,6 +274,20 @@ uint16_t SystemManager::getFreeMemory() const {
     return (int)&v - (__brkval == 0 ? (int)&__heap_start : (int)__brkval);
 }
 
+uint16_t SystemManager::getStackHeadroom() const {
+#if defined(__AVR__)
+    const uint8_t *p = __brkval == 0 ? (const uint8_t *)&__heap_start : (const uint8_t *)__brkval;
+    uint16_t untouched = 0;
+    while (p <= &__stack && *p == STACK_PAINT) {
+        p++;
+        untouched++;
+    }
+    return untouched;
+#else
+    return 0;
+#endif
+}
+
 void SystemManager::validateHardware() {
     // Use cached display manager pointer
     // Use cached time manager pointer
@@ -70,6 +70,8 @@ public:
     uint16_t getErrorCount() const { return _errorCount; }
     uint32_t getCommandsProcessed() const { return _commandsProcessed; }
     uint16_t getFreeMemory() const;
+    /** Bytes above the heap the stack has never reached since reset (painted in .init3); 0 off the board */
+    uint16_t getStackHeadroom() const;
     
     // Statistics and monitoring
     void printSystemInfo();
@@ -1,6 +1,7 @@
 #include "W25Q128Manager.h"
 #include "../Common/ServiceLocator.h"
 #include "../Common/ConfigurationService.h"
+#include "../Storage/SpiBus.h"
 
 namespace DeviceBridge::Components {
 
@@ -22,11 +23,11 @@ bool W25Q128Manager::initialize() {
     
     // Configure CS pin
     Serial.print(F("W25Q128: Configuring CS pin as OUTPUT...\r\n"));
+    chipSelect(false); // Deselect before driving the pin, so it never pulses low
     pinMode(_csPin, OUTPUT);
-    chipSelect(false); // Deselect initially
     Serial.print(F("W25Q128: CS pin configured and deselected\r\n"));
     
-    // Initialize SPI (should already be done by main)
+    // Initialize SPI (already done by Storage::SpiBus::begin() in FileSystemManager)
     Serial.print(F("W25Q128: Initializing SPI...\r\n"));
     SPI.begin();
     Serial.print(F("W25Q128: SPI initialized\r\n"));
@@ -90,13 +91,18 @@ bool W25Q128Manager::initialize() {
 }
 
 void W25Q128Manager::chipSelect(bool select) {
-    digitalWrite(_csPin, select ? LOW : HIGH);
-    if (select) {
-        delayMicroseconds(1); // Small delay after CS assertion
+    // The W25Q128 needs 5ns from select to the first clock: no settling delay
+    if (_csPin != Common::Pins::EEPROM_CS) {
+        digitalWrite(_csPin, select ? LOW : HIGH);
+    } else if (select) {
+        Storage::SpiBus::selectFlash();
+    } else {
+        Storage::SpiBus::deselectFlash();
     }
 }
 
 uint8_t W25Q128Manager::readStatus() {
+    Storage::SpiBus::Transaction bus(Storage::SpiBus::FLASH);
     chipSelect(true);
     SPI.transfer(CMD_READ_STATUS1);
     uint8_t status = SPI.transfer(0x00);
@@ -111,18 +117,21 @@ void W25Q128Manager::waitForReady() {
 }
 
 void W25Q128Manager::writeEnable() {
+    Storage::SpiBus::Transaction bus(Storage::SpiBus::FLASH);
     chipSelect(true);
     SPI.transfer(CMD_WRITE_ENABLE);
     chipSelect(false);
 }
 
 void W25Q128Manager::writeDisable() {
+    Storage::SpiBus::Transaction bus(Storage::SpiBus::FLASH);
     chipSelect(true);
     SPI.transfer(CMD_WRITE_DISABLE);
     chipSelect(false);
 }
 
 uint32_t W25Q128Manager::readJedecId() {
+    Storage::SpiBus::Transaction bus(Storage::SpiBus::FLASH);
     chipSelect(true);
     SPI.transfer(CMD_JEDEC_ID);
     uint32_t id = 0;
@@ -146,14 +155,19 @@ bool W25Q128Manager::readData(uint32_t address, uint8_t* buffer, uint32_t length
     
     waitForReady();
     
+    Storage::SpiBus::Transaction bus(Storage::SpiBus::FLASH);
     chipSelect(true);
     SPI.transfer(CMD_READ_DATA);
     SPI.transfer((address >> 16) & 0xFF); // Address bits 23-16
     SPI.transfer((address >> 8) & 0xFF);  // Address bits 15-8
     SPI.transfer(address & 0xFF);         // Address bits 7-0
     
-    for (uint32_t i = 0; i < length; i++) {
-        buffer[i] = SPI.transfer(0x00);
+    // The flash ignores MOSI while it shifts data out: the buffer is clocked in place
+    while (length > 0) {
+        const uint16_t count = length > 0x8000 ? 0x8000 : (uint16_t)length;
+        SPI.transfer(buffer, count);
+        buffer += count;
+        length -= count;
     }
     
     chipSelect(false);
@@ -188,25 +202,31 @@ bool W25Q128Manager::writePage(uint32_t address, const uint8_t* buffer, uint32_t
     // Note: No mutex needed in loop-based architecture
     
     waitForReady();
-    writeEnable();
     
-    // Verify write enable was successful
-    uint8_t status = readStatus();
-    if (!(status & STATUS_WEL)) {
-        return false;
+    // Write enable, its check and the program go out in one bus claim
+    uint8_t status;
+    {
+        Storage::SpiBus::Transaction bus(Storage::SpiBus::FLASH);
+        writeEnable();
+        
+        // Verify write enable was successful
+        status = readStatus();
+        if (!(status & STATUS_WEL)) {
+            return false;
+        }
+        
+        chipSelect(true);
+        SPI.transfer(CMD_PAGE_PROGRAM);
+        SPI.transfer((address >> 16) & 0xFF); // Address bits 23-16
+        SPI.transfer((address >> 8) & 0xFF);  // Address bits 15-8
+        SPI.transfer(address & 0xFF);         // Address bits 7-0
+        
+        for (uint32_t i = 0; i < length; i++) {
+            SPI.transfer(buffer[i]);
+        }
+        
+        chipSelect(false);
     }
-    
-    chipSelect(true);
-    SPI.transfer(CMD_PAGE_PROGRAM);
-    SPI.transfer((address >> 16) & 0xFF); // Address bits 23-16
-    SPI.transfer((address >> 8) & 0xFF);  // Address bits 15-8
-    SPI.transfer(address & 0xFF);         // Address bits 7-0
-    
-    for (uint32_t i = 0; i < length; i++) {
-        SPI.transfer(buffer[i]);
-    }
-    
-    chipSelect(false);
     waitForReady();
     
     // Verify write was successful by checking status
@@ -241,21 +261,26 @@ bool W25Q128Manager::eraseSector(uint32_t address) {
     // Note: No mutex needed in loop-based architecture
     
     waitForReady();
-    writeEnable();
     
-    // Verify write enable was successful
-    uint8_t status = readStatus();
-    if (!(status & STATUS_WEL)) {
-        return false;
+    uint8_t status;
+    {
+        Storage::SpiBus::Transaction bus(Storage::SpiBus::FLASH);
+        writeEnable();
+        
+        // Verify write enable was successful
+        status = readStatus();
+        if (!(status & STATUS_WEL)) {
+            return false;
+        }
+        
+        chipSelect(true);
+        SPI.transfer(CMD_SECTOR_ERASE_4KB);
+        SPI.transfer((address >> 16) & 0xFF); // Address bits 23-16
+        SPI.transfer((address >> 8) & 0xFF);  // Address bits 15-8
+        SPI.transfer(address & 0xFF);         // Address bits 7-0
+        chipSelect(false);
     }
     
-    chipSelect(true);
-    SPI.transfer(CMD_SECTOR_ERASE_4KB);
-    SPI.transfer((address >> 16) & 0xFF); // Address bits 23-16
-    SPI.transfer((address >> 8) & 0xFF);  // Address bits 15-8
-    SPI.transfer(address & 0xFF);         // Address bits 7-0
-    chipSelect(false);
-    
     waitForReady(); // Sector erase can take up to 400ms
     
     // Verify erase was successful
@@ -280,14 +305,17 @@ bool W25Q128Manager::eraseBlock32K(uint32_t address) {
     // Note: No mutex needed in loop-based architecture
     
     waitForReady();
-    writeEnable();
-    
-    chipSelect(true);
-    SPI.transfer(CMD_BLOCK_ERASE_32KB);
-    SPI.transfer((address >> 16) & 0xFF);
-    SPI.transfer((address >> 8) & 0xFF);
-    SPI.transfer(address & 0xFF);
-    chipSelect(false);
+    {
+        Storage::SpiBus::Transaction bus(Storage::SpiBus::FLASH);
+        writeEnable();
+        
+        chipSelect(true);
+        SPI.transfer(CMD_BLOCK_ERASE_32KB);
+        SPI.transfer((address >> 16) & 0xFF);
+        SPI.transfer((address >> 8) & 0xFF);
+        SPI.transfer(address & 0xFF);
+        chipSelect(false);
+    }
     
     waitForReady(); // Block erase can take up to 1.6s
     
@@ -307,14 +335,17 @@ bool W25Q128Manager::eraseBlock64K(uint32_t address) {
     // Note: No mutex needed in loop-based architecture
     
     waitForReady();
-    writeEnable();
-    
-    chipSelect(true);
-    SPI.transfer(CMD_BLOCK_ERASE_64KB);
-    SPI.transfer((address >> 16) & 0xFF);
-    SPI.transfer((address >> 8) & 0xFF);
-    SPI.transfer(address & 0xFF);
-    chipSelect(false);
+    {
+        Storage::SpiBus::Transaction bus(Storage::SpiBus::FLASH);
+        writeEnable();
+        
+        chipSelect(true);
+        SPI.transfer(CMD_BLOCK_ERASE_64KB);
+        SPI.transfer((address >> 16) & 0xFF);
+        SPI.transfer((address >> 8) & 0xFF);
+        SPI.transfer(address & 0xFF);
+        chipSelect(false);
+    }
     
     waitForReady(); // Block erase can take up to 2s
     
@@ -331,11 +362,14 @@ bool W25Q128Manager::eraseChip() {
     // Note: No mutex needed in loop-based architecture
     
     waitForReady();
-    writeEnable();
-    
-    chipSelect(true);
-    SPI.transfer(CMD_CHIP_ERASE);
-    chipSelect(false);
+    {
+        Storage::SpiBus::Transaction bus(Storage::SpiBus::FLASH);
+        writeEnable();
+        
+        chipSelect(true);
+        SPI.transfer(CMD_CHIP_ERASE);
+        chipSelect(false);
+    }
     
     waitForReady(); // Chip erase can take up to 50s
     
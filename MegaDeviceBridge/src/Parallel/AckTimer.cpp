@@ -0,0 +1,89 @@
+#include <Arduino.h>
+#include <avr/interrupt.h>
+#include "AckTimer.h"
+#include "FastPin.h"
+
+namespace DeviceBridge::Parallel::AckTimer
+{
+  namespace
+  {
+    namespace Pins = Common::Pins;
+
+    volatile bool enabled = false;
+    volatile bool busyRelease = false;   // configured
+    volatile bool releasePending = false; // for the pulse in flight
+    volatile uint16_t pulseUs = Common::Timing::ACK_TIMER_PULSE_US;
+    volatile uint16_t pulseTicks = Common::Timing::ACK_TIMER_PULSE_US * TICKS_PER_US + 1;
+  }
+
+  void initialize(uint16_t width, bool releaseBusy)
+  {
+    setPulseWidthUs(width);
+    const uint8_t sreg = SREG;
+    cli();
+    busyRelease = releaseBusy;
+    TIMSK5 = 0;
+    TCCR5A = 0;               // normal mode, OC5x disconnected
+    TCCR5B = (1 << CS51);     // clk/8
+    TIFR5 = (1 << OCF5A);
+    enabled = true;
+    SREG = sreg;
+  }
+
+  void stop()
+  {
+    const uint8_t sreg = SREG;
+    cli();
+    enabled = false;
+    TIMSK5 &= ~(1 << OCIE5A);
+    TCCR5B = 0;
+    FastPin<Pins::LPT_ACK>::high();
+    releasePending = false;
+    SREG = sreg;
+  }
+
+  bool isEnabled() { return enabled; }
+
+  void setPulseWidthUs(uint16_t width)
+  {
+    if (width == 0) {
+      width = 1;
+    } else if (width > Common::Timing::ACK_TIMER_MAX_PULSE_US) {
+      width = Common::Timing::ACK_TIMER_MAX_PULSE_US;
+    }
+    const uint8_t sreg = SREG;
+    cli();
+    pulseUs = width;
+    pulseTicks = width * TICKS_PER_US + 1;
+    SREG = sreg;
+  }
+
+  uint16_t getPulseWidthUs() { return pulseUs; }
+
+  bool releasesBusy() { return busyRelease; }
+
+  void start(bool releaseBusy)
+  {
+    FastPin<Pins::LPT_ACK>::low();
+    releasePending = releaseBusy && busyRelease;
+    OCR5A = TCNT5 + pulseTicks;
+    TIFR5 = (1 << OCF5A); // drop a match from an earlier pulse
+    TIMSK5 |= (1 << OCIE5A);
+  }
+
+  bool isPulseActive() { return (TIMSK5 & (1 << OCIE5A)) != 0; }
+}
+
+using namespace DeviceBridge::Parallel;
+
+// End of the /ACK pulse: one-shot, so the vector disables itself
+ISR(TIMER5_COMPA_vect)
+{
+  namespace Pins = DeviceBridge::Common::Pins;
+  FastPin<Pins::LPT_ACK>::high();
+  if (AckTimer::releasePending) {
+    FastPin<Pins::LPT_BUSY>::low();
+    AckTimer::releasePending = false;
+  }
+  TIMSK5 &= ~(1 << OCIE5A);
+}
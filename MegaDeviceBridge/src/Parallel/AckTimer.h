@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+#include "../Common/Config.h"
+
+namespace DeviceBridge::Parallel
+{
+  /**
+   * Timer-generated /ACK pulse (Timer5 compare A one-shot)
+   *
+   * /ACK is on PG0, which has no output-compare function, so the /STROBE ISR
+   * pulls it low and arms OCR5A, and the TIMER5_COMPA vector raises it again
+   * (and, if asked, releases BUSY on the same edge). The strobe ISR no longer
+   * spins through the pulse width and recovery delays.
+   *
+   * Timer5 free-runs at clk/8 (0.5us per tick) while enabled. One tick is
+   * added to the requested width so the unknown prescaler phase can only
+   * lengthen the pulse: /ACK is low for the configured width plus at most one
+   * tick and the compare vector's entry latency. Timer1 is left free.
+   */
+  namespace AckTimer
+  {
+    constexpr uint8_t TICKS_PER_US = 2; // 16MHz / 8
+
+    /** Start Timer5 and accept start() calls; /ACK must already be an output */
+    void initialize(uint16_t pulseUs, bool releaseBusy);
+    /** Disable the compare interrupt, end any pulse in flight and stop Timer5 */
+    void stop();
+    bool isEnabled();
+
+    /** Clamped to 1..ACK_TIMER_MAX_PULSE_US */
+    void setPulseWidthUs(uint16_t pulseUs);
+    uint16_t getPulseWidthUs();
+    bool releasesBusy();
+
+    /**
+     * /ACK low now, high again after the pulse width. Called with interrupts
+     * off (the /STROBE ISR); releaseBusy only has effect if releasesBusy().
+     */
+    void start(bool releaseBusy);
+    bool isPulseActive();
+  }
+}
@@ -0,0 +1,123 @@
+#include <Arduino.h>
+#include <avr/interrupt.h>
+#include <string.h>
+#include "CaptureTrace.h"
+
+namespace DeviceBridge::Parallel::CaptureTrace
+{
+  void writeHeader(uint8_t *header)
+  {
+    memcpy(header, MAGIC, sizeof(MAGIC));
+    header[4] = FORMAT_VERSION;
+    header[5] = TICKS_PER_US;
+    header[6] = 0;
+    header[7] = 0;
+  }
+}
+
+#ifdef DEVICEBRIDGE_CAPTURE_TRACE
+
+namespace DeviceBridge::Parallel::CaptureTrace
+{
+  static_assert(TICKS_PER_US == 2, "Timer4 runs at clk/8");
+
+  volatile bool recording = false;
+  volatile uint16_t epoch = 0;  // Timer4 wraps, counted by the compare A vector
+
+  namespace
+  {
+    Ring records;
+    uint32_t lastStamp;
+    Statistics stats;
+
+    /** TCNT4 extended by the wrap count; a wrap whose vector has not run yet is counted here */
+    inline uint32_t stamp()
+    {
+      const uint16_t ticks = TCNT4;
+      uint16_t wraps = epoch;
+      if ((TIFR4 & (1 << OCF4A)) && ticks < 0x8000) {
+        wraps++;
+      }
+      return ((uint32_t)wraps << 16) | ticks;
+    }
+  }
+
+  void initialize()
+  {
+    const uint8_t sreg = SREG;
+    cli();
+    TCCR4A = 0;              // normal mode, OC4x disconnected
+    TCCR4B = (1 << CS41);    // clk/8
+    OCR4A = 0;               // compare A on every wrap
+    TIFR4 = (1 << OCF4A);
+    TIMSK4 = (1 << OCIE4A);
+    SREG = sreg;
+  }
+
+  void start()
+  {
+    const uint8_t sreg = SREG;
+    cli();
+    records.clear();
+    lastStamp = stamp();
+    memset(&stats, 0, sizeof(stats));
+    recording = true;
+    SREG = sreg;
+  }
+
+  void stop()
+  {
+    recording = false;
+  }
+
+  void snapshot(Statistics &out)
+  {
+    const uint8_t sreg = SREG;
+    cli();
+    out = stats;
+    out.recording = recording;
+    SREG = sreg;
+  }
+
+  Ring &ring()
+  {
+    return records;
+  }
+
+  void recordByte(uint8_t data)
+  {
+    if (Ring::maxSize() - records.size() < MAX_RECORD_BYTES) {
+      // The file fell behind; a gap in the timing would shift every later delta
+      recording = false;
+      stats.overflowed = true;
+      return;
+    }
+
+    const uint32_t now = stamp();
+    uint32_t delta = now - lastStamp;
+    lastStamp = now;
+    if (delta > MAX_DELTA_TICKS) {
+      delta = MAX_DELTA_TICKS;
+    }
+
+    uint8_t length = 2;
+    while (delta >= 0x80) {
+      records.push((uint8_t)delta | 0x80);
+      delta >>= 7;
+      length++;
+    }
+    records.push((uint8_t)delta);
+    records.push(data);
+    stats.records++;
+    stats.encodedBytes += length;
+  }
+}
+
+using namespace DeviceBridge::Parallel;
+
+ISR(TIMER4_COMPA_vect)
+{
+  CaptureTrace::epoch = CaptureTrace::epoch + 1;
+}
+
+#endif
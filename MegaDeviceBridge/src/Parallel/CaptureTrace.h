@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stdint.h>
+#include <Arduino.h>
+#include "SpscRing.h"
+#include "../Common/Config.h"
+
+namespace DeviceBridge::Parallel
+{
+  /**
+   * Strobe-by-strobe trace of the first parallel port
+   *
+   * Built with -D DEVICEBRIDGE_CAPTURE_TRACE (env megaatmega2560_trace).
+   * While a trace runs (trace start), every byte a capture path puts into
+   * the first port's ring is also encoded, with the time since the previous
+   * one, into a second ring that FileSystemManager writes to a .trc file.
+   * Timer4 free-runs at clk/8 and its compare A vector counts the wraps, so
+   * the ISR builds a 32-bit stamp from TCNT4 without calling micros().
+   *
+   * File layout (little endian, replayed by NativeHal::TraceReplayer):
+   *
+   *   header  "DBTR", FORMAT_VERSION, TICKS_PER_US, two zero bytes
+   *   record  delta  LEB128 varint: ticks since the previous record's
+   *                  strobe (since trace start for the first), at most
+   *                  MAX_DELTA_TICKS
+   *           data   the byte as captured
+   *
+   * Two bytes per record while strobes come less than 64us apart, three up
+   * to 8ms, the idle gaps between jobs up to five. If the file falls behind
+   * and the ring fills, recording stops and the trace is marked overflowed;
+   * bytes the port dropped (ring full) are not recorded.
+   *
+   * Without the flag the hooks are empty inlines, no storage is reserved
+   * and Timer4 is left alone.
+   */
+  namespace CaptureTrace
+  {
+    constexpr char MAGIC[4] = {'D', 'B', 'T', 'R'};
+    constexpr uint8_t FORMAT_VERSION = 1;
+    constexpr uint8_t HEADER_SIZE = 8;
+    constexpr uint8_t TICKS_PER_US = Common::CaptureTrace::TICKS_PER_US;
+    constexpr uint32_t MAX_DELTA_TICKS = 0x0FFFFFFFUL; // four varint bytes, about 134s
+    constexpr uint8_t MAX_RECORD_BYTES = 5;
+
+    /** Fills `header` (HEADER_SIZE bytes) */
+    void writeHeader(uint8_t *header);
+
+    struct Statistics
+    {
+      uint32_t records;      // bytes traced
+      uint32_t encodedBytes; // record bytes, header excluded
+      bool recording;
+      bool overflowed;       // stopped because the file fell behind
+    };
+
+#ifdef DEVICEBRIDGE_CAPTURE_TRACE
+    constexpr bool ENABLED = true;
+
+    using Ring = SpscRing<uint8_t, Common::CaptureTrace::RING_SIZE>;
+
+    extern volatile bool recording;
+
+    /** Start Timer4 at clk/8 (normal mode, outputs disconnected) with the wrap-counting compare vector */
+    void initialize();
+    /** Empty the ring and take the next byte's delta from now */
+    void start();
+    void stop();
+    void snapshot(Statistics &out);
+
+    /** Main loop: encoded records waiting for the file */
+    Ring &ring();
+
+    /** Capture paths, with interrupts off: the byte just stored in the first port's ring */
+    void recordByte(uint8_t data);
+    inline void record(uint8_t data)
+    {
+      if (recording) {
+        recordByte(data);
+      }
+    }
+#else
+    constexpr bool ENABLED = false;
+
+    inline void initialize() {}
+    inline void record(uint8_t) {}
+#endif
+  }
+}
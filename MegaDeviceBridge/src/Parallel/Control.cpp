@@ -2,6 +2,8 @@
 #include <stdint.h>
 #include <Arduino.h>
 #include "Control.h"
+#include "FastPin.h"
+#include "../Common/Config.h"
 
 namespace DeviceBridge::Parallel
 {
@@ -15,15 +17,27 @@ namespace DeviceBridge::Parallel
         _autoFeed = autoFeed;
         _initialize = initialize;
         _select = select;
+        _fastSignals = false;
+        _fastPort = 0;
     }
 
     void Control::initialize()
     {
         pinMode(_strobe, INPUT_PULLUP); // Strobe - normally high
 
-        pinMode(_autoFeed, INPUT_PULLUP);
-        pinMode(_initialize, INPUT_PULLUP);
-        pinMode(_select, INPUT_PULLUP);
+        // The third port has no pins left for these (Common::Pins::NOT_WIRED)
+        if (_autoFeed != Common::Pins::NOT_WIRED) pinMode(_autoFeed, INPUT_PULLUP);
+        if (_initialize != Common::Pins::NOT_WIRED) pinMode(_initialize, INPUT_PULLUP);
+        if (_select != Common::Pins::NOT_WIRED) pinMode(_select, INPUT_PULLUP);
+
+        _fastSignals = _initialize == Common::Pins::LPT_INITIALIZE &&
+                       _select == Common::Pins::LPT_SELECT_IN;
+#if DEVICEBRIDGE_PARALLEL_PORTS > 1
+        if (_initialize == Common::Pins::LPT2_INITIALIZE && _select == Common::Pins::LPT2_SELECT_IN) {
+            _fastSignals = true;
+            _fastPort = 1;
+        }
+#endif
     }
 
     uint8_t Control::getStrobePin()
@@ -36,11 +50,12 @@ namespace DeviceBridge::Parallel
     }
     
     uint8_t Control::readValue(){
+        // Unwired lines read as inactive (high)
         uint8_t val =   
             (digitalRead(_strobe) << 0)    | 
-            (digitalRead(_autoFeed) << 1)  |
-            (digitalRead(_initialize) << 2)| 
-            (digitalRead(_select) << 3);
+            ((isAutoFeedLow() ? 0 : 1) << 1)  |
+            ((isInitializeLow() ? 0 : 1) << 2)| 
+            ((isSelectInLow() ? 0 : 1) << 3);
         return val;
     }
     
@@ -49,14 +64,29 @@ namespace DeviceBridge::Parallel
     }
     
     bool Control::isAutoFeedLow(){
-        return digitalRead(_autoFeed) == LOW;
+        return _autoFeed != Common::Pins::NOT_WIRED && digitalRead(_autoFeed) == LOW;
     }
     
     bool Control::isInitializeLow(){
-        return digitalRead(_initialize) == LOW;
+        return _initialize != Common::Pins::NOT_WIRED && digitalRead(_initialize) == LOW;
     }
     
     bool Control::isSelectInLow(){
-        return digitalRead(_select) == LOW;
+        return _select != Common::Pins::NOT_WIRED && digitalRead(_select) == LOW;
+    }
+    
+    uint8_t Control::readJobSignals(){
+        if (_fastSignals) {
+#if DEVICEBRIDGE_PARALLEL_PORTS > 1
+            if (_fastPort == 1) {
+                return (FastPin<Common::Pins::LPT2_INITIALIZE>::read() ? 0 : Common::JobBoundary::SIGNAL_INIT) |
+                       (FastPin<Common::Pins::LPT2_SELECT_IN>::read() ? 0 : Common::JobBoundary::SIGNAL_SELECT_IN);
+            }
+#endif
+            return (FastPin<Common::Pins::LPT_INITIALIZE>::read() ? 0 : Common::JobBoundary::SIGNAL_INIT) |
+                   (FastPin<Common::Pins::LPT_SELECT_IN>::read() ? 0 : Common::JobBoundary::SIGNAL_SELECT_IN);
+        }
+        return (isInitializeLow() ? Common::JobBoundary::SIGNAL_INIT : 0) |
+               (isSelectInLow() ? Common::JobBoundary::SIGNAL_SELECT_IN : 0);
     }
-}
\ No newline at end of file
+}
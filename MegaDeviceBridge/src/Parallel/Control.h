@@ -8,6 +8,8 @@ namespace DeviceBridge::Parallel
   {
   private:
     uint8_t _strobe, _autoFeed, _initialize, _select;
+    bool _fastSignals; // /INIT and /SELECT-IN match one port's Common::Pins, so FastPin<> can read them
+    uint8_t _fastPort; // Which one: 0 = LPT_*, 1 = LPT2_*
 
   public:
     Control(
@@ -26,5 +28,9 @@ namespace DeviceBridge::Parallel
     bool isAutoFeedLow();
     bool isInitializeLow();
     bool isSelectInLow();
+    
+    // JobBoundary::SIGNAL_* bits set for each line the host is asserting (driving low)
+    uint8_t readJobSignals();
+    bool isFastSignals() const { return _fastSignals; }
   };
 }
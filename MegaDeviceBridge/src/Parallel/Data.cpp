@@ -1,6 +1,7 @@
 #include <stdint.h>
 #include <Arduino.h>
 #include "Data.h"
+#include "DataBus.h"
 
 namespace DeviceBridge::Parallel
 {
@@ -13,7 +14,8 @@ namespace DeviceBridge::Parallel
       uint8_t data5,
       uint8_t data6,
       uint8_t data7)
-    : _portRegister(nullptr), _portMask(0), _portOffset(0)
+    : _fastBus(false),
+      _bus(0)
   {
     _data[0] = data0;
     _data[1] = data1;
@@ -55,51 +57,39 @@ namespace DeviceBridge::Parallel
   uint8_t Data::readValueAtomic()
   {
     // IEEE-1284 compliant atomic port reading
-    // Single instruction read eliminates race conditions
-    if (_portRegister != nullptr) {
-      // Read entire port register in single atomic operation (~0.1μs)
-      uint8_t portValue = *_portRegister;
-      
-      // Extract and rearrange data bits based on pin mapping
-      // This assumes data pins are consecutive on the same port
-      return (portValue & _portMask) >> _portOffset;
+    // One IN per data port back to back, then a PROGMEM bit-gather (see DataBus.h)
+    if (_fastBus) {
+      switch (_bus) {
+#if DEVICEBRIDGE_PARALLEL_PORTS > 1
+      case 1:
+        return DataBus::read<1>();
+#endif
+#if DEVICEBRIDGE_PARALLEL_PORTS > 2
+      case 2:
+        return DataBus::read<2>();
+#endif
+      default:
+        return DataBus::read<0>();
+      }
     }
     
-    // Fallback to non-atomic method if port caching failed
+    // Fallback to non-atomic method if the pins differ from Config.h
     return readValue();
   }
   
   void Data::cachePortConfiguration()
   {
-    // Determine which Arduino port the data pins are connected to
-    // This is a simplified implementation - in practice you'd need to 
-    // analyze the actual pin assignments and map to AVR ports
-    
-    // For Arduino Mega 2560, assuming data pins are on consecutive pins
-    // of the same port (this would need to be verified against actual pinout)
-    
-    // Example implementation for pins 25-32 (would be on PORTA)
-    // This is hardware-specific and must match actual pin assignments
-    
-    // NOTE: This is a template implementation - actual implementation
-    // must be customized based on the specific pin assignments in Config.h
-    
-    bool canUseAtomicRead = true;
-    
-    // Check if all data pins are on the same AVR port
-    // For now, disable atomic read and use fallback (safe)
-    canUseAtomicRead = false;
-    
-    if (canUseAtomicRead) {
-      // Example: If all pins are on PORTA (pins 22-29 on Mega)
-      // _portRegister = &PINA;
-      // _portMask = 0xFF;
-      // _portOffset = 0;
-    } else {
-      // Disable atomic read - use safe fallback
-      _portRegister = nullptr;
-      _portMask = 0;
-      _portOffset = 0;
+    // DataBus is generated from Common::Pins at compile time; only use it
+    // when this instance was built with exactly one port's pins
+    _fastBus = false;
+    for (uint8_t bus = 0; bus < DataBus::BUS_COUNT && !_fastBus; bus++) {
+      _fastBus = true;
+      _bus = bus;
+      for (uint8_t line = 0; line < 8; line++) {
+        if (_data[line] != DataBus::pin(line, bus)) {
+          _fastBus = false;
+        }
+      }
     }
   }
-}
\ No newline at end of file
+}
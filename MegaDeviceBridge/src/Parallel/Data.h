@@ -9,10 +9,9 @@ namespace DeviceBridge::Parallel
   private:
     uint8_t _data[8]; 
     
-    // Cached port configuration for atomic reading
-    volatile uint8_t* _portRegister;
-    uint8_t _portMask;
-    uint8_t _portOffset;
+    // Pins match one of the Common::Pins data buses, so DataBus::read<_bus>() can be used
+    bool _fastBus;
+    uint8_t _bus;
     
   public:
     Data(
@@ -28,8 +27,9 @@ namespace DeviceBridge::Parallel
     void initialize();
     uint8_t readValue();            // Original non-atomic method (deprecated)
     uint8_t readValueAtomic();      // IEEE-1284 compliant atomic read
+    bool isFastBus() const { return _fastBus; }
     
   private:
-    void cachePortConfiguration();  // Cache port register info for atomic access
+    void cachePortConfiguration();  // Select the compile-time bus reader when the pins match
   };
 }
\ No newline at end of file
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <stdint.h>
+#include <Arduino.h>
+#include "PinTraits.h"
+#include "../Common/Config.h"
+
+namespace DeviceBridge::Parallel
+{
+  /**
+   * Single-pass read of the LPT data bus wired to Common::Pins::LPT_D0..D7
+   *
+   * Every AVR port carrying a data line is sampled once, back to back, then
+   * the bits are gathered into D0..D7: through a PROGMEM 256-entry table for
+   * ports carrying several data lines, a mask test for ports carrying one.
+   * With the current wiring that is PINA + PINC + PING (3 IN instructions)
+   * instead of eight digitalRead() calls.
+   *
+   * Multi-port builds get the same reader for the other ports' data pins
+   * (bus 1 = LPT2_D0..D7, bus 2 = LPT3_D0..D7).
+   */
+  namespace DataBus
+  {
+    constexpr uint8_t BUS_COUNT = Common::ParallelPorts::COUNT;
+
+    constexpr uint8_t pin(uint8_t line, uint8_t bus = 0)
+    {
+      using namespace Common::Pins;
+      return bus == 1 ? (line == 0 ? LPT2_D0 : line == 1 ? LPT2_D1 : line == 2 ? LPT2_D2 : line == 3 ? LPT2_D3
+                       : line == 4 ? LPT2_D4 : line == 5 ? LPT2_D5 : line == 6 ? LPT2_D6 : LPT2_D7)
+           : bus == 2 ? (line == 0 ? LPT3_D0 : line == 1 ? LPT3_D1 : line == 2 ? LPT3_D2 : line == 3 ? LPT3_D3
+                       : line == 4 ? LPT3_D4 : line == 5 ? LPT3_D5 : line == 6 ? LPT3_D6 : LPT3_D7)
+           : line == 0 ? LPT_D0
+           : line == 1 ? LPT_D1
+           : line == 2 ? LPT_D2
+           : line == 3 ? LPT_D3
+           : line == 4 ? LPT_D4
+           : line == 5 ? LPT_D5
+           : line == 6 ? LPT_D6
+                       : LPT_D7;
+    }
+
+    /** Data byte bits contributed by `sample` read from `port` */
+    constexpr uint8_t gather(uint8_t port, uint8_t sample, uint8_t bus = 0, uint8_t line = 0)
+    {
+      return line == 8 ? 0
+           : (uint8_t)(((PinTraits::port(pin(line, bus)) == port && (sample & PinTraits::mask(pin(line, bus)))) ? (1 << line) : 0) |
+                       gather(port, sample, bus, line + 1));
+    }
+
+    /** Bits of `port` that carry data lines */
+    constexpr uint8_t portMask(uint8_t port, uint8_t bus = 0, uint8_t line = 0)
+    {
+      return line == 8 ? 0
+           : (uint8_t)((PinTraits::port(pin(line, bus)) == port ? PinTraits::mask(pin(line, bus)) : 0) | portMask(port, bus, line + 1));
+    }
+
+    constexpr bool singleBit(uint8_t mask) { return (mask & (mask - 1)) == 0; }
+
+    template <uint8_t Port, uint8_t Bus = 0, bool Used = (portMask(Port, Bus) != 0)>
+    struct Sample
+    {
+      static inline uint8_t read() { return PinTraits::Registers<Port>::in(); }
+    };
+
+    template <uint8_t Port, uint8_t Bus>
+    struct Sample<Port, Bus, false>
+    {
+      static inline uint8_t read() { return 0; }
+    };
+
+#define DATABUS_GATHER_1(P, B, v) gather(P, (uint8_t)(v), B)
+#define DATABUS_GATHER_4(P, B, v) DATABUS_GATHER_1(P, B, v), DATABUS_GATHER_1(P, B, v + 1), DATABUS_GATHER_1(P, B, v + 2), DATABUS_GATHER_1(P, B, v + 3)
+#define DATABUS_GATHER_16(P, B, v) DATABUS_GATHER_4(P, B, v), DATABUS_GATHER_4(P, B, v + 4), DATABUS_GATHER_4(P, B, v + 8), DATABUS_GATHER_4(P, B, v + 12)
+#define DATABUS_GATHER_64(P, B, v) DATABUS_GATHER_16(P, B, v), DATABUS_GATHER_16(P, B, v + 16), DATABUS_GATHER_16(P, B, v + 32), DATABUS_GATHER_16(P, B, v + 48)
+#define DATABUS_GATHER_256(P, B) DATABUS_GATHER_64(P, B, 0), DATABUS_GATHER_64(P, B, 64), DATABUS_GATHER_64(P, B, 128), DATABUS_GATHER_64(P, B, 192)
+
+    template <uint8_t Port, uint8_t Bus = 0, bool Single = singleBit(portMask(Port, Bus))>
+    struct Gather
+    {
+      static const uint8_t table[256];
+      static inline uint8_t apply(uint8_t sample) { return pgm_read_byte(&table[sample]); }
+    };
+
+    template <uint8_t Port, uint8_t Bus, bool Single>
+    const uint8_t Gather<Port, Bus, Single>::table[256] PROGMEM = {DATABUS_GATHER_256(Port, Bus)};
+
+    template <uint8_t Port, uint8_t Bus>
+    struct Gather<Port, Bus, true>
+    {
+      static inline uint8_t apply(uint8_t sample) { return (sample & portMask(Port, Bus)) ? gather(Port, portMask(Port, Bus), Bus) : 0; }
+    };
+
+#undef DATABUS_GATHER_1
+#undef DATABUS_GATHER_4
+#undef DATABUS_GATHER_16
+#undef DATABUS_GATHER_64
+#undef DATABUS_GATHER_256
+
+    /** Number of port reads per sample (for diagnostics) */
+    constexpr uint8_t portReads(uint8_t bus = 0, uint8_t port = 0)
+    {
+      return port == PinTraits::PORT_COUNT ? 0 : (portMask(port, bus) ? 1 : 0) + portReads(bus, port + 1);
+    }
+
+    template <uint8_t Bus = 0>
+    inline uint8_t read()
+    {
+      using namespace PinTraits;
+      // Sample all ports first so the byte is latched within a few cycles
+      const uint8_t a = Sample<PORT_A, Bus>::read();
+      const uint8_t b = Sample<PORT_B, Bus>::read();
+      const uint8_t c = Sample<PORT_C, Bus>::read();
+      const uint8_t d = Sample<PORT_D, Bus>::read();
+      const uint8_t e = Sample<PORT_E, Bus>::read();
+      const uint8_t f = Sample<PORT_F, Bus>::read();
+      const uint8_t g = Sample<PORT_G, Bus>::read();
+      const uint8_t h = Sample<PORT_H, Bus>::read();
+      const uint8_t j = Sample<PORT_J, Bus>::read();
+      const uint8_t k = Sample<PORT_K, Bus>::read();
+      const uint8_t l = Sample<PORT_L, Bus>::read();
+
+      return Gather<PORT_A, Bus>::apply(a) | Gather<PORT_B, Bus>::apply(b) | Gather<PORT_C, Bus>::apply(c) |
+             Gather<PORT_D, Bus>::apply(d) | Gather<PORT_E, Bus>::apply(e) | Gather<PORT_F, Bus>::apply(f) |
+             Gather<PORT_G, Bus>::apply(g) | Gather<PORT_H, Bus>::apply(h) | Gather<PORT_J, Bus>::apply(j) |
+             Gather<PORT_K, Bus>::apply(k) | Gather<PORT_L, Bus>::apply(l);
+    }
+  }
+}
@@ -0,0 +1,627 @@
+#include <Arduino.h>
+#include <string.h>
+#include "DocumentEnd.h"
+
+namespace DeviceBridge::Parallel
+{
+  namespace
+  {
+    namespace Formats = Common::FileFormats;
+    namespace Limits = Common::DocumentEnd;
+
+    enum Phase : uint8_t {
+      PCX_HEADER,
+      PCX_DATA,
+      PCX_RUN,
+      PCX_PALETTE,
+
+      TIFF_HEADER,
+      TIFF_SEEK,
+      TIFF_IFD_COUNT,
+      TIFF_IFD_ENTRY,
+      TIFF_IFD_NEXT,
+      TIFF_TABLE,
+      TIFF_TAIL,
+
+      PCL_TEXT,
+      PCL_ESCAPE,
+      PCL_PARAMETER,
+      PCL_VALUE
+    };
+
+    // TiffRead::kind and the strip table bits
+    constexpr uint8_t TIFF_OFFSETS = 0x01;
+    constexpr uint8_t TIFF_COUNTS = 0x02;
+    constexpr uint8_t TIFF_IFD = 0x04;
+    constexpr uint8_t TIFF_DONE_SHIFT = 2;
+    constexpr uint8_t TIFF_BOTH = TIFF_OFFSETS | TIFF_COUNTS;
+
+    constexpr uint16_t TIFF_SHORT = 3;
+    constexpr uint16_t TIFF_LONG = 4;
+
+    // Bytes per value for TIFF field types 1 (BYTE) .. 13 (IFD)
+    const uint8_t TIFF_TYPE_SIZES[] PROGMEM = {1, 1, 2, 4, 8, 1, 1, 2, 4, 8, 4, 8, 4};
+
+    constexpr uint8_t PJL_LINE_OFF = 0xFF;
+    const char PJL_JOB[] PROGMEM = "@PJL JOB";
+    const char PJL_EOJ[] PROGMEM = "@PJL EOJ";
+    constexpr uint32_t UEL_VALUE = 12345;  // ESC%-12345X
+  }
+
+  DocumentEnd::DocumentEnd()
+  {
+    reset();
+  }
+
+  void DocumentEnd::reset()
+  {
+    _format = Format::DETECTING;
+    _complete = false;
+    _phase = 0;
+    _position = 0;
+    _skip = 0;
+    _field = 0;
+    _fieldBytes = 0;
+    memset(&_state, 0, sizeof(_state));
+  }
+
+  uint16_t DocumentEnd::feed(const uint8_t *data, uint16_t length)
+  {
+    uint16_t used = 0;
+    while (used < length && !_complete) {
+      if (_format == Format::UNKNOWN) {
+        _position += length - used;
+        return length;
+      }
+      if (_skip != 0) {
+        const uint16_t run = (uint32_t)(length - used) < _skip ? length - used : (uint16_t)_skip;
+        _skip -= run;
+        _position += run;
+        used += run;
+        if (_skip == 0) {
+          skipDone();
+        }
+        continue;
+      }
+      // _position counts the byte being looked at
+      _position++;
+      accept(data[used++]);
+    }
+    return used;
+  }
+
+  void DocumentEnd::accept(uint8_t byte)
+  {
+    if (_format == Format::DETECTING) {
+      detect(byte);
+    }
+    switch (_format) {
+    case Format::BMP:
+      bmpByte(byte);
+      break;
+    case Format::PCX:
+      pcxByte(byte);
+      break;
+    case Format::TIFF:
+      tiffByte(byte);
+      break;
+    case Format::PCL:
+      pclByte(byte);
+      break;
+    default:
+      break;
+    }
+  }
+
+  void DocumentEnd::detect(uint8_t byte)
+  {
+    switch (byte) {
+    case Formats::BMP_SIGNATURE_1:
+      _format = Format::BMP;
+      break;
+    case Formats::PCX_SIGNATURE:
+      _format = Format::PCX;
+      _phase = PCX_HEADER;
+      break;
+    case Formats::TIFF_LE_1:
+    case Formats::TIFF_BE_1:
+      _format = Format::TIFF;
+      _state.tiff.end = 8;
+      tiffBegin(TIFF_HEADER, 8);
+      break;
+    case Formats::ESC_CHARACTER:
+      _format = Format::PCL;
+      _phase = PCL_TEXT;
+      _state.pcl.lineBytes = PJL_LINE_OFF;
+      break;
+    default:
+      unknown();
+      break;
+    }
+  }
+
+  void DocumentEnd::skipDone()
+  {
+    if (_format == Format::TIFF && _phase == TIFF_SEEK) {
+      tiffStartRead();
+    } else if (_format != Format::PCL) {
+      // BMP body, PCX palette, TIFF tail: the last byte of the document
+      complete();
+    }
+    // PCL: the binary block is over, the escape sequence or text continues
+  }
+
+  // ---------------------------------------------------------------- BMP
+
+  void DocumentEnd::bmpByte(uint8_t byte)
+  {
+    const uint32_t index = _position - 1;
+    if (index == 1) {
+      if (byte != Formats::BMP_SIGNATURE_2) {
+        unknown();
+      }
+    } else if (index >= 2 && index <= 5) {
+      _state.bmp.size |= (uint32_t)byte << (8 * (index - 2));
+    } else if (index >= 6 && index <= 9) {
+      if (byte != 0) {
+        unknown(); // bfReserved1/2
+      }
+    } else if (index >= 10) {
+      _field |= (uint32_t)byte << (8 * (index - 10));
+      if (index == Limits::BMP_HEADER_BYTES - 1) {
+        // bfOffBits has to lie inside the file past the headers
+        if (_state.bmp.size < Limits::BMP_MIN_SIZE || _field < Limits::BMP_MIN_SIZE || _field > _state.bmp.size) {
+          unknown();
+        } else {
+          _skip = _state.bmp.size - Limits::BMP_HEADER_BYTES;
+        }
+      }
+    }
+  }
+
+  // ---------------------------------------------------------------- PCX
+
+  void DocumentEnd::pcxByte(uint8_t byte)
+  {
+    switch (_phase) {
+    case PCX_HEADER: {
+      const uint32_t index = _position - 1;
+      if (index == 1) {
+        _state.pcx.version = byte;
+        if (byte == 1 || byte > 5) {
+          unknown();
+        }
+      } else if (index == 2) {
+        if (byte != 1) {
+          unknown(); // only RLE encoding is defined
+        }
+      } else if (index == 3) {
+        _state.pcx.bitsPerPixel = byte;
+        if (byte != 1 && byte != 2 && byte != 4 && byte != 8) {
+          unknown();
+        }
+      } else if (index >= 4 && index <= 11) {
+        _state.pcx.window[(index - 4) >> 1] |= (uint16_t)byte << (8 * ((index - 4) & 1));
+      } else if (index == 65) {
+        _state.pcx.planes = byte;
+      } else if (index == 66 || index == 67) {
+        _state.pcx.bytesPerLine |= (uint16_t)byte << (8 * (index - 66));
+      } else if (index == Limits::PCX_HEADER_BYTES - 1) {
+        const uint16_t *window = _state.pcx.window;
+        if (window[2] < window[0] || window[3] < window[1] || _state.pcx.planes == 0 || _state.pcx.planes > 4 ||
+            _state.pcx.bytesPerLine == 0) {
+          unknown();
+          break;
+        }
+        _state.pcx.remaining = (uint32_t)_state.pcx.bytesPerLine * _state.pcx.planes * (uint32_t)(window[3] - window[1] + 1);
+        _phase = PCX_DATA;
+      }
+      break;
+    }
+
+    case PCX_DATA:
+      if ((byte & 0xC0) == 0xC0) {
+        _field = byte & 0x3F;
+        _phase = PCX_RUN;
+      } else {
+        pcxDecoded(1);
+      }
+      break;
+
+    case PCX_RUN:
+      _phase = PCX_DATA;
+      pcxDecoded((uint8_t)_field);
+      break;
+
+    case PCX_PALETTE:
+      if (byte != Limits::PCX_PALETTE_MARKER) {
+        unknown(); // more likely bytes were lost than the palette left out
+        break;
+      }
+      _skip = Limits::PCX_PALETTE_BYTES;
+      break;
+    }
+  }
+
+  void DocumentEnd::pcxDecoded(uint8_t count)
+  {
+    if (count > _state.pcx.remaining) {
+      unknown(); // runs never cross the end of the image: bytes were lost
+      return;
+    }
+    _state.pcx.remaining -= count;
+    if (_state.pcx.remaining != 0) {
+      return;
+    }
+    if (_state.pcx.version == 5 && _state.pcx.bitsPerPixel == 8 && _state.pcx.planes == 1) {
+      _phase = PCX_PALETTE;
+    } else {
+      complete();
+    }
+  }
+
+  // ---------------------------------------------------------------- TIFF
+
+  void DocumentEnd::tiffBegin(uint8_t phase, uint8_t bytes)
+  {
+    _phase = phase;
+    _fieldBytes = bytes;
+    _state.tiff.entryBytes = 0;
+  }
+
+  uint32_t DocumentEnd::tiffValue(const uint8_t *bytes, uint8_t size) const
+  {
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < size; i++) {
+      const uint8_t byte = _state.tiff.bigEndian ? bytes[i] : bytes[size - 1 - i];
+      value = (value << 8) | byte;
+    }
+    return value;
+  }
+
+  void DocumentEnd::tiffByte(uint8_t byte)
+  {
+    auto &tiff = _state.tiff;
+    tiff.entry[tiff.entryBytes++] = byte;
+    if (tiff.entryBytes < _fieldBytes) {
+      return;
+    }
+
+    switch (_phase) {
+    case TIFF_HEADER: {
+      const uint8_t *header = tiff.entry;
+      tiff.bigEndian = header[0] == Formats::TIFF_BE_1;
+      if (header[1] != header[0] || tiffValue(header + 2, 2) != 42) {
+        unknown();
+        return;
+      }
+      const uint32_t ifd = tiffValue(header + 4, 4);
+      if (ifd < 8 || !tiffSchedule(ifd, 0, TIFF_IFD, 0)) {
+        unknown();
+        return;
+      }
+      tiffNext();
+      break;
+    }
+
+    case TIFF_IFD_COUNT:
+      tiff.entriesLeft = (uint16_t)tiffValue(tiff.entry, 2);
+      if (tiff.entriesLeft == 0 || tiff.entriesLeft > Limits::TIFF_MAX_ENTRIES) {
+        unknown();
+        return;
+      }
+      tiffExtend(tiff.current.offset + 2 + 12UL * tiff.entriesLeft + 4);
+      tiffBegin(TIFF_IFD_ENTRY, 12);
+      break;
+
+    case TIFF_IFD_ENTRY:
+      tiffEntry();
+      if (--tiff.entriesLeft == 0) {
+        tiffBegin(TIFF_IFD_NEXT, 4);
+      } else {
+        tiffBegin(TIFF_IFD_ENTRY, 12);
+      }
+      break;
+
+    case TIFF_IFD_NEXT: {
+      const uint32_t next = tiffValue(tiff.entry, 4);
+      if (next != 0 && !tiffSchedule(next, 0, TIFF_IFD, 0)) {
+        return;
+      }
+      tiffNext();
+      break;
+    }
+
+    case TIFF_TABLE: {
+      tiffElement(tiff.current.kind, tiff.index, tiffValue(tiff.entry, _fieldBytes));
+      if (++tiff.index < tiff.current.count) {
+        tiffBegin(TIFF_TABLE, _fieldBytes);
+      } else {
+        tiffTableDone(tiff.current.kind);
+        tiffNext();
+      }
+      break;
+    }
+    }
+  }
+
+  void DocumentEnd::tiffEntry()
+  {
+    auto &tiff = _state.tiff;
+    const uint16_t tag = (uint16_t)tiffValue(tiff.entry, 2);
+    const uint16_t type = (uint16_t)tiffValue(tiff.entry + 2, 2);
+    const uint32_t count = tiffValue(tiff.entry + 4, 4);
+    if (type == 0 || type > sizeof(TIFF_TYPE_SIZES) || count > 0x0FFFFFFFUL) {
+      unknown(); // the extent of an unknown type cannot be told
+      return;
+    }
+    const uint8_t size = pgm_read_byte(&TIFF_TYPE_SIZES[type - 1]);
+    const uint32_t bytes = count * size;
+    const uint32_t offset = tiffValue(tiff.entry + 8, 4);
+    if (bytes > 4) {
+      tiffExtend(offset + bytes);
+    }
+
+    // StripOffsets / TileOffsets, StripByteCounts / TileByteCounts
+    const uint8_t kind = (tag == 273 || tag == 324) ? TIFF_OFFSETS : (tag == 279 || tag == 325) ? TIFF_COUNTS : 0;
+    if (kind == 0) {
+      return;
+    }
+    if ((type != TIFF_SHORT && type != TIFF_LONG) || count == 0) {
+      unknown();
+      return;
+    }
+    if (tiff.strips & kind) {
+      // Another image: only once the previous one's tables are complete
+      if ((tiff.strips >> TIFF_DONE_SHIFT) != TIFF_BOTH) {
+        unknown();
+        return;
+      }
+      tiff.strips = 0;
+      tiff.maxOffset = 0;
+      tiff.maxOffsetIndex = 0;
+      tiff.maxCount = 0;
+      tiff.countAtMaxKnown = false;
+    }
+    tiff.strips |= kind;
+    if (bytes <= 4) {
+      for (uint8_t i = 0; i < count; i++) {
+        tiffElement(kind, i, tiffValue(tiff.entry + 8 + i * size, size));
+      }
+      tiffTableDone(kind);
+    } else {
+      tiffSchedule(offset, count, kind, (uint8_t)type);
+    }
+  }
+
+  void DocumentEnd::tiffElement(uint8_t kind, uint32_t index, uint32_t value)
+  {
+    auto &tiff = _state.tiff;
+    if (kind == TIFF_OFFSETS) {
+      // Strips do not overlap, so the one placed last ends last
+      if (index == 0 || value > tiff.maxOffset) {
+        tiff.maxOffset = value;
+        tiff.maxOffsetIndex = index;
+      }
+    } else {
+      if (value > tiff.maxCount) {
+        tiff.maxCount = value;
+      }
+      if ((tiff.strips & (TIFF_OFFSETS << TIFF_DONE_SHIFT)) && index == tiff.maxOffsetIndex) {
+        tiff.countAtMax = value;
+        tiff.countAtMaxKnown = true;
+      }
+    }
+  }
+
+  void DocumentEnd::tiffTableDone(uint8_t kind)
+  {
+    auto &tiff = _state.tiff;
+    tiff.strips |= kind << TIFF_DONE_SHIFT;
+    if ((tiff.strips >> TIFF_DONE_SHIFT) == TIFF_BOTH) {
+      // Counts read before the offsets: the largest count can only overshoot, which leaves the timeout
+      tiffExtend(tiff.maxOffset + (tiff.countAtMaxKnown ? tiff.countAtMax : tiff.maxCount));
+    }
+  }
+
+  bool DocumentEnd::tiffSchedule(uint32_t offset, uint32_t count, uint8_t kind, uint8_t type)
+  {
+    auto &tiff = _state.tiff;
+    if (tiff.readCount >= Limits::TIFF_PENDING_READS) {
+      unknown();
+      return false;
+    }
+    TiffRead &read = tiff.reads[tiff.readCount++];
+    read.offset = offset;
+    read.count = count;
+    read.kind = kind;
+    read.type = type;
+    return true;
+  }
+
+  void DocumentEnd::tiffNext()
+  {
+    auto &tiff = _state.tiff;
+    if (_format != Format::TIFF) {
+      return;
+    }
+    if (tiff.readCount == 0) {
+      // Everything is known: the file ends at the furthest byte anything pointed to
+      if ((tiff.strips >> TIFF_DONE_SHIFT) != TIFF_BOTH) {
+        unknown();
+      } else if (_position >= tiff.end) {
+        complete();
+      } else {
+        _phase = TIFF_TAIL;
+        _skip = tiff.end - _position;
+      }
+      return;
+    }
+
+    // Nearest pending read next; one the stream already passed cannot be had
+    uint8_t nearest = 0;
+    for (uint8_t i = 1; i < tiff.readCount; i++) {
+      if (tiff.reads[i].offset < tiff.reads[nearest].offset) {
+        nearest = i;
+      }
+    }
+    tiff.current = tiff.reads[nearest];
+    tiff.reads[nearest] = tiff.reads[--tiff.readCount];
+    if (tiff.current.offset < _position) {
+      unknown();
+      return;
+    }
+    _phase = TIFF_SEEK;
+    _skip = tiff.current.offset - _position;
+    if (_skip == 0) {
+      tiffStartRead();
+    }
+  }
+
+  void DocumentEnd::tiffStartRead()
+  {
+    auto &tiff = _state.tiff;
+    if (tiff.current.kind == TIFF_IFD) {
+      tiffBegin(TIFF_IFD_COUNT, 2);
+    } else {
+      tiff.index = 0;
+      tiffBegin(TIFF_TABLE, tiff.current.type == TIFF_SHORT ? 2 : 4);
+    }
+  }
+
+  // ---------------------------------------------------------------- PCL
+
+  void DocumentEnd::pclByte(uint8_t byte)
+  {
+    auto &pcl = _state.pcl;
+    switch (_phase) {
+    case PCL_TEXT:
+      if (byte == Formats::ESC_CHARACTER) {
+        _phase = PCL_ESCAPE;
+      } else {
+        pclText(byte);
+      }
+      break;
+
+    case PCL_ESCAPE:
+      if (byte >= 0x21 && byte <= 0x2F) {
+        // Parameterized: ESC <parameter> [group] value... terminator
+        pcl.parameter = byte;
+        pcl.group = 0;
+        pcl.value = 0;
+        pcl.negative = false;
+        pcl.fraction = false;
+        _phase = PCL_PARAMETER;
+      } else if (byte >= 0x30 && byte <= 0x7E) {
+        // Two-character sequence
+        _phase = PCL_TEXT;
+        if (!pcl.opened) {
+          if (byte == 'E') {
+            pcl.opened = true;
+          } else {
+            unknown(); // ESC/P and other ESC-led languages
+          }
+        } else if (byte == 'E' && !pcl.uel && pcl.content) {
+          complete();
+        } else if (byte != 'E' || pcl.uel) {
+          pcl.content = true;
+        }
+      } else if (byte != Formats::ESC_CHARACTER) {
+        _phase = PCL_TEXT;
+        pclText(byte);
+      }
+      if (pcl.lineBytes < sizeof(pcl.line)) {
+        pcl.lineBytes = PJL_LINE_OFF;
+      }
+      break;
+
+    case PCL_PARAMETER:
+      if (byte >= 0x60 && byte <= 0x7E) {
+        pcl.group = byte;
+        _phase = PCL_VALUE;
+        break;
+      }
+      _phase = PCL_VALUE;
+      // The value starts without a group character
+      [[fallthrough]];
+
+    case PCL_VALUE:
+      if (byte >= '0' && byte <= '9') {
+        if (!pcl.fraction && pcl.value < 100000000UL) {
+          pcl.value = pcl.value * 10 + (byte - '0');
+        }
+      } else if (byte == '+' || byte == '-') {
+        pcl.negative = byte == '-';
+      } else if (byte == '.') {
+        pcl.fraction = true;
+      } else if (byte >= 0x40 && byte <= 0x7E && byte != 0x5F) {
+        pclSequence(byte);
+      } else {
+        _phase = PCL_TEXT; // malformed, carry on as text
+      }
+      break;
+    }
+  }
+
+  void DocumentEnd::pclSequence(uint8_t terminator)
+  {
+    auto &pcl = _state.pcl;
+    const bool last = terminator < 0x60;   // upper case ends the sequence
+    const uint8_t upper = last ? terminator : terminator - 0x20;
+    const bool uel = pcl.parameter == '%' && pcl.group == 0 && pcl.negative && pcl.value == UEL_VALUE && upper == 'X';
+    const uint32_t value = pcl.value;
+    const bool negative = pcl.negative;
+    pcl.value = 0;
+    pcl.negative = false;
+    pcl.fraction = false;
+    _phase = last ? PCL_TEXT : PCL_VALUE;
+
+    if (!pcl.opened) {
+      if (uel) {
+        pcl.opened = true;
+        pcl.uel = true;
+        pcl.lineBytes = 0;
+      } else {
+        unknown();
+      }
+      return;
+    }
+    if (uel) {
+      if (pcl.uel && pcl.content && pcl.jobs == 0) {
+        complete();
+        return;
+      }
+      pcl.lineBytes = 0; // PJL follows a UEL
+    }
+    pcl.content = true;
+
+    // Binary payloads: raster rows, font and pattern data (#W), transparent print data (&p#X)
+    if (!negative && value != 0 &&
+        (upper == 'W' || (pcl.parameter == '&' && pcl.group == 'p' && upper == 'X'))) {
+      _skip = value;
+    }
+  }
+
+  void DocumentEnd::pclText(uint8_t byte)
+  {
+    auto &pcl = _state.pcl;
+    pcl.content = true;
+    if (byte == '\n') {
+      pcl.lineBytes = pcl.uel ? 0 : PJL_LINE_OFF;
+      return;
+    }
+    if (pcl.lineBytes >= sizeof(pcl.line)) {
+      return;
+    }
+    pcl.line[pcl.lineBytes++] = byte;
+    if (pcl.lineBytes == sizeof(pcl.line)) {
+      if (memcmp_P(pcl.line, PJL_JOB, sizeof(pcl.line)) == 0) {
+        if (pcl.jobs < 0xFF) {
+          pcl.jobs++;
+        }
+      } else if (memcmp_P(pcl.line, PJL_EOJ, sizeof(pcl.line)) == 0 && pcl.jobs > 0) {
+        pcl.jobs--;
+      }
+    }
+  }
+}
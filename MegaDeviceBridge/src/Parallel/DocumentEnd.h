@@ -0,0 +1,136 @@
+#pragma once
+
+#include <stdint.h>
+#include "../Common/Config.h"
+
+namespace DeviceBridge::Parallel
+{
+  /**
+   * Incremental end-of-document detection on the captured byte stream
+   *
+   * ParallelPortManager feeds each file's bytes as they leave the ring;
+   * feed() stops at the byte that completes the document, so whatever the
+   * host sent after it stays in the ring for the next file.
+   *
+   *   BMP   bfSize from the file header
+   *   PCX   the RLE image size from the header (bytes per line x planes x
+   *         lines), plus the 0x0C-marked palette after version 5 8-bit images
+   *   TIFF  the IFD chain, out-of-line tag values and the end of the strip
+   *         (or tile) with the highest offset; tables already passed by the
+   *         stream cannot be read back, so those files stay open
+   *   PCL   a stream opened by ESC E ends at the next ESC E after some
+   *         content; one opened by a UEL ends at the next UEL outside a PJL
+   *         JOB/EOJ pair. Binary data blocks (ESC ... #W, ESC&p#X) are skipped.
+   *
+   * Anything else, or a header or RLE stream that does not add up (a lossy
+   * capture), is UNKNOWN and left to the idle timeout.
+   */
+  class DocumentEnd
+  {
+  public:
+    enum class Format : uint8_t {
+      DETECTING,  // no byte yet
+      UNKNOWN,    // idle timeout only
+      BMP,
+      PCX,
+      TIFF,
+      PCL
+    };
+
+    DocumentEnd();
+
+    void reset();
+    /** Leaves the rest of the current document to the idle timeout (feeding started mid-stream) */
+    void abandon() { unknown(); }
+    /** Bytes of `data` belonging to the document: all of them, or up to and including its last one */
+    uint16_t feed(const uint8_t *data, uint16_t length);
+    bool isComplete() const { return _complete; }
+    Format getFormat() const { return _format; }
+    uint32_t getPosition() const { return _position; }
+
+  private:
+    struct TiffRead {
+      uint32_t offset;
+      uint32_t count;
+      uint8_t kind;    // TIFF_IFD, TIFF_OFFSETS, TIFF_COUNTS
+      uint8_t type;    // SHORT or LONG for the strip tables
+    };
+
+    Format _format;
+    bool _complete;
+    uint8_t _phase;
+    uint32_t _position;
+    uint32_t _skip;      // Bytes passed over without looking at them
+    uint32_t _field;     // BMP bfOffBits, PCX run length
+    uint8_t _fieldBytes; // TIFF field being collected into tiff.entry
+
+    union {
+      struct {
+        uint32_t size;
+      } bmp;
+      struct {
+        uint8_t version;
+        uint8_t bitsPerPixel;
+        uint8_t planes;
+        uint16_t window[4];     // xmin, ymin, xmax, ymax
+        uint16_t bytesPerLine;
+        uint32_t remaining;     // Decoded image bytes still to come
+      } pcx;
+      struct {
+        bool bigEndian;
+        uint8_t entry[12];
+        uint8_t entryBytes;
+        uint16_t entriesLeft;
+        TiffRead reads[Common::DocumentEnd::TIFF_PENDING_READS];
+        uint8_t readCount;
+        TiffRead current;
+        uint32_t index;
+        uint32_t end;           // Furthest byte known to belong to the file
+        uint8_t strips;         // TIFF_OFFSETS | TIFF_COUNTS tables seen for the current image
+        uint32_t maxOffset;
+        uint32_t maxOffsetIndex;
+        uint32_t countAtMax;    // Valid once the offsets came first
+        uint32_t maxCount;
+        bool countAtMaxKnown;
+      } tiff;
+      struct {
+        bool uel;               // Opened by a UEL rather than ESC E
+        bool opened;
+        bool content;           // Something after the opening ESC E
+        uint8_t parameter;      // ESC sequence: parameterized and group characters
+        uint8_t group;
+        bool negative;
+        bool fraction;
+        uint32_t value;
+        uint8_t jobs;           // PJL JOB without its EOJ
+        uint8_t line[8];        // Start of the current PJL line
+        uint8_t lineBytes;
+      } pcl;
+    } _state;
+
+    void accept(uint8_t byte);
+    void skipDone();
+    void detect(uint8_t byte);
+    void complete() { _complete = true; }
+    void unknown() { _format = Format::UNKNOWN; }
+
+    void bmpByte(uint8_t byte);
+    void pcxByte(uint8_t byte);
+    void pcxDecoded(uint8_t count);
+
+    void tiffByte(uint8_t byte);
+    void tiffEntry();
+    void tiffElement(uint8_t kind, uint32_t index, uint32_t value);
+    void tiffTableDone(uint8_t kind);
+    bool tiffSchedule(uint32_t offset, uint32_t count, uint8_t kind, uint8_t type);
+    void tiffNext();
+    void tiffStartRead();
+    void tiffBegin(uint8_t phase, uint8_t bytes);
+    uint32_t tiffValue(const uint8_t *bytes, uint8_t size) const;
+    void tiffExtend(uint32_t end) { if (end > _state.tiff.end) _state.tiff.end = end; }
+
+    void pclByte(uint8_t byte);
+    void pclSequence(uint8_t terminator);
+    void pclText(uint8_t byte);
+  };
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stdint.h>
+#include <Arduino.h>
+#include "PinTraits.h"
+#include "../Common/Config.h"
+
+namespace DeviceBridge::Parallel
+{
+  /**
+   * Direct PORTx output for a pin known at compile time
+   *
+   * Replaces digitalWrite()'s pin table lookups and unconditional SREG
+   * save/restore. On PORTA..PORTG a set/clear is a single SBI/CBI. On the
+   * extended ports (H..L, e.g. BUSY/PAPER_OUT/SELECT on PORTL) the
+   * read-modify-write is wrapped in an interrupt guard so main-loop writes
+   * cannot race the /STROBE ISR.
+   */
+  template <uint8_t Pin>
+  class FastPin
+  {
+  public:
+    static constexpr uint8_t port = PinTraits::port(Pin);
+    static constexpr uint8_t mask = PinTraits::mask(Pin);
+
+    static inline void high()
+    {
+      if (PinTraits::isLowIo(port)) {
+        PinTraits::Registers<port>::set(mask);
+      } else {
+        const uint8_t sreg = SREG;
+        cli();
+        PinTraits::Registers<port>::set(mask);
+        SREG = sreg;
+      }
+    }
+
+    static inline void low()
+    {
+      if (PinTraits::isLowIo(port)) {
+        PinTraits::Registers<port>::clear(mask);
+      } else {
+        const uint8_t sreg = SREG;
+        cli();
+        PinTraits::Registers<port>::clear(mask);
+        SREG = sreg;
+      }
+    }
+
+    static inline void write(bool level)
+    {
+      if (level) {
+        high();
+      } else {
+        low();
+      }
+    }
+
+    static inline bool read() { return (PinTraits::Registers<port>::in() & mask) != 0; }
+  };
+
+  /**
+   * FastPin<>::write() on one line of the port whose Config.h wiring matched
+   * (0 = LPT_*, 1 = LPT2_*, 2 = LPT3_*); single-port builds drop the compares
+   */
+  template <uint8_t Pin, uint8_t Pin2, uint8_t Pin3>
+  inline void writeFastPort(uint8_t fastPort, bool level)
+  {
+    if (Common::ParallelPorts::COUNT > 1 && fastPort == 1) {
+      FastPin<Pin2>::write(level);
+    } else if (Common::ParallelPorts::COUNT > 2 && fastPort == 2) {
+      FastPin<Pin3>::write(level);
+    } else {
+      FastPin<Pin>::write(level);
+    }
+  }
+}
@@ -0,0 +1,147 @@
+#include <Arduino.h>
+#include <string.h>
+#include "HandshakeCalibrator.h"
+#include "OptimizedTiming.h"
+
+namespace DeviceBridge::Parallel
+{
+  namespace
+  {
+    namespace Calibration = Common::Calibration;
+
+    constexpr uint32_t CYCLES_PER_US = F_CPU / 1000000UL;
+
+    uint16_t cyclesToNs(uint32_t cycles, uint32_t count)
+    {
+      if (count == 0) {
+        return 0;
+      }
+      const uint32_t ns = (cycles * 1000UL / CYCLES_PER_US) / count;
+      return ns > 0xFFFF ? 0xFFFF : (uint16_t)ns;
+    }
+  }
+
+  HandshakeCalibrator::HandshakeCalibrator(Port &port)
+      : _port(port),
+        _state(State::IDLE),
+        _sender(),
+        _window(),
+        _candidateUs(0),
+        _bestUs(0),
+        _bestGapCycles(0),
+        _strobes(0),
+        _widths(0),
+        _widthCycles(0),
+        _result()
+  {
+  }
+
+  bool HandshakeCalibrator::begin(const char *sender)
+  {
+    const size_t length = sender != nullptr ? strlen(sender) : 0;
+    if (length == 0 || length >= sizeof(_sender) || !_port.canCalibrate()) {
+      return false;
+    }
+    memcpy(_sender, sender, length + 1);
+    _bestUs = 0;
+    _bestGapCycles = 0;
+    _strobes = 0;
+    _widths = 0;
+    _widthCycles = 0;
+    _state = State::MEASURING;
+    tryCandidate(Common::Timing::ACK_PULSE_US);
+    return true;
+  }
+
+  void HandshakeCalibrator::cancel()
+  {
+    if (_state != State::MEASURING) {
+      return;
+    }
+    _state = State::IDLE;
+    TimingProfiles::Profile active;
+    OptimizedTiming::applyProfile(TimingProfiles::getActive(active) ? &active : nullptr);
+  }
+
+  void HandshakeCalibrator::sample()
+  {
+    if (_state == State::MEASURING) {
+      _port.calibrationSession(_window);
+    }
+  }
+
+  bool HandshakeCalibrator::update()
+  {
+    if (_state != State::MEASURING || _window.gaps < Calibration::WINDOW_GAPS) {
+      return false;
+    }
+    _strobes += _window.strobes;
+    _widths += _window.widths;
+    _widthCycles += _window.widthCycles;
+    const uint32_t meanGap = _window.gapCycles / _window.gaps;
+
+    // The first window sets the pace; later ones must keep it
+    const bool honored = _bestUs == 0 || meanGap <= _bestGapCycles + (_bestGapCycles >> Calibration::GAP_SLACK_SHIFT);
+    if (honored) {
+      _bestUs = _candidateUs;
+      _bestGapCycles = meanGap;
+    }
+    if (!honored || _candidateUs <= 1) {
+      finish();
+      return true;
+    }
+    // Big steps while far from the floor, 1us steps near it
+    const uint8_t step = _candidateUs >= 8 ? _candidateUs / 4 : 1;
+    tryCandidate(_candidateUs - step);
+    return false;
+  }
+
+  void HandshakeCalibrator::tryCandidate(uint8_t ackUs)
+  {
+    _candidateUs = ackUs;
+    _window = Port::CalibrationSamples();
+    OptimizedTiming::setHandshake(ackUs, busySetupFor(ackUs));
+  }
+
+  void HandshakeCalibrator::finish()
+  {
+    memset(&_result, 0, sizeof(_result));
+    memcpy(_result.sender, _sender, sizeof(_result.sender));
+    _result.ackPulseUs = _bestUs;
+    _result.busySetupUs = busySetupFor(_bestUs);
+    _result.strobeWidthNs = cyclesToNs(_widthCycles, _widths);
+    _result.strobeGapUs = (uint16_t)(_bestGapCycles / CYCLES_PER_US);
+    _result.samples = _strobes > 0xFFFF ? 0xFFFF : (uint16_t)_strobes;
+
+    if (TimingProfiles::save(_result) && TimingProfiles::setActive(_result.sender)) {
+      _state = State::DONE;
+      OptimizedTiming::applyProfile(&_result);
+    } else {
+      // Keep running on whatever was active before
+      cancel();
+      _state = State::FAILED;
+    }
+  }
+
+  uint8_t HandshakeCalibrator::busySetupFor(uint8_t ackUs)
+  {
+    // Same ratio as the hand-tuned TDS2024 constants, at least 1us
+    const uint16_t us = ((uint16_t)ackUs * Common::Timing::HARDWARE_DELAY_US + Common::Timing::ACK_PULSE_US - 1) /
+                        Common::Timing::ACK_PULSE_US;
+    return us == 0 ? 1 : (uint8_t)us;
+  }
+
+  HandshakeCalibrator::Status HandshakeCalibrator::getStatus() const
+  {
+    Status status;
+    status.state = _state;
+    memcpy(status.sender, _sender, sizeof(status.sender));
+    status.candidateUs = _candidateUs;
+    status.bestUs = _bestUs;
+    status.windowGaps = _window.gaps;
+    status.bestGapCycles = _bestGapCycles;
+    status.strobes = _strobes + (_state == State::MEASURING ? _window.strobes : 0);
+    status.strobeWidthNs = cyclesToNs(_widthCycles + _window.widthCycles, _widths + _window.widths);
+    return status;
+  }
+}
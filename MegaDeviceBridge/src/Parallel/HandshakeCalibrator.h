@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdint.h>
+#include "Port.h"
+#include "TimingProfiles.h"
+#include "../Common/Config.h"
+
+namespace DeviceBridge::Parallel
+{
+  /**
+   * Learns the shortest /ACK the sending instrument reliably sees
+   *
+   * While active, ParallelPortManager runs Port::calibrationSession() on
+   * every update with data; those time the /STROBE width and the gap
+   * between strobes while BUSY is low. Starting from ACK_PULSE_US, each
+   * candidate /ACK width is used on both capture paths for
+   * Calibration::WINDOW_GAPS gaps. A sender that still sees the pulse
+   * keeps its pace (mean gap within 1/8 of the last honored width); one
+   * that misses it waits for its own /ACK timeout and the mean gap jumps.
+   * The shortest honored width, the BUSY setup time scaled from it by the
+   * Config.h ratio and the measured strobe width and gap are saved as the
+   * sender's profile (TimingProfiles) and made active.
+   */
+  class HandshakeCalibrator
+  {
+  public:
+    enum class State : uint8_t {
+      IDLE,       // never started, or stopped
+      MEASURING,  // waiting for / timing the sender's traffic
+      DONE,       // profile saved and active
+      FAILED      // profile table full
+    };
+
+    struct Status {
+      State state;
+      char sender[Common::Calibration::SENDER_NAME_LENGTH];
+      uint8_t candidateUs;     // /ACK width being tried
+      uint8_t bestUs;          // shortest width honored so far, 0 before the first window
+      uint16_t windowGaps;     // gaps measured at candidateUs
+      uint32_t bestGapCycles;  // mean gap at bestUs
+      uint32_t strobes;        // bytes taken by calibration sessions
+      uint16_t strobeWidthNs;  // mean /STROBE low time so far
+    };
+
+    explicit HandshakeCalibrator(Port &port);
+
+    /** false if the name is empty or too long, or the port cannot run sessions (ackmode timer, wiring) */
+    bool begin(const char *sender);
+    /** Back to the active profile's timings */
+    void cancel();
+    bool isActive() const { return _state == State::MEASURING; }
+
+    /** One calibration session; masks interrupts itself */
+    void sample();
+    /** Main loop: judges a complete window; true when calibration ended in this call */
+    bool update();
+
+    Status getStatus() const;
+    /** Profile saved by the last calibration that reached DONE */
+    const TimingProfiles::Profile &getResult() const { return _result; }
+
+  private:
+    Port &_port;
+    State _state;
+    char _sender[Common::Calibration::SENDER_NAME_LENGTH];
+    Port::CalibrationSamples _window;
+    uint8_t _candidateUs;
+    uint8_t _bestUs;
+    uint32_t _bestGapCycles;
+    uint32_t _strobes;
+    uint32_t _widths;
+    uint32_t _widthCycles;
+    TimingProfiles::Profile _result;
+
+    void tryCandidate(uint8_t ackUs);
+    void finish();
+    static uint8_t busySetupFor(uint8_t ackUs);
+  };
+}
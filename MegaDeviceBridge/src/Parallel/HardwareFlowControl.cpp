@@ -1,4 +1,5 @@
 #include "HardwareFlowControl.h"
+#include "FastPin.h"
 #include "../Common/ServiceLocator.h"
 
 namespace DeviceBridge::Parallel {
@@ -15,6 +16,13 @@ HardwareFlowControl::HardwareFlowControl()
     , _emergencyCount(0)
     , _recoveryCount(0)
     , _pinStates(0)
+    , _fastSignals(false)
+    , _fastPort(0xFF)
+    , _escalateLevel(0xFFFF)
+    , _deferred(0)
+    , _predictive(false)
+    , _overshootPeak(0)
+    , _predictionTime(0)
 {
     // Initialize with default configuration using cached timing values
     _config.busyPin = Common::Pins::LPT_BUSY;
@@ -31,6 +39,8 @@ HardwareFlowControl::HardwareFlowControl()
     // Hardware timing for reliable signal recognition
     _config.signalSetupTime = 2;  // 2μs setup time for host recognition
     _config.signalHoldTime = 5;   // 5μs hold time for signal stability
+    _fixedConfig = _config;
+    _escalateLevel = _config.warningThreshold;
 }
 
 HardwareFlowControl::HardwareFlowControl(const Config& config) 
@@ -46,7 +56,23 @@ HardwareFlowControl::HardwareFlowControl(const Config& config)
     , _emergencyCount(0)
     , _recoveryCount(0)
     , _pinStates(0)
+    , _fastSignals(false)
+    , _fastPort(0xFF)
+    , _escalateLevel(0xFFFF)
+    , _deferred(0)
+    , _predictive(false)
+    , _fixedConfig(config)
+    , _overshootPeak(0)
+    , _predictionTime(0)
 {
+    _escalateLevel = _config.warningThreshold;
+}
+
+void HardwareFlowControl::setPins(uint8_t busyPin, uint8_t errorPin, uint8_t paperOutPin, uint8_t selectPin) {
+    _config.busyPin = _fixedConfig.busyPin = busyPin;
+    _config.errorPin = _fixedConfig.errorPin = errorPin;
+    _config.paperOutPin = _fixedConfig.paperOutPin = paperOutPin;
+    _config.selectPin = _fixedConfig.selectPin = selectPin;
 }
 
 void HardwareFlowControl::initialize() {
@@ -63,84 +89,124 @@ void HardwareFlowControl::initialize() {
     pinMode(_config.selectPin, OUTPUT);
     digitalWrite(_config.selectPin, HIGH);   // Selected initially
     
+    // FastPin<> is bound to Config.h at compile time; other wiring keeps digitalWrite
+    _fastSignals = _config.busyPin == Common::Pins::LPT_BUSY &&
+                   _config.errorPin == Common::Pins::LPT_ERROR &&
+                   _config.paperOutPin == Common::Pins::LPT_PAPER_OUT &&
+                   _config.selectPin == Common::Pins::LPT_SELECT;
+    _fastPort = _fastSignals ? 0 : 0xFF;
+#if DEVICEBRIDGE_PARALLEL_PORTS > 1
+    if (_config.busyPin == Common::Pins::LPT2_BUSY && _config.errorPin == Common::Pins::LPT2_ERROR &&
+        _config.paperOutPin == Common::Pins::LPT2_PAPER_OUT && _config.selectPin == Common::Pins::LPT2_SELECT) {
+        _fastPort = 1;
+    }
+#endif
+#if DEVICEBRIDGE_PARALLEL_PORTS > 2
+    if (_config.busyPin == Common::Pins::LPT3_BUSY && _config.errorPin == Common::Pins::LPT3_ERROR &&
+        _config.paperOutPin == Common::Pins::LPT3_PAPER_OUT && _config.selectPin == Common::Pins::LPT3_SELECT) {
+        _fastPort = 2;
+    }
+#endif
+    
     // Initialize state
     _currentState = FlowState::NORMAL;
     _previousState = FlowState::NORMAL;
     _stateChangeTime = millis();
     _stateHoldTime = 0;
     _emergencyMode = false;
-    
-    // Update pin state cache
-    updatePinStateCache();
+    _escalateLevel = escalationLevel(_currentState);
+    _deferred = 0;
     
     // Apply initial hardware signals
     applyHardwareSignals();
+    
+    // Update pin state cache
+    updatePinStateCache();
 }
 
-bool HardwareFlowControl::updateFlowControl(uint16_t bufferLevel, uint16_t bufferSize) {
-    // Calculate buffer utilization percentage
-    uint16_t bufferPercentage = (bufferLevel * 100) / bufferSize;
-    
-    // Determine optimal state based on buffer level
+bool HardwareFlowControl::escalate(uint16_t bufferLevel) {
     FlowState optimalState = calculateOptimalState(bufferLevel);
-    
-    // Check if state transition is allowed (prevent oscillation)
-    if (!isStateTransitionAllowed(optimalState)) {
-        return false; // No state change
-    }
-    
-    // Emergency override - immediate response to buffer overflow risk
-    if (bufferLevel >= _config.emergencyThreshold && !_emergencyMode) {
-        _emergencyMode = true;
-        _emergencyStartTime = millis();
-        _emergencyCount++;
-        optimalState = FlowState::EMERGENCY;
+    _lastBufferLevel = bufferLevel;
+    if (optimalState <= _currentState) {
+        return false;
     }
+    enterState(optimalState);
+    return true;
+}
+
+bool HardwareFlowControl::updateAfterDrain(uint16_t bufferLevel) {
+    // Stamp a change the ISR made before its hold time is checked
+    processDeferred();
     
-    // Update state if changed
-    if (optimalState != _currentState) {
-        _previousState = _currentState;
-        _currentState = optimalState;
-        _stateChangeTime = millis();
-        _stateTransitions++;
-        
-        // Apply hardware signals immediately for ISR context
-        applyHardwareSignals();
-        
+    const uint8_t sreg = SREG;
+    cli();
+    FlowState optimalState = calculateOptimalState(bufferLevel);
+    bool changed = false;
+    if (optimalState > _currentState) {
+        changed = escalate(bufferLevel);
+    } else if (optimalState < _currentState && isStateTransitionAllowed(optimalState)) {
         _lastBufferLevel = bufferLevel;
-        return true; // State changed
+        enterState(optimalState);
+        changed = true;
     }
+    SREG = sreg;
     
-    _lastBufferLevel = bufferLevel;
-    return false; // No state change
+    if (changed) {
+        // Setup time for the host to see the new levels; here rather than in the ISR
+        delayMicroseconds(_config.signalSetupTime);
+        processDeferred();
+    }
+    return changed;
 }
 
 void HardwareFlowControl::setFlowState(FlowState state) {
     if (state != _currentState) {
-        _previousState = _currentState;
-        _currentState = state;
-        _stateChangeTime = millis();
-        _stateTransitions++;
-        
-        // Handle emergency mode flag
-        if (state == FlowState::EMERGENCY) {
+        enterState(state);
+    }
+}
+
+void HardwareFlowControl::enterState(FlowState state) {
+    _previousState = _currentState;
+    _currentState = state;
+    _stateTransitions++;
+    _deferred |= DEFERRED_STATE_CHANGE;
+    
+    // Handle emergency mode flag
+    if (state == FlowState::EMERGENCY) {
+        if (!_emergencyMode) {
             _emergencyMode = true;
-            _emergencyStartTime = millis();
             _emergencyCount++;
-        } else if (_emergencyMode && state == FlowState::NORMAL) {
-            _emergencyMode = false;
-            _recoveryCount++;
+            _deferred |= DEFERRED_EMERGENCY;
         }
-        
-        applyHardwareSignals();
+    } else if (_emergencyMode && state == FlowState::NORMAL) {
+        _emergencyMode = false;
+        _recoveryCount++;
+    }
+    
+    _escalateLevel = escalationLevel(state);
+    applyHardwareSignals();
+}
+
+uint16_t HardwareFlowControl::escalationLevel(FlowState state) const {
+    switch (state) {
+        case FlowState::NORMAL:   return _config.warningThreshold;
+        case FlowState::WARNING:  return _config.criticalThreshold;
+        case FlowState::CRITICAL: return _config.emergencyThreshold;
+        default:                  return 0xFFFF;
     }
 }
 
 void HardwareFlowControl::resetEmergency() {
     if (_emergencyMode) {
-        _emergencyMode = false;
-        _recoveryCount++;
-        setFlowState(FlowState::NORMAL);
+        const uint8_t sreg = SREG;
+        cli();
+        if (_currentState == FlowState::NORMAL) {
+            _emergencyMode = false;
+            _recoveryCount++;
+        } else {
+            enterState(FlowState::NORMAL);
+        }
+        SREG = sreg;
     }
 }
 
@@ -155,6 +221,22 @@ HardwareFlowControl::Statistics HardwareFlowControl::getStatistics() const {
 }
 
 void HardwareFlowControl::processDeferred() {
+    const uint8_t sreg = SREG;
+    cli();
+    const uint8_t deferred = _deferred;
+    _deferred = 0;
+    SREG = sreg;
+    
+    if (deferred) {
+        // Hold times run from when the loop saw the change; at worst one loop late, never early
+        const uint32_t now = millis();
+        _stateChangeTime = now;
+        if (deferred & DEFERRED_EMERGENCY) {
+            _emergencyStartTime = now;
+        }
+        updatePinStateCache();
+    }
+    
     // Check for emergency timeout (20 seconds max)
     if (_emergencyMode) {
         uint32_t emergencyDuration = millis() - _emergencyStartTime;
@@ -168,6 +250,90 @@ void HardwareFlowControl::processDeferred() {
     // (logging, statistics updates, etc.)
 }
 
+void HardwareFlowControl::setPredictiveEnabled(bool enabled) {
+    if (enabled == _predictive) {
+        return;
+    }
+    if (!enabled) {
+        const uint8_t sreg = SREG;
+        cli();
+        _predictive = false;
+        _config.warningThreshold = _fixedConfig.warningThreshold;
+        _config.criticalThreshold = _fixedConfig.criticalThreshold;
+        _config.emergencyThreshold = _fixedConfig.emergencyThreshold;
+        _config.recoveryThreshold = _fixedConfig.recoveryThreshold;
+        _escalateLevel = escalationLevel(_currentState);
+        SREG = sreg;
+        return;
+    }
+    
+    _fixedConfig = _config;
+    _overshootPeak = 0;
+    _predictionTime = millis();
+    _predictive = true;
+    applyPredictedThresholds();
+}
+
+void HardwareFlowControl::recordDrain(uint16_t levelBefore) {
+    // Anything above the BUSY level came in after BUSY rose
+    const uint16_t busyLevel = _config.warningThreshold;
+    const uint16_t overshoot =
+        _currentState != FlowState::NORMAL && levelBefore > busyLevel ? levelBefore - busyLevel : 0;
+    const uint16_t decayed = _overshootPeak - (_overshootPeak >> Common::FlowControl::PREDICT_OVERSHOOT_DECAY_SHIFT);
+    _overshootPeak = overshoot > decayed ? overshoot : decayed;
+}
+
+void HardwareFlowControl::updatePrediction() {
+    if (!_predictive) {
+        return;
+    }
+    const uint32_t now = millis();
+    if (now - _predictionTime < Common::FlowControl::PREDICT_INTERVAL_MS) {
+        return;
+    }
+    _predictionTime = now;
+    applyPredictedThresholds();
+}
+
+void HardwareFlowControl::applyPredictedThresholds() {
+    // updateFlowControl() raises BUSY from the ISR the moment the level gets
+    // there, storage write or not, so BUSY does not have to anticipate a
+    // stalled main loop: a margin of fill rate times storage latency only
+    // holds the host off early. The room above it only has to take what the
+    // host sends before it sees BUSY: twice the worst recent overshoot.
+    constexpr uint16_t size = Common::FlowControl::RING_BUFFER_SIZE;
+    constexpr uint16_t floor = Common::FlowControl::PREDICT_MIN_BUSY_LEVEL;
+    uint16_t room = _overshootPeak << Common::FlowControl::PREDICT_OVERSHOOT_MARGIN_SHIFT;
+    if (room < Common::FlowControl::PREDICT_RESERVE_BYTES) {
+        room = Common::FlowControl::PREDICT_RESERVE_BYTES;
+    }
+    
+    const uint16_t busy = room >= size - floor ? floor : (uint16_t)(size - room);
+    const uint16_t critical = busy + (size - busy) / 2;
+    const uint16_t emergency = critical + (size - critical) / 2;
+    const uint16_t recovery = busy > Common::FlowControl::PREDICT_HYSTERESIS_BYTES
+                                  ? busy - Common::FlowControl::PREDICT_HYSTERESIS_BYTES
+                                  : 0;
+    
+    const uint8_t sreg = SREG;
+    cli();
+    _config.warningThreshold = busy;
+    _config.criticalThreshold = critical;
+    _config.emergencyThreshold = emergency;
+    _config.recoveryThreshold = recovery;
+    _escalateLevel = escalationLevel(_currentState);
+    SREG = sreg;
+}
+
+HardwareFlowControl::PredictionStatistics HardwareFlowControl::getPredictionStatistics() const {
+    PredictionStatistics stats;
+    stats.enabled = _predictive;
+    stats.overshootPeak = _overshootPeak;
+    stats.busyLevel = _config.warningThreshold;
+    stats.recoveryLevel = _config.recoveryThreshold;
+    return stats;
+}
+
 const char* HardwareFlowControl::getStateName(FlowState state) {
     switch (state) {
         case FlowState::NORMAL:    return "NORMAL";
@@ -185,42 +351,39 @@ void HardwareFlowControl::applyHardwareSignals() {
     switch (_currentState) {
         case FlowState::NORMAL:
             // Normal operation - ready to receive data
-            digitalWrite(_config.busyPin, LOW);      // Not busy
-            digitalWrite(_config.errorPin, HIGH);    // No error (active LOW)
-            digitalWrite(_config.paperOutPin, LOW);  // Paper available
-            digitalWrite(_config.selectPin, HIGH);   // Selected
+            writeSignals(LOW, HIGH, LOW, HIGH);      // Not busy, no error (active LOW), paper available, selected
             break;
             
         case FlowState::WARNING:
             // Buffer getting full - signal host to slow down
-            digitalWrite(_config.busyPin, HIGH);     // Busy signal
-            digitalWrite(_config.errorPin, HIGH);    // No error yet
-            digitalWrite(_config.paperOutPin, LOW);  // Paper still available
-            digitalWrite(_config.selectPin, HIGH);   // Still selected
+            writeSignals(HIGH, HIGH, LOW, HIGH);     // Busy, no error yet, paper still available, still selected
             break;
             
         case FlowState::CRITICAL:
             // Buffer nearly full - strong signal to slow down
-            digitalWrite(_config.busyPin, HIGH);     // Busy signal
-            digitalWrite(_config.errorPin, HIGH);    // No error yet
-            digitalWrite(_config.paperOutPin, HIGH); // Paper out signal (additional warning)
-            digitalWrite(_config.selectPin, HIGH);   // Still selected
+            writeSignals(HIGH, HIGH, HIGH, HIGH);    // Busy, no error yet, paper out (additional warning), still selected
             break;
             
         case FlowState::EMERGENCY:
             // Buffer overflow imminent - signal to stop immediately
-            digitalWrite(_config.busyPin, HIGH);     // Busy signal
-            digitalWrite(_config.errorPin, LOW);     // Error signal (active LOW)
-            digitalWrite(_config.paperOutPin, HIGH); // Paper out signal
-            digitalWrite(_config.selectPin, LOW);    // Not selected (stop transmission)
+            writeSignals(HIGH, LOW, HIGH, LOW);      // Busy, error (active LOW), paper out, not selected (stop transmission)
             break;
     }
-    
-    // Brief delay for signal setup time (hardware recognition)
-    delayMicroseconds(_config.signalSetupTime);
-    
-    // Update cached pin states
-    updatePinStateCache();
+}
+
+void HardwareFlowControl::writeSignals(bool busy, bool error, bool paperOut, bool select) {
+    // Pin levels as driven on the wire (ERROR is active LOW)
+    if (_fastPort != 0xFF) {
+        writeFastPort<Common::Pins::LPT_BUSY, Common::Pins::LPT2_BUSY, Common::Pins::LPT3_BUSY>(_fastPort, busy);
+        writeFastPort<Common::Pins::LPT_ERROR, Common::Pins::LPT2_ERROR, Common::Pins::LPT3_ERROR>(_fastPort, error);
+        writeFastPort<Common::Pins::LPT_PAPER_OUT, Common::Pins::LPT2_PAPER_OUT, Common::Pins::LPT3_PAPER_OUT>(_fastPort, paperOut);
+        writeFastPort<Common::Pins::LPT_SELECT, Common::Pins::LPT2_SELECT, Common::Pins::LPT3_SELECT>(_fastPort, select);
+    } else {
+        digitalWrite(_config.busyPin, busy);
+        digitalWrite(_config.errorPin, error);
+        digitalWrite(_config.paperOutPin, paperOut);
+        digitalWrite(_config.selectPin, select);
+    }
 }
 
 HardwareFlowControl::FlowState HardwareFlowControl::calculateOptimalState(uint16_t bufferLevel) const {
@@ -259,8 +422,9 @@ bool HardwareFlowControl::isStateTransitionAllowed(FlowState newState) const {
         return true;
     }
     
-    // Always allow recovery from emergency
-    if (_currentState == FlowState::EMERGENCY && newState == FlowState::NORMAL) {
+    // Always allow recovery to NORMAL: the level is already down to the
+    // recovery threshold, whose gap to the warning level is the hysteresis
+    if (newState == FlowState::NORMAL) {
         return true;
     }
     
@@ -270,6 +434,13 @@ bool HardwareFlowControl::isStateTransitionAllowed(FlowState newState) const {
 
 void HardwareFlowControl::updatePinStateCache() {
     // Cache current pin states for fast access
+    if (_fastSignals) {
+        _pinStates = (FastPin<Common::Pins::LPT_BUSY>::read() ? 0x01 : 0) |
+                     (FastPin<Common::Pins::LPT_ERROR>::read() ? 0x02 : 0) |
+                     (FastPin<Common::Pins::LPT_PAPER_OUT>::read() ? 0x04 : 0) |
+                     (FastPin<Common::Pins::LPT_SELECT>::read() ? 0x08 : 0);
+        return;
+    }
     _pinStates = 0;
     _pinStates |= (digitalRead(_config.busyPin) ? 0x01 : 0);
     _pinStates |= (digitalRead(_config.errorPin) ? 0x02 : 0);
@@ -65,6 +65,22 @@ private:
     
     // Pin state cache for fast access
     volatile uint8_t _pinStates;
+    bool _fastSignals;          // Config pins match the first port's Common::Pins, so FastPin<> can read them
+    uint8_t _fastPort;          // Port whose Common::Pins match (writeFastPort()), 0xFF for digitalWrite
+    
+    // ISR fast path: the level that moves to the next state up, kept in step with
+    // _currentState and the thresholds so the ISR makes one compare per byte
+    volatile uint16_t _escalateLevel;
+    // Work the ISR leaves to processDeferred(): time stamps, pin cache
+    volatile uint8_t _deferred;
+    static constexpr uint8_t DEFERRED_STATE_CHANGE = 0x01;
+    static constexpr uint8_t DEFERRED_EMERGENCY = 0x02;
+    
+    // Predictive thresholds (setPredictiveEnabled)
+    bool _predictive;
+    Config _fixedConfig;                // Thresholds to restore when prediction is turned off
+    uint16_t _overshootPeak;            // Decaying peak of bytes received after BUSY rose
+    uint32_t _predictionTime;
     
 public:
     /**
@@ -78,6 +94,12 @@ public:
      */
     explicit HardwareFlowControl(const Config& config);
     
+    /**
+     * @brief Drive another port's status lines instead of the Config.h ones
+     * Call before initialize(); thresholds and timings are kept
+     */
+    void setPins(uint8_t busyPin, uint8_t errorPin, uint8_t paperOutPin, uint8_t selectPin);
+    
     /**
      * @brief Initialize hardware flow control
      * Must be called during system setup
@@ -86,16 +108,28 @@ public:
     
     /**
      * @brief Update flow control based on buffer level
-     * Call from ISR context for immediate hardware response
-     * @param bufferLevel Current buffer utilization (0-100%)
-     * @param bufferSize Total buffer capacity
+     * Call from ISR context for immediate hardware response. Only moves to a
+     * more restrictive state: no division, millis() or delays; releases, the
+     * hold times and time stamps are main loop work (updateAfterDrain(),
+     * processDeferred())
+     * @param bufferLevel Bytes in the buffer
+     * @return true if state changed, false if no change
+     */
+    bool updateFlowControl(uint16_t bufferLevel) {
+        return bufferLevel >= _escalateLevel && escalate(bufferLevel);
+    }
+    
+    /**
+     * @brief Re-evaluate the state after the consumer drained the buffer
+     * Main loop context; masks interrupts around the update the ISR also makes
+     * @param bufferLevel Bytes left in the buffer
      * @return true if state changed, false if no change
      */
-    bool updateFlowControl(uint16_t bufferLevel, uint16_t bufferSize);
+    bool updateAfterDrain(uint16_t bufferLevel);
     
     /**
      * @brief Force specific flow control state
-     * Used for emergency conditions or testing
+     * Used for emergency conditions or testing; ISR safe
      * @param state Desired flow control state
      */
     void setFlowState(FlowState state);
@@ -130,6 +164,33 @@ public:
     
     Statistics getStatistics() const;
     
+    /**
+     * @brief Replace the fixed thresholds with ones predicted from measurements
+     * The ISR raises BUSY as soon as the level reaches it, so the ring only has
+     * to hold what the host sends before it sees BUSY: BUSY sits twice the
+     * peak overshoot below the top. Disabling restores the thresholds the
+     * controller was configured with
+     */
+    void setPredictiveEnabled(bool enabled);
+    bool isPredictiveEnabled() const { return _predictive; }
+    
+    /**
+     * @brief Main loop hooks feeding the prediction
+     * recordDrain() after each read from the ring, with the level before it;
+     * updatePrediction() once per loop
+     */
+    void recordDrain(uint16_t levelBefore);
+    void updatePrediction();
+    
+    struct PredictionStatistics {
+        bool enabled;
+        uint16_t overshootPeak;     // bytes received after BUSY rose
+        uint16_t busyLevel;         // ring level that raises BUSY (WARNING)
+        uint16_t recoveryLevel;     // ring level that releases it
+    };
+    
+    PredictionStatistics getPredictionStatistics() const;
+    
     /**
      * @brief Process deferred flow control operations
      * Call from main loop context for non-critical operations
@@ -146,10 +207,32 @@ public:
 private:
     /**
      * @brief Apply hardware signals for current state
-     * Fast pin manipulation for ISR context
+     * Fast pin manipulation for ISR context; setup time is left to the caller
      */
     void applyHardwareSignals();
     
+    /**
+     * @brief Enter a state: counters, emergency bookkeeping, pins, next threshold
+     * ISR safe; the time stamps are deferred to processDeferred()
+     */
+    void enterState(FlowState state);
+    
+    /**
+     * @brief Level at which the given state escalates (0xFFFF from EMERGENCY)
+     */
+    uint16_t escalationLevel(FlowState state) const;
+    
+    /**
+     * @brief ISR slow path: the level reached the next threshold up
+     */
+    bool escalate(uint16_t bufferLevel);
+    
+    /**
+     * @brief Drive BUSY/ERROR/PAPER_OUT/SELECT to the given wire levels
+     * FastPin<> when the pins match Config.h, digitalWrite otherwise
+     */
+    void writeSignals(bool busy, bool error, bool paperOut, bool select);
+    
     /**
      * @brief Calculate optimal state based on buffer level
      * @param bufferLevel Current buffer utilization
@@ -159,7 +242,7 @@ private:
     
     /**
      * @brief Check if state transition is allowed
-     * Prevents rapid state oscillation
+     * Prevents rapid state oscillation; main loop only (millis())
      * @param newState Proposed new state
      * @return true if transition is allowed
      */
@@ -169,6 +252,12 @@ private:
      * @brief Update pin states cache for fast access
      */
     void updatePinStateCache();
+    
+    /**
+     * @brief Thresholds from the current peak overshoot
+     * Main loop only; the ISR sees the four thresholds change together
+     */
+    void applyPredictedThresholds();
 };
 
 } // namespace DeviceBridge::Parallel
\ No newline at end of file
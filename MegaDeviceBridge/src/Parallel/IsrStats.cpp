@@ -0,0 +1,82 @@
+#include <Arduino.h>
+#include <string.h>
+#include "IsrStats.h"
+
+#ifdef DEVICEBRIDGE_ISR_STATS
+
+namespace DeviceBridge::Parallel::IsrStats
+{
+  volatile uint16_t ackStamp = 0;
+
+  namespace
+  {
+    Statistics stats;
+
+    void clear()
+    {
+      memset(&stats, 0, sizeof(stats));
+      stats.duration.min = 0xFFFF;
+      stats.latency.min = 0xFFFF;
+    }
+
+    inline void add(Histogram &h, uint16_t cycles)
+    {
+      h.count++;
+      if (cycles < h.min) {
+        h.min = cycles;
+      }
+      if (cycles > h.max) {
+        h.max = cycles;
+      }
+      h.sum += cycles;
+
+      uint8_t bucket = 0;
+      while (cycles >>= 1) {
+        bucket++;
+      }
+      if (h.buckets[bucket] != 0xFFFF) {
+        h.buckets[bucket]++;
+      }
+    }
+  }
+
+  void initialize()
+  {
+    const uint8_t sreg = SREG;
+    cli();
+    TIMSK1 = 0;
+    TCCR1A = 0;            // normal mode, OC1x disconnected (no PWM on pins 11/12)
+    TCCR1B = (1 << CS10);  // clk/1
+    clear();
+    SREG = sreg;
+  }
+
+  void reset()
+  {
+    const uint8_t sreg = SREG;
+    cli();
+    clear();
+    SREG = sreg;
+  }
+
+  void snapshot(Statistics &out)
+  {
+    const uint8_t sreg = SREG;
+    cli();
+    out = stats;
+    SREG = sreg;
+  }
+
+  void recordLatency(uint16_t entry)
+  {
+    add(stats.latency, ackStamp - entry + DISPATCH_CYCLES);
+  }
+
+  void recordDuration(uint16_t entry)
+  {
+    const uint16_t exit = TCNT1;
+    add(stats.duration, exit - entry);
+  }
+}
+
+#endif
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stdint.h>
+#include <Arduino.h>
+#include "../Common/Config.h"
+
+namespace DeviceBridge::Parallel
+{
+  /**
+   * Optimized /STROBE ISR timing statistics
+   *
+   * Built with -D DEVICEBRIDGE_ISR_STATS (env megaatmega2560_isrstats).
+   * Timer1 free-runs at clk/1 and Port::handleInterruptOptimized() stamps
+   * TCNT1 on entry, just before /ACK is pulled low and on exit. Each
+   * interrupt adds its duration (entry to exit, burst bytes included) and its
+   * strobe-to-/ACK latency (entry to /ACK plus DISPATCH_CYCLES for the
+   * interrupt response and attachInterrupt()'s dispatcher, which run before
+   * the first stamp) to a min/max/sum and a log2 histogram.
+   *
+   * Without the flag the hooks are empty inlines, no storage is reserved
+   * and Timer1 is left alone.
+   */
+  namespace IsrStats
+  {
+    /** Interrupt response, vector JMP, WInterrupts prologue, ICALL and isr0()'s mode checks */
+    constexpr uint8_t DISPATCH_CYCLES = 44;
+    /** /ACK deadline after /STROBE that the capture path is written against */
+    constexpr uint8_t ACK_LIMIT_US = 10;
+    constexpr uint8_t BUCKETS = 16;
+
+    /** Cycles (62.5ns); buckets[n] counts values in [2^n, 2^(n+1)), 0 lands in bucket 0 */
+    struct Histogram
+    {
+      uint32_t count;
+      uint16_t min;
+      uint16_t max;
+      uint32_t sum;
+      uint16_t buckets[BUCKETS]; // saturate at 65535
+    };
+
+    struct Statistics
+    {
+      Histogram duration; // one per interrupt
+      Histogram latency;  // interrupts whose first byte was acknowledged
+    };
+
+#ifdef DEVICEBRIDGE_ISR_STATS
+    constexpr bool ENABLED = true;
+
+    extern volatile uint16_t ackStamp;
+
+    /** Start Timer1 at clk/1 (normal mode, outputs disconnected) and clear the statistics */
+    void initialize();
+    void reset();
+    /** Consistent copy, taken with interrupts off */
+    void snapshot(Statistics &out);
+
+    inline uint16_t stamp() { return TCNT1; }
+    inline void markAck() { ackStamp = TCNT1; }
+    /** Called with interrupts off: after the first byte was acknowledged, and on exit */
+    void recordLatency(uint16_t entry);
+    void recordDuration(uint16_t entry);
+#else
+    constexpr bool ENABLED = false;
+
+    inline void initialize() {}
+    inline uint16_t stamp() { return 0; }
+    inline void markAck() {}
+    inline void recordLatency(uint16_t) {}
+    inline void recordDuration(uint16_t) {}
+#endif
+  }
+}
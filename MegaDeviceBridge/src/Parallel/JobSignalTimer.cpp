@@ -0,0 +1,73 @@
+#include <Arduino.h>
+#include <avr/interrupt.h>
+#include "JobSignalTimer.h"
+#include "Port.h"
+
+namespace DeviceBridge::Parallel::JobSignalTimer
+{
+  namespace
+  {
+    constexpr uint16_t PERIOD_TICKS = Common::JobBoundary::SAMPLE_PERIOD_US * TICKS_PER_US;
+    Port *volatile targets[Common::ParallelPorts::COUNT] = {};
+  }
+
+  void initialize(Port &port)
+  {
+    const uint8_t sreg = SREG;
+    cli();
+    uint8_t free = Common::ParallelPorts::COUNT;
+    bool listed = false;
+    for (uint8_t i = 0; i < Common::ParallelPorts::COUNT; i++) {
+      if (targets[i] == &port) {
+        listed = true;
+      } else if (targets[i] == nullptr && free == Common::ParallelPorts::COUNT) {
+        free = i;
+      }
+    }
+    if (!listed && free < Common::ParallelPorts::COUNT) {
+      targets[free] = &port;
+    }
+    if (!isEnabled()) {
+      TCCR3A = 0;               // normal mode, OC3x disconnected
+      TCCR3B = (1 << CS31);     // clk/8
+      OCR3A = TCNT3 + PERIOD_TICKS;
+      TIFR3 = (1 << OCF3A);
+      TIMSK3 |= (1 << OCIE3A);
+    }
+    SREG = sreg;
+  }
+
+  void stop(Port &port)
+  {
+    const uint8_t sreg = SREG;
+    cli();
+    bool any = false;
+    for (uint8_t i = 0; i < Common::ParallelPorts::COUNT; i++) {
+      if (targets[i] == &port) {
+        targets[i] = nullptr;
+      }
+      any = any || targets[i] != nullptr;
+    }
+    if (!any) {
+      TIMSK3 &= ~(1 << OCIE3A);
+      TCCR3B = 0;
+    }
+    SREG = sreg;
+  }
+
+  bool isEnabled() { return (TIMSK3 & (1 << OCIE3A)) != 0; }
+}
+
+using namespace DeviceBridge::Parallel;
+
+// Periodic: the next compare is scheduled from the last one, not from now, so latency does not drift
+ISR(TIMER3_COMPA_vect)
+{
+  OCR3A = OCR3A + JobSignalTimer::PERIOD_TICKS;
+  for (uint8_t i = 0; i < DeviceBridge::Common::ParallelPorts::COUNT; i++) {
+    Port *port = JobSignalTimer::targets[i];
+    if (port) {
+      port->sampleJobSignals();
+    }
+  }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+#include "../Common/Config.h"
+
+namespace DeviceBridge::Parallel
+{
+  class Port;
+
+  /**
+   * Timer3 sampling of /INIT and /SELECT-IN for job boundaries
+   *
+   * /INIT (PA4) and /SELECT-IN (PA6) have no external or pin-change
+   * interrupt on the ATmega2560, and the main loop only reaches
+   * ParallelPortManager every millisecond or so, which misses most /INIT
+   * pulses. Timer3 free-runs at clk/8 and its compare A vector samples both
+   * lines every JobBoundary::SAMPLE_PERIOD_US, so an edge is latched with
+   * the ring position of its moment. Timer1 and Timer5 are left free.
+   * Multi-port builds sample every port that asked, in one vector.
+   *
+   * The vector calls Port::sampleJobSignals() out of line, so it saves
+   * every call-clobbered register, and a strobe arriving during a tick
+   * waits for it; its cost on the AVR has not been measured. It only runs
+   * while `jobsplit` watches a signal (off by default).
+   */
+  namespace JobSignalTimer
+  {
+    constexpr uint8_t TICKS_PER_US = 2; // 16MHz / 8
+
+    /** Start Timer3 if needed and sample `port`'s job signals; its control lines must be on Config.h pins */
+    void initialize(Port &port);
+    /** Stop sampling `port`; Timer3 stops with the last port */
+    void stop(Port &port);
+    bool isEnabled();
+  }
+}
@@ -1,4 +1,5 @@
 #include <Arduino.h>
+#include <string.h>
 #include "OptimizedTiming.h"
 #include "../Common/ServiceLocator.h"
 #include "../Common/ConfigurationService.h"
@@ -7,10 +8,14 @@ namespace DeviceBridge::Parallel {
 
 // Static member initialization
 bool OptimizedTiming::_initialized = false;
+bool OptimizedTiming::_profileLoaded = false;
+char OptimizedTiming::_profileSender[Common::Calibration::SENDER_NAME_LENGTH] = "";
 
-uint16_t OptimizedTiming::hardwareDelayUs = 0;
-uint16_t OptimizedTiming::ackPulseUs = 0; 
-uint16_t OptimizedTiming::recoveryDelayUs = 0;
+// Handshake timings the ISRs use from reset; profiles replace them
+uint16_t OptimizedTiming::hardwareDelayUs = Common::Timing::HARDWARE_DELAY_US;
+uint16_t OptimizedTiming::ackPulseUs = Common::Timing::ACK_PULSE_US;
+uint16_t OptimizedTiming::fastAckPulseUs = Common::Timing::FAST_ACK_PULSE_US;
+uint16_t OptimizedTiming::recoveryDelayUs = Common::Timing::RECOVERY_DELAY_US;
 uint16_t OptimizedTiming::criticalFlowDelayUs = 0;
 uint16_t OptimizedTiming::moderateFlowDelayUs = 0;
 uint16_t OptimizedTiming::flowControlDelayUs = 0;
@@ -30,9 +35,10 @@ void OptimizedTiming::initialize() {
         return; // Already initialized
     }
     
-    // Cache all timing values from configuration constants
-    hardwareDelayUs = Common::Timing::HARDWARE_DELAY_US;
-    ackPulseUs = Common::Timing::ACK_PULSE_US;
+    // Handshake timings: the active sender profile, else Config.h
+    loadProfile();
+    
+    // Cache the remaining timing values from configuration constants
     recoveryDelayUs = Common::Timing::RECOVERY_DELAY_US;
     criticalFlowDelayUs = Common::Timing::CRITICAL_FLOW_DELAY_US;
     moderateFlowDelayUs = Common::Timing::MODERATE_FLOW_DELAY_US;
@@ -51,4 +57,44 @@ void OptimizedTiming::initialize() {
     _initialized = true;
 }
 
+void OptimizedTiming::loadProfile() {
+    if (_profileLoaded) {
+        return;
+    }
+    TimingProfiles::Profile profile;
+    applyProfile(TimingProfiles::getActive(profile) ? &profile : nullptr);
+    _profileLoaded = true;
+}
+
+void OptimizedTiming::applyProfile(const TimingProfiles::Profile *profile) {
+    if (profile != nullptr) {
+        setHandshake(profile->ackPulseUs, profile->busySetupUs);
+    } else {
+        // Config.h: the optimized path keeps its own short /ACK
+        const uint8_t sreg = SREG;
+        cli();
+        ackPulseUs = Common::Timing::ACK_PULSE_US;
+        fastAckPulseUs = Common::Timing::FAST_ACK_PULSE_US;
+        hardwareDelayUs = Common::Timing::HARDWARE_DELAY_US;
+        SREG = sreg;
+    }
+    
+    if (profile != nullptr) {
+        strncpy(_profileSender, profile->sender, sizeof(_profileSender) - 1);
+        _profileSender[sizeof(_profileSender) - 1] = '\0';
+    } else {
+        _profileSender[0] = '\0';
+    }
+}
+
+void OptimizedTiming::setHandshake(uint16_t ackUs, uint16_t busySetupUs) {
+    // Both capture paths are running; take the new widths with interrupts off
+    const uint8_t sreg = SREG;
+    cli();
+    ackPulseUs = ackUs;
+    fastAckPulseUs = ackUs;
+    hardwareDelayUs = busySetupUs;
+    SREG = sreg;
+}
+
 } // namespace DeviceBridge::Parallel
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <stdint.h>
 #include <Arduino.h>
 #include "../Common/Config.h"
+#include "TimingProfiles.h"
 
 namespace DeviceBridge::Parallel {
 
@@ -13,12 +14,18 @@ namespace DeviceBridge::Parallel {
  * ServiceLocator overhead in time-critical interrupt service routines.
  * All values are computed once and stored as static constants for
  * maximum performance.
+ *
+ * The handshake timings start from Config.h and are replaced by the
+ * sender's calibrated profile (TimingProfiles) when one is active; they are
+ * valid from static initialization, so the legacy ISR can use them before
+ * initialize() selects the optimized one.
  */
 class OptimizedTiming {
 public:
     // Cached timing values (computed at initialization)
-    static uint16_t hardwareDelayUs;
-    static uint16_t ackPulseUs;
+    static uint16_t hardwareDelayUs;        // BUSY before /ACK (legacy ISR)
+    static uint16_t ackPulseUs;             // /ACK width (legacy ISR)
+    static uint16_t fastAckPulseUs;         // /ACK width (optimized capture)
     static uint16_t recoveryDelayUs;
     static uint16_t criticalFlowDelayUs;
     static uint16_t moderateFlowDelayUs;
@@ -51,8 +58,32 @@ public:
      */
     static bool isInitialized() { return _initialized; }
     
+    /**
+     * @brief Load the active profile from internal EEPROM over the Config.h timings
+     * 
+     * Called from Port::initialize() at boot and by initialize().
+     */
+    static void loadProfile();
+    
+    /**
+     * @brief Use a profile's handshake timings; nullptr restores Config.h
+     */
+    static void applyProfile(const TimingProfiles::Profile *profile);
+    
+    /**
+     * @brief Handshake timings for both capture paths (HandshakeCalibrator's candidates)
+     */
+    static void setHandshake(uint16_t ackUs, uint16_t busySetupUs);
+    
+    /**
+     * @brief Sender whose profile is in use, empty for the Config.h timings
+     */
+    static const char *getProfileSender() { return _profileSender; }
+    
 private:
     static bool _initialized;
+    static bool _profileLoaded;
+    static char _profileSender[Common::Calibration::SENDER_NAME_LENGTH];
 };
 
 } // namespace DeviceBridge::Parallel
\ No newline at end of file
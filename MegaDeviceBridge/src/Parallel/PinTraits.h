@@ -0,0 +1,117 @@
+#pragma once
+
+#include <stdint.h>
+#include <Arduino.h>
+
+namespace DeviceBridge::Parallel
+{
+  /**
+   * Compile-time Arduino Mega 2560 pin -> AVR port/bit mapping
+   *
+   * Mirrors the core's digital_pin_to_port_PGM / digital_pin_to_bit_mask_PGM
+   * tables as constexpr functions so pin constants from Config.h resolve to
+   * a register and bit with no run-time lookup.
+   */
+  namespace PinTraits
+  {
+    enum : uint8_t
+    {
+      PORT_A = 0,
+      PORT_B,
+      PORT_C,
+      PORT_D,
+      PORT_E,
+      PORT_F,
+      PORT_G,
+      PORT_H,
+      PORT_J,
+      PORT_K,
+      PORT_L,
+      PORT_COUNT,
+      NOT_A_PORT = 0xFF
+    };
+
+    constexpr uint8_t port(uint8_t pin)
+    {
+      return pin <= 3 || pin == 5 ? PORT_E
+           : pin == 4             ? PORT_G
+           : pin <= 9             ? PORT_H
+           : pin <= 13            ? PORT_B
+           : pin <= 15            ? PORT_J
+           : pin <= 17            ? PORT_H
+           : pin <= 21            ? PORT_D
+           : pin <= 29            ? PORT_A
+           : pin <= 37            ? PORT_C
+           : pin == 38            ? PORT_D
+           : pin <= 41            ? PORT_G
+           : pin <= 49            ? PORT_L
+           : pin <= 53            ? PORT_B
+           : pin <= 61            ? PORT_F
+           : pin <= 69            ? PORT_K
+                                  : NOT_A_PORT;
+    }
+
+    constexpr uint8_t bit(uint8_t pin)
+    {
+      return pin <= 1  ? pin
+           : pin <= 3  ? pin + 2
+           : pin == 4  ? 5
+           : pin == 5  ? 3
+           : pin <= 9  ? pin - 3
+           : pin <= 13 ? pin - 6
+           : pin <= 15 ? 15 - pin
+           : pin <= 17 ? 17 - pin
+           : pin <= 21 ? 21 - pin
+           : pin <= 29 ? pin - 22
+           : pin <= 37 ? 37 - pin
+           : pin == 38 ? 7
+           : pin <= 41 ? 41 - pin
+           : pin <= 49 ? 49 - pin
+           : pin <= 53 ? 53 - pin
+           : pin <= 61 ? pin - 54
+                       : pin - 62;
+    }
+
+    constexpr uint8_t mask(uint8_t pin) { return (uint8_t)(1 << bit(pin)); }
+
+    constexpr uint8_t NO_INTERRUPT = 0xFF;
+
+    /** INTn (EIFR/EIMSK bit) wired to a pin, NO_INTERRUPT if it has none */
+    constexpr uint8_t externalInterrupt(uint8_t pin)
+    {
+      return pin == 2                ? 4
+           : pin == 3                ? 5
+           : pin >= 18 && pin <= 21  ? 21 - pin
+                                     : NO_INTERRUPT;
+    }
+
+    /** PORTA..PORTG are reachable by SBI/CBI; H..L need a read-modify-write */
+    constexpr bool isLowIo(uint8_t port) { return port <= PORT_G; }
+
+    /** PINx/PORTx/DDRx for a port index, resolved at compile time */
+    template <uint8_t Port> struct Registers;
+
+#define DEVICEBRIDGE_PORT_REGISTERS(index, letter)                    \
+    template <> struct Registers<index>                               \
+    {                                                                 \
+      static inline uint8_t in() { return PIN##letter; }              \
+      static inline void set(uint8_t m) { PORT##letter |= m; }        \
+      static inline void clear(uint8_t m) { PORT##letter &= ~m; }     \
+      static inline void output(uint8_t m) { DDR##letter |= m; }      \
+    };
+
+    DEVICEBRIDGE_PORT_REGISTERS(PORT_A, A)
+    DEVICEBRIDGE_PORT_REGISTERS(PORT_B, B)
+    DEVICEBRIDGE_PORT_REGISTERS(PORT_C, C)
+    DEVICEBRIDGE_PORT_REGISTERS(PORT_D, D)
+    DEVICEBRIDGE_PORT_REGISTERS(PORT_E, E)
+    DEVICEBRIDGE_PORT_REGISTERS(PORT_F, F)
+    DEVICEBRIDGE_PORT_REGISTERS(PORT_G, G)
+    DEVICEBRIDGE_PORT_REGISTERS(PORT_H, H)
+    DEVICEBRIDGE_PORT_REGISTERS(PORT_J, J)
+    DEVICEBRIDGE_PORT_REGISTERS(PORT_K, K)
+    DEVICEBRIDGE_PORT_REGISTERS(PORT_L, L)
+
+#undef DEVICEBRIDGE_PORT_REGISTERS
+  }
+}
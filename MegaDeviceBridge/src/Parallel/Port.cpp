@@ -6,9 +6,15 @@
 #include "Data.h"
 #include "OptimizedTiming.h"
 #include "HardwareFlowControl.h"
+#include "AckTimer.h"
+#include "FastPin.h"
+#include "JobSignalTimer.h"
+#include "IsrStats.h"
+#include "CaptureTrace.h"
+#include "PinTraits.h"
+#include <util/delay_basic.h>
 #include "../Common/ServiceLocator.h"
 #include "../Common/ConfigurationService.h"
-#include <RingBuf.h>
 
 namespace DeviceBridge::Parallel
 {
@@ -24,14 +30,70 @@ namespace DeviceBridge::Parallel
                             _whichIsr(_isrSeed++),
                             _interruptCount(0),
                             _dataCount(0),
-                            _locked(false),
+                            _droppedCount(0),
+                            _discardedCount(0),
+                            _overflowEvents(0),
+                            _flowState((uint8_t)HardwareFlowControl::FlowState::NORMAL),
+                            _flowStateSince(0),
+                            _flowStateUs(),
                             _criticalFlowControl(false),
                             _criticalStartTime(0),
                             _pendingAck(false),
                             _pendingFlowControl(false),
                             _lastFlowControlLevel(0),
-                            _hardwareFlowEnabled(false)
+                            _pacingStart(0),
+                            _pacingUs(0),
+                            _pacingCounted(0),
+                            _pacingRecoveredUs(0),
+                            _hardwareFlowEnabled(false),
+                            _timedAckEnabled(false),
+                            _burstEnabled(false),
+                            _strobeFlag(0),
+                            _burstWindow(0),
+                            _burstIdle(0),
+                            _burstCaptures(0),
+                            _polledEnabled(false),
+                            _polledStats(),
+                            _jobSignals(Common::JobBoundary::DEFAULT_SIGNALS),
+                            _jobSignalLevels(0),
+                            _boundaryFirst(0),
+                            _boundaryCount(0),
+                            _boundaryIndex(),
+                            _jobBoundaries(0)
   {
+    // Flow control drives this port's status lines, not always the first port's
+    _hardwareFlowControl.setPins(_status.getBusyPin(), _status.getErrorPin(), _status.getPaperOutPin(), _status.getSelectPin());
+  }
+
+  inline void Port::trackFlowState(uint16_t bufferSize)
+  {
+    uint8_t state = (uint8_t)HardwareFlowControl::FlowState::NORMAL;
+    if (bufferSize >= Common::FlowControl::CRITICAL_THRESHOLD) {
+      state = (uint8_t)HardwareFlowControl::FlowState::CRITICAL;
+    } else if (bufferSize >= Common::FlowControl::MODERATE_THRESHOLD) {
+      state = (uint8_t)HardwareFlowControl::FlowState::WARNING;
+    }
+    // micros() only on a change; most bytes stay in the state they found
+    if (state != _flowState) {
+      enterFlowState(state);
+    }
+  }
+
+  void Port::enterFlowState(uint8_t state)
+  {
+    const uint32_t now = micros();
+    _flowStateUs[_flowState] += now - _flowStateSince;
+    _flowStateSince = now;
+    _flowState = state;
+  }
+
+  void Port::noteDropped()
+  {
+    _droppedCount++;
+    if (_flowState != (uint8_t)HardwareFlowControl::FlowState::EMERGENCY) {
+      _overflowEvents++;
+      enterFlowState((uint8_t)HardwareFlowControl::FlowState::EMERGENCY);
+    }
   }
 
   void Port::handleInterrupt()
@@ -39,14 +101,10 @@ namespace DeviceBridge::Parallel
     // Count all interrupt calls for debugging
     _interruptCount++;
     
-    // Check if port is locked (SPI/Serial operations in progress)
-    if (_locked) {
-      return; // Ignore data while locked
-    }
-    
     // Check for buffer overflow BEFORE capturing data
     if (_buffer.isFull()) {
       // Critical: Buffer overflow! Drop this byte and signal error
+      noteDropped();
       setBusy(true);  // Hold busy to prevent more data
       return;
     }
@@ -57,11 +115,12 @@ namespace DeviceBridge::Parallel
     // Set busy to indicate we're processing (critical for TDS2024 timing)
     _status.setBusy();
     
-    // Brief delay to ensure TDS2024 sees the busy signal
-    delayMicroseconds(Common::Timing::HARDWARE_DELAY_US);
+    // Brief delay to ensure TDS2024 sees the busy signal (or the sender's profile)
+    delayMicroseconds(OptimizedTiming::hardwareDelayUs);
     
     // Read the data byte from parallel port with timing critical section
-    uint8_t value = _data.readValue();
+    // (single pass over the data ports when the pins match Config.h)
+    uint8_t value = _data.readValueAtomic();
     
     // Count valid data captures
     _dataCount++;
@@ -69,6 +128,10 @@ namespace DeviceBridge::Parallel
     // Store data in ring buffer for processing - this MUST succeed
     // since we checked for full buffer above
     bool pushResult = _buffer.push(value);
+    if (_whichIsr == 0) {
+      CaptureTrace::record(value);
+    }
+    trackFlowState(_buffer.size());
     
     // Send acknowledge pulse to confirm data received
     // This MUST happen before clearing busy for proper protocol
@@ -110,29 +173,87 @@ namespace DeviceBridge::Parallel
   }
   
   void Port::handleInterruptOptimized()
+  {
+    const uint16_t entry = IsrStats::stamp();
+    bool stored = captureOptimized();
+    if (stored) {
+      IsrStats::recordLatency(entry);
+    }
+    _interruptCount++;
+    
+    // Burst mode: take strobes that follow within the poll window in this
+    // same invocation instead of paying interrupt entry/exit for each one
+    if (_burstEnabled) {
+      uint8_t captured = 1;
+      while (stored && captured < Common::Timing::BURST_MAX_BYTES && waitForStrobe()) {
+        stored = captureOptimized();
+        captured++;
+      }
+      _burstCaptures += captured - 1;
+    }
+    IsrStats::recordDuration(entry);
+  }
+  
+  bool Port::waitForStrobe()
+  {
+    // Back-to-back traffic: a strobe already latched in EIFR is free to take
+    uint8_t steps = _burstWindow;
+    if (steps == 0 && ++_burstIdle >= Common::Timing::BURST_PROBE_INTERVAL) {
+      // Sparse traffic shrank the window to nothing; probe again now and then
+      _burstIdle = 0;
+      steps = Common::Timing::BURST_POLL_STEPS;
+    }
+    
+    do {
+      if (EIFR & _strobeFlag) {
+        EIFR = _strobeFlag; // taken here, not by another interrupt
+        _burstWindow = Common::Timing::BURST_POLL_STEPS;
+        _burstIdle = 0;
+        return true;
+      }
+      if (steps == 0) {
+        return false;
+      }
+      _delay_loop_1(1);
+    } while (--steps);
+    
+    // Missed: halve the window so sparse traffic falls back to one byte per interrupt
+    _burstWindow >>= 1;
+    return false;
+  }
+  
+  bool Port::captureOptimized()
   {
     // IEEE-1284 COMPLIANT MINIMAL ISR - Target execution time: ≤2μs
     
     // CRITICAL: Immediate data capture with atomic read
-    uint8_t data = _data.readValueAtomic();
-    
+    return storeOptimized(_data.readValueAtomic());
+  }
+  
+  bool Port::storeOptimized(uint8_t data)
+  {
     // CRITICAL: Check buffer space and store data (≤1μs)
     if (!_buffer.isFull()) {
       _buffer.push(data);
       _dataCount++;
       
       // CRITICAL: Immediate ACK response (IEEE-1284 requires ≤10μs)
+      IsrStats::markAck();
       _status.sendAcknowledgePulseOptimized();
+      if (_whichIsr == 0) {
+        CaptureTrace::record(data); // after /ACK, off the handshake's critical path
+      }
       
       // Flag deferred processing for main loop
       _pendingFlowControl = true;
       
       // Fast flow control decision using cached thresholds
       uint16_t bufferSize = _buffer.size();
+      trackFlowState(bufferSize);
       
       // Use hardware flow control if enabled, otherwise use basic flow control
       if (_hardwareFlowEnabled) {
-        _hardwareFlowControl.updateFlowControl(bufferSize, _buffer.maxSize());
+        _hardwareFlowControl.updateFlowControl(bufferSize);
       } else {
         // Basic flow control using status pins
         if (bufferSize >= Common::FlowControl::CRITICAL_THRESHOLD) {
@@ -148,17 +269,61 @@ namespace DeviceBridge::Parallel
       }
     } else {
       // Buffer overflow - signal error immediately
+      noteDropped();
       if (_hardwareFlowEnabled) {
         _hardwareFlowControl.setFlowState(HardwareFlowControl::FlowState::EMERGENCY);
       } else {
         _status.setBusy(true);
         _status.setError(true);
       }
+      return false;
     }
     
+    // TOTAL ISR TIME: ≤2μs (IEEE-1284 compliant!)
+    return true;
+  }
+  
+  void Port::handleInterruptTimed()
+  {
+    // Same capture as the optimized ISR; the /ACK pulse and the BUSY release
+    // are finished by the Timer5 compare vector instead of delayMicroseconds()
+    uint8_t data = _data.readValueAtomic();
     _interruptCount++;
     
-    // TOTAL ISR TIME: ≤2μs (IEEE-1284 compliant!)
+    if (!_buffer.push(data)) {
+      // Buffer overflow - hold the host off, no /ACK for the dropped byte
+      noteDropped();
+      _status.setBusy(true);
+      return;
+    }
+    _dataCount++;
+    if (_whichIsr == 0) {
+      CaptureTrace::record(data);
+    }
+    
+    uint16_t bufferSize = _buffer.size();
+    trackFlowState(bufferSize);
+    if (bufferSize >= Common::FlowControl::CRITICAL_THRESHOLD) {
+      if (!_criticalFlowControl) {
+        _criticalFlowControl = true;
+        _criticalStartTime = millis();
+      }
+    } else if (_criticalFlowControl && bufferSize < Common::FlowControl::MODERATE_THRESHOLD) {
+      _criticalFlowControl = false;
+    }
+    
+    if (_hardwareFlowEnabled) {
+      _hardwareFlowControl.updateFlowControl(bufferSize);
+      AckTimer::start(false);
+    } else {
+      // BUSY for the whole handshake; the timer drops it with /ACK unless we are holding
+      bool hold = _criticalFlowControl || bufferSize >= Common::FlowControl::MODERATE_THRESHOLD;
+      _status.setBusy(true);
+      AckTimer::start(!hold);
+      if (!hold && !AckTimer::releasesBusy()) {
+        _status.setBusy(false);
+      }
+    }
   }
   
   // Hardware flow control is now integrated into handleInterruptOptimized()
@@ -168,39 +333,63 @@ namespace DeviceBridge::Parallel
   Port *Port::_instance0;
   void Port::isr0()
   {
-    // Use optimized ISR by default (hardware flow control is integrated)
-    if (OptimizedTiming::isInitialized()) {
-      _instance0->handleInterruptOptimized();
-    } else {
-      _instance0->handleInterrupt();
-    }
+    _instance0->dispatchInterrupt();
+    takeLatchedStrobes(_instance0);
   }
   Port *Port::_instance1;
   void Port::isr1()
   {
-    // Use optimized ISR by default (hardware flow control is integrated)
-    if (OptimizedTiming::isInitialized()) {
-      _instance1->handleInterruptOptimized();
-    } else {
-      _instance1->handleInterrupt();
-    }
+    _instance1->dispatchInterrupt();
+    takeLatchedStrobes(_instance1);
   }
   Port *Port::_instance2;
   void Port::isr2()
   {
-    // Use optimized ISR by default (hardware flow control is integrated)  
-    if (OptimizedTiming::isInitialized()) {
-      _instance2->handleInterruptOptimized();
+    _instance2->dispatchInterrupt();
+    takeLatchedStrobes(_instance2);
+  }
+
+  void Port::dispatchInterrupt()
+  {
+    // Use optimized ISR by default (hardware flow control is integrated)
+    if (_timedAckEnabled) {
+      handleInterruptTimed();
+    } else if (OptimizedTiming::isInitialized()) {
+      handleInterruptOptimized();
     } else {
-      _instance2->handleInterrupt();
+      handleInterrupt();
     }
   }
 
+  void Port::takeLatchedStrobes(Port *self)
+  {
+#if DEVICEBRIDGE_PARALLEL_PORTS > 1
+    // INTn priority is fixed by the vector table, so a sender that keeps its
+    // port's ISR busy back to back would starve the ports behind it; every
+    // ISR also takes the other ports' strobes already latched in EIFR
+    Port *const ports[] = {_instance0, _instance1, _instance2};
+    for (Port *port : ports) {
+      if (port && port != self && (EIFR & port->_strobeFlag)) {
+        EIFR = port->_strobeFlag; // taken here, not by its own vector
+        port->dispatchInterrupt();
+      }
+    }
+#else
+    (void)self;
+#endif
+  }
+
   void Port::initialize()
   {
+    // The legacy ISR uses the active sender profile's handshake timings too
+    OptimizedTiming::loadProfile();
+    
     _control.initialize();
+    setJobSignals(_jobSignals);
     _status.initialize();
     _data.initialize();
+    IsrStats::initialize();
+    CaptureTrace::initialize();
 
     switch (_whichIsr)
     {
@@ -217,6 +406,7 @@ namespace DeviceBridge::Parallel
       attachInterrupt(digitalPinToInterrupt(_control.getStrobePin()), isr2, FALLING); // Attach to pin interrupt
       break;
     }
+    cacheStrobeFlag(); // takeLatchedStrobes() clears it for the other ports' ISRs
   }
   
   void Port::initializeOptimized()
@@ -228,6 +418,8 @@ namespace DeviceBridge::Parallel
     _control.initialize();
     _status.initialize();
     _data.initialize();
+    IsrStats::initialize();
+    CaptureTrace::initialize();
 
     // Replace ISR handlers with optimized versions
     switch (_whichIsr)
@@ -245,6 +437,7 @@ namespace DeviceBridge::Parallel
       attachInterrupt(digitalPinToInterrupt(_control.getStrobePin()), isr2, FALLING);
       break;
     }
+    cacheStrobeFlag();
   }
   
   // Hardware flow control is now integrated - use initializeOptimized() and enable via setHardwareFlowControlEnabled()
@@ -272,50 +465,67 @@ namespace DeviceBridge::Parallel
   }
 
   uint16_t Port::readData(uint8_t buffer[], uint16_t index, uint16_t length)
+  {
+    const uint16_t cnt = peekData(buffer, index, length);
+    releaseData(cnt);
+    return cnt;
+  }
+
+  uint16_t Port::peekData(uint8_t buffer[], uint16_t index, uint16_t length)
   {
     // Note: sizeof(buffer) gives size of pointer, not array
     // For Arduino, we'll use the length parameter properly
     if (length == 0) // if length is 0, assume we want to fill the buffer
       length = Common::Buffer::DATA_CHUNK_SIZE; // Default chunk size from configuration
 
-    // Disable interrupts during buffer operations to prevent corruption
-    noInterrupts();
-    
-    uint16_t cnt = 0;
-    for (uint16_t i = 0; i < length; i++)
-    {
-      uint8_t element;
-      if (_buffer.lockedPop(element))
-      {
-        buffer[index + i] = element;
-        cnt++;
-      }
-      else
-      {
-        break; // read buffer is empty
-      }
+    // Bytes after a job boundary wait until the manager has closed the file. Without one,
+    // only what was in the ring at this moment: a boundary latched during the copy lies after it
+    const uint8_t sreg = SREG;
+    cli();
+    const int16_t available = _boundaryCount != 0 ? bytesBeforeBoundary() : (int16_t)_buffer.size();
+    SREG = sreg;
+    if (available <= 0) {
+      length = 0;
+    } else if (length > (uint16_t)available) {
+      length = (uint16_t)available;
     }
-    
-    // Re-enable interrupts
-    interrupts();
+
+    // Lock-free: the ISR keeps capturing while the ring is copied out
+    return _buffer.copy(&buffer[index], length);
+  }
+
+  void Port::releaseData(uint16_t cnt)
+  {
+    _buffer.consume(cnt);
     
     // Aggressive flow control update based on buffer level after read
     uint16_t bufferLevelAfterRead = _buffer.size();
     uint16_t bufferCapacity = _buffer.maxSize();
+    if (_hardwareFlowEnabled) {
+      _hardwareFlowControl.recordDrain(cnt + bufferLevelAfterRead);
+    }
     
-    if (cnt > 0) { // Only update if we actually read data
+    if (cnt > 0 && _hardwareFlowEnabled) {
+      // The controller owns BUSY; releasing it here would leave its state stale
+      _hardwareFlowControl.updateAfterDrain(bufferLevelAfterRead);
+    } else if (cnt > 0) { // Only update if we actually read data
       if (bufferLevelAfterRead < Common::FlowControl::RECOVERY_THRESHOLD) {
         // Less than 40% full - clear busy immediately
         setBusy(false);
       } else if (bufferLevelAfterRead < Common::FlowControl::MODERATE_THRESHOLD) {
-        // 40-50% full - clear busy but with brief delay
+        // 40-50% full - clear busy, then a brief pacing window before the next flow-control step
         setBusy(false);
-        delayMicroseconds(Common::Timing::FLOW_CONTROL_DELAY_US);
+        startPacing(Common::Timing::FLOW_CONTROL_DELAY_US);
       }
       // If still >60% full, keep busy active until next interrupt
     }
     
-    return cnt;
+    if (cnt > 0) {
+      const uint8_t sreg = SREG;
+      cli();
+      trackFlowState(_buffer.size());
+      SREG = sreg;
+    }
   }
 
   void Port::setBusy(bool busy) {
@@ -335,18 +545,119 @@ namespace DeviceBridge::Parallel
   }
 
   void Port::sendAcknowledge() {
+    if (_timedAckEnabled) {
+      const uint8_t sreg = SREG;
+      cli();
+      AckTimer::start(false);
+      SREG = sreg;
+      return;
+    }
     _status.sendAcknowledgePulse();
   }
 
   void Port::clearBuffer() {
-    // Clear the ring buffer and reset flow control
-    noInterrupts();
-    while (!_buffer.isEmpty()) {
-      uint8_t dummy;
-      _buffer.lockedPop(dummy);
-    }
+    // Clear the ring buffer and reset flow control; whatever it held was acknowledged and is lost
+    const uint8_t sreg = SREG;
+    cli();
+    _discardedCount += _buffer.size();
+    _buffer.clear();
+    trackFlowState(0);
+    SREG = sreg;
     setBusy(false); // Clear busy signal since buffer is empty
-    interrupts();
+  }
+  
+  void Port::setJobSignals(uint8_t signals) {
+    const uint8_t sreg = SREG;
+    cli();
+    _jobSignals = signals & (Common::JobBoundary::SIGNAL_INIT | Common::JobBoundary::SIGNAL_SELECT_IN);
+    _jobSignalLevels = _control.readJobSignals();
+    SREG = sreg;
+    
+    // The vector reads the lines through FastPin<>; other wiring is left to pollJobSignals()
+    if (_jobSignals != 0 && _control.isFastSignals()) {
+      JobSignalTimer::initialize(*this);
+    } else {
+      JobSignalTimer::stop(*this);
+    }
+  }
+  
+  void Port::sampleJobSignals() {
+    // /INIT asserting starts a job; /SELECT-IN releasing ends one
+    const uint8_t levels = _control.readJobSignals();
+    const uint8_t edges = ((levels & ~_jobSignalLevels & Common::JobBoundary::SIGNAL_INIT) |
+                           (~levels & _jobSignalLevels & Common::JobBoundary::SIGNAL_SELECT_IN)) &
+                          _jobSignals;
+    _jobSignalLevels = levels;
+    
+    if (edges == 0) {
+      return;
+    }
+    // Back-to-back jobs can queue several edges behind a slow drain; an edge
+    // with no bytes since the last one would only split off an empty job
+    const uint16_t head = _buffer.headIndex();
+    const uint8_t count = _boundaryCount;
+    if (count != 0 &&
+        (count == Common::JobBoundary::MAX_PENDING ||
+         _boundaryIndex[(_boundaryFirst + count - 1) % Common::JobBoundary::MAX_PENDING] == head)) {
+      return;
+    }
+    _boundaryIndex[(_boundaryFirst + count) % Common::JobBoundary::MAX_PENDING] = head;
+    _boundaryCount = count + 1;
+    _jobBoundaries++;
+  }
+  
+  void Port::pollJobSignals() {
+    if (_jobSignals == 0) {
+      return;
+    }
+    const uint8_t sreg = SREG;
+    cli();
+    sampleJobSignals();
+    SREG = sreg;
+  }
+  
+  int16_t Port::bytesBeforeBoundary() const {
+    return (int16_t)(_boundaryIndex[_boundaryFirst] - _buffer.tailIndex());
+  }
+  
+  bool Port::atJobBoundary() const {
+    const uint8_t sreg = SREG;
+    cli();
+    const bool at = _boundaryCount != 0 && bytesBeforeBoundary() <= 0;
+    SREG = sreg;
+    return at;
+  }
+  
+  void Port::clearJobBoundary() {
+    const uint8_t sreg = SREG;
+    cli();
+    if (_boundaryCount != 0) {
+      _boundaryFirst = (_boundaryFirst + 1) % Common::JobBoundary::MAX_PENDING;
+      _boundaryCount = _boundaryCount - 1;
+    }
+    SREG = sreg;
+  }
+  
+  uint32_t Port::getJobBoundaryCount() const {
+    const uint8_t sreg = SREG;
+    cli();
+    const uint32_t count = _jobBoundaries;
+    SREG = sreg;
+    return count;
+  }
+  
+  void Port::getCaptureCounters(CaptureCounters &out) const {
+    const uint8_t sreg = SREG;
+    cli();
+    out.captured = _dataCount;
+    out.dropped = _droppedCount;
+    out.discarded = _discardedCount;
+    out.overflowEvents = _overflowEvents;
+    for (uint8_t i = 0; i < 4; i++) {
+      out.flowStateUs[i] = _flowStateUs[i];
+    }
+    out.flowStateUs[_flowState] += micros() - _flowStateSince;
+    SREG = sreg;
   }
 
   uint16_t Port::getBufferSize() const {
@@ -377,7 +688,14 @@ namespace DeviceBridge::Parallel
     // Process deferred operations from optimized ISR
     // This runs in main loop context, not interrupt context
     
-    if (_pendingFlowControl) {
+    // The per-level settle time is a pacing window on micros() rather than a
+    // delayMicroseconds(): the loop goes on to storage and the UI, and a flag
+    // raised while the window is open is taken (coalesced) once it closes
+    creditPacing();
+    if (_pacingUs != 0 && micros() - _pacingStart < _pacingUs) {
+      // still pacing
+    } else if (_pendingFlowControl) {
+      _pacingUs = 0;
       _pendingFlowControl = false;
       
       // Apply detailed flow control timing based on level
@@ -387,11 +705,11 @@ namespace DeviceBridge::Parallel
             _criticalFlowControl = true;
             _criticalStartTime = millis();
           }
-          delayMicroseconds(OptimizedTiming::criticalFlowDelayUs);
+          startPacing(OptimizedTiming::criticalFlowDelayUs);
           break;
           
         case 2: // Moderate
-          delayMicroseconds(OptimizedTiming::moderateFlowDelayUs);
+          startPacing(OptimizedTiming::moderateFlowDelayUs);
           break;
           
         case 1: // Normal
@@ -400,21 +718,54 @@ namespace DeviceBridge::Parallel
           if (_criticalFlowControl && _buffer.size() < OptimizedTiming::recoveryThreshold) {
             _criticalFlowControl = false;
           }
-          delayMicroseconds(OptimizedTiming::flowControlDelayUs);
+          startPacing(OptimizedTiming::flowControlDelayUs);
           break;
       }
+    } else {
+      _pacingUs = 0;
     }
     
-    // Check for critical timeout recovery
-    if (_criticalFlowControl && checkCriticalTimeout()) {
-      // Emergency timeout - clear buffer and reset state
-      clearBuffer();
-      resetCriticalState();
+    // The critical timeout is left to the owner (ParallelPortManager), which
+    // closes the file before the buffer is dropped
+    
+    // Time in here is not recovered; the next call credits only what the loop spent elsewhere
+    if (_pacingUs != 0) {
+      _pacingCounted = pacingElapsedUs();
     }
     
-    // Process hardware flow control deferred operations
     if (_hardwareFlowEnabled) {
-      _hardwareFlowControl.processDeferred();
+      _hardwareFlowControl.updatePrediction();
+      // Stamps the ISR's state changes; a release refused for hold time would otherwise wait for traffic
+      _hardwareFlowControl.updateAfterDrain(_buffer.size());
+    }
+  }
+  
+  void Port::startPacing(uint16_t us)
+  {
+    if (us == 0) {
+      return;
+    }
+    creditPacing(); // a window reopened from readData() is credited up to here, not twice
+    _pacingStart = micros();
+    _pacingUs = us;
+    _pacingCounted = 0;
+  }
+  
+  uint16_t Port::pacingElapsedUs() const
+  {
+    const uint32_t elapsed = micros() - _pacingStart;
+    return elapsed < _pacingUs ? (uint16_t)elapsed : _pacingUs;
+  }
+  
+  void Port::creditPacing()
+  {
+    if (_pacingUs == 0) {
+      return;
+    }
+    const uint16_t elapsed = pacingElapsedUs();
+    if (elapsed > _pacingCounted) {
+      _pacingRecoveredUs += elapsed - _pacingCounted;
+      _pacingCounted = elapsed;
     }
   }
   
@@ -431,6 +782,236 @@ namespace DeviceBridge::Parallel
     return _hardwareFlowControl.getStatistics();
   }
   
+  bool Port::setTimedAcknowledgeEnabled(bool enabled, uint16_t pulseUs)
+  {
+    if (!enabled) {
+      _timedAckEnabled = false;
+      AckTimer::stop();
+      return true;
+    }
+    // AckTimer drives /ACK and BUSY through FastPin<Config.h pins>
+    if (!_status.isFastSignals()) {
+      return false;
+    }
+    AckTimer::initialize(pulseUs, Common::Timing::ACK_TIMER_RELEASES_BUSY);
+    _timedAckEnabled = true;
+    return true;
+  }
+  
+  bool Port::setBurstCaptureEnabled(bool enabled)
+  {
+    if (!enabled) {
+      _burstEnabled = false;
+      return true;
+    }
+    if (!cacheStrobeFlag()) {
+      return false;
+    }
+    // Burst capture lives in the optimized ISR
+    OptimizedTiming::initialize();
+    _burstWindow = Common::Timing::BURST_POLL_STEPS;
+    _burstIdle = 0;
+    _burstEnabled = true;
+    return true;
+  }
+  
+  bool Port::cacheStrobeFlag()
+  {
+    const uint8_t intn = PinTraits::externalInterrupt(_control.getStrobePin());
+    if (intn == PinTraits::NO_INTERRUPT) {
+      return false;
+    }
+    _strobeFlag = (uint8_t)(1 << intn);
+    return true;
+  }
+  
+  bool Port::setPolledCaptureEnabled(bool enabled)
+  {
+    if (!enabled) {
+      _polledEnabled = false;
+      return true;
+    }
+    if (!cacheStrobeFlag()) {
+      return false;
+    }
+    // Sessions reuse the optimized ISR's per-byte capture, which also runs between them
+    OptimizedTiming::initialize();
+    _polledEnabled = true;
+    return true;
+  }
+  
+  uint16_t Port::pollCapture(uint8_t spentTicks)
+  {
+    // Timer0 (clk/64, 4us per tick) keeps counting with interrupts masked;
+    // sampled every pass, so its 8-bit wrap never hides a full period
+    constexpr uint8_t US_PER_TICK = 64 / (F_CPU / 1000000UL);
+    constexpr uint16_t IDLE_TICKS = Common::Timing::POLLED_IDLE_TIMEOUT_US / US_PER_TICK;
+    constexpr uint16_t SESSION_TICKS = Common::Timing::POLLED_MAX_SESSION_US / US_PER_TICK;
+    
+    if (!_polledEnabled || _timedAckEnabled) {
+      return 0;
+    }
+    
+    uint16_t captured = 0;
+    uint16_t idle = 0;
+    uint16_t elapsed = spentTicks; // the caller's masked drain shares the session budget
+    
+    const uint8_t sreg = SREG;
+    cli();
+    uint8_t last = TCNT0;
+    while (true) {
+      // The edge still latches in EIFR; taking it here keeps the ISR from running for it
+      if (EIFR & _strobeFlag) {
+        EIFR = _strobeFlag;
+        if (!captureOptimized()) {
+          _polledStats.highWaterExits++;
+          break;
+        }
+        captured++;
+        idle = 0;
+        if (_buffer.size() >= Common::FlowControl::MODERATE_THRESHOLD) {
+          _polledStats.highWaterExits++;
+          break;
+        }
+      }
+      
+      const uint8_t now = TCNT0;
+      const uint8_t ticks = now - last;
+      last = now;
+      if (ticks != 0 && _jobSignals != 0) {
+        sampleJobSignals(); // JobSignalTimer's vector waits for this session to end
+      }
+      idle += ticks;
+      elapsed += ticks;
+      if (idle >= IDLE_TICKS) {
+        _polledStats.idleExits++;
+        break;
+      }
+      if (elapsed >= SESSION_TICKS) {
+        _polledStats.timeLimitExits++;
+        break;
+      }
+    }
+    // A strobe after the last check stays latched and is taken by the ISR
+    SREG = sreg;
+    
+    _polledStats.sessions++;
+    _polledStats.bytes += captured;
+    return captured;
+  }
+  
+  bool Port::canCalibrate()
+  {
+    // The session reads /STROBE and BUSY through FastPin<Config.h pins> and clears the strobe's EIFR flag
+    if (_timedAckEnabled || !_status.isFastSignals() || _control.getStrobePin() != Common::Pins::LPT_STROBE) {
+      return false;
+    }
+    if (!cacheStrobeFlag()) {
+      return false;
+    }
+    // Sessions store through the optimized capture, which also runs between them
+    OptimizedTiming::initialize();
+    return true;
+  }
+  
+  uint16_t Port::calibrationSession(CalibrationSamples &samples)
+  {
+    // Timer1 at clk/1 stamps the edges (62.5ns); a session is far shorter than its 4ms wrap
+    constexpr uint16_t CYCLES_PER_US = F_CPU / 1000000UL;
+    constexpr uint16_t IDLE_CYCLES = Common::Timing::POLLED_IDLE_TIMEOUT_US * CYCLES_PER_US;
+    constexpr uint16_t SESSION_CYCLES = Common::Timing::POLLED_MAX_SESSION_US * CYCLES_PER_US;
+    constexpr uint16_t STROBE_TIMEOUT_CYCLES = Common::Calibration::STROBE_TIMEOUT_US * CYCLES_PER_US;
+    using Strobe = FastPin<Common::Pins::LPT_STROBE>;
+    using Busy = FastPin<Common::Pins::LPT_BUSY>;
+    
+    if (_strobeFlag == 0 || _timedAckEnabled) {
+      return 0;
+    }
+    
+    uint16_t captured = 0;
+    bool seenHigh = false;   // the falling edge happened during this pass, so its width can be timed
+    bool gapOpen = false;    // previous strobe was taken here and left BUSY low
+    uint16_t lastFall = 0;
+    
+    const uint8_t sreg = SREG;
+    cli();
+    const uint8_t tccr1a = TCCR1A;
+    const uint8_t tccr1b = TCCR1B;
+    TCCR1A = 0;
+    TCCR1B = (1 << CS10);
+    const uint16_t start = TCNT1;
+    uint16_t lastActivity = start;
+    while (true) {
+      const uint16_t fall = TCNT1;
+      if (!Strobe::read()) {
+        // Latch the byte at the falling edge, time the pulse, then /ACK after it as Centronics orders it
+        const uint8_t data = _data.readValueAtomic();
+        uint16_t rise;
+        do {
+          rise = TCNT1;
+        } while (!Strobe::read() && (uint16_t)(rise - fall) < STROBE_TIMEOUT_CYCLES);
+        EIFR = _strobeFlag; // taken here, not by the ISR
+        
+        // A strobe already low when first seen has an early fall; its width is not
+        // known, but the gap still ends here, when this loop could next take a byte
+        if (seenHigh && (uint16_t)(rise - fall) < STROBE_TIMEOUT_CYCLES) {
+          samples.widths++;
+          samples.widthCycles += (uint16_t)(rise - fall);
+        }
+        if (gapOpen) {
+          samples.gaps++;
+          samples.gapCycles += (uint16_t)(fall - lastFall);
+        }
+        if (!storeOptimized(data)) {
+          break;
+        }
+        captured++;
+        lastFall = fall;
+        gapOpen = !Busy::read();
+        seenHigh = false;
+        lastActivity = TCNT1;
+        if (_buffer.size() >= Common::FlowControl::MODERATE_THRESHOLD) {
+          break;
+        }
+      } else if (EIFR & _strobeFlag) {
+        // Came and went while the last byte was stored: take it untimed
+        EIFR = _strobeFlag;
+        if (!captureOptimized()) {
+          break;
+        }
+        captured++;
+        gapOpen = false;
+        seenHigh = true;
+        lastActivity = TCNT1;
+        if (_buffer.size() >= Common::FlowControl::MODERATE_THRESHOLD) {
+          break;
+        }
+      } else {
+        seenHigh = true;
+      }
+      
+      const uint16_t now = TCNT1;
+      if ((uint16_t)(now - lastActivity) >= IDLE_CYCLES || (uint16_t)(now - start) >= SESSION_CYCLES) {
+        break;
+      }
+    }
+    TCCR1A = tccr1a;
+    TCCR1B = tccr1b;
+    // A strobe after the last check stays latched and is taken by the ISR
+    SREG = sreg;
+    
+    samples.strobes += captured;
+    return captured;
+  }
+  
+  uint16_t Port::getAcknowledgePulseUs() const
+  {
+    if (_timedAckEnabled) {
+      return AckTimer::getPulseWidthUs();
+    }
+    return OptimizedTiming::isInitialized() ? OptimizedTiming::fastAckPulseUs : OptimizedTiming::ackPulseUs;
+  }
+  
   /*
   | Name         | DB25  |  Direction | Register |
   |--------------|-------|------------|----------|
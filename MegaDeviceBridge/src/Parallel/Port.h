@@ -6,13 +6,49 @@
 #include "Data.h"
 #include "OptimizedTiming.h"
 #include "HardwareFlowControl.h"
+#include "SpscRing.h"
 #include "../Common/Config.h"
-#include <RingBuf.h>
 
 namespace DeviceBridge::Parallel
 {
   class Port
   {
+  public:
+    /** Polled capture sessions and why each one ended */
+    struct PolledCaptureStatistics {
+      uint32_t sessions;
+      uint32_t bytes;
+      uint32_t idleExits;        // no strobe for POLLED_IDLE_TIMEOUT_US
+      uint32_t highWaterExits;   // buffer reached the moderate threshold
+      uint32_t timeLimitExits;   // POLLED_MAX_SESSION_US used up
+    };
+
+    /**
+     * Capture accounting since boot, for per-file differences
+     *
+     * Flow-state residency follows ring occupancy against the Config.h
+     * thresholds (NORMAL, WARNING from MODERATE_THRESHOLD, CRITICAL from
+     * CRITICAL_THRESHOLD) in every capture mode, and EMERGENCY from a
+     * dropped strobe until the next store or drain. The microsecond totals
+     * wrap every ~71 minutes, so take differences over shorter spans.
+     */
+    struct CaptureCounters {
+      uint32_t captured;         // bytes acknowledged into the ring
+      uint32_t dropped;          // strobes not acknowledged: ring full
+      uint32_t discarded;        // acknowledged bytes thrown away by clearBuffer()
+      uint32_t overflowEvents;   // runs of dropped strobes
+      uint32_t flowStateUs[4];   // indexed by HardwareFlowControl::FlowState
+    };
+
+    /** Handshake calibration measurements (calibrationSession()); cycles at 16MHz */
+    struct CalibrationSamples {
+      uint16_t strobes;          // bytes captured in sessions
+      uint16_t widths;           // /STROBE low times measured
+      uint32_t widthCycles;
+      uint16_t gaps;             // falling edge to falling edge with BUSY low in between
+      uint32_t gapCycles;
+    };
+
   private:
     Control _control;
     Status _status;
@@ -21,8 +57,19 @@ namespace DeviceBridge::Parallel
 
     void handleInterrupt();               // Original ISR (deprecated)
     void handleInterruptOptimized();      // IEEE-1284 compliant ISR with hardware flow control
+    void handleInterruptTimed();          // Timer5 ends /ACK, no busy-wait delays
+    bool captureOptimized();              // One byte of handleInterruptOptimized(); false if dropped
+    bool storeOptimized(uint8_t data);    // captureOptimized() after the data bus was read
+    bool waitForStrobe();                 // Burst mode: next /STROBE within the poll window
+    bool cacheStrobeFlag();               // _strobeFlag from the /STROBE pin, false if it has no INTn
+    void trackFlowState(uint16_t bufferSize);
+    void enterFlowState(uint8_t state);
+    void noteDropped();
+    void startPacing(uint16_t us);        // Opens the flow-control pacing window
+    uint16_t pacingElapsedUs() const;     // Time into the open window, capped at its length
+    void creditPacing();                  // Window time since processPendingOperations() last returned
     
-    RingBuf<uint8_t, DeviceBridge::Common::Buffer::RING_BUFFER_SIZE> _buffer;
+    SpscRing<uint8_t, DeviceBridge::Common::Buffer::RING_BUFFER_SIZE> _buffer;
 
     const byte _whichIsr;
     static byte _isrSeed;
@@ -32,13 +79,20 @@ namespace DeviceBridge::Parallel
     static Port *_instance1;
     static void isr2();
     static Port *_instance2;
+    void dispatchInterrupt();             // The capture path the port is set up for
+    static void takeLatchedStrobes(Port *self); // Multi-port builds: other ports' pending /STROBEs
     
     // Debug counters
     volatile uint32_t _interruptCount;
     volatile uint32_t _dataCount;
     
-    // Printer protocol state
-    volatile bool _locked;
+    // Capture accounting (CaptureCounters)
+    volatile uint32_t _droppedCount;
+    volatile uint32_t _discardedCount;
+    volatile uint32_t _overflowEvents;
+    volatile uint8_t _flowState;          // HardwareFlowControl::FlowState by ring occupancy
+    volatile uint32_t _flowStateSince;    // micros() when _flowState was entered
+    volatile uint32_t _flowStateUs[4];
     
     // Critical buffer management
     volatile bool _criticalFlowControl;
@@ -50,9 +104,38 @@ namespace DeviceBridge::Parallel
     volatile bool _pendingFlowControl;
     volatile uint8_t _lastFlowControlLevel;
     
+    // Flow-control pacing window (main loop only): replaces the settle-time busy-waits
+    uint32_t _pacingStart;       // micros()
+    uint16_t _pacingUs;          // 0 when no window is open
+    uint16_t _pacingCounted;     // window time already credited or spent in processPendingOperations()
+    uint32_t _pacingRecoveredUs; // window time the loop spent elsewhere instead of busy-waiting
+    
     // Hardware flow control state
     bool _hardwareFlowEnabled;
     
+    // Timer-generated /ACK (AckTimer)
+    volatile bool _timedAckEnabled;
+    
+    // Burst capture (optimized ISR only)
+    volatile bool _burstEnabled;
+    uint8_t _strobeFlag;                  // EIFR bit of the /STROBE interrupt
+    uint8_t _burstWindow;                 // Poll steps; halves on a miss, 0 = one byte per interrupt
+    uint8_t _burstIdle;                   // Interrupts since the window closed
+    volatile uint32_t _burstCaptures;     // Bytes taken without an interrupt of their own
+    
+    // Polled capture
+    bool _polledEnabled;
+    PolledCaptureStatistics _polledStats;
+    
+    // Job boundaries from /INIT and /SELECT-IN (JobSignalTimer, main loop)
+    uint8_t _jobSignals;                  // JobBoundary::SIGNAL_* bits watched
+    volatile uint8_t _jobSignalLevels;    // Lines asserted at the last sample
+    volatile uint8_t _boundaryFirst;      // Oldest pending edge in _boundaryIndex
+    volatile uint8_t _boundaryCount;
+    volatile uint16_t _boundaryIndex[DeviceBridge::Common::JobBoundary::MAX_PENDING]; // Ring head index at each edge
+    volatile uint32_t _jobBoundaries;
+    int16_t bytesBeforeBoundary() const;  // Negative once the ring was cleared past it
+    
   public:
     Port(
         Control control,
@@ -68,6 +151,8 @@ namespace DeviceBridge::Parallel
     uint16_t getBufferFreeSpace() const;
     bool isFull();
     uint16_t readData(uint8_t buffer[], uint16_t index = 0, uint16_t length = 0);
+    uint16_t peekData(uint8_t buffer[], uint16_t index = 0, uint16_t length = 0); // readData() without releasing
+    void releaseData(uint16_t count);     // Frees `count` peeked bytes and updates flow control
     
     // Printer protocol methods
     void setBusy(bool busy);
@@ -75,21 +160,57 @@ namespace DeviceBridge::Parallel
     void setPaperOut(bool paperOut);
     void setSelect(bool select);
     void sendAcknowledge();
-    bool isLocked() const { return _locked; }
-    void lock() { _locked = true; setBusy(true); }
-    void unlock() { _locked = false; setBusy(false); }
     
     // Debug methods
     uint32_t getInterruptCount() const { return _interruptCount; }
     uint32_t getDataCount() const { return _dataCount; }
+    uint32_t getDroppedCount() const { return _droppedCount; }
+    void getCaptureCounters(CaptureCounters &out) const;  // residency includes the current state
     
-    // Deferred processing for optimized ISR
+    // Deferred processing for optimized ISR and the flow controller; main loop, never blocks
     void processPendingOperations();
+    uint32_t getPacingRecoveredUs() const { return _pacingRecoveredUs; }
     
     // Hardware flow control methods
     void setHardwareFlowControlEnabled(bool enabled);
     bool isHardwareFlowControlEnabled() const { return _hardwareFlowEnabled; }
     HardwareFlowControl::Statistics getFlowControlStatistics() const;
+    void setFlowPredictionEnabled(bool enabled) { _hardwareFlowControl.setPredictiveEnabled(enabled); }
+    bool isFlowPredictionEnabled() const { return _hardwareFlowControl.isPredictiveEnabled(); }
+    HardwareFlowControl::PredictionStatistics getFlowPredictionStatistics() const { return _hardwareFlowControl.getPredictionStatistics(); }
+    
+    // Timer-generated /ACK pulse; needs the Config.h status pin wiring
+    bool setTimedAcknowledgeEnabled(bool enabled, uint16_t pulseUs = DeviceBridge::Common::Timing::ACK_TIMER_PULSE_US);
+    bool isTimedAcknowledgeEnabled() const { return _timedAckEnabled; }
+    uint16_t getAcknowledgePulseUs() const;
+    
+    // Burst capture: the optimized ISR keeps taking back-to-back strobes
+    bool setBurstCaptureEnabled(bool enabled);
+    bool isBurstCaptureEnabled() const { return _burstEnabled; }
+    uint32_t getBurstCaptureCount() const { return _burstCaptures; }
+    
+    // Polled capture: ParallelPortManager runs pollCapture() sessions during sustained transfers
+    bool setPolledCaptureEnabled(bool enabled);
+    bool isPolledCaptureEnabled() const { return _polledEnabled; }
+    uint16_t pollCapture(uint8_t spentTicks = 0); // One session with interrupts masked; returns bytes captured.
+                                          // spentTicks: Timer0 ticks (4us) already masked before the call
+    const PolledCaptureStatistics &getPolledCaptureStatistics() const { return _polledStats; }
+    
+    // Job boundaries: an /INIT (or /SELECT-IN release) edge splits the stream where the ring stood;
+    // readData() stops there until clearJobBoundary()
+    void setJobSignals(uint8_t signals);  // Common::JobBoundary::SIGNAL_* bits, 0 = off; starts JobSignalTimer
+    uint8_t getJobSignals() const { return _jobSignals; }
+    void sampleJobSignals();              // Interrupts off: JobSignalTimer vector, polled sessions
+    void pollJobSignals();                // Main loop: catches edges while the timer is not running
+    bool atJobBoundary() const;
+    void clearJobBoundary();              // Moves on to the next pending edge
+    uint32_t getJobBoundaryCount() const;
+    
+    // Handshake calibration (HandshakeCalibrator): polled sessions that time /STROBE on Timer1 and
+    // /ACK at OptimizedTiming::fastAckPulseUs after the strobe rises
+    bool canCalibrate();                  // Wiring and ACK mode allow sessions; selects the optimized ISR
+    uint16_t calibrationSession(CalibrationSamples &samples); // Interrupts masked, <= POLLED_MAX_SESSION_US
+    void resetPolledCaptureStatistics() { _polledStats = PolledCaptureStatistics(); }
     
     // Control signal debugging
     bool isStrobeLow() { return _control.isStrobeLow(); }
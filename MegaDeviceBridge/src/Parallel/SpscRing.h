@@ -0,0 +1,171 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <Arduino.h>
+
+namespace DeviceBridge::Parallel
+{
+  /**
+   * Single-producer / single-consumer byte ring for the /STROBE ISR
+   *
+   * The producer (ISR) only writes _head, the consumer (main loop) only
+   * writes _tail, so neither side needs to mask interrupts around a whole
+   * transfer. Indices run free over 16 bits and are masked on access, which
+   * needs Capacity to be a power of two and lets a full ring be told apart
+   * from an empty one without a spare slot.
+   *
+   * A 16-bit index is two byte accesses on AVR, so the consumer's load of
+   * _head and store of _tail are bracketed by a two-instruction SREG guard;
+   * the ISR side runs with interrupts off and touches the indices directly.
+   * On the host the indices use acquire/release atomics so the ring can be
+   * exercised with a real concurrent producer.
+   */
+  template <typename T, uint16_t Capacity>
+  class SpscRing
+  {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+    static_assert(Capacity <= 0x8000, "SpscRing capacity must fit a 16-bit free-running index");
+
+  public:
+    /** Contiguous run of elements inside the ring */
+    struct Span
+    {
+      const T *data;
+      uint16_t length;
+    };
+
+    SpscRing() : _head(0), _tail(0) {}
+
+    // Producer side (ISR, or anywhere interrupts are disabled)
+
+    inline bool push(const T &value)
+    {
+      const uint16_t head = _head;
+      if ((uint16_t)(head - producerLoadTail()) >= Capacity) {
+        return false;
+      }
+      _buffer[head & MASK] = value;
+      producerStoreHead(head + 1);
+      return true;
+    }
+
+    // Consumer side (main loop)
+
+    /**
+     * Readable elements as at most two contiguous spans (the second is
+     * non-empty only when the data wraps). Nothing is released until
+     * consume() is called, so the spans can be handed straight to memcpy()
+     * or a storage write.
+     */
+    uint16_t peek(Span &first, Span &second, uint16_t max = Capacity) const
+    {
+      const uint16_t tail = _tail;
+      uint16_t count = (uint16_t)(loadHead() - tail);
+      if (count > max) {
+        count = max;
+      }
+      const uint16_t start = tail & MASK;
+      const uint16_t run = Capacity - start;
+      first.data = &_buffer[start];
+      first.length = count < run ? count : run;
+      second.data = &_buffer[0];
+      second.length = count - first.length;
+      return count;
+    }
+
+    /** Release `count` elements previously returned by peek() */
+    inline void consume(uint16_t count) { storeTail(_tail + count); }
+
+    /** Copy up to `max` elements into `out`; nothing is released */
+    uint16_t copy(T *out, uint16_t max) const
+    {
+      Span first, second;
+      const uint16_t count = peek(first, second, max);
+      memcpy(out, first.data, first.length * sizeof(T));
+      if (second.length) {
+        memcpy(out + first.length, second.data, second.length * sizeof(T));
+      }
+      return count;
+    }
+
+    /** Copy up to `max` elements into `out` and release them */
+    uint16_t read(T *out, uint16_t max)
+    {
+      const uint16_t count = copy(out, max);
+      consume(count);
+      return count;
+    }
+
+    inline bool pop(T &value)
+    {
+      const uint16_t tail = _tail;
+      if (loadHead() == tail) {
+        return false;
+      }
+      value = _buffer[tail & MASK];
+      storeTail(tail + 1);
+      return true;
+    }
+
+    /** Drop everything currently readable */
+    inline void clear() { storeTail(loadHead()); }
+
+    // Either side
+
+    inline uint16_t size() const { return (uint16_t)(loadHead() - loadTail()); }
+    inline bool isEmpty() const { return size() == 0; }
+    inline bool isFull() const { return size() >= Capacity; }
+    /** Free-running count of elements pushed / released; differences are exact while under 32768 */
+    inline uint16_t headIndex() const { return loadHead(); }
+    inline uint16_t tailIndex() const { return loadTail(); }
+    static constexpr uint16_t maxSize() { return Capacity; }
+
+  private:
+    static constexpr uint16_t MASK = Capacity - 1;
+
+    T _buffer[Capacity];
+    volatile uint16_t _head;
+    volatile uint16_t _tail;
+
+#if defined(__AVR__)
+    static inline uint16_t load(const volatile uint16_t &index)
+    {
+      const uint8_t sreg = SREG;
+      cli();
+      const uint16_t value = index;
+      SREG = sreg;
+      return value;
+    }
+
+    static inline void store(volatile uint16_t &index, uint16_t value)
+    {
+      const uint8_t sreg = SREG;
+      cli();
+      index = value;
+      SREG = sreg;
+    }
+
+    // Interrupts are already off on the producer side
+    inline uint16_t producerLoadTail() const { return _tail; }
+    inline void producerStoreHead(uint16_t value) { _head = value; }
+#else
+    static inline uint16_t load(const volatile uint16_t &index)
+    {
+      return __atomic_load_n(&index, __ATOMIC_ACQUIRE);
+    }
+
+    static inline void store(volatile uint16_t &index, uint16_t value)
+    {
+      __atomic_store_n(&index, value, __ATOMIC_RELEASE);
+    }
+
+    inline uint16_t producerLoadTail() const { return load(_tail); }
+    inline void producerStoreHead(uint16_t value) { store(_head, value); }
+#endif
+
+    inline uint16_t loadHead() const { return load(_head); }
+    inline uint16_t loadTail() const { return load(_tail); }
+    inline void storeTail(uint16_t value) { store(_tail, value); }
+  };
+}
@@ -2,6 +2,7 @@
 #include <Arduino.h>
 #include "Status.h"
 #include "OptimizedTiming.h"
+#include "FastPin.h"
 #include "../Common/ServiceLocator.h"
 #include "../Common/ConfigurationService.h"
 
@@ -19,6 +20,8 @@ namespace DeviceBridge::Parallel
     _paperOut = paperOut;
     _selected = selected;
     _error = error;
+    _fastSignals = false;
+    _fastPort = NO_FAST_PORT;
   }
 
   void Status::initialize()
@@ -37,45 +40,71 @@ namespace DeviceBridge::Parallel
 
     pinMode(_acknowledge, OUTPUT); // Ack - normally high
     digitalWrite(_acknowledge, true);
+
+    // FastPin<> is bound to Config.h at compile time; other wiring keeps digitalWrite
+    _fastSignals = _acknowledge == Common::Pins::LPT_ACK &&
+                   _busy == Common::Pins::LPT_BUSY &&
+                   _paperOut == Common::Pins::LPT_PAPER_OUT &&
+                   _selected == Common::Pins::LPT_SELECT &&
+                   _error == Common::Pins::LPT_ERROR;
+    _fastPort = _fastSignals ? 0 : NO_FAST_PORT;
+#if DEVICEBRIDGE_PARALLEL_PORTS > 1
+    if (_acknowledge == Common::Pins::LPT2_ACK && _busy == Common::Pins::LPT2_BUSY &&
+        _paperOut == Common::Pins::LPT2_PAPER_OUT && _selected == Common::Pins::LPT2_SELECT &&
+        _error == Common::Pins::LPT2_ERROR) {
+      _fastPort = 1;
+    }
+#endif
+#if DEVICEBRIDGE_PARALLEL_PORTS > 2
+    if (_acknowledge == Common::Pins::LPT3_ACK && _busy == Common::Pins::LPT3_BUSY &&
+        _paperOut == Common::Pins::LPT3_PAPER_OUT && _selected == Common::Pins::LPT3_SELECT &&
+        _error == Common::Pins::LPT3_ERROR) {
+      _fastPort = 2;
+    }
+#endif
   }
 
   void Status::setBusy(){
     // set busy
-    digitalWrite(_busy, true);
+    setBusy(true);
   }
   void Status::setBusy(bool busy) {
-    digitalWrite(_busy, busy);
+    if (_fastPort != NO_FAST_PORT) {
+      writeFastPort<Common::Pins::LPT_BUSY, Common::Pins::LPT2_BUSY, Common::Pins::LPT3_BUSY>(_fastPort, busy);
+    } else {
+      digitalWrite(_busy, busy);
+    }
   }
 
   void Status::setAck(){
     // set acknowledgement
-    digitalWrite(_acknowledge, false);
+    writeAck(false);
     
     //TODO: might need spin lock
 
     // reset acknowledgement
-    digitalWrite(_acknowledge, true);
+    writeAck(true);
     // reset busy
-    digitalWrite(_busy, false);
+    setBusy(false);
     
   }
 
   void Status::sendAcknowledgePulse() {
     // Send proper acknowledge pulse for TDS2024 timing
     // TDS2024 requires minimum 10μs acknowledge pulse width
-    digitalWrite(_acknowledge, false);
-    delayMicroseconds(Common::Timing::ACK_PULSE_US);  // Extended pulse for reliable capture
-    digitalWrite(_acknowledge, true);
-    delayMicroseconds(Common::Timing::RECOVERY_DELAY_US);   // Brief recovery time
+    writeAck(false);
+    delayMicroseconds(OptimizedTiming::ackPulseUs);  // Extended pulse for reliable capture (or the sender's profile)
+    writeAck(true);
+    delayMicroseconds(OptimizedTiming::recoveryDelayUs);   // Brief recovery time
   }
   
   void Status::sendAcknowledgePulseOptimized() {
     // IEEE-1284 compliant fast acknowledge pulse using cached timing
     // Direct pin access for minimum latency in ISR context
     if (OptimizedTiming::isInitialized()) {
-      digitalWrite(_acknowledge, LOW);
-      delayMicroseconds(1); // Minimum pulse width for fast response
-      digitalWrite(_acknowledge, HIGH);
+      writeAck(LOW);
+      delayMicroseconds(OptimizedTiming::fastAckPulseUs); // Minimum pulse width the sender honors
+      writeAck(HIGH);
     } else {
       // Fallback to ServiceLocator method
       sendAcknowledgePulse();
@@ -83,14 +112,35 @@ namespace DeviceBridge::Parallel
   }
 
   void Status::setError(bool error) {
-    digitalWrite(_error, !error);  // Error is active LOW
+    // Error is active LOW
+    if (_fastPort != NO_FAST_PORT) {
+      writeFastPort<Common::Pins::LPT_ERROR, Common::Pins::LPT2_ERROR, Common::Pins::LPT3_ERROR>(_fastPort, !error);
+    } else {
+      digitalWrite(_error, !error);
+    }
   }
 
   void Status::setPaperOut(bool paperOut) {
-    digitalWrite(_paperOut, paperOut);
+    if (_fastPort != NO_FAST_PORT) {
+      writeFastPort<Common::Pins::LPT_PAPER_OUT, Common::Pins::LPT2_PAPER_OUT, Common::Pins::LPT3_PAPER_OUT>(_fastPort, paperOut);
+    } else {
+      digitalWrite(_paperOut, paperOut);
+    }
   }
 
   void Status::setSelect(bool select) {
-    digitalWrite(_selected, select);
+    if (_fastPort != NO_FAST_PORT) {
+      writeFastPort<Common::Pins::LPT_SELECT, Common::Pins::LPT2_SELECT, Common::Pins::LPT3_SELECT>(_fastPort, select);
+    } else {
+      digitalWrite(_selected, select);
+    }
+  }
+
+  void Status::writeAck(bool level) {
+    if (_fastPort != NO_FAST_PORT) {
+      writeFastPort<Common::Pins::LPT_ACK, Common::Pins::LPT2_ACK, Common::Pins::LPT3_ACK>(_fastPort, level);
+    } else {
+      digitalWrite(_acknowledge, level);
+    }
   }
 }
\ No newline at end of file
@@ -8,6 +8,12 @@ namespace DeviceBridge::Parallel
   {
   private:
     uint8_t _acknowledge, _busy, _paperOut, _selected, _error;
+    bool _fastSignals; // Pins match the first port's Common::Pins (timer /ACK, polled capture)
+    uint8_t _fastPort; // Port whose Common::Pins match, so FastPin<> can drive them; NO_FAST_PORT otherwise
+
+    static constexpr uint8_t NO_FAST_PORT = 0xFF;
+
+    void writeAck(bool level);
 
   public:
     Status(
@@ -26,5 +32,10 @@ namespace DeviceBridge::Parallel
     void setError(bool error);
     void setPaperOut(bool paperOut);
     void setSelect(bool select);
+    bool isFastSignals() const { return _fastSignals; }
+    uint8_t getBusyPin() const { return _busy; }
+    uint8_t getErrorPin() const { return _error; }
+    uint8_t getPaperOutPin() const { return _paperOut; }
+    uint8_t getSelectPin() const { return _selected; }
   };
 }
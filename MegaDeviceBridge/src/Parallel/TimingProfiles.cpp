@@ -0,0 +1,158 @@
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <stddef.h>
+#include <string.h>
+#include "TimingProfiles.h"
+
+namespace DeviceBridge::Parallel::TimingProfiles
+{
+  namespace
+  {
+    namespace Calibration = Common::Calibration;
+
+    constexpr uint16_t MAGIC = 0x5444; // "DT"
+    constexpr uint8_t VERSION = 1;
+    constexpr uint8_t NO_SLOT = 0xFF;
+
+    struct Header
+    {
+      uint16_t magic;
+      uint8_t version;
+      uint8_t active;
+    };
+
+    static_assert(Calibration::PROFILE_EEPROM_ADDRESS + sizeof(Header) +
+                          Calibration::PROFILE_SLOTS * sizeof(Profile) <= 4096,
+                  "profile table does not fit the internal EEPROM");
+
+    int slotAddress(uint8_t slot)
+    {
+      return Calibration::PROFILE_EEPROM_ADDRESS + sizeof(Header) + slot * sizeof(Profile);
+    }
+
+    uint8_t checksum(const Profile &profile)
+    {
+      const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&profile);
+      uint8_t sum = 0xA5;
+      for (uint8_t i = 0; i < offsetof(Profile, checksum); i++) {
+        sum = (uint8_t)((sum << 1) | (sum >> 7)) ^ bytes[i];
+      }
+      return sum;
+    }
+
+    bool readHeader(Header &header)
+    {
+      EEPROM.get(Calibration::PROFILE_EEPROM_ADDRESS, header);
+      return header.magic == MAGIC && header.version == VERSION;
+    }
+
+    // First write to a blank or foreign table: claim it and empty every slot
+    void formatIfNeeded()
+    {
+      Header header;
+      if (readHeader(header)) {
+        return;
+      }
+      for (uint8_t slot = 0; slot < Calibration::PROFILE_SLOTS; slot++) {
+        EEPROM.update(slotAddress(slot), 0);
+      }
+      header.magic = MAGIC;
+      header.version = VERSION;
+      header.active = NO_SLOT;
+      EEPROM.put(Calibration::PROFILE_EEPROM_ADDRESS, header);
+    }
+
+    int8_t findSlot(const char *sender)
+    {
+      Profile profile;
+      for (uint8_t slot = 0; slot < Calibration::PROFILE_SLOTS; slot++) {
+        if (get(slot, profile) && strcasecmp(profile.sender, sender) == 0) {
+          return (int8_t)slot;
+        }
+      }
+      return -1;
+    }
+  }
+
+  bool get(uint8_t slot, Profile &out)
+  {
+    Header header;
+    if (slot >= Calibration::PROFILE_SLOTS || !readHeader(header)) {
+      return false;
+    }
+    EEPROM.get(slotAddress(slot), out);
+    return out.sender[0] != '\0' && out.sender[sizeof(out.sender) - 1] == '\0' && out.checksum == checksum(out);
+  }
+
+  bool find(const char *sender, Profile &out)
+  {
+    const int8_t slot = findSlot(sender);
+    return slot >= 0 && get((uint8_t)slot, out);
+  }
+
+  bool save(Profile &profile)
+  {
+    if (profile.sender[0] == '\0') {
+      return false;
+    }
+    formatIfNeeded();
+    int8_t slot = findSlot(profile.sender);
+    Profile existing;
+    for (uint8_t i = 0; slot < 0 && i < Calibration::PROFILE_SLOTS; i++) {
+      if (!get(i, existing)) {
+        slot = (int8_t)i;
+      }
+    }
+    if (slot < 0) {
+      return false;
+    }
+    profile.sender[sizeof(profile.sender) - 1] = '\0';
+    profile.checksum = checksum(profile);
+    EEPROM.put(slotAddress((uint8_t)slot), profile);
+    return true;
+  }
+
+  bool remove(const char *sender)
+  {
+    const int8_t slot = findSlot(sender);
+    if (slot < 0) {
+      return false;
+    }
+    Header header;
+    readHeader(header);
+    if (header.active == (uint8_t)slot) {
+      header.active = NO_SLOT;
+      EEPROM.put(Calibration::PROFILE_EEPROM_ADDRESS, header);
+    }
+    EEPROM.update(slotAddress((uint8_t)slot), 0);
+    return true;
+  }
+
+  bool getActive(Profile &out)
+  {
+    Header header;
+    return readHeader(header) && header.active != NO_SLOT && get(header.active, out);
+  }
+
+  bool setActive(const char *sender)
+  {
+    int8_t slot = -1;
+    if (sender != nullptr) {
+      slot = findSlot(sender);
+      if (slot < 0) {
+        return false;
+      }
+    }
+    Header header;
+    if (!readHeader(header)) {
+      if (slot < 0) {
+        return true; // nothing stored, Config.h timings already in use
+      }
+      formatIfNeeded();
+      readHeader(header);
+    }
+    header.active = slot < 0 ? NO_SLOT : (uint8_t)slot;
+    EEPROM.put(Calibration::PROFILE_EEPROM_ADDRESS, header);
+    return true;
+  }
+}
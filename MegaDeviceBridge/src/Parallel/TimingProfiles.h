@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdint.h>
+#include "../Common/Config.h"
+
+namespace DeviceBridge::Parallel
+{
+  /**
+   * Handshake timing profiles per sending instrument
+   *
+   * A table of PROFILE_SLOTS profiles in the ATmega2560's internal EEPROM
+   * at Calibration::PROFILE_EEPROM_ADDRESS, behind a 4-byte header holding
+   * the active slot. HandshakeCalibrator fills a profile from a transfer;
+   * OptimizedTiming loads the active one at boot. A blank or foreign table
+   * reads as empty; each slot carries its own checksum. Every EEPROM byte
+   * written takes ~3.4ms, so saving is for the main loop only.
+   */
+  namespace TimingProfiles
+  {
+    struct Profile
+    {
+      char sender[Common::Calibration::SENDER_NAME_LENGTH]; // NUL-terminated, matched without case
+      uint8_t ackPulseUs;      // shortest /ACK width the sender reliably saw
+      uint8_t busySetupUs;     // BUSY held before /ACK (legacy capture path)
+      uint16_t strobeWidthNs;  // mean /STROBE low time measured
+      uint16_t strobeGapUs;    // mean strobe-to-strobe period at ackPulseUs, BUSY low
+      uint16_t samples;        // strobes measured over the whole calibration
+      uint8_t checksum;
+    };
+
+    /** Saved profile for `sender`; false if there is none */
+    bool find(const char *sender, Profile &out);
+    /** Slot `slot` (0..PROFILE_SLOTS-1); false if it is empty */
+    bool get(uint8_t slot, Profile &out);
+    /** Replaces the profile with the same sender, else takes a free slot; false when the table is full */
+    bool save(Profile &profile);
+    bool remove(const char *sender);
+
+    /** Profile loaded at boot; false when the Config.h timings are in use */
+    bool getActive(Profile &out);
+    /** nullptr goes back to the Config.h timings; false if `sender` has no profile */
+    bool setActive(const char *sender);
+  }
+}
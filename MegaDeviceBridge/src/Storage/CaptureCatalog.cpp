@@ -0,0 +1,321 @@
+#include "CaptureCatalog.h"
+#include "ContiguousFile.h"
+#include "../Common/Types.h"
+#include <string.h>
+
+namespace DeviceBridge::Storage {
+
+namespace {
+
+constexpr char MAGIC[8] = {'D', 'B', 'C', 'A', 'T', 'L', 'O', 'G'};
+constexpr uint8_t VERSION = 1;
+
+struct Header {
+    char magic[8];
+    uint8_t version;
+    uint8_t recordSize;
+    uint8_t reserved[22];
+};
+static_assert(sizeof(Header) == sizeof(CaptureCatalog::Entry), "the header takes the first record");
+static_assert(sizeof(CaptureCatalog::Entry) == 32, "16 records to a block");
+
+bool hasExtension(const char *name, const char *extension) {
+    const size_t length = strlen(name);
+    const size_t extensionLength = strlen(extension);
+    return length >= extensionLength && strcasecmp(name + length - extensionLength, extension) == 0;
+}
+
+// The catalog's own files, capture records and traces are not captures
+bool isCapture(const char *name) {
+    return strcasecmp(name, Common::Catalog::FILE_NAME) != 0 && strcasecmp(name, Common::Commit::JOURNAL_NAME) != 0 &&
+           !hasExtension(name, Common::FileSystem::CAPTURE_RECORD_EXTENSION) &&
+           !hasExtension(name, Common::CaptureTrace::EXTENSION);
+}
+
+uint8_t typeOf(const char *name) {
+    const char *dot = strrchr(name, '.');
+    if (dot) {
+        for (int8_t type = Common::FileType::BMP; type < Common::FileType::Count; type++) {
+            if (strcasecmp(dot, Common::FileType((Common::FileType::Value)type).getFileExtension()) == 0) {
+                return (uint8_t)type;
+            }
+        }
+    }
+    return Common::FileType::BINARY;
+}
+
+// Names are compared the way FAT does; a rebuilt record has the card's upper case
+bool sameField(const char *field, size_t fieldSize, const char *text, size_t length) {
+    return length <= fieldSize && strncasecmp(field, text, length) == 0 && (length == fieldSize || field[length] == '\0');
+}
+
+} // namespace
+
+bool CaptureCatalog::_ready = false;
+uint32_t CaptureCatalog::_count = 0;
+uint32_t CaptureCatalog::_totalBytes = 0;
+
+bool CaptureCatalog::mount() {
+    _ready = false;
+    _count = 0;
+    _totalBytes = 0;
+    ContiguousFile::endStream();
+
+    File catalog = SD.open(Common::Catalog::FILE_NAME, FILE_READ);
+    if (catalog) {
+        Header header;
+        bool valid = catalog.read(&header, sizeof(header)) == (int)sizeof(header) &&
+                     memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == VERSION &&
+                     header.recordSize == sizeof(Entry) && catalog.size() % sizeof(Entry) == 0;
+        Entry entry;
+        while (valid && catalog.read(&entry, sizeof(entry)) == (int)sizeof(entry)) {
+            if (!(entry.flags & DELETED)) {
+                _count++;
+                _totalBytes += entry.size;
+            }
+        }
+        catalog.close();
+        if (valid) {
+            _ready = true;
+            return true;
+        }
+    }
+    return rebuild(false) >= 0;
+}
+
+bool CaptureCatalog::setPath(Entry &entry, const char *path) {
+    // "/20250101/120000.bin" or "120000.bin"
+    while (*path == '/') {
+        path++;
+    }
+    memset(entry.directory, 0, sizeof(entry.directory));
+    memset(entry.name, 0, sizeof(entry.name));
+    const char *slash = strchr(path, '/');
+    const char *name = slash ? slash + 1 : path;
+    const size_t directoryLength = slash ? (size_t)(slash - path) : 0;
+    const size_t nameLength = strlen(name);
+    if (directoryLength > sizeof(entry.directory) || nameLength == 0 || nameLength > sizeof(entry.name) ||
+        strchr(name, '/')) {
+        return false;
+    }
+    memcpy(entry.directory, path, directoryLength);
+    memcpy(entry.name, name, nameLength);
+    return true;
+}
+
+void CaptureCatalog::formatPath(const Entry &entry, char *buffer, size_t bufferSize) {
+    const int directoryLength = (int)strnlen(entry.directory, sizeof(entry.directory));
+    const int nameLength = (int)strnlen(entry.name, sizeof(entry.name));
+    if (directoryLength) {
+        snprintf(buffer, bufferSize, "%.*s/%.*s", directoryLength, entry.directory, nameLength, entry.name);
+    } else {
+        snprintf(buffer, bufferSize, "%.*s", nameLength, entry.name);
+    }
+}
+
+bool CaptureCatalog::append(const char *path, uint32_t size, uint8_t type, uint16_t crc, uint32_t timestamp) {
+    Entry entry;
+    if (!_ready || !setPath(entry, path)) {
+        return false;
+    }
+    entry.size = size;
+    entry.timestamp = timestamp;
+    entry.crc = crc;
+    entry.type = type;
+    entry.flags = CRC_VALID;
+    return write(entry);
+}
+
+bool CaptureCatalog::replace(const char *path, uint32_t size) {
+    Entry entry;
+    if (!_ready || !setPath(entry, path)) {
+        return false;
+    }
+    remove(path);
+    entry.size = size;
+    entry.timestamp = 0;
+    entry.crc = 0;
+    entry.type = typeOf(path);
+    entry.flags = 0;
+    return write(entry);
+}
+
+bool CaptureCatalog::write(const Entry &entry) {
+    // A record cut short by a power loss leaves the size off a record boundary: mount() rebuilds
+    ContiguousFile::endStream();
+    File catalog = SD.open(Common::Catalog::FILE_NAME, FILE_WRITE);
+    if (!catalog) {
+        return false;
+    }
+    const bool written = catalog.write((const uint8_t *)&entry, sizeof(entry)) == sizeof(entry);
+    catalog.close();
+    if (written) {
+        _count++;
+        _totalBytes += entry.size;
+    }
+    return written;
+}
+
+bool CaptureCatalog::remove(const char *path) {
+    Entry wanted;
+    if (!_ready || !setPath(wanted, path)) {
+        return false;
+    }
+    const size_t directoryLength = strnlen(wanted.directory, sizeof(wanted.directory));
+    const size_t nameLength = strnlen(wanted.name, sizeof(wanted.name));
+
+    ContiguousFile::endStream();
+    File catalog = SD.open(Common::Catalog::FILE_NAME, O_RDWR);
+    if (!catalog) {
+        return false;
+    }
+    bool found = false;
+    Entry entry;
+    uint32_t position = sizeof(Header);
+    catalog.seek(position);
+    while (catalog.read(&entry, sizeof(entry)) == (int)sizeof(entry)) {
+        if (!(entry.flags & DELETED) &&
+            sameField(entry.directory, sizeof(entry.directory), wanted.directory, directoryLength) &&
+            sameField(entry.name, sizeof(entry.name), wanted.name, nameLength)) {
+            entry.flags |= DELETED;
+            found = catalog.seek(position) && catalog.write((const uint8_t *)&entry, sizeof(entry)) == sizeof(entry);
+            break;
+        }
+        position += sizeof(entry);
+    }
+    catalog.close();
+    if (found) {
+        _count--;
+        _totalBytes -= entry.size;
+    }
+    return found;
+}
+
+bool CaptureCatalog::forEach(void (*visit)(const Entry &entry, void *context), void *context) {
+    if (!_ready) {
+        return false;
+    }
+    ContiguousFile::endStream();
+    File catalog = SD.open(Common::Catalog::FILE_NAME, FILE_READ);
+    if (!catalog || !catalog.seek(sizeof(Header))) {
+        return false;
+    }
+    Entry entry;
+    while (catalog.read(&entry, sizeof(entry)) == (int)sizeof(entry)) {
+        if (!(entry.flags & DELETED)) {
+            visit(entry, context);
+        }
+    }
+    catalog.close();
+    return true;
+}
+
+int32_t CaptureCatalog::rebuild(bool withCrc) {
+    _ready = false;
+    _count = 0;
+    _totalBytes = 0;
+    ContiguousFile::endStream();
+
+    if (SD.exists(Common::Catalog::FILE_NAME)) {
+        SD.remove(Common::Catalog::FILE_NAME);
+    }
+    File catalog = SD.open(Common::Catalog::FILE_NAME, FILE_WRITE);
+    if (!catalog) {
+        return -1;
+    }
+    Header header = {};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.recordSize = sizeof(Entry);
+    if (catalog.write((const uint8_t *)&header, sizeof(header)) != sizeof(header)) {
+        catalog.close();
+        return -1;
+    }
+
+    // Records go out in batches: the walk and the catalog share the one block cache
+    Entry batch[Common::Catalog::REBUILD_BATCH];
+    uint8_t batched = 0;
+    int32_t cataloged = 0;
+    File root = SD.open("/");
+    bool result = root && addFiles(root, "", catalog, withCrc, batch, batched, cataloged);
+    if (root) {
+        root.close();
+    }
+    result = result && catalog.write((const uint8_t *)batch, batched * sizeof(Entry)) == batched * sizeof(Entry);
+    catalog.close();
+    if (!result) {
+        return -1;
+    }
+    _ready = true;
+    return cataloged;
+}
+
+bool CaptureCatalog::addFiles(File &directory, const char *directoryName, File &catalog, bool withCrc,
+                              Entry *batch, uint8_t &batched, int32_t &cataloged) {
+    while (true) {
+        File file = directory.openNextFile();
+        if (!file) {
+            return true;
+        }
+        if (file.isDirectory()) {
+            // Day directories, one level below the root
+            char name[13];
+            strncpy(name, file.name(), sizeof(name) - 1);
+            name[sizeof(name) - 1] = '\0';
+            const bool added = *directoryName || addFiles(file, name, catalog, withCrc, batch, batched, cataloged);
+            file.close();
+            if (!added) {
+                return false;
+            }
+            continue;
+        }
+        if (!isCapture(file.name())) {
+            file.close();
+            continue;
+        }
+
+        Entry &entry = batch[batched];
+        char path[Common::Limits::MAX_FILENAME_LENGTH];
+        snprintf(path, sizeof(path), "%s/%s", directoryName, file.name());
+        if (!setPath(entry, path)) {
+            file.close();
+            continue;
+        }
+        entry.size = file.size();
+        entry.timestamp = 0;
+        entry.crc = 0;
+        entry.type = typeOf(file.name());
+        entry.flags = 0;
+        if (withCrc) {
+            uint8_t buffer[64];
+            int length;
+            while ((length = file.read(buffer, sizeof(buffer))) > 0) {
+                entry.crc = crc16(entry.crc, buffer, (size_t)length);
+            }
+            entry.flags = CRC_VALID;
+        }
+        file.close();
+
+        _count++;
+        _totalBytes += entry.size;
+        cataloged++;
+        if (++batched == Common::Catalog::REBUILD_BATCH) {
+            if (catalog.write((const uint8_t *)batch, sizeof(Entry) * batched) != sizeof(Entry) * batched) {
+                return false;
+            }
+            batched = 0;
+        }
+    }
+}
+
+uint16_t CaptureCatalog::crc16(uint16_t crc, const uint8_t *data, size_t length) {
+    // Byte at a time without a table: a few shifts per byte keeps up with a chunk between strobes
+    while (length--) {
+        uint8_t x = (uint8_t)(crc >> 8) ^ *data++;
+        x ^= x >> 4;
+        crc = (uint16_t)((crc << 8) ^ ((uint16_t)x << 12) ^ ((uint16_t)x << 5) ^ x);
+    }
+    return crc;
+}
+
+} // namespace DeviceBridge::Storage
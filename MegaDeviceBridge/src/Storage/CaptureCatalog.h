@@ -0,0 +1,70 @@
+#pragma once
+
+#include <Arduino.h>
+#include <SD.h>
+#include "../Common/Config.h"
+
+namespace DeviceBridge::Storage {
+
+/**
+ * @brief Catalog of the capture files on the SD card, so counts and listings need no directory walk
+ *
+ * Common::Catalog::FILE_NAME in the SD root: a header record, then one
+ * 32-byte record per capture file (16 to a block), appended when the file
+ * closes. mount() reads it front to back once for the file count and total
+ * size; after that both are kept in RAM, and a listing is one sequential
+ * read. deleteFile() marks the record in place.
+ *
+ * A missing, foreign or torn catalog (a partial record at the end) is
+ * rebuilt from a walk of the root and its day directories. Only
+ * rebuild(true) reads the files back for their CRC. Files copied to or
+ * deleted from the card elsewhere show up after `catalog rebuild`.
+ */
+class CaptureCatalog {
+public:
+    struct Entry {
+        char directory[8];   // "20250101"; empty in the root; not terminated when full
+        char name[12];       // 8.3, as directory
+        uint32_t size;
+        uint32_t timestamp;  // TimeManager::getTimestamp() at close: Unix time, or millis() without the RTC; 0 if rebuilt
+        uint16_t crc;        // crc16() of the data
+        uint8_t type;        // Common::FileType::Value
+        uint8_t flags;
+    };
+    static constexpr uint8_t CRC_VALID = 0x01;  // A rebuild without CRCs leaves it clear
+    static constexpr uint8_t DELETED = 0x80;
+
+    /** After SD.begin(): reads the catalog, or rebuilds it (without CRCs); false if neither works */
+    static bool mount();
+    /** Card removed */
+    static void unmount() { _ready = false; }
+    static bool isReady() { return _ready; }
+    static uint32_t count() { return _count; }
+    static uint32_t totalBytes() { return _totalBytes; }
+
+    static bool append(const char *path, uint32_t size, uint8_t type, uint16_t crc, uint32_t timestamp);
+    static bool remove(const char *path);
+    /** Drops any record of `path` and catalogs it at `size`, typed by its extension, without a CRC */
+    static bool replace(const char *path, uint32_t size);
+    /** Walks the card and rewrites the catalog; files cataloged, or -1 */
+    static int32_t rebuild(bool withCrc);
+    /** Live records in the order they were written */
+    static bool forEach(void (*visit)(const Entry &entry, void *context), void *context);
+
+    /** CRC-16/XMODEM (polynomial 0x1021, start 0); chunks chain through `crc` */
+    static uint16_t crc16(uint16_t crc, const uint8_t *data, size_t length);
+    /** "20250101/120000.bin" */
+    static void formatPath(const Entry &entry, char *buffer, size_t bufferSize);
+
+private:
+    static bool setPath(Entry &entry, const char *path);
+    static bool write(const Entry &entry);
+    static bool addFiles(File &directory, const char *directoryName, File &catalog, bool withCrc,
+                         Entry *batch, uint8_t &batched, int32_t &cataloged);
+
+    static bool _ready;
+    static uint32_t _count;
+    static uint32_t _totalBytes;
+};
+
+} // namespace DeviceBridge::Storage
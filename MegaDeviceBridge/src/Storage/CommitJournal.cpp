@@ -0,0 +1,139 @@
+#include "CommitJournal.h"
+#include <stddef.h>
+#include <string.h>
+
+namespace DeviceBridge::Storage {
+
+namespace {
+
+constexpr char MAGIC[4] = {'D', 'B', 'C', 'J'};
+constexpr uint8_t VERSION = 1;
+
+struct Header {
+    char magic[4];
+    uint8_t version;
+    uint8_t count;
+    uint16_t checksum;  // header up to here, then the entries
+};
+
+constexpr uint8_t MAX_ENTRIES =
+    (Common::FileSystem::BLOCK_SIZE - sizeof(Header)) / sizeof(CommitJournal::Entry);
+static_assert(MAX_ENTRIES >= Common::ParallelPorts::COUNT, "journal block cannot name every port's file");
+
+uint16_t checksum(const uint8_t *block, uint8_t count) {
+    uint16_t sum = 0xA55A;
+    const size_t length = sizeof(Header) + count * sizeof(CommitJournal::Entry);
+    for (size_t i = 0; i < length; i++) {
+        if (i == offsetof(Header, checksum)) {
+            i += sizeof(uint16_t) - 1;
+            continue;
+        }
+        sum = (uint16_t)((sum << 1) | (sum >> 15)) ^ block[i];
+    }
+    return sum;
+}
+
+} // namespace
+
+uint32_t CommitJournal::_block = 0;
+
+uint8_t CommitJournal::mount(void (*recovered)(const char *path, uint32_t size)) {
+    _block = 0;
+    if (!ContiguousFile::_ready) {
+        return 0;
+    }
+    ContiguousFile::endStream();
+
+    SdFile journal;
+    bool created = false;
+    if (!journal.open(&ContiguousFile::_root, Common::Commit::JOURNAL_NAME, O_RDWR)) {
+        created = journal.createContiguous(&ContiguousFile::_root, Common::Commit::JOURNAL_NAME,
+                                           Common::FileSystem::BLOCK_SIZE);
+        if (!created) {
+            return 0;
+        }
+    }
+    uint32_t lastBlock;
+    const bool ranged = journal.contiguousRange(&_block, &lastBlock);
+    journal.close();
+    if (!ranged) {
+        _block = 0;
+        return 0;
+    }
+    if (created) {
+        record(nullptr, 0);
+        return 0;
+    }
+
+    uint8_t *block = SdVolume::cacheClear();
+    if (!ContiguousFile::_card->readBlock(_block, block)) {
+        _block = 0;
+        return 0;
+    }
+    Header header;
+    memcpy(&header, block, sizeof(header));
+    if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        header.count > MAX_ENTRIES || header.checksum != checksum(block, header.count)) {
+        record(nullptr, 0);
+        return 0;
+    }
+
+    // One entry at a time: opening the files reuses the block cache
+    uint8_t truncated = 0;
+    const uint8_t count = header.count;
+    for (uint8_t i = 0; i < count; i++) {
+        Entry entry;
+        block = SdVolume::cacheClear();
+        if (i > 0 && !ContiguousFile::_card->readBlock(_block, block)) {
+            break;
+        }
+        memcpy(&entry, block + sizeof(Header) + i * sizeof(Entry), sizeof(entry));
+        entry.path[sizeof(entry.path) - 1] = '\0';
+
+        const char *name = entry.path;
+        SdFile directory;
+        SdFile *parent = ContiguousFile::openParent(name, directory);
+        SdFile file;
+        bool cut = false;
+        if (parent && file.open(parent, name, O_RDWR)) {
+            // Never closed: the blocks past the commit hold erased or stale data
+            cut = file.fileSize() == entry.reserved && entry.size < entry.reserved && file.truncate(entry.size);
+            file.close();
+        }
+        if (parent == &directory) {
+            directory.close();
+        }
+        if (cut) {
+            truncated++;
+            if (recovered) {
+                recovered(entry.path, entry.size);
+            }
+        }
+    }
+    record(nullptr, 0);
+    return truncated;
+}
+
+bool CommitJournal::record(const Entry *entries, uint8_t count) {
+    if (!_block || !ContiguousFile::_ready || count > MAX_ENTRIES) {
+        return false;
+    }
+    ContiguousFile::endStream();
+
+    uint8_t *block = SdVolume::cacheClear();
+    memset(block, 0, Common::FileSystem::BLOCK_SIZE);
+    Header header;
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.count = count;
+    header.checksum = 0;
+    memcpy(block, &header, sizeof(header));
+    if (count) {
+        memcpy(block + sizeof(Header), entries, count * sizeof(Entry));
+    }
+    header.checksum = checksum(block, count);
+    memcpy(block, &header, sizeof(header));
+    return ContiguousFile::_card->writeBlock(_block, block);
+}
+
+} // namespace DeviceBridge::Storage
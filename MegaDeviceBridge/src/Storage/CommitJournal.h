@@ -0,0 +1,44 @@
+#pragma once
+
+#include <Arduino.h>
+#include "ContiguousFile.h"
+#include "../Common/Config.h"
+
+namespace DeviceBridge::Storage {
+
+/**
+ * @brief Committed sizes of the open contiguous capture files, for recovery after a power loss
+ *
+ * Until it is closed, a ContiguousFile's directory entry holds the size it
+ * was created with (the whole extent), whatever was written. The journal is
+ * one block of a one-cluster file in the SD root (Commit::JOURNAL_NAME),
+ * rewritten in place with a raw block write on every commit: each open
+ * file's path, reserved size and the bytes known to be on the card. mount()
+ * truncates every named file that still has its reserved size to its
+ * committed size, which drops the blocks past the last commit and frees the
+ * clusters after them. A closed file has its real size and is left alone, so
+ * closing needs no journal write. Files written through the SD library are
+ * not named: their directory entry is their last flush.
+ *
+ * The block carries a checksum; a torn or foreign block reads as empty.
+ */
+class CommitJournal {
+public:
+    struct Entry {
+        uint32_t size;      // committed
+        uint32_t reserved;  // directory entry size until close
+        char path[Common::Limits::MAX_FILENAME_LENGTH];
+    };
+
+    /** After ContiguousFile::begin(): opens or creates the journal and recovers what it names; files truncated */
+    static uint8_t mount(void (*recovered)(const char *path, uint32_t size) = nullptr);
+    static bool isReady() { return _block != 0; }
+
+    /** Replaces the journal with `count` entries; 0 once no capture file is open */
+    static bool record(const Entry *entries, uint8_t count);
+
+private:
+    static uint32_t _block;
+};
+
+} // namespace DeviceBridge::Storage
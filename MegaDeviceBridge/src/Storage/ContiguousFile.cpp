@@ -0,0 +1,214 @@
+#include "ContiguousFile.h"
+#include <string.h>
+
+namespace DeviceBridge::Storage {
+
+namespace {
+constexpr uint16_t BLOCK_SIZE = Common::FileSystem::BLOCK_SIZE;
+}
+
+Sd2Card *ContiguousFile::_card = nullptr;
+SdVolume ContiguousFile::_volume;
+SdFile ContiguousFile::_root;
+bool ContiguousFile::_ready = false;
+ContiguousFile *ContiguousFile::_streaming = nullptr;
+uint32_t ContiguousFile::_nextBlock = 0;
+ContiguousFile *ContiguousFile::_cached = nullptr;
+uint8_t *ContiguousFile::_cache = nullptr;
+
+ContiguousFile::ContiguousFile() : _firstBlock(0), _lastBlock(0), _size(0), _open(false) {}
+
+bool ContiguousFile::begin() {
+    end();
+    // Re-running Sd2Card::init() on a second object would rebind the static block cache to it;
+    // the volume is initialized on the card SD.begin() already owns, so the binding stays
+    _card = _volume.sdCard();
+    _ready = _card && _volume.init(_card) && _root.openRoot(&_volume);
+    return _ready;
+}
+
+void ContiguousFile::end() {
+    _streaming = nullptr;
+    _cached = nullptr;
+    if (_ready) {
+        _root.close();
+    }
+    _ready = false;
+}
+
+bool ContiguousFile::stopStream() {
+    if (!_streaming) {
+        return true;
+    }
+    _streaming = nullptr;
+    return _card->writeStop();
+}
+
+bool ContiguousFile::endStream() {
+    if (!_ready) {
+        _streaming = nullptr;
+        _cached = nullptr;
+        return false;
+    }
+
+    bool result = true;
+    if (_cached && _cached->_size % BLOCK_SIZE) {
+        // The partial block goes out padded; the file reads it back when it continues
+        const uint32_t block = _cached->_firstBlock + _cached->_size / BLOCK_SIZE;
+        if (_streaming == _cached && _nextBlock == block) {
+            result = _card->writeData(_cache);
+        } else {
+            stopStream();
+            result = _card->writeBlock(block, _cache);
+        }
+    }
+    _cached = nullptr;
+    return stopStream() && result;
+}
+
+SdFile *ContiguousFile::openParent(const char *&path, SdFile &directory) {
+    // "/20250101/120000.bin": open the day directory, leave the name in it
+    while (*path == '/') {
+        path++;
+    }
+    const char *slash = strchr(path, '/');
+    if (!slash) {
+        return &_root;
+    }
+    char directoryName[13];
+    const size_t length = (size_t)(slash - path);
+    if (length >= sizeof(directoryName) || strchr(slash + 1, '/')) {
+        return nullptr;
+    }
+    memcpy(directoryName, path, length);
+    directoryName[length] = '\0';
+    if (!directory.open(&_root, directoryName, O_READ)) {
+        return nullptr;
+    }
+    path = slash + 1;
+    return &directory;
+}
+
+bool ContiguousFile::create(const char *path, uint32_t extentBytes) {
+    if (!_ready || _open) {
+        return false;
+    }
+    endStream();
+
+    SdFile directory;
+    SdFile *parent = openParent(path, directory);
+    if (!parent) {
+        return false;
+    }
+
+    _open = _file.createContiguous(parent, path, extentBytes) && _file.contiguousRange(&_firstBlock, &_lastBlock);
+    if (parent == &directory) {
+        directory.close();
+    }
+    if (!_open) {
+        if (_file.isOpen()) {
+            _file.remove();
+        }
+        return false;
+    }
+    _size = 0;
+    return true;
+}
+
+bool ContiguousFile::loadBlock(uint32_t block, uint16_t offset) {
+    if (_cached == this) {
+        return true;
+    }
+    // Another file's block, or the SD library's, is in the cache
+    endStream();
+    _cache = SdVolume::cacheClear();
+    if (offset && !_card->readBlock(block, _cache)) {
+        return false;
+    }
+    _cached = this;
+    return true;
+}
+
+bool ContiguousFile::streamBlock(uint32_t block) {
+    if (_streaming != this || _nextBlock != block) {
+        stopStream();
+        // Pre-erase the rest of the extent; the card can then program without erasing per block
+        if (!_card->writeStart(block, _lastBlock - block + 1)) {
+            return false;
+        }
+        _streaming = this;
+        _nextBlock = block;
+    }
+    if (!_card->writeData(_cache)) {
+        _streaming = nullptr;
+        return false;
+    }
+    _nextBlock++;
+    return true;
+}
+
+size_t ContiguousFile::write(const uint8_t *data, size_t length) {
+    if (!_open) {
+        return 0;
+    }
+
+    size_t done = 0;
+    while (done < length) {
+        const uint32_t block = _firstBlock + _size / BLOCK_SIZE;
+        const uint16_t offset = _size % BLOCK_SIZE;
+
+        if (block > _lastBlock) {
+            // Extent full: the rest goes through the FAT chain
+            endStream();
+            if (!_file.seekSet(_size)) {
+                break;
+            }
+            const int16_t written = _file.write(data + done, (uint16_t)(length - done));
+            if (written > 0) {
+                _size += (uint16_t)written;
+                done += (uint16_t)written;
+            }
+            break;
+        }
+
+        if (!loadBlock(block, offset)) {
+            break;
+        }
+        const uint16_t count = (length - done) < (size_t)(BLOCK_SIZE - offset) ? (uint16_t)(length - done)
+                                                                              : (uint16_t)(BLOCK_SIZE - offset);
+        memcpy(_cache + offset, data + done, count);
+        if (offset + count == BLOCK_SIZE && !streamBlock(block)) {
+            break;
+        }
+        _size += count;
+        done += count;
+    }
+    return done;
+}
+
+bool ContiguousFile::sync() {
+    if (!_open) {
+        return false;
+    }
+    bool result = endStream();
+    if (_size > (_lastBlock - _firstBlock + 1) * BLOCK_SIZE) {
+        result = _file.sync() && result;
+    }
+    return result;
+}
+
+bool ContiguousFile::close() {
+    if (!_open) {
+        return true;
+    }
+    _open = false;
+
+    bool result = endStream();
+    // Give back the clusters past the data; the directory entry gets the real size
+    if (_size < _file.fileSize()) {
+        result = _file.truncate(_size) && result;
+    }
+    return _file.close() && result;
+}
+
+} // namespace DeviceBridge::Storage
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <Arduino.h>
+#include <SD.h>
+#include "../Common/Config.h"
+
+namespace DeviceBridge::Storage {
+
+/**
+ * @brief SD capture file on a pre-allocated run of clusters, written with multi-block commands
+ *
+ * create() reserves the extent through the SD library's createContiguous(),
+ * so the FAT chain and directory entry are written once, up front. Data then
+ * goes straight to the card: every completed 512-byte block is sent inside
+ * one CMD25 multi-block write that stays open across chunks, from the
+ * library's own block cache (SdVolume::cacheClear()), so no extra buffer is
+ * needed. close() ends the stream and truncates the file to the bytes
+ * written, which frees the unused clusters.
+ *
+ * The card, its volume's block cache and SPI settings are the ones
+ * SD.begin() set up; no second card object is initialized. Call
+ * endStream() before any SD/File operation. It writes the partial block of
+ * the file holding the cache (padded) and stops the multi-block write; the
+ * file reads the block back when it continues. A file that outgrows its
+ * extent continues through the FAT chain like any other.
+ *
+ * Inside the multi-block write the card programs each block after it is
+ * sent, and the next block waits for that. isCardBusy() lets the caller do
+ * other work instead of waiting in the SD library.
+ */
+class ContiguousFile {
+    friend class CommitJournal;
+
+public:
+    /** After SD.begin(): the library's card, and a volume on it for the root directory */
+    static bool begin();
+    /** Card removed: forget the stream without touching the bus */
+    static void end();
+    /** Hand the card and block cache back to the SD library */
+    static bool endStream();
+    static bool isReady() { return _ready; }
+    /** The open multi-block write's card is still programming the last block; one byte on the bus */
+    static bool isCardBusy() { return _streaming && _card->isBusy(); }
+
+    ContiguousFile();
+
+    /** False if the name exists, no run of free clusters is that long, or the path is more than one directory deep */
+    bool create(const char *path, uint32_t extentBytes = Common::FileSystem::EXTENT_BYTES);
+    size_t write(const uint8_t *data, size_t length);
+    /** Every byte written on the card; past the extent that includes the FAT chain and directory entry */
+    bool sync();
+    bool close();
+
+    bool isOpen() const { return _open; }
+    uint32_t size() const { return _size; }
+
+private:
+    bool loadBlock(uint32_t block, uint16_t offset);
+    bool streamBlock(uint32_t block);
+    static bool stopStream();
+    /** Parent of a root or one-level path, with `path` moved to the name in it; nullptr if it cannot be opened */
+    static SdFile *openParent(const char *&path, SdFile &directory);
+
+    SdFile _file;
+    uint32_t _firstBlock;
+    uint32_t _lastBlock;
+    uint32_t _size;
+    bool _open;
+
+    static Sd2Card *_card;             // the SD library's, from SdVolume::sdCard()
+    static SdVolume _volume;
+    static SdFile _root;
+    static bool _ready;
+    static ContiguousFile *_streaming;  // file whose CMD25 is open
+    static uint32_t _nextBlock;        // block the open CMD25 writes next
+    static ContiguousFile *_cached;    // file whose current block is in the block cache
+    static uint8_t *_cache;
+};
+
+} // namespace DeviceBridge::Storage
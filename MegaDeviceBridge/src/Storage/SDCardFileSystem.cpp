@@ -1,4 +1,5 @@
 #include "SDCardFileSystem.h"
+#include "CaptureCatalog.h"
 #include <string.h>
 
 namespace DeviceBridge::Storage {
@@ -32,6 +33,7 @@ bool SDCardFileSystem::initialize() {
         _initialized = false;
         return false;
     }
+    ContiguousFile::begin();
     
     _initialized = true;
     updateSpaceInfo();
@@ -44,6 +46,10 @@ bool SDCardFileSystem::isAvailable() const {
 }
 
 void SDCardFileSystem::shutdown() {
+    if (_contiguousFile.isOpen()) {
+        _contiguousFile.close();
+        _hasActiveFile = false;
+    }
     if (_currentFile) {
         _currentFile.close();
         _hasActiveFile = false;
@@ -66,22 +72,15 @@ bool SDCardFileSystem::createFile(const char* filename) {
         closeFile();
     }
     
-    // Create directories if they don't exist
-    String filepath(filename);
-    int lastSlash = filepath.lastIndexOf('/');
-    if (lastSlash > 0) {
-        String dirPath = filepath.substring(0, lastSlash);
-        if (!SD.exists(dirPath)) {
-            // Note: SD library doesn't have mkdir, files create directories automatically
+    ContiguousFile::endStream();
+    if (!_contiguousFile.create(filename)) {
+        _currentFile = SD.open(filename, FILE_WRITE);
+        if (!_currentFile) {
+            setError(FileSystemErrors::FILE_CREATE_FAILED, "Failed to create file");
+            return false;
         }
     }
     
-    _currentFile = SD.open(filename, FILE_WRITE);
-    if (!_currentFile) {
-        setError(FileSystemErrors::FILE_CREATE_FAILED, "Failed to create file");
-        return false;
-    }
-    
     _hasActiveFile = true;
     _filesCreated++;
     clearError();
@@ -98,6 +97,7 @@ bool SDCardFileSystem::openFile(const char* filename, bool append) {
         closeFile();
     }
     
+    ContiguousFile::endStream();
     _currentFile = SD.open(filename, append ? FILE_WRITE : FILE_READ);
     if (!_currentFile) {
         setError(FileSystemErrors::FILE_OPEN_FAILED, "Failed to open file");
@@ -114,7 +114,7 @@ bool SDCardFileSystem::openFile(const char* filename, bool append) {
 }
 
 bool SDCardFileSystem::writeData(const uint8_t* data, uint16_t length) {
-    if (!_hasActiveFile || !_currentFile) {
+    if (!_hasActiveFile || (!_contiguousFile.isOpen() && !_currentFile)) {
         setError(FileSystemErrors::FILE_WRITE_FAILED, "No active file");
         return false;
     }
@@ -124,7 +124,7 @@ bool SDCardFileSystem::writeData(const uint8_t* data, uint16_t length) {
         return false;
     }
     
-    size_t written = _currentFile.write(data, length);
+    size_t written = _contiguousFile.isOpen() ? _contiguousFile.write(data, length) : _currentFile.write(data, length);
     if (written != length) {
         setError(FileSystemErrors::FILE_WRITE_FAILED, "Write operation incomplete");
         return false;
@@ -136,11 +136,20 @@ bool SDCardFileSystem::writeData(const uint8_t* data, uint16_t length) {
 }
 
 bool SDCardFileSystem::closeFile() {
-    if (!_hasActiveFile || !_currentFile) {
+    if (!_hasActiveFile || (!_contiguousFile.isOpen() && !_currentFile)) {
         return true; // Already closed
     }
     
-    _currentFile.close();
+    if (_contiguousFile.isOpen()) {
+        // Truncated to the bytes written
+        if (!_contiguousFile.close()) {
+            _hasActiveFile = false;
+            setError(FileSystemErrors::FILE_CLOSE_FAILED, "Failed to close file");
+            return false;
+        }
+    } else {
+        _currentFile.close();
+    }
     _hasActiveFile = false;
     clearError();
     return true;
@@ -157,6 +166,7 @@ bool SDCardFileSystem::deleteFile(const char* filename) {
         return false;
     }
     
+    ContiguousFile::endStream();
     if (!SD.exists(filename)) {
         setError(FileSystemErrors::FILE_NOT_FOUND, "File does not exist");
         return false;
@@ -166,6 +176,7 @@ bool SDCardFileSystem::deleteFile(const char* filename) {
         setError(FileSystemErrors::FILE_DELETE_FAILED, "Failed to delete file");
         return false;
     }
+    CaptureCatalog::remove(filename);
     
     clearError();
     return true;
@@ -176,6 +187,7 @@ bool SDCardFileSystem::fileExists(const char* filename) {
         return false;
     }
     
+    ContiguousFile::endStream();
     return SD.exists(filename);
 }
 
@@ -185,39 +197,34 @@ bool SDCardFileSystem::listFiles(char* buffer, uint16_t bufferSize) {
         return false;
     }
     
-    File root = SD.open("/");
-    if (!root) {
-        setError(FileSystemErrors::DIRECTORY_READ_FAILED, "Failed to open root directory");
-        return false;
-    }
-    
-    uint16_t pos = 0;
+    // One sequential read of the capture catalog instead of a directory walk
+    struct Listing {
+        char* buffer;
+        uint16_t size;
+        uint16_t pos;
+    } listing = {buffer, bufferSize, 0};
     buffer[0] = '\0';
     
-    while (true) {
-        File entry = root.openNextFile();
-        if (!entry) {
-            break;
-        }
-        
-        const char* name = entry.name();
-        uint16_t nameLen = strlen(name);
+    const bool listed = CaptureCatalog::forEach([](const CaptureCatalog::Entry& entry, void* context) {
+        Listing& listing = *static_cast<Listing*>(context);
+        char path[Common::Limits::MAX_FILENAME_LENGTH];
+        CaptureCatalog::formatPath(entry, path, sizeof(path));
+        uint16_t pathLen = strlen(path);
         
-        // Check if we have space for filename + newline + null terminator
-        if (pos + nameLen + 2 >= bufferSize) {
-            entry.close();
-            break;
+        // Check if we have space for path + newline + null terminator
+        if (listing.pos + pathLen + 2 >= listing.size) {
+            return;
         }
-        
-        strcat(buffer + pos, name);
-        pos += nameLen;
-        buffer[pos++] = '\n';
-        buffer[pos] = '\0';
-        
-        entry.close();
-    }
+        memcpy(listing.buffer + listing.pos, path, pathLen);
+        listing.pos += pathLen;
+        listing.buffer[listing.pos++] = '\n';
+        listing.buffer[listing.pos] = '\0';
+    }, &listing);
     
-    root.close();
+    if (!listed) {
+        setError(FileSystemErrors::DIRECTORY_READ_FAILED, "No capture catalog");
+        return false;
+    }
     clearError();
     return true;
 }
@@ -227,25 +234,8 @@ uint32_t SDCardFileSystem::getFileCount() {
         return 0;
     }
     
-    File root = SD.open("/");
-    if (!root) {
-        return 0;
-    }
-    
-    uint32_t count = 0;
-    while (true) {
-        File entry = root.openNextFile();
-        if (!entry) {
-            break;
-        }
-        if (!entry.isDirectory()) {
-            count++;
-        }
-        entry.close();
-    }
-    
-    root.close();
-    return count;
+    // Kept by the capture catalog: no directory walk
+    return CaptureCatalog::count();
 }
 
 uint32_t SDCardFileSystem::getTotalSpace() {
@@ -265,6 +255,10 @@ bool SDCardFileSystem::format() {
 }
 
 bool SDCardFileSystem::flush() {
+    if (_hasActiveFile && _contiguousFile.isOpen()) {
+        // Blocks are on the card once the multi-block write ends; the size follows on close
+        return ContiguousFile::endStream();
+    }
     if (_hasActiveFile && _currentFile) {
         _currentFile.flush();
     }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "IFileSystem.h"
+#include "ContiguousFile.h"
 #include "../Common/Config.h"
 #include <SD.h>
 #include <Arduino.h>
@@ -11,11 +12,13 @@ namespace DeviceBridge::Storage {
  * @brief SD Card file system implementation
  * 
  * Provides file operations for SD card storage with hardware detection,
- * write protection monitoring, and automatic error recovery.
+ * write protection monitoring, and automatic error recovery. New files are
+ * written to a pre-allocated extent (ContiguousFile) when the card has one.
  */
 class SDCardFileSystem : public IFileSystem {
 private:
     File _currentFile;
+    ContiguousFile _contiguousFile;
     bool _initialized;
     bool _writeProtected;
     uint32_t _totalSpace;
@@ -55,7 +58,9 @@ public:
     }
     const char* getStorageName() const override { return "SD Card"; }
     bool isWriteProtected() const override { return _writeProtected; }
-    bool hasActiveFile() const override { return (_currentFile ? true : false) && _hasActiveFile; }
+    bool hasActiveFile() const override {
+        return (_contiguousFile.isOpen() || (_currentFile ? true : false)) && _hasActiveFile;
+    }
     
     // Statistics
     uint32_t getBytesWritten() const override { return _bytesWritten; }
@@ -0,0 +1,57 @@
+#include "SpiBus.h"
+#include "../Parallel/FastPin.h"
+#include <string.h>
+
+namespace DeviceBridge::Storage {
+
+namespace {
+using FlashSelect = Parallel::FastPin<Common::Pins::EEPROM_CS>;
+}
+
+uint8_t SpiBus::_depth[SpiBus::DEVICE_COUNT] = {};
+unsigned long SpiBus::_since[SpiBus::DEVICE_COUNT] = {};
+SpiBus::Statistics SpiBus::_statistics[SpiBus::DEVICE_COUNT] = {};
+
+void SpiBus::begin() {
+    // A select left floating at power-up would answer SD.begin()'s commands on MISO
+    FlashSelect::high();
+    pinMode(Common::Pins::EEPROM_CS, OUTPUT);
+    digitalWrite(Common::Pins::SD_CS, HIGH);
+    pinMode(Common::Pins::SD_CS, OUTPUT);
+    SPI.begin();
+    memset(_depth, 0, sizeof(_depth));
+    resetStatistics();
+}
+
+void SpiBus::claim(Device device) {
+    if (_depth[device]++) {
+        return;
+    }
+    _since[device] = micros();
+    if (device == FLASH) {
+        SPI.beginTransaction(SPISettings(Common::Spi::FLASH_CLOCK_HZ, MSBFIRST, SPI_MODE0));
+        SPI.transfer(0xFF);
+    }
+}
+
+void SpiBus::release(Device device) {
+    if (!_depth[device] || --_depth[device]) {
+        return;
+    }
+    if (device == FLASH) {
+        SPI.endTransaction();
+    }
+    Statistics &stats = _statistics[device];
+    const uint32_t heldUs = micros() - _since[device];
+    stats.claims++;
+    stats.busyUs += heldUs;
+    stats.maxUs = heldUs > stats.maxUs ? heldUs : stats.maxUs;
+}
+
+void SpiBus::selectFlash() { FlashSelect::low(); }
+
+void SpiBus::deselectFlash() { FlashSelect::high(); }
+
+void SpiBus::resetStatistics() { memset(_statistics, 0, sizeof(_statistics)); }
+
+} // namespace DeviceBridge::Storage
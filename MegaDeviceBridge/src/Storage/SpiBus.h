@@ -0,0 +1,65 @@
+#pragma once
+
+#include <Arduino.h>
+#include <SPI.h>
+#include "../Common/Config.h"
+
+namespace DeviceBridge::Storage {
+
+/**
+ * @brief Arbiter for the SPI bus the SD card and the W25Q128 flash share
+ *
+ * Each device has its own SPISettings (Common::Spi): the flash runs at the
+ * full 8MHz SCK whatever rate the card left behind. A claim begins the
+ * device's transaction once for a batch of command frames, and
+ * selectFlash()/deselectFlash() toggle the flash's chip select with a single
+ * SBI/CBI between them. A flash claim first clocks a byte with every select
+ * high: a card keeps driving MISO until it sees one, and the SD library
+ * also uses the bus outside any claim.
+ *
+ * The SD library begins its own transaction around every card command, so
+ * claim(SD_CARD) only accounts for the bus. Claims of one device nest; the
+ * outermost is timed (claims, total and longest hold per device).
+ */
+class SpiBus {
+public:
+    enum Device : uint8_t { SD_CARD, FLASH, DEVICE_COUNT };
+
+    struct Statistics {
+        uint32_t claims;
+        uint32_t busyUs;
+        uint32_t maxUs;
+    };
+
+    /** Every chip select high, then SPI.begin(); before either device is initialized. Clears the statistics */
+    static void begin();
+    static void claim(Device device);
+    static void release(Device device);
+
+    /** The flash's chip select; the SD library drives the card's */
+    static void selectFlash();
+    static void deselectFlash();
+
+    static const Statistics &statistics(Device device) { return _statistics[device]; }
+    static void resetStatistics();
+    static uint32_t clockHz(Device device) {
+        return device == FLASH ? Common::Spi::FLASH_CLOCK_HZ : Common::Spi::SD_CLOCK_HZ;
+    }
+
+    /** claim() for a scope */
+    class Transaction {
+    public:
+        explicit Transaction(Device device) : _device(device) { claim(device); }
+        ~Transaction() { release(_device); }
+
+    private:
+        Device _device;
+    };
+
+private:
+    static uint8_t _depth[DEVICE_COUNT];
+    static unsigned long _since[DEVICE_COUNT];
+    static Statistics _statistics[DEVICE_COUNT];
+};
+
+} // namespace DeviceBridge::Storage
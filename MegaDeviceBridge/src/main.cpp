@@ -2,6 +2,7 @@
 
 // Hardware abstraction layers
 #include "./Parallel/Port.h"
+#include "./Parallel/OptimizedTiming.h"
 #include "./User/Display.h"
 
 // Component managers
@@ -42,6 +43,54 @@ DeviceBridge::Parallel::Port printerPort(
         DeviceBridge::Common::Pins::LPT_D6,
         DeviceBridge::Common::Pins::LPT_D7));
 
+#if DEVICEBRIDGE_PARALLEL_PORTS > 1
+DeviceBridge::Parallel::Port printerPort2(
+    DeviceBridge::Parallel::Control(
+        DeviceBridge::Common::Pins::LPT2_STROBE,
+        DeviceBridge::Common::Pins::LPT2_AUTO_FEED,
+        DeviceBridge::Common::Pins::LPT2_INITIALIZE,
+        DeviceBridge::Common::Pins::LPT2_SELECT_IN),
+    DeviceBridge::Parallel::Status(
+        DeviceBridge::Common::Pins::LPT2_ACK,
+        DeviceBridge::Common::Pins::LPT2_BUSY,
+        DeviceBridge::Common::Pins::LPT2_PAPER_OUT,
+        DeviceBridge::Common::Pins::LPT2_SELECT,
+        DeviceBridge::Common::Pins::LPT2_ERROR),
+    DeviceBridge::Parallel::Data(
+        DeviceBridge::Common::Pins::LPT2_D0,
+        DeviceBridge::Common::Pins::LPT2_D1,
+        DeviceBridge::Common::Pins::LPT2_D2,
+        DeviceBridge::Common::Pins::LPT2_D3,
+        DeviceBridge::Common::Pins::LPT2_D4,
+        DeviceBridge::Common::Pins::LPT2_D5,
+        DeviceBridge::Common::Pins::LPT2_D6,
+        DeviceBridge::Common::Pins::LPT2_D7));
+#endif
+
+#if DEVICEBRIDGE_PARALLEL_PORTS > 2
+DeviceBridge::Parallel::Port printerPort3(
+    DeviceBridge::Parallel::Control(
+        DeviceBridge::Common::Pins::LPT3_STROBE,
+        DeviceBridge::Common::Pins::LPT3_AUTO_FEED,
+        DeviceBridge::Common::Pins::LPT3_INITIALIZE,
+        DeviceBridge::Common::Pins::LPT3_SELECT_IN),
+    DeviceBridge::Parallel::Status(
+        DeviceBridge::Common::Pins::LPT3_ACK,
+        DeviceBridge::Common::Pins::LPT3_BUSY,
+        DeviceBridge::Common::Pins::LPT3_PAPER_OUT,
+        DeviceBridge::Common::Pins::LPT3_SELECT,
+        DeviceBridge::Common::Pins::LPT3_ERROR),
+    DeviceBridge::Parallel::Data(
+        DeviceBridge::Common::Pins::LPT3_D0,
+        DeviceBridge::Common::Pins::LPT3_D1,
+        DeviceBridge::Common::Pins::LPT3_D2,
+        DeviceBridge::Common::Pins::LPT3_D3,
+        DeviceBridge::Common::Pins::LPT3_D4,
+        DeviceBridge::Common::Pins::LPT3_D5,
+        DeviceBridge::Common::Pins::LPT3_D6,
+        DeviceBridge::Common::Pins::LPT3_D7));
+#endif
+
 DeviceBridge::User::Display display(
     DeviceBridge::Common::Pins::LCD_RESET,
     DeviceBridge::Common::Pins::LCD_ENABLE,
@@ -51,7 +100,7 @@ DeviceBridge::User::Display display(
     DeviceBridge::Common::Pins::LCD_D7);
 
 // Component managers - Array-based management
-DeviceBridge::IComponent* components[7];
+DeviceBridge::IComponent* components[6 + DeviceBridge::Common::ParallelPorts::COUNT];
 DeviceBridge::Common::ConfigurationService* configurationService = nullptr;
 
 // Component indices for easy access
@@ -62,7 +111,8 @@ constexpr uint8_t TIME_INDEX = 3;
 constexpr uint8_t SYSTEM_INDEX = 4;
 constexpr uint8_t CONFIGURATION_INDEX = 5;
 constexpr uint8_t HEARTBEAT_LED_INDEX = 6;
-constexpr uint8_t COMPONENT_COUNT = 7;
+constexpr uint8_t EXTRA_PARALLEL_PORT_INDEX = 7; // Second and third ports (DEVICEBRIDGE_PARALLEL_PORTS)
+constexpr uint8_t COMPONENT_COUNT = 6 + DeviceBridge::Common::ParallelPorts::COUNT;
 
 // Update intervals (milliseconds) - now accessed via ConfigurationService
 
@@ -78,6 +128,19 @@ void setup()
   Serial.print(F("Initializing printer port...\r\n"));
   Serial.flush();
   printerPort.initialize();
+#if DEVICEBRIDGE_PARALLEL_PORTS > 1
+  Serial.print(F("Initializing printer port 2...\r\n"));
+  printerPort2.initialize();
+#endif
+#if DEVICEBRIDGE_PARALLEL_PORTS > 2
+  Serial.print(F("Initializing printer port 3...\r\n"));
+  printerPort3.initialize();
+#endif
+  if (DeviceBridge::Parallel::OptimizedTiming::getProfileSender()[0] != '\0') {
+    Serial.print(F("Handshake timing profile: "));
+    Serial.print(DeviceBridge::Parallel::OptimizedTiming::getProfileSender());
+    Serial.print(F("\r\n"));
+  }
   
   Serial.print(F("Initializing display...\r\n"));
   Serial.flush();
@@ -121,6 +184,17 @@ void setup()
   Serial.flush();
   components[HEARTBEAT_LED_INDEX] = new DeviceBridge::Components::HeartbeatLEDManager();
   
+#if DEVICEBRIDGE_PARALLEL_PORTS > 1
+  Serial.print(F("Creating ParallelPortManager for port 2...\r\n"));
+  Serial.flush();
+  components[EXTRA_PARALLEL_PORT_INDEX] = new DeviceBridge::Components::ParallelPortManager(printerPort2, 1);
+#endif
+#if DEVICEBRIDGE_PARALLEL_PORTS > 2
+  Serial.print(F("Creating ParallelPortManager for port 3...\r\n"));
+  Serial.flush();
+  components[EXTRA_PARALLEL_PORT_INDEX + 1] = new DeviceBridge::Components::ParallelPortManager(printerPort3, 2);
+#endif
+  
   Serial.print(F("Creating ConfigurationService...\r\n"));
   Serial.flush();
   configurationService = new DeviceBridge::Common::ConfigurationService();
@@ -153,6 +227,10 @@ void setup()
   services.registerSystemManager(static_cast<DeviceBridge::Components::SystemManager*>(components[SYSTEM_INDEX]));
   services.registerConfigurationManager(static_cast<DeviceBridge::Components::ConfigurationManager*>(components[CONFIGURATION_INDEX]));
   services.registerHeartbeatLEDManager(static_cast<DeviceBridge::Components::HeartbeatLEDManager*>(components[HEARTBEAT_LED_INDEX]));
+  for (uint8_t port = 1; port < DeviceBridge::Common::ParallelPorts::COUNT; port++) {
+    services.registerParallelPortManager(
+        static_cast<DeviceBridge::Components::ParallelPortManager*>(components[EXTRA_PARALLEL_PORT_INDEX + port - 1]), port);
+  }
   services.registerConfigurationService(configurationService);
   
   // Validate all dependencies are registered
@@ -210,7 +288,4 @@ void loop()
       components[i]->markUpdated(currentTime);
     }
   }
-  
-  // Small delay to prevent overwhelming the CPU
-  delayMicroseconds(10);
 }
\ No newline at end of file
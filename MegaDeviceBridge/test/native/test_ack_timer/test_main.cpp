@@ -0,0 +1,218 @@
+// Timer-generated /ACK pulse (AckTimer, Timer5 compare A).
+//
+// Checks the /ACK low time produced by the one-shot against the configured
+// width, that the BUSY release lands on the /ACK rising edge, that BUSY is
+// held once the buffer passes the moderate threshold, and that the /STROBE
+// ISR no longer spends any time in delayMicroseconds().
+//
+//   pio test -e native -f native/test_ack_timer -v
+
+#include <unity.h>
+#include <Arduino.h>
+#include <stdio.h>
+#include <vector>
+#include "Common/Config.h"
+#include "Parallel/AckTimer.h"
+#include "Parallel/Port.h"
+
+using namespace NativeHal;
+using namespace DeviceBridge::Parallel;
+namespace Pins = DeviceBridge::Common::Pins;
+
+extern DeviceBridge::Parallel::Port printerPort;
+
+namespace {
+
+// One tick of prescaler phase plus entry into the compare vector
+const uint32_t PULSE_SLACK = 8 + 32;
+
+struct Edge {
+    uint8_t pin;
+    bool level;
+    uint64_t cycle;
+};
+
+class EdgeRecorder : public Peripheral {
+public:
+    std::vector<Edge> edges;
+
+    uint64_t nextEventCycle() const override { return UINT64_MAX; }
+    void onEvent(uint64_t now) override {}
+    void onOutputChange(uint8_t pin, bool level, uint64_t now) override
+    {
+        if (pin == Pins::LPT_ACK || pin == Pins::LPT_BUSY) {
+            edges.push_back(Edge{pin, level, now});
+        }
+    }
+
+    // Low time of each complete /ACK pulse
+    std::vector<uint32_t> ackPulses() const
+    {
+        std::vector<uint32_t> widths;
+        uint64_t fell = 0;
+        bool low = false;
+        for (const Edge &e : edges) {
+            if (e.pin != Pins::LPT_ACK) {
+                continue;
+            }
+            if (!e.level) {
+                fell = e.cycle;
+                low = true;
+            } else if (low) {
+                widths.push_back((uint32_t)(e.cycle - fell));
+                low = false;
+            }
+        }
+        return widths;
+    }
+};
+
+EdgeRecorder recorder;
+uint8_t drainBuffer[DeviceBridge::Common::Buffer::RING_BUFFER_SIZE];
+
+void drain() { printerPort.readData(drainBuffer, 0, sizeof(drainBuffer)); }
+
+void strobeByte(uint8_t value)
+{
+    const uint8_t pins[8] = {Pins::LPT_D0, Pins::LPT_D1, Pins::LPT_D2, Pins::LPT_D3,
+                             Pins::LPT_D4, Pins::LPT_D5, Pins::LPT_D6, Pins::LPT_D7};
+    for (uint8_t line = 0; line < 8; line++) {
+        drivePin(pins[line], (value >> line) & 0x01);
+    }
+    drivePin(Pins::LPT_STROBE, LOW);
+    advanceMicros(1);
+    drivePin(Pins::LPT_STROBE, HIGH);
+}
+
+void startPort()
+{
+    drivePin(Pins::LPT_STROBE, HIGH);
+    drivePin(Pins::LPT_AUTO_FEED, HIGH);
+    drivePin(Pins::LPT_INITIALIZE, HIGH);
+    drivePin(Pins::LPT_SELECT_IN, HIGH);
+    printerPort.initialize();
+    printerPort.setJobSignals(0); // JobSignalTimer's vector would be counted and timed with the strobes
+    attachPeripheral(&recorder);
+}
+
+} // namespace
+
+void setUp()
+{
+    recorder.edges.clear();
+}
+
+void tearDown()
+{
+    printerPort.setTimedAcknowledgeEnabled(false);
+    printerPort.clearBuffer();
+}
+
+void test_pulse_width_follows_configuration()
+{
+    const uint16_t widths[] = {1, 5, 20, 137, DeviceBridge::Common::Timing::ACK_TIMER_MAX_PULSE_US};
+    TEST_ASSERT_TRUE(printerPort.setTimedAcknowledgeEnabled(true, 20));
+    for (uint16_t width : widths) {
+        AckTimer::setPulseWidthUs(width);
+        TEST_ASSERT_EQUAL_UINT16(width, AckTimer::getPulseWidthUs());
+        // Vary the prescaler phase from pulse to pulse
+        for (uint8_t phase = 0; phase < 8; phase++) {
+            advanceCycles(phase + 3);
+            recorder.edges.clear();
+            cli();
+            AckTimer::start(false);
+            sei();
+            TEST_ASSERT_TRUE(AckTimer::isPulseActive());
+            advanceMicros(width + 10);
+            TEST_ASSERT_FALSE(AckTimer::isPulseActive());
+            std::vector<uint32_t> pulses = recorder.ackPulses();
+            TEST_ASSERT_EQUAL_UINT32(1, pulses.size());
+            TEST_ASSERT_GREATER_OR_EQUAL_UINT32((uint32_t)microsToCycles(width), pulses[0]);
+            TEST_ASSERT_LESS_OR_EQUAL_UINT32((uint32_t)microsToCycles(width) + PULSE_SLACK, pulses[0]);
+        }
+    }
+    AckTimer::setPulseWidthUs(0);
+    TEST_ASSERT_EQUAL_UINT16(1, AckTimer::getPulseWidthUs());
+    AckTimer::setPulseWidthUs(60000);
+    TEST_ASSERT_EQUAL_UINT16(DeviceBridge::Common::Timing::ACK_TIMER_MAX_PULSE_US, AckTimer::getPulseWidthUs());
+}
+
+void test_strobe_isr_leaves_pulse_to_timer()
+{
+    const uint16_t count = 200;
+    const uint16_t width = DeviceBridge::Common::Timing::ACK_TIMER_PULSE_US;
+
+    // Reference: the default (legacy) ISR with its busy-wait pulse and delays
+    uint64_t cycles0 = interruptCycles();
+    uint32_t serviced0 = interruptsServiced();
+    for (uint16_t i = 0; i < count; i++) {
+        strobeByte((uint8_t)i);
+        advanceMicros(width + 10);
+        drain();
+    }
+    double delayed = (double)(interruptCycles() - cycles0) / (interruptsServiced() - serviced0);
+
+    TEST_ASSERT_TRUE(printerPort.setTimedAcknowledgeEnabled(true, width));
+    recorder.edges.clear();
+    cycles0 = interruptCycles();
+    serviced0 = interruptsServiced();
+    uint64_t delay0 = interruptDelayCycles();
+    for (uint16_t i = 0; i < count; i++) {
+        strobeByte((uint8_t)(i * 37));
+        advanceMicros(width + 10);
+        TEST_ASSERT_EQUAL_UINT8((uint8_t)(i * 37), printerPort.readData(drainBuffer, 0, 1) ? drainBuffer[0] : 0xFF);
+    }
+    uint32_t serviced = interruptsServiced() - serviced0;
+    TEST_ASSERT_EQUAL_UINT32(2 * count, serviced); // strobe + compare per byte
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)delay0, (uint32_t)interruptDelayCycles());
+    double timed = (double)(interruptCycles() - cycles0) / count;
+
+    printf("\n  ISR cycles per byte: %.1f legacy with delays, %.1f timer /ACK (strobe + compare)\n\n", delayed, timed);
+    TEST_ASSERT_TRUE(timed * 2 < delayed);
+
+    // Every byte acknowledged with a full-width pulse, BUSY released on the rising edge
+    std::vector<uint32_t> pulses = recorder.ackPulses();
+    TEST_ASSERT_EQUAL_UINT32(count, pulses.size());
+    for (uint32_t pulse : pulses) {
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT32((uint32_t)microsToCycles(width), pulse);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32((uint32_t)microsToCycles(width) + PULSE_SLACK, pulse);
+    }
+    uint32_t releases = 0;
+    for (size_t i = 0; i + 1 < recorder.edges.size(); i++) {
+        const Edge &a = recorder.edges[i];
+        const Edge &b = recorder.edges[i + 1];
+        if (a.pin == Pins::LPT_ACK && a.level && b.pin == Pins::LPT_BUSY && !b.level) {
+            TEST_ASSERT_LESS_OR_EQUAL_UINT32(8, (uint32_t)(b.cycle - a.cycle));
+            releases++;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(count, releases);
+}
+
+void test_busy_held_above_moderate_threshold()
+{
+    const uint16_t width = 10;
+    TEST_ASSERT_TRUE(printerPort.setTimedAcknowledgeEnabled(true, width));
+    for (uint16_t i = 0; i < DeviceBridge::Common::FlowControl::MODERATE_THRESHOLD + 4; i++) {
+        strobeByte((uint8_t)i);
+        advanceMicros(width + 10);
+        const bool expectBusy = printerPort.getBufferSize() >= DeviceBridge::Common::FlowControl::MODERATE_THRESHOLD;
+        TEST_ASSERT_EQUAL(expectBusy, readPin(Pins::LPT_BUSY));
+        TEST_ASSERT_TRUE(readPin(Pins::LPT_ACK));
+    }
+    TEST_ASSERT_EQUAL_UINT32(DeviceBridge::Common::FlowControl::MODERATE_THRESHOLD + 4, recorder.ackPulses().size());
+
+    // Draining below the recovery threshold releases BUSY from the main loop
+    drain();
+    TEST_ASSERT_FALSE(readPin(Pins::LPT_BUSY));
+}
+
+int main(int argc, char **argv)
+{
+    startPort();
+    UNITY_BEGIN();
+    RUN_TEST(test_pulse_width_follows_configuration);
+    RUN_TEST(test_strobe_isr_leaves_pulse_to_timer);
+    RUN_TEST(test_busy_held_above_moderate_threshold);
+    return UNITY_END();
+}
@@ -0,0 +1,217 @@
+// Handshake calibration and per-sender timing profiles.
+//
+// Checks the profile table in the simulated internal EEPROM (save, replace,
+// lookup without case, full table, delete, active slot), then calibrates
+// against a simulated host that only sees /ACK pulses of at least 3us: the
+// calibrator has to settle on 3us, measure the host's 1us strobes, save the
+// profile as active, and the optimized ISR running on it must not cost the
+// host a single /ACK timeout where the Config.h 1us pulse does.
+//
+//   pio test -e native -f native/test_calibration -v
+
+#include <unity.h>
+#include <Arduino.h>
+#include <LptHostSimulator.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "Common/Config.h"
+#include "Parallel/HandshakeCalibrator.h"
+#include "Parallel/OptimizedTiming.h"
+#include "Parallel/Port.h"
+#include "Parallel/TimingProfiles.h"
+
+using namespace NativeHal;
+namespace Pins = DeviceBridge::Common::Pins;
+namespace Calibration = DeviceBridge::Common::Calibration;
+using DeviceBridge::Parallel::HandshakeCalibrator;
+using DeviceBridge::Parallel::OptimizedTiming;
+using DeviceBridge::Parallel::TimingProfiles::Profile;
+namespace TimingProfiles = DeviceBridge::Parallel::TimingProfiles;
+
+extern DeviceBridge::Parallel::Port printerPort;
+
+namespace {
+
+constexpr uint32_t SENDER_MIN_ACK_NS = 3000;
+
+uint8_t drainBuffer[DeviceBridge::Common::Buffer::RING_BUFFER_SIZE];
+
+Profile makeProfile(const char *sender, uint8_t ackUs)
+{
+    Profile profile;
+    memset(&profile, 0, sizeof(profile));
+    strncpy(profile.sender, sender, sizeof(profile.sender) - 1);
+    profile.ackPulseUs = ackUs;
+    profile.busySetupUs = 1;
+    return profile;
+}
+
+LptHostSimulator::Timing senderTiming()
+{
+    LptHostSimulator::Timing timing;
+    timing.minAckNs = SENDER_MIN_ACK_NS;
+    return timing;
+}
+
+LptHostSimulator::Pins senderPins()
+{
+    return {Pins::LPT_STROBE,
+            {Pins::LPT_D0, Pins::LPT_D1, Pins::LPT_D2, Pins::LPT_D3, Pins::LPT_D4, Pins::LPT_D5, Pins::LPT_D6,
+             Pins::LPT_D7},
+            Pins::LPT_ACK,
+            Pins::LPT_BUSY};
+}
+
+std::vector<uint8_t> jobBytes(uint16_t count)
+{
+    std::vector<uint8_t> bytes;
+    for (uint16_t i = 0; i < count; i++) {
+        bytes.push_back((uint8_t)(i * 37 + 11));
+    }
+    return bytes;
+}
+
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_profile_table()
+{
+    eraseEeprom();
+    Profile profile;
+    TEST_ASSERT_FALSE(TimingProfiles::getActive(profile));
+    TEST_ASSERT_FALSE(TimingProfiles::find("TDS2024", profile));
+    TEST_ASSERT_TRUE(TimingProfiles::setActive(nullptr)); // blank table: defaults already in use
+
+    Profile tds = makeProfile("TDS2024", 4);
+    TEST_ASSERT_TRUE(TimingProfiles::save(tds));
+    TEST_ASSERT_TRUE(TimingProfiles::find("tds2024", profile));
+    TEST_ASSERT_EQUAL_UINT8(4, profile.ackPulseUs);
+    TEST_ASSERT_FALSE(TimingProfiles::getActive(profile));
+
+    // Same sender replaces its slot
+    tds.ackPulseUs = 6;
+    TEST_ASSERT_TRUE(TimingProfiles::save(tds));
+    TEST_ASSERT_TRUE(TimingProfiles::find("TDS2024", profile));
+    TEST_ASSERT_EQUAL_UINT8(6, profile.ackPulseUs);
+
+    char name[Calibration::SENDER_NAME_LENGTH];
+    for (uint8_t i = 1; i < Calibration::PROFILE_SLOTS; i++) {
+        snprintf(name, sizeof(name), "SCOPE%u", i);
+        Profile other = makeProfile(name, i);
+        TEST_ASSERT_TRUE(TimingProfiles::save(other));
+    }
+    Profile extra = makeProfile("EXTRA", 2);
+    TEST_ASSERT_FALSE(TimingProfiles::save(extra));
+
+    TEST_ASSERT_FALSE(TimingProfiles::setActive("EXTRA"));
+    TEST_ASSERT_TRUE(TimingProfiles::setActive("SCOPE3"));
+    TEST_ASSERT_TRUE(TimingProfiles::getActive(profile));
+    TEST_ASSERT_EQUAL_STRING("SCOPE3", profile.sender);
+
+    // Deleting the active profile falls back to the defaults and frees the slot
+    TEST_ASSERT_TRUE(TimingProfiles::remove("scope3"));
+    TEST_ASSERT_FALSE(TimingProfiles::getActive(profile));
+    TEST_ASSERT_FALSE(TimingProfiles::remove("SCOPE3"));
+    TEST_ASSERT_TRUE(TimingProfiles::save(extra));
+
+    // A corrupted slot reads as empty
+    eepromData()[Calibration::PROFILE_EEPROM_ADDRESS + 4 + offsetof(Profile, ackPulseUs)] ^= 0x01;
+    TEST_ASSERT_FALSE(TimingProfiles::find("TDS2024", profile));
+    TEST_ASSERT_TRUE(TimingProfiles::find("SCOPE1", profile));
+}
+
+void test_calibration_learns_sender_ack()
+{
+    eraseEeprom();
+    printerPort.initialize();
+    OptimizedTiming::applyProfile(nullptr);
+
+    HandshakeCalibrator calibrator(printerPort);
+    TEST_ASSERT_FALSE(calibrator.begin(""));
+    TEST_ASSERT_FALSE(calibrator.begin("NAME-TOO-LONG-FOR-A-SLOT"));
+    TEST_ASSERT_TRUE(calibrator.begin("TDS2024"));
+    TEST_ASSERT_EQUAL_UINT8(DeviceBridge::Common::Timing::ACK_PULSE_US, OptimizedTiming::fastAckPulseUs);
+
+    // Drive it the way ParallelPortManager does: drain and run a session with interrupts masked
+    LptHostSimulator host(senderPins(), senderTiming());
+    host.addJob(jobBytes(16384));
+    attachPeripheral(&host);
+    host.start(cycles());
+    const uint64_t deadline = cycles() + microsToCycles(2000000);
+    bool ended = false;
+    while (!ended && !host.finished()) {
+        advanceMicros(200);
+        const uint8_t sreg = SREG;
+        cli();
+        printerPort.readData(drainBuffer, 0, sizeof(drainBuffer));
+        if (printerPort.getBufferSize() < DeviceBridge::Common::FlowControl::RECOVERY_THRESHOLD) {
+            calibrator.sample();
+        }
+        SREG = sreg;
+        printerPort.processPendingOperations();
+        ended = calibrator.update();
+        TEST_ASSERT_TRUE(cycles() < deadline);
+    }
+    detachPeripheral(&host);
+    TEST_ASSERT_TRUE(ended);
+
+    const HandshakeCalibrator::Status status = calibrator.getStatus();
+    const Profile &result = calibrator.getResult();
+    printf("=== Calibration (sender sees /ACK >= %uns) ===\n", (unsigned)SENDER_MIN_ACK_NS);
+    printf("  /ACK %uus, BUSY setup %uus, strobe %uns, %uus/byte, %u strobes, %u short /ACKs seen\n\n",
+           result.ackPulseUs, result.busySetupUs, result.strobeWidthNs, result.strobeGapUs, result.samples,
+           (unsigned)host.stats().shortAcks);
+    TEST_ASSERT_TRUE(status.state == HandshakeCalibrator::State::DONE);
+    TEST_ASSERT_EQUAL_UINT8(SENDER_MIN_ACK_NS / 1000, result.ackPulseUs);
+    TEST_ASSERT_TRUE(result.busySetupUs >= 1);
+    TEST_ASSERT_UINT32_WITHIN(200, 1000, result.strobeWidthNs); // the fall is seen up to one polling pass late
+    TEST_ASSERT_TRUE(result.samples >= Calibration::WINDOW_GAPS);
+
+    // Saved, active and in use
+    Profile stored;
+    TEST_ASSERT_TRUE(TimingProfiles::getActive(stored));
+    TEST_ASSERT_EQUAL_STRING("TDS2024", stored.sender);
+    TEST_ASSERT_EQUAL_UINT8(result.ackPulseUs, stored.ackPulseUs);
+    TEST_ASSERT_EQUAL_UINT8(result.ackPulseUs, OptimizedTiming::fastAckPulseUs);
+    TEST_ASSERT_EQUAL_STRING("TDS2024", OptimizedTiming::getProfileSender());
+}
+
+void test_profile_keeps_sender_acknowledged()
+{
+    Profile stored;
+    TEST_ASSERT_TRUE(TimingProfiles::getActive(stored));
+
+    uint32_t timeouts[2];
+    for (uint8_t run = 0; run < 2; run++) {
+        // Config.h defaults first, then the calibrated profile as loaded at boot
+        OptimizedTiming::applyProfile(run == 0 ? nullptr : &stored);
+        LptHostSimulator host(senderPins(), senderTiming());
+        host.addJob(jobBytes(512));
+        attachPeripheral(&host);
+        host.start(cycles());
+        uint32_t received = 0;
+        while (received < 512) {
+            advanceMicros(200);
+            received += printerPort.readData(drainBuffer, 0, sizeof(drainBuffer));
+            printerPort.processPendingOperations();
+        }
+        detachPeripheral(&host);
+        timeouts[run] = host.stats().ackTimeouts;
+    }
+    printf("  %-34s %5u\n  %-34s %5u\n\n", "/ACK timeouts, Config.h 1us", (unsigned)timeouts[0],
+           "/ACK timeouts, calibrated profile", (unsigned)timeouts[1]);
+    TEST_ASSERT_TRUE(timeouts[0] > 0);
+    TEST_ASSERT_EQUAL_UINT32(0, timeouts[1]);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_profile_table);
+    RUN_TEST(test_calibration_learns_sender_ack);
+    RUN_TEST(test_profile_keeps_sender_acknowledged);
+    return UNITY_END();
+}
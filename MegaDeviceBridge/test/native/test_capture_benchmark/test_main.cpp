@@ -0,0 +1,506 @@
+// Capture-path benchmark for the native environment.
+//
+// Boots the real firmware (setup()/loop() from src/main.cpp) on the NativeHal
+// shim, replays the sample captures in Images/ through a simulated TDS2024
+// print port and reports what the bench scope would show: sustained bytes/s,
+// bytes lost, BUSY duty cycle and end-to-end latency (strobe -> data durable
+// on the SD card). All times are virtual 16MHz AVR cycles. Every stored file
+// has to be in the SD capture catalog with its size and CRC.
+//
+// DEVICEBRIDGE_CAPTURE selects the /STROBE path: legacy (default, what
+// setup() attaches), optimized, burst (optimized + burst capture), polled
+// (ParallelPortManager polling sessions), timer (Timer5-generated /ACK),
+// hwflow (optimized + hardware flow control, fixed thresholds) or predictive
+// (hwflow with thresholds predicted from fill rate and storage latency).
+//
+// DEVICEBRIDGE_COMMIT sets FileSystemManager's SD commit policy: chunk (every
+// chunk, as before commit policies), <n>k, <t>ms or close; default every 16KB.
+// The report gives the sector writes per MB captured for comparison.
+//
+// DEVICEBRIDGE_SD_TRACE names a card latency trace (one extra microseconds
+// value per sector write, '#' comments, replayed cyclically), e.g.
+// test/sd_traces/slow_card.txt.
+//
+//   pio test -e native -f native/test_capture_benchmark -v
+//   DEVICEBRIDGE_CAPTURE=burst pio test -e native -f native/test_capture_benchmark -v
+//
+// DEVICEBRIDGE_JOB_GAP_MS sets the host's idle time between jobs (default
+// 3000, beyond the 2s end-of-file timeout) and DEVICEBRIDGE_HOST_INIT=1 has
+// it pulse /INIT before each job, as print spoolers do, with `jobsplit init`
+// set, e.g. back-to-back jobs with DEVICEBRIDGE_JOB_GAP_MS=50
+// DEVICEBRIDGE_HOST_INIT=1.
+//
+// Under env native_isrstats the optimized ISR's own duration and
+// strobe-to-/ACK figures (IsrStats) are reported as well.
+
+#include <unity.h>
+#include <Arduino.h>
+#include <SD.h>
+#include <LptHostSimulator.h>
+#include <algorithm>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "Common/Config.h"
+#include "Common/ServiceLocator.h"
+#include "Components/FileSystemManager.h"
+#include "Components/ParallelPortManager.h"
+#include "Parallel/OptimizedTiming.h"
+#include "Parallel/Port.h"
+#include "Storage/SpiBus.h"
+
+using namespace NativeHal;
+namespace Pins = DeviceBridge::Common::Pins;
+
+extern DeviceBridge::Parallel::Port printerPort;
+
+namespace {
+
+const uint32_t MAX_VIRTUAL_SECONDS = 900;
+const uint32_t SETTLE_MS = 4000;   // > KEEP_BUSY_MS so the last file gets closed
+
+struct Job {
+    std::string name;
+    std::vector<uint8_t> bytes;
+};
+
+struct Results {
+    uint64_t bytesSent;
+    uint64_t bytesStored;
+    uint64_t bytesLost;
+    uint32_t corruptFiles;
+    uint32_t filesStored;
+    double bytesPerSecond;
+    double busyDuty;
+    double meanLatencyMs;
+    double maxLatencyMs;
+    double maxJobCloseMs;
+    double meanJobCloseMs;
+};
+
+std::vector<Job> jobs;
+std::vector<uint32_t> sdTrace;
+Results results;
+
+std::string imagesDirectory()
+{
+    const char *env = getenv("DEVICEBRIDGE_IMAGES");
+    return env ? env : "../Images";
+}
+
+std::vector<Job> loadJobs(const std::string &dir)
+{
+    std::vector<Job> out;
+    DIR *d = opendir(dir.c_str());
+    if (!d) {
+        return out;
+    }
+    while (struct dirent *entry = readdir(d)) {
+        std::string name = entry->d_name;
+        if (name[0] == '.') {
+            continue;
+        }
+        FILE *f = fopen((dir + "/" + name).c_str(), "rb");
+        if (!f) {
+            continue;
+        }
+        Job job;
+        job.name = name;
+        int c;
+        while ((c = fgetc(f)) != EOF) {
+            job.bytes.push_back((uint8_t)c);
+        }
+        fclose(f);
+        if (!job.bytes.empty()) {
+            out.push_back(job);
+        }
+    }
+    closedir(d);
+    std::sort(out.begin(), out.end(), [](const Job &a, const Job &b) { return a.name < b.name; });
+    return out;
+}
+
+const char *captureMode()
+{
+    const char *env = getenv("DEVICEBRIDGE_CAPTURE");
+    return env ? env : "legacy";
+}
+
+bool selectCaptureMode(DeviceBridge::Components::ParallelPortManager &manager, const std::string &mode)
+{
+    if (mode == "legacy") {
+        return true;
+    }
+    if (mode == "optimized") {
+        DeviceBridge::Parallel::OptimizedTiming::initialize();
+        return true;
+    }
+    if (mode == "burst") {
+        return manager.setBurstCaptureEnabled(true);
+    }
+    if (mode == "polled") {
+        return manager.setPolledCaptureEnabled(true);
+    }
+    if (mode == "timer") {
+        return manager.setTimedAcknowledgeEnabled(true, DeviceBridge::Common::Timing::ACK_TIMER_PULSE_US);
+    }
+    if (mode == "hwflow" || mode == "predictive") {
+        DeviceBridge::Parallel::OptimizedTiming::initialize();
+        manager.setHardwareFlowControlEnabled(true);
+        manager.setFlowPredictionEnabled(mode == "predictive");
+        return true;
+    }
+    return false;
+}
+
+const char *commitPolicy()
+{
+    const char *env = getenv("DEVICEBRIDGE_COMMIT");
+    return env && *env ? env : "16k";
+}
+
+bool selectCommitPolicy(DeviceBridge::Components::FileSystemManager &fs, const std::string &policy)
+{
+    using CommitPolicy = DeviceBridge::Components::FileSystemManager::CommitPolicy;
+    char *end = nullptr;
+    const unsigned long value = strtoul(policy.c_str(), &end, 10);
+    if (policy == "chunk") {
+        fs.setCommitPolicy(CommitPolicy::BYTES, 0);
+    } else if (policy == "close") {
+        fs.setCommitPolicy(CommitPolicy::CLOSE, 0);
+    } else if (end != policy.c_str() && strcmp(end, "k") == 0) {
+        fs.setCommitPolicy(CommitPolicy::BYTES, (uint16_t)value);
+    } else if (end != policy.c_str() && strcmp(end, "ms") == 0 && value > 0) {
+        fs.setCommitPolicy(CommitPolicy::INTERVAL, (uint16_t)value);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+LptHostSimulator::Timing hostTiming()
+{
+    LptHostSimulator::Timing timing;
+    const char *gap = getenv("DEVICEBRIDGE_JOB_GAP_MS");
+    if (gap && *gap) {
+        timing.jobGapMs = (uint32_t)strtoul(gap, nullptr, 10);
+    }
+    const char *init = getenv("DEVICEBRIDGE_HOST_INIT");
+    if (init && *init && strcmp(init, "0") != 0) {
+        timing.initPulseNs = 50000; // IEEE 1284 minimum
+    }
+    return timing;
+}
+
+const char *sdTraceName()
+{
+    const char *env = getenv("DEVICEBRIDGE_SD_TRACE");
+    return env && *env ? env : nullptr;
+}
+
+/** One extra-latency value (us) per line, '#' starts a comment */
+bool loadSdTrace(const char *path, std::vector<uint32_t> &out)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return false;
+    }
+    char line[128];
+    while (fgets(line, sizeof(line), f)) {
+        char *end = nullptr;
+        unsigned long us = strtoul(line, &end, 10);
+        if (end != line) {
+            out.push_back((uint32_t)us);
+        }
+    }
+    fclose(f);
+    return !out.empty();
+}
+
+bool isCaptureRecord(const SdNode &node)
+{
+    const std::string ext = ".CAP";
+    return node.path.size() > ext.size() && node.path.compare(node.path.size() - ext.size(), ext.size(), ext) == 0;
+}
+
+/** Value of `key=` in a capture record, 0 when missing */
+uint32_t recordValue(const SdNode &record, const char *key)
+{
+    std::string text(record.data.begin(), record.data.end());
+    size_t at = text.find(std::string(key) + "=");
+    return at == std::string::npos ? 0 : (uint32_t)strtoul(text.c_str() + at + strlen(key) + 1, nullptr, 10);
+}
+
+bool recordLossless(const SdNode &record)
+{
+    std::string text(record.data.begin(), record.data.end());
+    return text.find("lossless=yes") != std::string::npos;
+}
+
+/** First cycle at which at least `size` bytes of the file were on the card */
+uint64_t durableAt(const SdNode &node, uint32_t size)
+{
+    for (const DurabilityMark &mark : node.durability) {
+        if (mark.size >= size) {
+            return mark.cycle;
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_capture_benchmark()
+{
+    jobs = loadJobs(imagesDirectory());
+    if (jobs.empty()) {
+        TEST_IGNORE_MESSAGE("No sample captures found (set DEVICEBRIDGE_IMAGES)");
+    }
+
+    if (sdTraceName()) {
+        TEST_ASSERT_TRUE_MESSAGE(loadSdTrace(sdTraceName(), sdTrace), "Cannot read DEVICEBRIDGE_SD_TRACE");
+        sdTiming().latencyTrace = sdTrace.data();
+        sdTiming().latencyTraceLength = sdTrace.size();
+    }
+
+    // Card inserted, not write protected; host holds the control lines inactive
+    drivePin(Pins::SD_CD, LOW);
+    drivePin(Pins::SD_WP, LOW);
+    drivePin(Pins::LPT_AUTO_FEED, HIGH);
+    drivePin(Pins::LPT_INITIALIZE, HIGH);
+    drivePin(Pins::LPT_SELECT_IN, HIGH);
+
+    LptHostSimulator::Pins pins = {Pins::LPT_STROBE,
+                                   {Pins::LPT_D0, Pins::LPT_D1, Pins::LPT_D2, Pins::LPT_D3, Pins::LPT_D4, Pins::LPT_D5,
+                                    Pins::LPT_D6, Pins::LPT_D7},
+                                   Pins::LPT_ACK,
+                                   Pins::LPT_BUSY,
+                                   Pins::LPT_INITIALIZE};
+    const LptHostSimulator::Timing timing = hostTiming();
+    LptHostSimulator host(pins, timing);
+    for (const Job &job : jobs) {
+        host.addJob(job.bytes);
+    }
+
+    setup();
+    auto *manager = DeviceBridge::ServiceLocator::getInstance().getParallelPortManager();
+    TEST_ASSERT_TRUE_MESSAGE(selectCaptureMode(*manager, captureMode()), "Unknown DEVICEBRIDGE_CAPTURE mode");
+    auto *fileSystem = DeviceBridge::ServiceLocator::getInstance().getFileSystemManager();
+    TEST_ASSERT_TRUE_MESSAGE(selectCommitPolicy(*fileSystem, commitPolicy()), "Unknown DEVICEBRIDGE_COMMIT policy");
+    if (timing.initPulseNs > 0) {
+        manager->setJobSignals(DeviceBridge::Common::JobBoundary::SIGNAL_INIT); // jobsplit init
+    }
+    const SdStats sdAtStart = sdStats();
+
+    attachPeripheral(&host);
+    host.start(cycles() + microsToCycles(1000));
+    uint64_t busyHighAtStart = pinHighCycles(Pins::LPT_BUSY);
+    uint64_t loopDelayAtStart = loopDelayCycles();
+    uint32_t pacingAtStart = printerPort.getPacingRecoveredUs();
+
+    const uint64_t limit = (uint64_t)MAX_VIRTUAL_SECONDS * CPU_HZ;
+    while (!host.finished() && cycles() < limit) {
+        loop();
+    }
+    uint64_t captureEnd = cycles();
+    uint64_t loopDelayDuringCapture = loopDelayCycles() - loopDelayAtStart;
+    uint32_t pacingDuringCapture = printerPort.getPacingRecoveredUs() - pacingAtStart;
+    while (cycles() < captureEnd + (uint64_t)SETTLE_MS * (CPU_HZ / 1000)) {
+        loop();
+    }
+    detachPeripheral(&host);
+    TEST_ASSERT_TRUE_MESSAGE(host.finished(), "Host did not finish sending within the time limit");
+
+    const LptHostSimulator::Stats &hs = host.stats();
+    std::vector<const SdNode *> files;
+    std::vector<const SdNode *> records;
+    for (const SdNode *node : sdFiles()) {
+        if (node->path != DeviceBridge::Common::Commit::JOURNAL_NAME &&
+            node->path != DeviceBridge::Common::Catalog::FILE_NAME) {
+            (isCaptureRecord(*node) ? records : files).push_back(node);
+        }
+    }
+
+    // Every capture is cataloged at close with the CRC of what reached the card
+    struct Cataloged {
+        const std::vector<const SdNode *> &files;
+        uint32_t matched;
+    } cataloged = {files, 0};
+    DeviceBridge::Storage::CaptureCatalog::forEach(
+        [](const DeviceBridge::Storage::CaptureCatalog::Entry &entry, void *context) {
+            Cataloged &c = *static_cast<Cataloged *>(context);
+            char path[DeviceBridge::Common::Limits::MAX_FILENAME_LENGTH];
+            DeviceBridge::Storage::CaptureCatalog::formatPath(entry, path, sizeof(path));
+            for (const SdNode *node : c.files) {
+                if (strcasecmp(node->path.c_str(), path) == 0 && node->data.size() == entry.size &&
+                    DeviceBridge::Storage::CaptureCatalog::crc16(0, node->data.data(), node->data.size()) == entry.crc) {
+                    c.matched++;
+                }
+            }
+        },
+        &cataloged);
+    TEST_ASSERT_EQUAL_UINT32(files.size(), DeviceBridge::Storage::CaptureCatalog::count());
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(files.size(), cataloged.matched, "catalog records differ from the card");
+
+    results = Results();
+    results.bytesSent = hs.bytesSent;
+    results.filesStored = (uint32_t)files.size();
+
+    uint64_t activeCycles = 0;
+    uint64_t latencyTotal = 0;
+    uint64_t latencySamples = 0;
+    uint64_t latencyMax = 0;
+    uint64_t closeMax = 0;
+    uint64_t closeTotal = 0;
+    uint32_t closeCount = 0;
+    for (size_t i = 0; i < host.jobCount(); i++) {
+        const std::vector<uint8_t> &sent = host.job(i);
+        activeCycles += host.jobEndCycle(i) - host.strobeCycle(i, 0);
+        if (i >= files.size()) {
+            results.bytesLost += sent.size();
+            continue;
+        }
+        const SdNode &file = *files[i];
+        results.bytesStored += file.data.size();
+        if (file.data.size() < sent.size()) {
+            results.bytesLost += sent.size() - file.data.size();
+        }
+        if (file.data != sent) {
+            results.corruptFiles++;
+        }
+        for (size_t offset = 0; offset < file.committedSize && offset < sent.size(); offset++) {
+            uint64_t durable = durableAt(file, (uint32_t)offset + 1);
+            uint64_t strobe = host.strobeCycle(i, offset);
+            if (durable >= strobe) {
+                uint64_t latency = durable - strobe;
+                latencyTotal += latency;
+                latencyMax = std::max(latencyMax, latency);
+                latencySamples++;
+            }
+        }
+        if (file.closedCycle > host.jobEndCycle(i)) {
+            closeMax = std::max(closeMax, file.closedCycle - host.jobEndCycle(i));
+            closeTotal += file.closedCycle - host.jobEndCycle(i);
+            closeCount++;
+        }
+    }
+
+    results.bytesPerSecond = activeCycles ? hs.bytesSent / cyclesToSeconds(activeCycles) : 0;
+    results.busyDuty =
+        activeCycles ? (double)(pinHighCycles(Pins::LPT_BUSY) - busyHighAtStart) / (double)activeCycles : 0;
+    results.meanLatencyMs = latencySamples ? cyclesToSeconds(latencyTotal / latencySamples) * 1000.0 : 0;
+    results.maxLatencyMs = cyclesToSeconds(latencyMax) * 1000.0;
+    results.maxJobCloseMs = cyclesToSeconds(closeMax) * 1000.0;
+    results.meanJobCloseMs = closeCount ? cyclesToSeconds(closeTotal / closeCount) * 1000.0 : 0;
+
+    const SdStats &sd = sdStats();
+    printf("\n=== Capture benchmark (%u jobs, %llu bytes, %s capture%s%s) ===\n", (unsigned)host.jobCount(),
+           (unsigned long long)results.bytesSent, captureMode(), sdTraceName() ? ", SD trace " : "",
+           sdTraceName() ? sdTraceName() : "");
+    printf("  Sustained throughput : %.0f bytes/s\n", results.bytesPerSecond);
+    printf("  Bytes lost           : %llu (%u of %u files differ, %u files stored)\n",
+           (unsigned long long)results.bytesLost, results.corruptFiles, (unsigned)host.jobCount(),
+           results.filesStored);
+    printf("  BUSY duty cycle      : %.1f%%\n", results.busyDuty * 100.0);
+    printf("  Host BUSY stall      : %.1f ms total, %u ACK timeouts, %u BUSY timeouts\n",
+           cyclesToSeconds(hs.busyWaitCycles) * 1000.0, hs.ackTimeouts, hs.busyTimeouts);
+    printf("  Stall during SD I/O  : %.1f ms (host waiting while the card was busy)\n",
+           cyclesToSeconds(hs.busyWaitSdCycles) * 1000.0);
+    printf("  Strobe->durable      : mean %.2f ms, max %.2f ms\n", results.meanLatencyMs, results.maxLatencyMs);
+    printf("  Last byte->close     : mean %.0f ms, max %.0f ms (%u /INIT or /SELECT-IN boundaries)\n",
+           results.meanJobCloseMs, results.maxJobCloseMs, (unsigned)manager->getJobBoundaryCount());
+    printf("  SD traffic           : %u data + %u metadata sector writes, %u reads, %u flushes\n",
+           sd.dataSectorWrites, sd.metadataSectorWrites, sd.sectorReads, sd.flushes);
+    printf("                         %u data blocks in %u multi-block writes\n", sd.streamedBlocks, sd.streams);
+    const double megabytes = results.bytesSent / 1048576.0;
+    printf("  SD writes per MB     : %.0f sectors (%.0f metadata), %u commits, commit policy %s\n",
+           (sd.sectorWrites - sdAtStart.sectorWrites) / megabytes,
+           (sd.metadataSectorWrites - sdAtStart.metadataSectorWrites) / megabytes,
+           (unsigned)fileSystem->getCommitCount(), commitPolicy());
+    printf("  SD file open         : mean %.2f ms, max %.2f ms (%u files)\n", fileSystem->getFileOpenMeanUs() / 1000.0,
+           fileSystem->getFileOpenMaxUs() / 1000.0, (unsigned)fileSystem->getFileOpenCount());
+    const DeviceBridge::Storage::SpiBus::Statistics &spi =
+        DeviceBridge::Storage::SpiBus::statistics(DeviceBridge::Storage::SpiBus::SD_CARD);
+    printf("  SPI bus held by SD   : %.1f ms in %u claims, longest %.2f ms\n", spi.busyUs / 1000.0,
+           (unsigned)spi.claims, spi.maxUs / 1000.0);
+    printf("  Interrupts serviced  : %u (%u bytes taken in a burst), %.1f ms in ISRs\n", interruptsServiced(),
+           (unsigned)manager->getBurstCaptureCount(), cyclesToSeconds(interruptCycles()) * 1000.0);
+    printf("  Main-loop busy-waits : %.1f ms in delay()/delayMicroseconds() during capture\n",
+           cyclesToSeconds(loopDelayDuringCapture) * 1000.0);
+    printf("  Flow-control pacing  : %.1f ms of settle time the loop spent on other work (measured)\n",
+           pacingDuringCapture / 1000.0);
+    if (manager->isPolledCaptureEnabled()) {
+        auto polled = manager->getPolledCaptureStatistics();
+        printf("  Polled capture       : %u bytes in %u sessions, exits idle %u / high-water %u / time %u\n",
+               (unsigned)polled.bytes, (unsigned)polled.sessions, (unsigned)polled.idleExits,
+               (unsigned)polled.highWaterExits, (unsigned)polled.timeLimitExits);
+    }
+    if (manager->isHardwareFlowControlEnabled()) {
+        auto flow = manager->getFlowControlStatistics();
+        printf("  Flow control         : %u state transitions, %u emergency activations, %u recoveries\n",
+               (unsigned)flow.stateTransitions, (unsigned)flow.emergencyActivations,
+               (unsigned)flow.recoveryOperations);
+    }
+    if (manager->isFlowPredictionEnabled()) {
+        auto prediction = manager->getFlowPredictionStatistics();
+        printf("  Prediction           : overshoot %u, BUSY at %u, release at %u\n", prediction.overshootPeak,
+               prediction.busyLevel, prediction.recoveryLevel);
+    }
+#ifdef DEVICEBRIDGE_ISR_STATS
+    auto isr = manager->getIsrStatistics();
+    if (isr.duration.count) {
+        printf("  Optimized ISR        : %u interrupts, %u/%u/%u cycles min/mean/max\n", (unsigned)isr.duration.count,
+               isr.duration.min, (unsigned)(isr.duration.sum / isr.duration.count), isr.duration.max);
+    }
+    if (isr.latency.count) {
+        printf("  Strobe->ACK          : %u/%u/%u cycles min/mean/max (limit %u us = %u cycles)\n", isr.latency.min,
+               (unsigned)(isr.latency.sum / isr.latency.count), isr.latency.max,
+               DeviceBridge::Parallel::IsrStats::ACK_LIMIT_US, DeviceBridge::Parallel::IsrStats::ACK_LIMIT_US * 16U);
+    }
+#endif
+    uint32_t recordDropped = 0;
+    uint32_t recordDiscarded = 0;
+    uint32_t recordBusyMs = 0;
+    uint32_t recordsLossless = 0;
+    for (const SdNode *record : records) {
+        recordDropped += recordValue(*record, "dropped");
+        recordDiscarded += recordValue(*record, "discarded");
+        recordBusyMs += recordValue(*record, "busy_ms");
+        recordsLossless += recordLossless(*record) ? 1 : 0;
+    }
+    printf("  Capture records      : %u, %u lossless, %u dropped, %u discarded, %u ms BUSY for flow control\n",
+           (unsigned)records.size(), (unsigned)recordsLossless, (unsigned)recordDropped, (unsigned)recordDiscarded,
+           (unsigned)recordBusyMs);
+    auto queue = manager->getChunkQueueStatistics();
+    printf("  Chunk queue          : depth %u, high-water %u, %u queued, %u delayed, full %u times / %u ms\n\n",
+           queue.depth, queue.highWater, (unsigned)queue.chunksQueued, (unsigned)queue.chunksDelayed,
+           (unsigned)queue.fullEvents, (unsigned)queue.timeFullMs);
+
+    TEST_ASSERT_GREATER_THAN(0, results.filesStored);
+    TEST_ASSERT_GREATER_THAN(0, results.bytesStored);
+
+    // Every stored file has its record, and a record claims lossless exactly for a file that arrived intact,
+    // so a capture path that stops counting fails here instead of reporting every file as lossy
+    TEST_ASSERT_EQUAL_UINT32(results.filesStored, records.size());
+    for (size_t i = 0; i < records.size() && i < files.size() && i < host.jobCount(); i++) {
+        const bool intact = files[i]->data == host.job(i);
+        TEST_ASSERT_EQUAL(intact, recordLossless(*records[i]));
+        if (intact) {
+            TEST_ASSERT_EQUAL_UINT32(host.job(i).size(), recordValue(*records[i], "captured"));
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    setSerialEcho(getenv("DEVICEBRIDGE_ECHO") != nullptr);
+    UNITY_BEGIN();
+    RUN_TEST(test_capture_benchmark);
+    return UNITY_END();
+}
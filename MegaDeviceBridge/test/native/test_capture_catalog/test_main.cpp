@@ -0,0 +1,352 @@
+// SD capture catalog (Storage::CaptureCatalog) against the NativeHal card.
+//
+// Records appended on close have to survive a remount with the same count,
+// total and listing order; a card without a catalog, or one whose last
+// record was cut short by a power loss, gets it rebuilt from the directories
+// (capture records, traces and the catalog's own files left out), with CRCs
+// read back on request. deleteFile()'s mark-in-place has to hold across a
+// remount. The file count and listing of a card with 2000 captures are
+// compared with the directory walks they replace: the count must not touch
+// the card and the listing must be one sequential read.
+//
+//   pio test -e native -f native/test_capture_catalog -v
+
+#include <unity.h>
+#include <Arduino.h>
+#include <NativeHal.h>
+#include <SD.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "Common/Config.h"
+#include "Common/Types.h"
+#include "Storage/CaptureCatalog.h"
+
+using namespace NativeHal;
+using DeviceBridge::Storage::CaptureCatalog;
+namespace Pins = DeviceBridge::Common::Pins;
+using DeviceBridge::Common::FileType;
+using Bytes = std::vector<uint8_t>;
+
+namespace {
+
+Bytes makeData(size_t size, uint8_t seed)
+{
+    Bytes out(size);
+    for (size_t i = 0; i < size; i++) {
+        out[i] = (uint8_t)(i * 13 + seed + (i >> 8));
+    }
+    return out;
+}
+
+void store(const char *path, const Bytes &data)
+{
+    File file = SD.open(path, FILE_WRITE);
+    TEST_ASSERT_TRUE_MESSAGE(file, path);
+    TEST_ASSERT_EQUAL_UINT32(data.size(), file.write(data.data(), data.size()));
+    file.close();
+}
+
+void remountCard()
+{
+    TEST_ASSERT_TRUE(SD.begin(Pins::SD_CS));
+    TEST_ASSERT_TRUE(CaptureCatalog::mount());
+    TEST_ASSERT_TRUE(CaptureCatalog::isReady());
+}
+
+void mountCard()
+{
+    sdReset();
+    remountCard();
+    TEST_ASSERT_EQUAL_UINT32(0, CaptureCatalog::count());
+    TEST_ASSERT_TRUE(SD.mkdir("/20250101"));
+}
+
+std::vector<CaptureCatalog::Entry> listing()
+{
+    std::vector<CaptureCatalog::Entry> entries;
+    TEST_ASSERT_TRUE(CaptureCatalog::forEach(
+        [](const CaptureCatalog::Entry &entry, void *context) {
+            static_cast<std::vector<CaptureCatalog::Entry> *>(context)->push_back(entry);
+        },
+        &entries));
+    return entries;
+}
+
+std::string pathOf(const CaptureCatalog::Entry &entry)
+{
+    char path[DeviceBridge::Common::Limits::MAX_FILENAME_LENGTH];
+    CaptureCatalog::formatPath(entry, path, sizeof(path));
+    return path;
+}
+
+const CaptureCatalog::Entry *findEntry(const std::vector<CaptureCatalog::Entry> &entries, const char *path)
+{
+    for (const CaptureCatalog::Entry &entry : entries) {
+        if (strcasecmp(pathOf(entry).c_str(), path) == 0) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+/** The walk FileSystemManager::countFilesRecursive() did before the catalog */
+uint32_t walkCount(const char *dirPath)
+{
+    uint32_t count = 0;
+    File dir = SD.open(dirPath);
+    if (!dir) {
+        return 0;
+    }
+    while (true) {
+        File entry = dir.openNextFile();
+        if (!entry) {
+            break;
+        }
+        if (entry.isDirectory()) {
+            count += walkCount(entry.name());
+        } else {
+            const char *name = entry.name();
+            const size_t length = strlen(name);
+            if (length < 4 || strcasecmp(name + length - 4, DeviceBridge::Common::FileSystem::CAPTURE_RECORD_EXTENSION) != 0) {
+                count++;
+            }
+        }
+        entry.close();
+    }
+    dir.close();
+    return count;
+}
+
+/** The `list sd` walk before the catalog: names and sizes, one directory level */
+uint32_t walkListing(uint32_t &totalSize)
+{
+    uint32_t count = 0;
+    File root = SD.open("/");
+    while (true) {
+        File entry = root.openNextFile();
+        if (!entry) {
+            break;
+        }
+        if (entry.isDirectory()) {
+            File subDir = SD.open(entry.name());
+            while (true) {
+                File subEntry = subDir.openNextFile();
+                if (!subEntry) {
+                    break;
+                }
+                if (!subEntry.isDirectory()) {
+                    count++;
+                    totalSize += subEntry.size();
+                }
+                subEntry.close();
+            }
+            subDir.close();
+        } else {
+            count++;
+            totalSize += entry.size();
+        }
+        entry.close();
+    }
+    root.close();
+    return count;
+}
+
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_crc16_is_xmodem()
+{
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    TEST_ASSERT_EQUAL_UINT16(0x31C3, CaptureCatalog::crc16(0, check, sizeof(check)));
+
+    // Chained over chunks as writeDataChunk() does
+    const Bytes data = makeData(3000, 1);
+    uint16_t chained = CaptureCatalog::crc16(0, data.data(), 77);
+    chained = CaptureCatalog::crc16(chained, data.data() + 77, data.size() - 77);
+    TEST_ASSERT_EQUAL_UINT16(CaptureCatalog::crc16(0, data.data(), data.size()), chained);
+}
+
+void test_appended_records_survive_remount()
+{
+    mountCard();
+    TEST_ASSERT_TRUE(CaptureCatalog::append("20250101/120000.bmp", 76854, FileType::BMP, 0x1234, 1735732800));
+    TEST_ASSERT_TRUE(CaptureCatalog::append("/20250101/12000001.pcx", 1000, FileType::PCX, 0xBEEF, 1735732801));
+    TEST_ASSERT_TRUE(CaptureCatalog::append("DAT12345.bin", 5, FileType::BINARY, 0x0001, 42));
+    TEST_ASSERT_FALSE(CaptureCatalog::append("20250101/longer/than.bin", 5, FileType::BINARY, 0, 0));
+    TEST_ASSERT_EQUAL_UINT32(3, CaptureCatalog::count());
+    TEST_ASSERT_EQUAL_UINT32(77859, CaptureCatalog::totalBytes());
+
+    remountCard();
+    TEST_ASSERT_EQUAL_UINT32(3, CaptureCatalog::count());
+    TEST_ASSERT_EQUAL_UINT32(77859, CaptureCatalog::totalBytes());
+    const std::vector<CaptureCatalog::Entry> entries = listing();
+    TEST_ASSERT_EQUAL_UINT32(3, entries.size());
+    TEST_ASSERT_EQUAL_STRING("20250101/120000.bmp", pathOf(entries[0]).c_str());
+    TEST_ASSERT_EQUAL_STRING("20250101/12000001.pcx", pathOf(entries[1]).c_str());
+    TEST_ASSERT_EQUAL_STRING("DAT12345.bin", pathOf(entries[2]).c_str());
+    TEST_ASSERT_EQUAL_UINT32(76854, entries[0].size);
+    TEST_ASSERT_EQUAL_UINT32(1735732800, entries[0].timestamp);
+    TEST_ASSERT_EQUAL_UINT16(0xBEEF, entries[1].crc);
+    TEST_ASSERT_EQUAL_UINT8(FileType::PCX, entries[1].type);
+    TEST_ASSERT_TRUE(entries[2].flags & CaptureCatalog::CRC_VALID);
+}
+
+void test_missing_catalog_is_rebuilt_from_the_card()
+{
+    mountCard();
+    const Bytes bmp = makeData(4000, 2);
+    const Bytes bin = makeData(700, 3);
+    const Bytes root = makeData(1500, 4);
+    TEST_ASSERT_TRUE(SD.mkdir("/20250102"));
+    store("/20250101/120000.bmp", bmp);
+    store("/20250101/120000.cap", makeData(200, 5));
+    store("/20250102/080000.bin", bin);
+    store("/20250102/080000.trc", makeData(300, 6));
+    store("/DAT1234.bin", root);
+    store(DeviceBridge::Common::Commit::JOURNAL_NAME, makeData(512, 7));
+    TEST_ASSERT_TRUE(SD.remove(DeviceBridge::Common::Catalog::FILE_NAME));
+
+    remountCard();
+    TEST_ASSERT_EQUAL_UINT32(3, CaptureCatalog::count());
+    TEST_ASSERT_EQUAL_UINT32(bmp.size() + bin.size() + root.size(), CaptureCatalog::totalBytes());
+    std::vector<CaptureCatalog::Entry> entries = listing();
+    const CaptureCatalog::Entry *image = findEntry(entries, "20250101/120000.bmp");
+    TEST_ASSERT_TRUE(image != nullptr);
+    TEST_ASSERT_EQUAL_UINT8(FileType::BMP, image->type);
+    TEST_ASSERT_EQUAL_UINT32(bmp.size(), image->size);
+    TEST_ASSERT_FALSE(image->flags & CaptureCatalog::CRC_VALID);
+    TEST_ASSERT_TRUE(findEntry(entries, "DAT1234.bin") != nullptr);
+
+    // On demand, every file read back for its CRC
+    TEST_ASSERT_TRUE(3 == CaptureCatalog::rebuild(true));
+    entries = listing();
+    image = findEntry(entries, "20250101/120000.bmp");
+    const CaptureCatalog::Entry *binary = findEntry(entries, "20250102/080000.bin");
+    TEST_ASSERT_TRUE(image != nullptr && binary != nullptr);
+    TEST_ASSERT_TRUE(image->flags & CaptureCatalog::CRC_VALID);
+    TEST_ASSERT_EQUAL_UINT16(CaptureCatalog::crc16(0, bmp.data(), bmp.size()), image->crc);
+    TEST_ASSERT_EQUAL_UINT16(CaptureCatalog::crc16(0, bin.data(), bin.size()), binary->crc);
+    TEST_ASSERT_EQUAL_UINT8(FileType::BINARY, binary->type);
+}
+
+void test_torn_record_is_rebuilt()
+{
+    mountCard();
+    const Bytes first = makeData(900, 8);
+    const Bytes second = makeData(1900, 9);
+    store("/20250101/090000.bin", first);
+    TEST_ASSERT_TRUE(CaptureCatalog::append("20250101/090000.bin", first.size(), FileType::BINARY, 0, 1));
+    store("/20250101/090100.bin", second);
+    TEST_ASSERT_TRUE(CaptureCatalog::append("20250101/090100.bin", second.size(), FileType::BINARY, 0, 2));
+
+    // The power went while the second record was being written
+    SdNode *catalog = const_cast<SdNode *>(sdFind(DeviceBridge::Common::Catalog::FILE_NAME));
+    TEST_ASSERT_TRUE(catalog != nullptr);
+    catalog->data.resize(catalog->data.size() - 20);
+    catalog->committedSize = (uint32_t)catalog->data.size();
+
+    remountCard();
+    TEST_ASSERT_EQUAL_UINT32(2, CaptureCatalog::count());
+    TEST_ASSERT_EQUAL_UINT32(first.size() + second.size(), CaptureCatalog::totalBytes());
+    TEST_ASSERT_EQUAL_UINT32(0, (sdFind(DeviceBridge::Common::Catalog::FILE_NAME)->data.size()) % 32);
+}
+
+void test_removed_record_stays_removed()
+{
+    mountCard();
+    TEST_ASSERT_TRUE(CaptureCatalog::append("20250101/100000.bin", 10, FileType::BINARY, 0, 1));
+    TEST_ASSERT_TRUE(CaptureCatalog::append("20250101/100001.bin", 20, FileType::BINARY, 0, 2));
+    TEST_ASSERT_TRUE(CaptureCatalog::append("20250101/100002.bin", 30, FileType::BINARY, 0, 3));
+
+    // FAT names come back in upper case
+    TEST_ASSERT_TRUE(CaptureCatalog::remove("/20250101/100001.BIN"));
+    TEST_ASSERT_FALSE(CaptureCatalog::remove("/20250101/100001.bin"));
+    TEST_ASSERT_EQUAL_UINT32(2, CaptureCatalog::count());
+    TEST_ASSERT_EQUAL_UINT32(40, CaptureCatalog::totalBytes());
+
+    remountCard();
+    TEST_ASSERT_EQUAL_UINT32(2, CaptureCatalog::count());
+    const std::vector<CaptureCatalog::Entry> entries = listing();
+    TEST_ASSERT_EQUAL_UINT32(2, entries.size());
+    TEST_ASSERT_EQUAL_STRING("20250101/100002.bin", pathOf(entries[1]).c_str());
+}
+
+void test_count_and_listing_cost()
+{
+    const uint32_t DAYS = 10;
+    const uint32_t FILES_PER_DAY = 200;
+    mountCard();
+    const Bytes data = makeData(100, 10);
+    const Bytes record = makeData(40, 11);
+    for (uint32_t day = 0; day < DAYS; day++) {
+        char directory[16];
+        snprintf(directory, sizeof(directory), "/202502%02u", (unsigned)(day + 1));
+        TEST_ASSERT_TRUE(SD.mkdir(directory));
+        for (uint32_t i = 0; i < FILES_PER_DAY; i++) {
+            // Each capture with its statistics record, as FileSystemManager leaves them
+            char path[32];
+            snprintf(path, sizeof(path), "%s/%06u.cap", directory, (unsigned)(100000 + i));
+            store(path, record);
+            snprintf(path, sizeof(path), "%s/%06u.bin", directory, (unsigned)(100000 + i));
+            store(path, data);
+            TEST_ASSERT_TRUE(CaptureCatalog::append(path, data.size(), FileType::BINARY, 0, i));
+        }
+    }
+    const uint32_t files = DAYS * FILES_PER_DAY;
+
+    SdStats &stats = sdStats();
+    uint32_t reads = stats.sectorReads;
+    uint64_t start = cycles();
+    TEST_ASSERT_EQUAL_UINT32(files + 1, walkCount("/")); // The catalog itself is a file in the root
+    const double walkCountMs = (double)(cycles() - start) * 1000.0 / CPU_HZ;
+    const uint32_t walkCountReads = stats.sectorReads - reads;
+
+    reads = stats.sectorReads;
+    start = cycles();
+    TEST_ASSERT_EQUAL_UINT32(files, CaptureCatalog::count());
+    const double catalogCountMs = (double)(cycles() - start) * 1000.0 / CPU_HZ;
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, stats.sectorReads - reads, "count touched the card");
+
+    uint32_t walkTotal = 0;
+    reads = stats.sectorReads;
+    start = cycles();
+    TEST_ASSERT_EQUAL_UINT32(2 * files + 1, walkListing(walkTotal)); // `list sd` showed the records too
+    const double walkListMs = (double)(cycles() - start) * 1000.0 / CPU_HZ;
+    const uint32_t walkListReads = stats.sectorReads - reads;
+
+    reads = stats.sectorReads;
+    start = cycles();
+    TEST_ASSERT_EQUAL_UINT32(files, listing().size());
+    const double catalogListMs = (double)(cycles() - start) * 1000.0 / CPU_HZ;
+    const uint32_t catalogListReads = stats.sectorReads - reads;
+    TEST_ASSERT_EQUAL_UINT32(files * data.size(), CaptureCatalog::totalBytes());
+
+    printf("  %u files in %u directories\n", (unsigned)files, (unsigned)DAYS);
+    printf("  count  : walk %8.1f ms, %5u sector reads; catalog %6.3f ms, 0 reads\n", walkCountMs,
+           (unsigned)walkCountReads, catalogCountMs);
+    printf("  list   : walk %8.1f ms, %5u sector reads; catalog %6.1f ms, %u reads\n", walkListMs,
+           (unsigned)walkListReads, catalogListMs, (unsigned)catalogListReads);
+
+    // One pass over the catalog's blocks, plus opening it
+    const uint32_t catalogBlocks = (files + 1) * sizeof(CaptureCatalog::Entry) / 512 + 1;
+    TEST_ASSERT_TRUE_MESSAGE(catalogListReads <= catalogBlocks + 4, "listing is not one sequential read");
+    // A directory entry is as large as a record, but the walk also reads every capture record's entry
+    TEST_ASSERT_TRUE(catalogListReads < walkListReads);
+    TEST_ASSERT_TRUE(catalogListMs < walkListMs);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_crc16_is_xmodem);
+    RUN_TEST(test_appended_records_survive_remount);
+    RUN_TEST(test_missing_catalog_is_rebuilt_from_the_card);
+    RUN_TEST(test_torn_record_is_rebuilt);
+    RUN_TEST(test_removed_record_stays_removed);
+    RUN_TEST(test_count_and_listing_cost);
+    return UNITY_END();
+}
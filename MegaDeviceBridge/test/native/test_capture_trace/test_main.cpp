@@ -0,0 +1,296 @@
+// Capture trace recording and replay.
+//
+// Boots the firmware built with DEVICEBRIDGE_CAPTURE_TRACE, starts a trace
+// and sends two jobs from a simulated TDS2024 paced at 4KB/s: the .trc file on the card
+// has to decode to exactly the bytes sent, with every strobe where the host
+// put it. Then NativeHal::TraceReplayer plays that file back through the
+// same capture path, at the recorded speed and four times faster: both runs
+// must store the jobs intact in their own files without an /ACK timeout,
+// the first on the recorded clock and the second in a quarter of the time.
+//
+// DEVICEBRIDGE_TRACE=<file.trc> replays a trace from the bench instead, at
+// DEVICEBRIDGE_TRACE_SPEED (default 1), and prints what the bridge made of it.
+//
+//   pio test -e native_trace -v
+
+#include <unity.h>
+#include <Arduino.h>
+#include <SD.h>
+#include <LptHostSimulator.h>
+#include <TraceReplayer.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include "Common/Config.h"
+#include "Common/ServiceLocator.h"
+#include "Components/FileSystemManager.h"
+#include "Parallel/CaptureTrace.h"
+
+using namespace NativeHal;
+namespace Pins = DeviceBridge::Common::Pins;
+namespace CaptureTrace = DeviceBridge::Parallel::CaptureTrace;
+using Bytes = std::vector<uint8_t>;
+
+namespace {
+
+constexpr uint64_t CYCLES_PER_MS = CPU_HZ / 1000;
+constexpr uint64_t CYCLES_PER_TICK = CYCLES_PER_US / CaptureTrace::TICKS_PER_US;
+
+LptHostSimulator::Pins hostPins()
+{
+    return {Pins::LPT_STROBE,
+            {Pins::LPT_D0, Pins::LPT_D1, Pins::LPT_D2, Pins::LPT_D3, Pins::LPT_D4, Pins::LPT_D5, Pins::LPT_D6,
+             Pins::LPT_D7},
+            Pins::LPT_ACK,
+            Pins::LPT_BUSY};
+}
+
+bool hasExtension(const SdNode &node, const char *ext)
+{
+    const std::string suffix = ext;
+    return node.path.size() > suffix.size() &&
+           node.path.compare(node.path.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+/** Capture files on the card, in creation order, without traces, .CAP records and the commit journal */
+std::vector<const SdNode *> storedFiles()
+{
+    std::vector<const SdNode *> files;
+    for (const SdNode *node : sdFiles()) {
+        if (!hasExtension(*node, ".CAP") && !hasExtension(*node, ".TRC") && !hasExtension(*node, ".JNL") &&
+            node->path != DeviceBridge::Common::Catalog::FILE_NAME) {
+            files.push_back(node);
+        }
+    }
+    return files;
+}
+
+Bytes makeJob(size_t size, uint8_t seed)
+{
+    Bytes out(size);
+    for (size_t i = 0; i < size; i++) {
+        out[i] = (uint8_t)(i * 31 + seed + (i >> 8));
+    }
+    return out;
+}
+
+void runUntil(uint64_t cycle)
+{
+    while (cycles() < cycle) {
+        loop();
+    }
+}
+
+/** Replays `trace` and waits out the idle timeout so the last file is closed */
+TraceReplayer::Stats replay(const TraceReplayer::Trace &trace, const TraceReplayer::Options &options,
+                            std::vector<uint64_t> *strobes = nullptr)
+{
+    TraceReplayer replayer(hostPins(), trace, options);
+    attachPeripheral(&replayer);
+    replayer.start(cycles() + microsToCycles(1000));
+    const uint64_t limit = cycles() + 600ULL * CPU_HZ;
+    while (!replayer.finished() && cycles() < limit) {
+        loop();
+    }
+    TEST_ASSERT_TRUE_MESSAGE(replayer.finished(), "replay did not finish");
+    runUntil(cycles() + 3000 * CYCLES_PER_MS);
+    detachPeripheral(&replayer);
+
+    if (strobes) {
+        strobes->clear();
+        for (size_t i = 0; i < trace.data.size(); i++) {
+            strobes->push_back(replayer.strobeCycle(i));
+        }
+    }
+    return replayer.stats();
+}
+
+const std::vector<Bytes> jobs = {makeJob(6000, 1), makeJob(2500, 2)};
+TraceReplayer::Trace recorded;
+std::vector<uint64_t> hostStrobes;
+
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_trace_records_every_strobe()
+{
+    auto *fileSystem = DeviceBridge::ServiceLocator::getInstance().getFileSystemManager();
+    TEST_ASSERT_TRUE(fileSystem->startTrace());
+    TEST_ASSERT_TRUE(fileSystem->isTraceOpen());
+
+    // Paced below what the bridge takes, so the accelerated replay has room to go faster
+    LptHostSimulator::Timing timing;
+    timing.minBytePeriodNs = 250000;
+    LptHostSimulator host(hostPins(), timing);
+    for (const Bytes &job : jobs) {
+        host.addJob(job);
+    }
+    attachPeripheral(&host);
+    host.start(cycles() + microsToCycles(1000));
+    const uint64_t limit = cycles() + 60ULL * CPU_HZ;
+    while (!host.finished() && cycles() < limit) {
+        loop();
+    }
+    TEST_ASSERT_TRUE(host.finished());
+    TEST_ASSERT_EQUAL_UINT32(0, host.stats().ackTimeouts);
+    runUntil(cycles() + 3000 * CYCLES_PER_MS);
+    detachPeripheral(&host);
+
+    CaptureTrace::Statistics stats;
+    CaptureTrace::snapshot(stats);
+    TEST_ASSERT_FALSE_MESSAGE(stats.overflowed, "trace ring overflowed");
+    TEST_ASSERT_TRUE(fileSystem->stopTrace());
+    TEST_ASSERT_FALSE(fileSystem->isTraceOpen());
+    TEST_ASSERT_EQUAL_UINT32(CaptureTrace::HEADER_SIZE + stats.encodedBytes, fileSystem->getTraceBytesWritten());
+
+    const SdNode *file = nullptr;
+    for (const SdNode *node : sdFiles()) {
+        if (hasExtension(*node, ".TRC")) {
+            file = node;
+        }
+    }
+    TEST_ASSERT_TRUE_MESSAGE(file != nullptr, "no .TRC file on the card");
+    TEST_ASSERT_TRUE(file->closedCycle != 0);
+    TEST_ASSERT_TRUE(TraceReplayer::decode(file->data, recorded));
+    TEST_ASSERT_EQUAL_UINT8(CaptureTrace::TICKS_PER_US, recorded.ticksPerUs);
+
+    Bytes sent;
+    for (size_t j = 0; j < jobs.size(); j++) {
+        sent.insert(sent.end(), jobs[j].begin(), jobs[j].end());
+        for (size_t i = 0; i < jobs[j].size(); i++) {
+            hostStrobes.push_back(host.strobeCycle(j, i));
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(sent.size(), stats.records);
+    TEST_ASSERT_TRUE(recorded.data == sent);
+
+    // Stamps are taken in the ISR, a few microseconds after the falling edge;
+    // summed deltas must follow the host's strobes without drifting
+    uint64_t offset = 0;
+    uint64_t maxError = 0;
+    for (size_t i = 1; i < recorded.data.size(); i++) {
+        offset += (uint64_t)recorded.deltaTicks[i] * CYCLES_PER_TICK;
+        const int64_t error = (int64_t)offset - (int64_t)(hostStrobes[i] - hostStrobes[0]);
+        const uint64_t magnitude = error < 0 ? -error : error;
+        maxError = magnitude > maxError ? magnitude : maxError;
+    }
+    printf("trace: %u strobes in %u bytes (%.2f per strobe), max timing error %.1fus\n", stats.records,
+           stats.encodedBytes, (double)stats.encodedBytes / stats.records, (double)maxError / CYCLES_PER_US);
+    TEST_ASSERT_TRUE_MESSAGE(maxError <= microsToCycles(20), "trace timing drifted from the host's strobes");
+}
+
+void test_replay_at_recorded_speed()
+{
+    TEST_ASSERT_FALSE(recorded.data.empty());
+    const size_t before = storedFiles().size();
+
+    TraceReplayer::Options options;
+    std::vector<uint64_t> strobes;
+    const TraceReplayer::Stats stats = replay(recorded, options, &strobes);
+    TEST_ASSERT_EQUAL_UINT32(recorded.data.size(), stats.bytesSent);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.ackTimeouts);
+
+    const std::vector<const SdNode *> files = storedFiles();
+    TEST_ASSERT_EQUAL_UINT32(before + jobs.size(), files.size());
+    for (size_t j = 0; j < jobs.size(); j++) {
+        TEST_ASSERT_TRUE(files[before + j]->data == jobs[j]);
+    }
+
+    // Same session as the lab bench: each strobe lands where the TDS2024 put it
+    uint64_t maxDrift = 0;
+    for (size_t i = 1; i < strobes.size(); i++) {
+        const int64_t drift = (int64_t)(strobes[i] - strobes[0]) - (int64_t)(hostStrobes[i] - hostStrobes[0]);
+        const uint64_t magnitude = drift < 0 ? -drift : drift;
+        maxDrift = magnitude > maxDrift ? magnitude : maxDrift;
+    }
+    printf("replay x1: %u late of %u, max late %.1fus, max drift from recording %.1fus\n", stats.lateBytes,
+           stats.bytesSent, (double)stats.maxLateCycles / CYCLES_PER_US, (double)maxDrift / CYCLES_PER_US);
+    TEST_ASSERT_TRUE(maxDrift <= microsToCycles(50));
+}
+
+void test_replay_accelerated()
+{
+    TEST_ASSERT_FALSE(recorded.data.empty());
+    const size_t before = storedFiles().size();
+
+    TraceReplayer::Options options;
+    options.speed = 4.0;
+    std::vector<uint64_t> strobes;
+    const TraceReplayer::Stats stats = replay(recorded, options, &strobes);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.ackTimeouts);
+
+    // The gap between the jobs is kept, so they still land in their own files
+    const std::vector<const SdNode *> files = storedFiles();
+    TEST_ASSERT_EQUAL_UINT32(before + jobs.size(), files.size());
+    for (size_t j = 0; j < jobs.size(); j++) {
+        TEST_ASSERT_TRUE(files[before + j]->data == jobs[j]);
+    }
+
+    const size_t last = jobs[0].size() - 1;
+    const double recordedMs = (double)(hostStrobes[last] - hostStrobes[0]) / CYCLES_PER_MS;
+    const double replayedMs = (double)(strobes[last] - strobes[0]) / CYCLES_PER_MS;
+    printf("replay x4: first job %.1fms (recorded %.1fms), %u late, max late %.1fus\n", replayedMs, recordedMs,
+           stats.lateBytes, (double)stats.maxLateCycles / CYCLES_PER_US);
+    TEST_ASSERT_TRUE(replayedMs < recordedMs * 0.3);
+}
+
+void test_replay_bench_trace()
+{
+    const char *path = getenv("DEVICEBRIDGE_TRACE");
+    if (!path) {
+        TEST_IGNORE_MESSAGE("set DEVICEBRIDGE_TRACE to replay a trace from the bench");
+    }
+    FILE *f = fopen(path, "rb");
+    TEST_ASSERT_TRUE_MESSAGE(f != nullptr, path);
+    Bytes file;
+    int c;
+    while ((c = fgetc(f)) != EOF) {
+        file.push_back((uint8_t)c);
+    }
+    fclose(f);
+
+    TraceReplayer::Trace trace;
+    TEST_ASSERT_TRUE_MESSAGE(TraceReplayer::decode(file, trace), "not a capture trace");
+    TraceReplayer::Options options;
+    const char *speed = getenv("DEVICEBRIDGE_TRACE_SPEED");
+    if (speed) {
+        options.speed = atof(speed);
+    }
+
+    const size_t before = storedFiles().size();
+    const TraceReplayer::Stats stats = replay(trace, options);
+    uint64_t stored = 0;
+    const std::vector<const SdNode *> files = storedFiles();
+    for (size_t i = before; i < files.size(); i++) {
+        stored += files[i]->data.size();
+    }
+    const double seconds = cyclesToSeconds(stats.lastStrobeCycle - stats.firstStrobeCycle);
+    printf("%s x%.1f: %u bytes sent, %llu stored in %u files, %.0f bytes/s, %u /ACK timeouts, %u late "
+           "(max %.1fus)\n",
+           path, options.speed, stats.bytesSent, (unsigned long long)stored, (unsigned)(files.size() - before),
+           seconds > 0 ? stats.bytesSent / seconds : 0.0, stats.ackTimeouts, stats.lateBytes,
+           (double)stats.maxLateCycles / CYCLES_PER_US);
+    TEST_ASSERT_EQUAL_UINT32(stats.bytesSent, stored);
+}
+
+int main(int argc, char **argv)
+{
+    // Card inserted, not write protected; host holds the control lines inactive
+    drivePin(Pins::SD_CD, LOW);
+    drivePin(Pins::SD_WP, LOW);
+    drivePin(Pins::LPT_AUTO_FEED, HIGH);
+    drivePin(Pins::LPT_INITIALIZE, HIGH);
+    drivePin(Pins::LPT_SELECT_IN, HIGH);
+    setup();
+    runUntil(cycles() + 100 * CYCLES_PER_MS);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_trace_records_every_strobe);
+    RUN_TEST(test_replay_at_recorded_speed);
+    RUN_TEST(test_replay_accelerated);
+    RUN_TEST(test_replay_bench_trace);
+    return UNITY_END();
+}
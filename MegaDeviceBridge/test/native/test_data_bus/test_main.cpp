@@ -0,0 +1,119 @@
+// DataBus (compile-time pin traits + PROGMEM bit-gather) against the
+// digitalRead() reference in Data::readValue().
+
+#include <unity.h>
+#include <Arduino.h>
+#include "Common/Config.h"
+#include "Parallel/Data.h"
+#include "Parallel/DataBus.h"
+#include "Parallel/PinTraits.h"
+
+using namespace DeviceBridge::Parallel;
+namespace Pins = DeviceBridge::Common::Pins;
+
+namespace {
+
+Data makeData()
+{
+    return Data(Pins::LPT_D0, Pins::LPT_D1, Pins::LPT_D2, Pins::LPT_D3, Pins::LPT_D4, Pins::LPT_D5, Pins::LPT_D6,
+                Pins::LPT_D7);
+}
+
+void driveBus(uint8_t value)
+{
+    for (uint8_t line = 0; line < 8; line++) {
+        NativeHal::drivePin(DataBus::pin(line), (value >> line) & 0x01);
+    }
+}
+
+} // namespace
+
+void setUp() { NativeHal::reset(); }
+void tearDown() {}
+
+void test_pin_traits_match_core_mapping()
+{
+    for (uint8_t pin = 0; pin < NativeHal::PIN_COUNT; pin++) {
+        TEST_ASSERT_EQUAL_UINT8(NativeHal::pinPort(pin), PinTraits::port(pin));
+        TEST_ASSERT_EQUAL_UINT8(NativeHal::pinBit(pin), PinTraits::bit(pin));
+    }
+}
+
+void test_bus_uses_fewest_port_reads()
+{
+    // D0-D2 on PORTA, D3-D6 on PORTC, D7 on PORTG
+    static_assert(DataBus::portReads() == 3, "LPT data bus spans three AVR ports");
+    TEST_ASSERT_EQUAL_UINT8(0xA8, DataBus::portMask(PinTraits::PORT_A));
+    TEST_ASSERT_EQUAL_UINT8(0x55, DataBus::portMask(PinTraits::PORT_C));
+    TEST_ASSERT_EQUAL_UINT8(0x04, DataBus::portMask(PinTraits::PORT_G));
+}
+
+void test_fast_read_matches_read_value_for_all_bytes()
+{
+    Data data = makeData();
+    data.initialize();
+    TEST_ASSERT_TRUE(data.isFastBus());
+
+    for (uint16_t value = 0; value < 256; value++) {
+        driveBus((uint8_t)value);
+        uint8_t reference = data.readValue();
+        TEST_ASSERT_EQUAL_UINT8(value, reference);
+        TEST_ASSERT_EQUAL_UINT8(reference, DataBus::read());
+        TEST_ASSERT_EQUAL_UINT8(reference, data.readValueAtomic());
+    }
+}
+
+void test_fast_read_ignores_unrelated_port_bits()
+{
+    Data data = makeData();
+    data.initialize();
+    // Neighbouring pins on the same ports: /INIT, /SELECT-IN, ERROR (PORTA), SD_CD/SD_WP/LEDs (PORTC), ACK (PORTG)
+    const uint8_t others[] = {22, 23, 24, 26, 28, 30, 32, 34, 36, 40, 41};
+    for (uint8_t pin : others) {
+        NativeHal::drivePin(pin, HIGH);
+    }
+    for (uint16_t value = 0; value < 256; value += 17) {
+        driveBus((uint8_t)value);
+        TEST_ASSERT_EQUAL_UINT8(value, DataBus::read());
+    }
+}
+
+void test_fast_read_cost()
+{
+    Data data = makeData();
+    data.initialize();
+    driveBus(0x5A);
+
+    uint64_t start = NativeHal::cycles();
+    data.readValue();
+    uint64_t slow = NativeHal::cycles() - start;
+
+    start = NativeHal::cycles();
+    DataBus::read();
+    uint64_t fast = NativeHal::cycles() - start;
+
+    TEST_ASSERT_EQUAL_UINT32(8 * NativeHal::costs().digitalRead, (uint32_t)slow);
+    TEST_ASSERT_EQUAL_UINT32(3 * NativeHal::costs().ioAccess, (uint32_t)fast);
+}
+
+void test_mismatched_pins_fall_back_to_digital_read()
+{
+    Data data(Pins::LPT_D1, Pins::LPT_D0, Pins::LPT_D2, Pins::LPT_D3, Pins::LPT_D4, Pins::LPT_D5, Pins::LPT_D6,
+              Pins::LPT_D7);
+    data.initialize();
+    TEST_ASSERT_FALSE(data.isFastBus());
+    driveBus(0x01);
+    TEST_ASSERT_EQUAL_UINT8(0x02, data.readValueAtomic());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_pin_traits_match_core_mapping);
+    RUN_TEST(test_bus_uses_fewest_port_reads);
+    RUN_TEST(test_fast_read_matches_read_value_for_all_bytes);
+    RUN_TEST(test_fast_read_ignores_unrelated_port_bits);
+    RUN_TEST(test_fast_read_cost);
+    RUN_TEST(test_mismatched_pins_fall_back_to_digital_read);
+    return UNITY_END();
+}
@@ -0,0 +1,379 @@
+// Content-aware end-of-document detection.
+//
+// Feeds synthetic BMP, PCX, TIFF and PCL documents to Parallel::DocumentEnd
+// in odd-sized pieces: each has to complete on its own last byte and leave
+// whatever follows it unconsumed, while a lossy capture (the short BMPs and
+// the overrunning PCX in Images/ look like that) or an unknown format must
+// never complete. Then boots the firmware and sends three complete documents
+// and a text job 50ms apart without /INIT: the documents have to land in
+// their own files, each closed within the gap after it, and the text job
+// is still left to the idle timeout. A file already on the card under one
+// of the names they get (a restart within the second) is left alone.
+//
+//   pio test -e native -f native/test_document_end -v
+
+#include <unity.h>
+#include <Arduino.h>
+#include <SD.h>
+#include <LptHostSimulator.h>
+#include <algorithm>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "Common/Config.h"
+#include "Common/ServiceLocator.h"
+#include "Components/ParallelPortManager.h"
+#include "Parallel/DocumentEnd.h"
+
+using namespace NativeHal;
+namespace Pins = DeviceBridge::Common::Pins;
+using DeviceBridge::Parallel::DocumentEnd;
+using Format = DeviceBridge::Parallel::DocumentEnd::Format;
+using Bytes = std::vector<uint8_t>;
+
+namespace {
+
+void put16(Bytes &out, uint16_t value)
+{
+    out.push_back(value & 0xFF);
+    out.push_back(value >> 8);
+}
+
+void put32(Bytes &out, uint32_t value)
+{
+    put16(out, value & 0xFFFF);
+    put16(out, value >> 16);
+}
+
+void append(Bytes &out, const char *text)
+{
+    out.insert(out.end(), text, text + strlen(text));
+}
+
+/** 8-bit BMP, 16x8 pixels with a 256-entry palette */
+Bytes makeBmp()
+{
+    const uint32_t offset = 14 + 40 + 1024;
+    const uint32_t size = offset + 16 * 8;
+    Bytes out = {'B', 'M'};
+    put32(out, size);
+    put32(out, 0);
+    put32(out, offset);
+    put32(out, 40);
+    put32(out, 16);
+    put32(out, 8);
+    put16(out, 1);
+    put16(out, 8);
+    while (out.size() < size) {
+        out.push_back((uint8_t)(out.size() * 7));
+    }
+    return out;
+}
+
+/** PCX version 5, 8 bits, one plane, 32x8 pixels; runs, literals and the palette */
+Bytes makePcx(bool palette = true)
+{
+    Bytes out(128, 0);
+    out[0] = 0x0A;
+    out[1] = 5;
+    out[2] = 1;
+    out[3] = 8;
+    out[8] = 31;   // xmax
+    out[10] = 7;   // ymax
+    out[65] = 1;
+    out[66] = 32;  // bytes per line
+    for (int line = 0; line < 8; line++) {
+        out.push_back(0xC0 | 20);   // 20 x 0x1B
+        out.push_back(0x1B);
+        for (int i = 0; i < 11; i++) {
+            out.push_back((uint8_t)(line * 11 + i));
+        }
+        out.push_back(0xC1);        // a value with the run bits set needs a run of one
+        out.push_back(0xE5);
+    }
+    if (palette) {
+        out.push_back(0x0C);
+        for (int i = 0; i < 768; i++) {
+            out.push_back((uint8_t)i);
+        }
+    }
+    return out;
+}
+
+void putEntry(Bytes &out, uint16_t tag, uint16_t type, uint32_t count, uint32_t value)
+{
+    put16(out, tag);
+    put16(out, type);
+    put32(out, count);
+    put32(out, value);
+}
+
+/** Little-endian TIFF, IFD first: strip offsets out of line after it, counts inline, two 32-byte strips */
+Bytes makeTiff()
+{
+    const uint32_t ifd = 8;
+    const uint16_t entries = 6;
+    const uint32_t offsetsAt = ifd + 2 + 12 * entries + 4;
+    const uint32_t stripsAt = offsetsAt + 8;
+    Bytes out = {'I', 'I', 42, 0};
+    put32(out, ifd);
+    put16(out, entries);
+    putEntry(out, 256, 3, 1, 16);                   // ImageWidth
+    putEntry(out, 257, 3, 1, 4);                    // ImageLength
+    putEntry(out, 258, 3, 1, 8);                    // BitsPerSample
+    putEntry(out, 273, 4, 2, offsetsAt);            // StripOffsets
+    putEntry(out, 278, 3, 1, 2);                    // RowsPerStrip
+    putEntry(out, 279, 3, 2, 32 | (32UL << 16));    // StripByteCounts, both inline
+    put32(out, 0);
+    put32(out, stripsAt);
+    put32(out, stripsAt + 32);
+    for (int i = 0; i < 64; i++) {
+        out.push_back((uint8_t)(i * 5));
+    }
+    return out;
+}
+
+/** PCL 5 raster job: ESC E ... ESC E, with ESC E inside the raster data */
+Bytes makePcl()
+{
+    Bytes out;
+    append(out, "\x1B" "E" "\x1B&l0O" "\x1B*t300R" "\x1B*r1A");
+    for (int row = 0; row < 4; row++) {
+        append(out, "\x1B*b0m8W");
+        const uint8_t data[8] = {0x1B, 'E', 0x1B, '%', (uint8_t)row, 0xFF, 0x00, 0x1B};
+        out.insert(out.end(), data, data + sizeof(data));
+    }
+    append(out, "\x1B*rB" "\f" "\x1B" "E");
+    return out;
+}
+
+/** Bytes taken before the document completed, fed `piece` at a time */
+size_t feedAll(DocumentEnd &document, const Bytes &bytes, size_t piece)
+{
+    size_t used = 0;
+    while (used < bytes.size() && !document.isComplete()) {
+        const size_t length = std::min(piece, bytes.size() - used);
+        const uint16_t taken = document.feed(&bytes[used], (uint16_t)length);
+        used += taken;
+        if (taken < length) {
+            break;
+        }
+    }
+    return used;
+}
+
+/** The document alone completes on its last byte; what follows it is left over */
+void assertEndsExactly(const Bytes &document, Format format)
+{
+    static const size_t pieces[] = {1, 3, 64, 512};
+    Bytes stream = document;
+    append(stream, "\x1B" "E" "NEXT JOB");
+    for (size_t piece : pieces) {
+        DocumentEnd parser;
+        TEST_ASSERT_EQUAL_UINT32(document.size(), feedAll(parser, stream, piece));
+        TEST_ASSERT_TRUE(parser.isComplete());
+        TEST_ASSERT_TRUE(parser.getFormat() == format);
+        TEST_ASSERT_EQUAL_UINT32(document.size(), parser.getPosition());
+    }
+}
+
+/** Never completes: everything is taken and the idle timeout decides */
+void assertLeftToTimeout(const Bytes &stream)
+{
+    DocumentEnd parser;
+    TEST_ASSERT_EQUAL_UINT32(stream.size(), feedAll(parser, stream, 100));
+    TEST_ASSERT_FALSE(parser.isComplete());
+}
+
+LptHostSimulator::Pins hostPins()
+{
+    return {Pins::LPT_STROBE,
+            {Pins::LPT_D0, Pins::LPT_D1, Pins::LPT_D2, Pins::LPT_D3, Pins::LPT_D4, Pins::LPT_D5, Pins::LPT_D6,
+             Pins::LPT_D7},
+            Pins::LPT_ACK,
+            Pins::LPT_BUSY};
+}
+
+bool isCaptureRecord(const SdNode &node)
+{
+    const std::string ext = ".CAP";
+    return node.path.size() > ext.size() && node.path.compare(node.path.size() - ext.size(), ext.size(), ext) == 0;
+}
+
+/** Capture files on the card, without their .CAP records, the commit journal, the catalog and `skipped` */
+std::vector<const SdNode *> storedFiles(const char *skipped = "")
+{
+    std::vector<const SdNode *> files;
+    for (const SdNode *node : sdFiles()) {
+        if (!isCaptureRecord(*node) && node->path != DeviceBridge::Common::Commit::JOURNAL_NAME &&
+            node->path != DeviceBridge::Common::Catalog::FILE_NAME && node->path != skipped) {
+            files.push_back(node);
+        }
+    }
+    return files;
+}
+
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_bmp_ends_at_file_size()
+{
+    assertEndsExactly(makeBmp(), Format::BMP);
+
+    // A capture shorter than bfSize (lost bytes) waits for the timeout
+    Bytes lossy = makeBmp();
+    lossy.resize(lossy.size() - 40);
+    assertLeftToTimeout(lossy);
+
+    // Reserved fields set: not a BMP after all
+    Bytes text = makeBmp();
+    text[6] = 'x';
+    DocumentEnd parser;
+    feedAll(parser, text, 512);
+    TEST_ASSERT_TRUE(parser.getFormat() == Format::UNKNOWN);
+}
+
+void test_pcx_ends_after_image_and_palette()
+{
+    assertEndsExactly(makePcx(), Format::PCX);
+
+    // 8-bit without the palette marker: more likely bytes were lost than the palette left out
+    Bytes bare = makePcx(false);
+    bare.push_back('X');
+    assertLeftToTimeout(bare);
+
+    // A byte lost inside a run makes the next run overrun the image
+    Bytes lossy = makePcx();
+    lossy.erase(lossy.begin() + 128 + 1);
+    assertLeftToTimeout(lossy);
+}
+
+void test_tiff_ends_after_last_strip()
+{
+    assertEndsExactly(makeTiff(), Format::TIFF);
+
+    // Big-endian with the IFD after the strip: inline offset and count
+    Bytes be = {'M', 'M', 0, 42, 0, 0, 0, 16};
+    for (int i = 0; i < 8; i++) {
+        be.push_back((uint8_t)(0xA0 + i));
+    }
+    const uint8_t ifd[] = {0, 2,
+                           0x01, 0x11, 0, 4, 0, 0, 0, 1, 0, 0, 0, 8,    // StripOffsets = 8
+                           0x01, 0x17, 0, 3, 0, 0, 0, 1, 0, 8, 0, 0,    // StripByteCounts = 8 (SHORT, left-justified)
+                           0, 0, 0, 0};
+    be.insert(be.end(), ifd, ifd + sizeof(ifd));
+    assertEndsExactly(be, Format::TIFF);
+
+    // Strip tables the stream passed before the IFD pointed at them cannot be read back
+    Bytes passed = {'I', 'I', 42, 0};
+    put32(passed, 8 + 8 + 64);
+    put32(passed, 16);
+    put32(passed, 48);
+    for (int i = 0; i < 64; i++) {
+        passed.push_back((uint8_t)i);
+    }
+    put16(passed, 2);
+    putEntry(passed, 273, 4, 2, 8);
+    putEntry(passed, 279, 3, 2, 32 | (32UL << 16));
+    put32(passed, 0);
+    assertLeftToTimeout(passed);
+}
+
+void test_pcl_ends_at_reset()
+{
+    assertEndsExactly(makePcl(), Format::PCL);
+
+    // PJL job: the UEL after @PJL EOJ ends it, not the one that starts PCL
+    Bytes pjl;
+    append(pjl, "\x1B%-12345X@PJL JOB NAME=\"scope\"\r\n@PJL ENTER LANGUAGE=PCL\r\n");
+    Bytes pcl = makePcl();
+    pjl.insert(pjl.end(), pcl.begin(), pcl.end());
+    append(pjl, "\x1B%-12345X@PJL EOJ\r\n\x1B%-12345X");
+    assertEndsExactly(pjl, Format::PCL);
+
+    // ESC/P and plain text are not PCL
+    Bytes escp;
+    append(escp, "\x1B@\x1B" "E" "text\x1B" "E");
+    assertLeftToTimeout(escp);
+    Bytes text;
+    append(text, "Hello\r\n\x1B" "E");
+    assertLeftToTimeout(text);
+}
+
+void test_documents_close_without_idle_timeout()
+{
+    // Card inserted, not write protected; host holds the control lines inactive
+    drivePin(Pins::SD_CD, LOW);
+    drivePin(Pins::SD_WP, LOW);
+    drivePin(Pins::LPT_AUTO_FEED, HIGH);
+    drivePin(Pins::LPT_INITIALIZE, HIGH);
+    drivePin(Pins::LPT_SELECT_IN, HIGH);
+
+    LptHostSimulator::Timing timing;
+    timing.jobGapMs = 50;
+    LptHostSimulator host(hostPins(), timing);
+    Bytes text;
+    append(text, "Plain text has no end marker\r\n");
+    const std::vector<Bytes> jobs = {makeBmp(), makePcx(), makePcl(), text};
+    for (const Bytes &job : jobs) {
+        host.addJob(job);
+    }
+
+    // The second document's name, taken before a restart: it must not be appended to
+    const char *stale = "20250101/12000001.BIN";
+    TEST_ASSERT_TRUE(SD.mkdir("20250101"));
+    File old = SD.open(stale, FILE_WRITE);
+    TEST_ASSERT_EQUAL_UINT32(5, old.write((const uint8_t *)"STALE", 5));
+    old.close();
+
+    setup();
+    auto *manager = DeviceBridge::ServiceLocator::getInstance().getParallelPortManager();
+    TEST_ASSERT_TRUE(manager->isDocumentEndEnabled());
+
+    attachPeripheral(&host);
+    host.start(cycles() + microsToCycles(1000));
+    const uint64_t limit = cycles() + 30ULL * CPU_HZ;
+    while (!host.finished() && cycles() < limit) {
+        loop();
+    }
+    TEST_ASSERT_TRUE(host.finished());
+    const uint64_t sent = cycles();
+    while (cycles() < sent + 500ULL * (CPU_HZ / 1000)) {
+        loop();
+    }
+
+    TEST_ASSERT_TRUE(sdFind(stale)->data == Bytes({'S', 'T', 'A', 'L', 'E'}));
+    std::vector<const SdNode *> files = storedFiles(stale);
+    TEST_ASSERT_EQUAL_UINT32(3, files.size());
+    for (size_t i = 0; i < files.size(); i++) {
+        TEST_ASSERT_TRUE(files[i]->data == jobs[i]);
+        TEST_ASSERT_TRUE(files[i]->closedCycle != 0);
+        // Closed within the gap before the next job, not 2s later
+        TEST_ASSERT_TRUE(files[i]->closedCycle - host.jobEndCycle(i) < 50ULL * (CPU_HZ / 1000));
+    }
+    TEST_ASSERT_EQUAL_UINT32(3, manager->getDocumentEndCount());
+
+    // The text job is still waiting in its partial chunk; only the idle timeout stores it
+    while (cycles() < sent + 3000ULL * (CPU_HZ / 1000)) {
+        loop();
+    }
+    files = storedFiles(stale);
+    TEST_ASSERT_EQUAL_UINT32(jobs.size(), files.size());
+    TEST_ASSERT_TRUE(files[3]->data == jobs[3]);
+    TEST_ASSERT_TRUE(files[3]->closedCycle - host.jobEndCycle(3) > 2000ULL * (CPU_HZ / 1000));
+    TEST_ASSERT_EQUAL_UINT32(3, manager->getDocumentEndCount());
+    detachPeripheral(&host);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_bmp_ends_at_file_size);
+    RUN_TEST(test_pcx_ends_after_image_and_palette);
+    RUN_TEST(test_tiff_ends_after_last_strip);
+    RUN_TEST(test_pcl_ends_at_reset);
+    RUN_TEST(test_documents_close_without_idle_timeout);
+    return UNITY_END();
+}
@@ -0,0 +1,484 @@
+// Cycles per /STROBE interrupt for both Port ISR paths.
+//
+// Drives strobes straight into the firmware's printerPort (src/main.cpp)
+// and reports the mean cycles spent in interrupt context per byte, with and
+// without the fixed busy-wait delays, for: the legacy handler with the
+// buffer kept empty, the legacy handler filling the buffer through the
+// flow-control thresholds, and the optimized handler with hardware flow
+// control doing the same, plus the flow-control core's own cost per byte
+// and on state changes, and that the deferred main-loop work paces flow
+// control without busy-waiting. Further tests run burst capture and polled
+// capture sessions against a simulated host sending back to back and then
+// paced, check the capture counters behind the per-file records and the
+// overshoot and BUSY level predictive flow control derives from the
+// traffic, and that an /INIT or /SELECT-IN edge, sampled on Timer3, splits
+// the byte stream where the ring stood.
+//
+// Every figure is NativeHal's cost model ("model cycles"): Arduino calls,
+// register accesses, interrupt entry and delays are charged, plain C++ is
+// free. They compare calls made on each path, not avr-gcc instruction
+// counts; a path that runs more C++ but makes fewer charged calls comes out
+// cheaper, as HW flow control does against the plain optimized handler.
+//
+//   pio test -e native -f native/test_isr_cycles -v
+
+#include <unity.h>
+#include <Arduino.h>
+#include <LptHostSimulator.h>
+#include <algorithm>
+#include <stdio.h>
+#include <vector>
+#include "Common/Config.h"
+#include "Parallel/FastPin.h"
+#include "Parallel/Port.h"
+
+using namespace NativeHal;
+namespace Pins = DeviceBridge::Common::Pins;
+
+extern DeviceBridge::Parallel::Port printerPort;
+
+namespace {
+
+struct IsrCost {
+    double total;
+    double work; // excluding delayMicroseconds()
+    uint32_t max; // slowest single interrupt
+};
+
+uint8_t drainBuffer[DeviceBridge::Common::Buffer::RING_BUFFER_SIZE];
+
+void drain() { printerPort.readData(drainBuffer, 0, sizeof(drainBuffer)); }
+
+IsrCost strobe(uint16_t count, bool keepEmpty)
+{
+    uint64_t cycles0 = interruptCycles();
+    uint64_t delay0 = interruptDelayCycles();
+    uint32_t serviced0 = interruptsServiced();
+    uint32_t slowest = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        uint64_t before = interruptCycles();
+        uint8_t value = (uint8_t)(i * 37);
+        for (uint8_t line = 0; line < 8; line++) {
+            const uint8_t pins[8] = {Pins::LPT_D0, Pins::LPT_D1, Pins::LPT_D2, Pins::LPT_D3,
+                                     Pins::LPT_D4, Pins::LPT_D5, Pins::LPT_D6, Pins::LPT_D7};
+            drivePin(pins[line], (value >> line) & 0x01);
+        }
+        drivePin(Pins::LPT_STROBE, LOW);
+        advanceMicros(1);
+        drivePin(Pins::LPT_STROBE, HIGH);
+        advanceMicros(1);
+        slowest = std::max(slowest, (uint32_t)(interruptCycles() - before));
+        if (keepEmpty) {
+            drain();
+        }
+    }
+    uint32_t serviced = interruptsServiced() - serviced0;
+    TEST_ASSERT_EQUAL_UINT32(count, serviced);
+    IsrCost cost;
+    cost.total = (double)(interruptCycles() - cycles0) / serviced;
+    cost.work = (double)(interruptCycles() - cycles0 - (interruptDelayCycles() - delay0)) / serviced;
+    cost.max = slowest;
+    return cost;
+}
+
+void report(const char *label, const IsrCost &cost)
+{
+    printf("  %-34s %7.1f model cycles/ISR (%5.1f us), %6.1f excluding delays\n", label, cost.total, cost.total / 16.0,
+           cost.work);
+}
+
+struct BurstRun {
+    uint32_t interrupts;
+    uint32_t burstBytes;
+    double cyclesPerByte;
+};
+
+// Send `count` bytes from a simulated host, draining the port as they arrive;
+// with `polled` each drain is followed by a pollCapture() session. Flow control
+// is serviced after each drain, as ParallelPortManager::update() does
+BurstRun sendFromHost(uint16_t count, uint32_t bytePeriodNs, bool polled = false)
+{
+    LptHostSimulator::Pins pins = {Pins::LPT_STROBE,
+                                   {Pins::LPT_D0, Pins::LPT_D1, Pins::LPT_D2, Pins::LPT_D3, Pins::LPT_D4, Pins::LPT_D5,
+                                    Pins::LPT_D6, Pins::LPT_D7},
+                                   Pins::LPT_ACK,
+                                   Pins::LPT_BUSY};
+    LptHostSimulator::Timing timing;
+    timing.minBytePeriodNs = bytePeriodNs;
+    LptHostSimulator host(pins, timing);
+    std::vector<uint8_t> bytes;
+    for (uint16_t i = 0; i < count; i++) {
+        bytes.push_back((uint8_t)(i * 37 + 11));
+    }
+    host.addJob(bytes);
+
+    uint32_t serviced0 = interruptsServiced();
+    uint32_t burst0 = printerPort.getBurstCaptureCount();
+    uint64_t cycles0 = interruptCycles();
+    std::vector<uint8_t> received;
+    attachPeripheral(&host);
+    host.start(cycles());
+    const uint64_t deadline = cycles() + microsToCycles(1000000);
+    while (received.size() < count) {
+        advanceMicros(200);
+        // As ParallelPortManager does: interrupts stay masked from the drain through the session
+        const uint8_t sreg = SREG;
+        if (polled) {
+            cli();
+        }
+        uint16_t n = printerPort.readData(drainBuffer, 0, sizeof(drainBuffer));
+        if (polled) {
+            printerPort.pollCapture();
+        }
+        SREG = sreg;
+        printerPort.processPendingOperations();
+        received.insert(received.end(), drainBuffer, drainBuffer + n);
+        TEST_ASSERT_TRUE(cycles() < deadline);
+    }
+    detachPeripheral(&host);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(bytes.data(), received.data(), count);
+
+    BurstRun run;
+    run.interrupts = interruptsServiced() - serviced0;
+    run.burstBytes = printerPort.getBurstCaptureCount() - burst0;
+    run.cyclesPerByte = (double)(interruptCycles() - cycles0) / count;
+    return run;
+}
+
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+template <uint8_t Pin> void checkFastPin()
+{
+    using DeviceBridge::Parallel::FastPin;
+    pinMode(Pin, OUTPUT);
+    const uint8_t port = pinPort(Pin);
+    const uint8_t before = portState(port).out & (uint8_t)~FastPin<Pin>::mask;
+    FastPin<Pin>::high();
+    TEST_ASSERT_TRUE(readPin(Pin));
+    TEST_ASSERT_TRUE(FastPin<Pin>::read());
+    FastPin<Pin>::low();
+    TEST_ASSERT_FALSE(readPin(Pin));
+    TEST_ASSERT_EQUAL_UINT8(before, portState(port).out);
+    TEST_ASSERT_TRUE(interruptsEnabled());
+}
+
+void test_fast_pin_drives_status_lines()
+{
+    checkFastPin<Pins::LPT_ACK>();
+    checkFastPin<Pins::LPT_BUSY>();
+    checkFastPin<Pins::LPT_PAPER_OUT>();
+    checkFastPin<Pins::LPT_SELECT>();
+    checkFastPin<Pins::LPT_ERROR>();
+}
+
+void test_isr_cycles()
+{
+    drivePin(Pins::LPT_STROBE, HIGH);
+    drivePin(Pins::LPT_AUTO_FEED, HIGH);
+    drivePin(Pins::LPT_INITIALIZE, HIGH);
+    drivePin(Pins::LPT_SELECT_IN, HIGH);
+
+    printf("\n=== Model cycles per /STROBE interrupt ===\n");
+
+    printerPort.initialize();
+    printerPort.setJobSignals(0); // JobSignalTimer's vector would be counted with the strobes
+    report("legacy, buffer empty", strobe(256, true));
+    report("legacy, filling to 400 bytes", strobe(400, false));
+    printerPort.clearBuffer();
+
+    // OptimizedTiming stays initialized for the rest of the process
+    printerPort.initializeOptimized();
+    printerPort.setHardwareFlowControlEnabled(true);
+    report("optimized, buffer empty", strobe(256, true));
+    report("optimized + HW flow, filling to 400", strobe(400, false));
+    printf("\n");
+    printerPort.clearBuffer();
+}
+
+void test_flow_control_isr_cost()
+{
+    using Statistics = DeviceBridge::Parallel::HardwareFlowControl::Statistics;
+    printerPort.clearBuffer();
+    printerPort.setHardwareFlowControlEnabled(false);
+    IsrCost off = strobe(256, true);
+    printerPort.setHardwareFlowControlEnabled(true);
+    IsrCost steady = strobe(256, true);
+
+    // Fill through every threshold, drain, and let the release hold times run out; eight rounds
+    const uint8_t rounds = 8;
+    const uint16_t fill = 400;
+    Statistics before = printerPort.getFlowControlStatistics();
+    IsrCost filling = {0, 0, 0};
+    for (uint8_t i = 0; i < rounds; i++) {
+        IsrCost round = strobe(fill, false);
+        filling.total += round.total / rounds;
+        filling.work += round.work / rounds;
+        filling.max = std::max(filling.max, round.max);
+        drain();
+        advanceMicros(200000);
+        printerPort.processPendingOperations();
+    }
+    Statistics after = printerPort.getFlowControlStatistics();
+    const uint32_t transitions = after.stateTransitions - before.stateTransitions;
+
+    printf("=== Flow-control core in the optimized ISR ===\n");
+    report("HW flow off, buffer empty", off);
+    report("HW flow on, buffer empty", steady);
+    report("HW flow on, filling to 400", filling);
+    printf("  %-34s %+7.1f model cycles/byte against HW flow off\n", "HW flow steady state", steady.total - off.total);
+    printf("  %-34s %7u model cycles (%u state changes in %u rounds)\n\n", "slowest ISR while filling", (unsigned)filling.max,
+           (unsigned)transitions, rounds);
+    printerPort.setHardwareFlowControlEnabled(false);
+
+    // No Arduino calls per byte below the next threshold; escalation is never held back by hold
+    // times, so every round goes NORMAL -> WARNING -> CRITICAL -> EMERGENCY and back
+    TEST_ASSERT_TRUE(steady.work <= off.work);
+    TEST_ASSERT_EQUAL_UINT32(rounds * 4, transitions);
+}
+
+void test_pending_operations_never_wait()
+{
+    namespace Timing = DeviceBridge::Common::Timing;
+    printerPort.clearBuffer();
+    printerPort.setHardwareFlowControlEnabled(false);
+    printerPort.processPendingOperations();
+    advanceMicros(Timing::CRITICAL_FLOW_DELAY_US);
+    printerPort.processPendingOperations();
+
+    // Past the critical threshold the old handler spun CRITICAL_FLOW_DELAY_US here
+    strobe(400, false);
+    const uint64_t delay0 = loopDelayCycles();
+    const uint32_t recovered0 = printerPort.getPacingRecoveredUs();
+    uint64_t start = cycles();
+    printerPort.processPendingOperations();
+    const uint64_t elapsed = cycles() - start;
+    TEST_ASSERT_TRUE(loopDelayCycles() == delay0);
+    TEST_ASSERT_EQUAL_UINT32(recovered0, printerPort.getPacingRecoveredUs()); // nothing spent elsewhere yet
+    TEST_ASSERT_TRUE(elapsed < microsToCycles(Timing::CRITICAL_FLOW_DELAY_US) / 4);
+
+    // Calls back to back recover nothing: the time went to processPendingOperations() itself
+    printerPort.processPendingOperations();
+    const uint32_t recovered1 = printerPort.getPacingRecoveredUs();
+    TEST_ASSERT_TRUE(recovered1 - recovered0 < Timing::CRITICAL_FLOW_DELAY_US / 4);
+
+    // Strobes inside the window are taken together once it closes; the loop
+    // time between the calls is credited, at most the window's length
+    strobe(2, false);
+    printerPort.processPendingOperations();
+    advanceMicros(Timing::CRITICAL_FLOW_DELAY_US);
+    printerPort.processPendingOperations();
+    const uint32_t recovered = printerPort.getPacingRecoveredUs() - recovered0;
+    TEST_ASSERT_TRUE(recovered <= Timing::CRITICAL_FLOW_DELAY_US);
+    TEST_ASSERT_TRUE(recovered >= Timing::CRITICAL_FLOW_DELAY_US / 2);
+    TEST_ASSERT_TRUE(loopDelayCycles() == delay0);
+
+    printf("=== Deferred flow-control work (critical level) ===\n");
+    printf("  %-34s %7u model cycles, %u of %u us window used by the loop\n\n", "processPendingOperations()",
+           (unsigned)elapsed, (unsigned)recovered, (unsigned)Timing::CRITICAL_FLOW_DELAY_US);
+    printerPort.clearBuffer();
+}
+
+void test_burst_capture_adapts_to_traffic()
+{
+    const uint16_t count = 256;
+    printerPort.setHardwareFlowControlEnabled(false);
+    TEST_ASSERT_TRUE(printerPort.setBurstCaptureEnabled(true));
+
+    // Back to back: nearly every byte is taken inside an earlier interrupt
+    BurstRun dense = sendFromHost(count, 0);
+    TEST_ASSERT_EQUAL_UINT32(count, dense.interrupts + dense.burstBytes);
+    TEST_ASSERT_TRUE(dense.interrupts * 8 <= count);
+
+    // Paced at 50us per byte: the window closes and each byte gets its own interrupt
+    BurstRun sparse = sendFromHost(count, 50000);
+    TEST_ASSERT_EQUAL_UINT32(count, sparse.interrupts);
+    TEST_ASSERT_EQUAL_UINT32(0, sparse.burstBytes);
+
+    TEST_ASSERT_TRUE(printerPort.setBurstCaptureEnabled(false));
+    BurstRun single = sendFromHost(count, 0);
+    TEST_ASSERT_EQUAL_UINT32(count, single.interrupts);
+
+    printf("\n=== Burst capture (%u bytes) ===\n", count);
+    printf("  %-34s %5u interrupts, %6.1f ISR model cycles/byte\n", "burst, back to back", dense.interrupts,
+           dense.cyclesPerByte);
+    printf("  %-34s %5u interrupts, %6.1f ISR model cycles/byte\n", "burst, 50us per byte", sparse.interrupts,
+           sparse.cyclesPerByte);
+    printf("  %-34s %5u interrupts, %6.1f ISR model cycles/byte\n\n", "one byte per interrupt", single.interrupts,
+           single.cyclesPerByte);
+    TEST_ASSERT_TRUE(dense.cyclesPerByte < single.cyclesPerByte);
+}
+
+void test_polled_capture_sessions()
+{
+    using Statistics = DeviceBridge::Parallel::Port::PolledCaptureStatistics;
+    const uint16_t count = 1024;
+    TEST_ASSERT_EQUAL_UINT16(0, printerPort.pollCapture()); // not enabled
+    TEST_ASSERT_TRUE(printerPort.setPolledCaptureEnabled(true));
+    printerPort.resetPolledCaptureStatistics();
+
+    // Back to back: sessions run until the buffer reaches the moderate threshold
+    BurstRun dense = sendFromHost(count, 0, true);
+    Statistics stats = printerPort.getPolledCaptureStatistics();
+    TEST_ASSERT_EQUAL_UINT32(count, dense.interrupts + stats.bytes);
+    TEST_ASSERT_TRUE(stats.bytes * 2 >= count);
+    TEST_ASSERT_TRUE(stats.highWaterExits > 0);
+
+    // Paced at 200us per byte: every session gives up on the idle timeout
+    printerPort.resetPolledCaptureStatistics();
+    BurstRun sparse = sendFromHost(64, 200000, true);
+    stats = printerPort.getPolledCaptureStatistics();
+    TEST_ASSERT_EQUAL_UINT32(64, sparse.interrupts + stats.bytes);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.highWaterExits);
+    TEST_ASSERT_EQUAL_UINT32(stats.sessions, stats.idleExits);
+
+    TEST_ASSERT_TRUE(printerPort.setPolledCaptureEnabled(false));
+    printf("=== Polled capture (%u bytes back to back) ===\n", count);
+    printf("  %-34s %5u bytes polled, %5u interrupts\n\n", "polled sessions",
+           (unsigned)(count - dense.interrupts), dense.interrupts);
+}
+
+void test_capture_counters_account_for_losses()
+{
+    using Counters = DeviceBridge::Parallel::Port::CaptureCounters;
+    using FlowState = DeviceBridge::Parallel::HardwareFlowControl::FlowState;
+    const uint16_t capacity = DeviceBridge::Common::Buffer::RING_BUFFER_SIZE;
+    printerPort.clearBuffer();
+    Counters before;
+    printerPort.getCaptureCounters(before);
+
+    // Fill the ring, then three strobes with nowhere to go: one overflow event
+    strobe(capacity + 3, false);
+    advanceMicros(500);
+    Counters full;
+    printerPort.getCaptureCounters(full);
+    TEST_ASSERT_EQUAL_UINT32(capacity, full.captured - before.captured);
+    TEST_ASSERT_EQUAL_UINT32(3, full.dropped - before.dropped);
+    TEST_ASSERT_EQUAL_UINT32(1, full.overflowEvents - before.overflowEvents);
+    TEST_ASSERT_TRUE(full.flowStateUs[(uint8_t)FlowState::WARNING] > before.flowStateUs[(uint8_t)FlowState::WARNING]);
+    TEST_ASSERT_TRUE(full.flowStateUs[(uint8_t)FlowState::CRITICAL] > before.flowStateUs[(uint8_t)FlowState::CRITICAL]);
+    TEST_ASSERT_TRUE(full.flowStateUs[(uint8_t)FlowState::EMERGENCY] - before.flowStateUs[(uint8_t)FlowState::EMERGENCY] >= 500);
+
+    // Clearing throws away acknowledged bytes and leaves EMERGENCY
+    printerPort.clearBuffer();
+    advanceMicros(500);
+    Counters cleared;
+    printerPort.getCaptureCounters(cleared);
+    TEST_ASSERT_EQUAL_UINT32(capacity, cleared.discarded - full.discarded);
+    TEST_ASSERT_TRUE(cleared.flowStateUs[(uint8_t)FlowState::NORMAL] - full.flowStateUs[(uint8_t)FlowState::NORMAL] >= 500);
+    TEST_ASSERT_UINT32_WITHIN(10, full.flowStateUs[(uint8_t)FlowState::EMERGENCY],
+                              cleared.flowStateUs[(uint8_t)FlowState::EMERGENCY]);
+}
+
+void test_job_signals_split_the_stream()
+{
+    namespace JobBoundary = DeviceBridge::Common::JobBoundary;
+    uint8_t out[64];
+    // Bytes strobed without counting interrupts: Timer3 is sampling the job signals too
+    auto send = [](uint8_t count) {
+        for (uint8_t i = 0; i < count; i++) {
+            drivePin(Pins::LPT_STROBE, LOW);
+            advanceMicros(1);
+            drivePin(Pins::LPT_STROBE, HIGH);
+            advanceMicros(20);
+        }
+    };
+    printerPort.clearBuffer();
+    drivePin(Pins::LPT_INITIALIZE, HIGH);
+    drivePin(Pins::LPT_SELECT_IN, LOW);
+    printerPort.setJobSignals(JobBoundary::SIGNAL_INIT);
+    const uint32_t boundaries0 = printerPort.getJobBoundaryCount();
+
+    // Job A's tail is still in the ring when a 50us /INIT pulse announces job B
+    send(5);
+    drivePin(Pins::LPT_INITIALIZE, LOW);
+    advanceMicros(50);
+    drivePin(Pins::LPT_INITIALIZE, HIGH);
+    advanceMicros(100);
+    send(7);
+    TEST_ASSERT_EQUAL_UINT32(boundaries0 + 1, printerPort.getJobBoundaryCount());
+    TEST_ASSERT_FALSE(printerPort.atJobBoundary());
+
+    // Reads stop at the edge until the boundary is taken
+    TEST_ASSERT_EQUAL_UINT16(3, printerPort.readData(out, 0, 3));
+    TEST_ASSERT_EQUAL_UINT16(2, printerPort.readData(out, 0, sizeof(out)));
+    TEST_ASSERT_TRUE(printerPort.atJobBoundary());
+    TEST_ASSERT_EQUAL_UINT16(0, printerPort.readData(out, 0, sizeof(out)));
+    printerPort.clearJobBoundary();
+    TEST_ASSERT_EQUAL_UINT16(7, printerPort.readData(out, 0, sizeof(out)));
+
+    // /SELECT-IN counts when released, and only when watched
+    drivePin(Pins::LPT_SELECT_IN, HIGH);
+    advanceMicros(100);
+    TEST_ASSERT_EQUAL_UINT32(boundaries0 + 1, printerPort.getJobBoundaryCount());
+    printerPort.setJobSignals(JobBoundary::SIGNAL_INIT | JobBoundary::SIGNAL_SELECT_IN);
+    drivePin(Pins::LPT_SELECT_IN, LOW);
+    advanceMicros(100);
+    TEST_ASSERT_EQUAL_UINT32(boundaries0 + 1, printerPort.getJobBoundaryCount());
+    drivePin(Pins::LPT_SELECT_IN, HIGH);
+    advanceMicros(100);
+    TEST_ASSERT_EQUAL_UINT32(boundaries0 + 2, printerPort.getJobBoundaryCount());
+    TEST_ASSERT_TRUE(printerPort.atJobBoundary()); // empty ring: nothing left before it
+    printerPort.clearJobBoundary();
+
+    // Without the timer the main loop's poll still sees a level held across it
+    printerPort.setJobSignals(0);
+    printerPort.setJobSignals(JobBoundary::SIGNAL_INIT);
+    printerPort.setJobSignals(0);
+    drivePin(Pins::LPT_INITIALIZE, LOW);
+    printerPort.pollJobSignals();
+    TEST_ASSERT_EQUAL_UINT32(boundaries0 + 2, printerPort.getJobBoundaryCount());
+    drivePin(Pins::LPT_INITIALIZE, HIGH);
+}
+
+void test_flow_prediction_follows_overshoot()
+{
+    using Statistics = DeviceBridge::Parallel::HardwareFlowControl::PredictionStatistics;
+    namespace FlowControl = DeviceBridge::Common::FlowControl;
+    printerPort.clearBuffer();
+    printerPort.setHardwareFlowControlEnabled(true);
+    printerPort.setFlowPredictionEnabled(true);
+
+    // 20us per byte, drained every 200us: the ring never reaches BUSY, nothing overshoots, BUSY sits at the top
+    sendFromHost(4096, 20000);
+    Statistics stats = printerPort.getFlowPredictionStatistics();
+    TEST_ASSERT_TRUE(stats.enabled);
+    const uint16_t size = FlowControl::RING_BUFFER_SIZE;
+    TEST_ASSERT_EQUAL_UINT16(0, stats.overshootPeak);
+    TEST_ASSERT_EQUAL_UINT16(size - FlowControl::PREDICT_RESERVE_BYTES, stats.busyLevel);
+    TEST_ASSERT_EQUAL_UINT16(stats.busyLevel - FlowControl::PREDICT_HYSTERESIS_BYTES, stats.recoveryLevel);
+
+    // A host that runs 24 bytes past BUSY moves it down to leave twice that
+    strobe(stats.busyLevel + 24, false);
+    drain();
+    advanceMicros(FlowControl::PREDICT_INTERVAL_MS * 1000UL);
+    printerPort.processPendingOperations();
+    stats = printerPort.getFlowPredictionStatistics();
+    TEST_ASSERT_EQUAL_UINT16(24, stats.overshootPeak);
+    TEST_ASSERT_EQUAL_UINT16(size - 48, stats.busyLevel);
+
+    // Fixed thresholds come back when prediction is turned off
+    printerPort.setFlowPredictionEnabled(false);
+    stats = printerPort.getFlowPredictionStatistics();
+    TEST_ASSERT_FALSE(stats.enabled);
+    TEST_ASSERT_EQUAL_UINT16(FlowControl::PRE_WARNING_THRESHOLD, stats.busyLevel);
+    TEST_ASSERT_EQUAL_UINT16(FlowControl::RECOVERY_THRESHOLD, stats.recoveryLevel);
+    printerPort.setHardwareFlowControlEnabled(false);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_fast_pin_drives_status_lines);
+    RUN_TEST(test_isr_cycles);
+    RUN_TEST(test_flow_control_isr_cost);
+    RUN_TEST(test_pending_operations_never_wait);
+    RUN_TEST(test_burst_capture_adapts_to_traffic);
+    RUN_TEST(test_polled_capture_sessions);
+    RUN_TEST(test_capture_counters_account_for_losses);
+    RUN_TEST(test_job_signals_split_the_stream);
+    RUN_TEST(test_flow_prediction_follows_overshoot);
+    return UNITY_END();
+}
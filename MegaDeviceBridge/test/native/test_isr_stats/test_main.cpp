@@ -0,0 +1,178 @@
+// Optimized /STROBE ISR timing statistics (IsrStats, Timer1 timestamps).
+//
+// Checks the strobe-to-/ACK latency derived from the ISR's own timestamps
+// against the /STROBE and /ACK edges seen on the pins, that the duration
+// histogram agrees with the interrupt time NativeHal charged, and that a
+// strobe dropped on a full buffer counts towards duration only.
+//
+//   pio test -e native_isrstats -v
+
+#include <unity.h>
+#include <Arduino.h>
+#include <stdio.h>
+#include <vector>
+#include "Common/Config.h"
+#include "Parallel/IsrStats.h"
+#include "Parallel/Port.h"
+
+#ifndef DEVICEBRIDGE_ISR_STATS
+#error "test_isr_stats needs -D DEVICEBRIDGE_ISR_STATS (env native_isrstats)"
+#endif
+
+using namespace NativeHal;
+using namespace DeviceBridge::Parallel;
+namespace Pins = DeviceBridge::Common::Pins;
+
+extern DeviceBridge::Parallel::Port printerPort;
+
+namespace {
+
+// TCNT1 reads and the /ACK port write between the stamps and the edges they stand for
+const uint32_t STAMP_SLACK = 8;
+
+class AckRecorder : public Peripheral {
+public:
+    std::vector<uint64_t> falls;
+
+    uint64_t nextEventCycle() const override { return UINT64_MAX; }
+    void onEvent(uint64_t now) override {}
+    void onOutputChange(uint8_t pin, bool level, uint64_t now) override
+    {
+        if (pin == Pins::LPT_ACK && !level) {
+            falls.push_back(now);
+        }
+    }
+};
+
+AckRecorder recorder;
+uint8_t drainBuffer[DeviceBridge::Common::Buffer::RING_BUFFER_SIZE];
+
+void drain() { printerPort.readData(drainBuffer, 0, sizeof(drainBuffer)); }
+
+// Cycle at which /STROBE fell
+uint64_t strobeByte(uint8_t value)
+{
+    const uint8_t pins[8] = {Pins::LPT_D0, Pins::LPT_D1, Pins::LPT_D2, Pins::LPT_D3,
+                             Pins::LPT_D4, Pins::LPT_D5, Pins::LPT_D6, Pins::LPT_D7};
+    for (uint8_t line = 0; line < 8; line++) {
+        drivePin(pins[line], (value >> line) & 0x01);
+    }
+    const uint64_t fell = cycles();
+    drivePin(Pins::LPT_STROBE, LOW);
+    serviceInterrupts(); // take the edge now rather than at the end of the next advance
+    advanceMicros(1);
+    drivePin(Pins::LPT_STROBE, HIGH);
+    advanceMicros(3);
+    return fell;
+}
+
+uint32_t bucketTotal(const IsrStats::Histogram &h)
+{
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < IsrStats::BUCKETS; i++) {
+        total += h.buckets[i];
+    }
+    return total;
+}
+
+} // namespace
+
+void setUp()
+{
+    recorder.falls.clear();
+    printerPort.clearBuffer();
+    IsrStats::reset();
+}
+
+void tearDown() {}
+
+void test_latency_matches_pin_edges()
+{
+    const uint16_t count = 200;
+    uint32_t measuredMin = UINT32_MAX;
+    uint32_t measuredMax = 0;
+    uint64_t isrCycles0 = interruptCycles();
+
+    for (uint16_t i = 0; i < count; i++) {
+        recorder.falls.clear();
+        uint64_t fell = strobeByte((uint8_t)(i * 37));
+        TEST_ASSERT_EQUAL_UINT32(1, recorder.falls.size());
+        uint32_t latency = (uint32_t)(recorder.falls[0] - fell);
+        measuredMin = latency < measuredMin ? latency : measuredMin;
+        measuredMax = latency > measuredMax ? latency : measuredMax;
+        drain();
+    }
+    uint32_t isrCycles = (uint32_t)(interruptCycles() - isrCycles0);
+
+    IsrStats::Statistics stats;
+    IsrStats::snapshot(stats);
+    TEST_ASSERT_EQUAL_UINT32(count, stats.duration.count);
+    TEST_ASSERT_EQUAL_UINT32(count, stats.latency.count);
+    TEST_ASSERT_EQUAL_UINT32(count, bucketTotal(stats.duration));
+    TEST_ASSERT_EQUAL_UINT32(count, bucketTotal(stats.latency));
+
+    // Timestamps agree with the edges on the pins
+    TEST_ASSERT_UINT32_WITHIN(STAMP_SLACK, measuredMin, stats.latency.min);
+    TEST_ASSERT_UINT32_WITHIN(STAMP_SLACK, measuredMax, stats.latency.max);
+
+    // Duration covers the handler; NativeHal also charges the dispatch around it
+    uint32_t handlerCycles = isrCycles - count * costs().interruptDispatch;
+    TEST_ASSERT_UINT32_WITHIN(count * STAMP_SLACK, handlerCycles, stats.duration.sum);
+    TEST_ASSERT_TRUE(stats.duration.min <= stats.duration.sum / count);
+    TEST_ASSERT_TRUE(stats.duration.sum / count <= stats.duration.max);
+
+    // Every sample lands in the bucket holding its own power of two
+    uint8_t minBucket = 0;
+    while ((2U << minBucket) <= stats.latency.min) {
+        minBucket++;
+    }
+    TEST_ASSERT_TRUE(stats.latency.buckets[minBucket] > 0);
+    for (uint8_t i = 0; i < minBucket; i++) {
+        TEST_ASSERT_EQUAL_UINT16(0, stats.latency.buckets[i]);
+    }
+
+    printf("\n=== Optimized ISR timing (%u strobes) ===\n", count);
+    printf("  duration    min %4u  mean %4lu  max %4u cycles\n", stats.duration.min,
+           (unsigned long)(stats.duration.sum / count), stats.duration.max);
+    printf("  strobe->ACK min %4u  mean %4lu  max %4u cycles (pins: %lu..%lu)\n\n", stats.latency.min,
+           (unsigned long)(stats.latency.sum / count), stats.latency.max, (unsigned long)measuredMin,
+           (unsigned long)measuredMax);
+    TEST_ASSERT_TRUE(stats.latency.max <= IsrStats::ACK_LIMIT_US * 16U);
+}
+
+void test_dropped_strobe_counts_duration_only()
+{
+    // Fill the ring without draining; the strobe after that is dropped without /ACK
+    const uint16_t capacity = DeviceBridge::Common::Buffer::RING_BUFFER_SIZE;
+    printerPort.setHardwareFlowControlEnabled(false);
+    for (uint16_t i = 0; i <= capacity; i++) {
+        strobeByte((uint8_t)i);
+    }
+    TEST_ASSERT_EQUAL_UINT16(capacity, printerPort.getBufferSize());
+
+    IsrStats::Statistics stats;
+    IsrStats::snapshot(stats);
+    TEST_ASSERT_EQUAL_UINT32(capacity + 1, stats.duration.count);
+    TEST_ASSERT_EQUAL_UINT32(capacity, stats.latency.count);
+
+    IsrStats::reset();
+    IsrStats::snapshot(stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.duration.count);
+    TEST_ASSERT_EQUAL_UINT32(0, bucketTotal(stats.latency));
+    TEST_ASSERT_EQUAL_UINT16(UINT16_MAX, stats.latency.min);
+}
+
+int main(int argc, char **argv)
+{
+    drivePin(Pins::LPT_STROBE, HIGH);
+    drivePin(Pins::LPT_AUTO_FEED, HIGH);
+    drivePin(Pins::LPT_INITIALIZE, HIGH);
+    drivePin(Pins::LPT_SELECT_IN, HIGH);
+    printerPort.initializeOptimized();
+    attachPeripheral(&recorder);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_latency_matches_pin_edges);
+    RUN_TEST(test_dropped_strobe_counts_duration_only);
+    return UNITY_END();
+}
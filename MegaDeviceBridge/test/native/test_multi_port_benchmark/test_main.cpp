@@ -0,0 +1,367 @@
+// Aggregate capture benchmark for two or three parallel ports.
+//
+// Boots the real firmware built with DEVICEBRIDGE_PARALLEL_PORTS ports and
+// has one simulated TDS2024 per active port replay the sample captures in
+// Images/ at the same time, each starting at a different file. Reports the
+// combined and per-port bytes/s, bytes lost, BUSY duty cycle and how evenly
+// the ports shared the card, so we know how many instruments one Mega can
+// serve. All times are virtual 16MHz AVR cycles.
+//
+// DEVICEBRIDGE_PORTS_ACTIVE sets how many of the built ports have a host
+// attached (default all of them); DEVICEBRIDGE_CAPTURE picks the /STROBE
+// path as in test_capture_benchmark (optimized, hwflow (default) or
+// predictive; the first port also takes burst, polled and timer).
+//
+//   pio test -e native_multiport -v
+//   DEVICEBRIDGE_PORTS_ACTIVE=2 pio test -e native_multiport -v
+
+#include <unity.h>
+#include <Arduino.h>
+#include <SD.h>
+#include <LptHostSimulator.h>
+#include <algorithm>
+#include <dirent.h>
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <strings.h>
+#include <vector>
+#include "Common/Config.h"
+#include "Common/ServiceLocator.h"
+#include "Components/FileSystemManager.h"
+#include "Components/ParallelPortManager.h"
+#include "Parallel/OptimizedTiming.h"
+
+using namespace NativeHal;
+namespace Pins = DeviceBridge::Common::Pins;
+using DeviceBridge::Common::ParallelPorts::COUNT;
+
+namespace {
+
+const uint32_t MAX_VIRTUAL_SECONDS = 1800;
+const uint32_t SETTLE_MS = 4000;   // > KEEP_BUSY_MS so the last files get closed
+
+struct PortWiring {
+    LptHostSimulator::Pins host;
+    uint8_t autoFeed;
+    uint8_t selectIn;
+};
+
+const PortWiring WIRING[] = {
+    {{Pins::LPT_STROBE,
+      {Pins::LPT_D0, Pins::LPT_D1, Pins::LPT_D2, Pins::LPT_D3, Pins::LPT_D4, Pins::LPT_D5, Pins::LPT_D6, Pins::LPT_D7},
+      Pins::LPT_ACK,
+      Pins::LPT_BUSY,
+      Pins::LPT_INITIALIZE},
+     Pins::LPT_AUTO_FEED,
+     Pins::LPT_SELECT_IN},
+    {{Pins::LPT2_STROBE,
+      {Pins::LPT2_D0, Pins::LPT2_D1, Pins::LPT2_D2, Pins::LPT2_D3, Pins::LPT2_D4, Pins::LPT2_D5, Pins::LPT2_D6,
+       Pins::LPT2_D7},
+      Pins::LPT2_ACK,
+      Pins::LPT2_BUSY,
+      Pins::LPT2_INITIALIZE},
+     Pins::LPT2_AUTO_FEED,
+     Pins::LPT2_SELECT_IN},
+    {{Pins::LPT3_STROBE,
+      {Pins::LPT3_D0, Pins::LPT3_D1, Pins::LPT3_D2, Pins::LPT3_D3, Pins::LPT3_D4, Pins::LPT3_D5, Pins::LPT3_D6,
+       Pins::LPT3_D7},
+      Pins::LPT3_ACK,
+      Pins::LPT3_BUSY,
+      Pins::LPT3_INITIALIZE},
+     Pins::LPT3_AUTO_FEED,
+     Pins::LPT3_SELECT_IN},
+};
+
+struct Job {
+    std::string name;
+    std::vector<uint8_t> bytes;
+};
+
+std::string imagesDirectory()
+{
+    const char *env = getenv("DEVICEBRIDGE_IMAGES");
+    return env ? env : "../Images";
+}
+
+std::vector<Job> loadJobs(const std::string &dir)
+{
+    std::vector<Job> out;
+    DIR *d = opendir(dir.c_str());
+    if (!d) {
+        return out;
+    }
+    while (struct dirent *entry = readdir(d)) {
+        std::string name = entry->d_name;
+        if (name[0] == '.') {
+            continue;
+        }
+        FILE *f = fopen((dir + "/" + name).c_str(), "rb");
+        if (!f) {
+            continue;
+        }
+        Job job;
+        job.name = name;
+        int c;
+        while ((c = fgetc(f)) != EOF) {
+            job.bytes.push_back((uint8_t)c);
+        }
+        fclose(f);
+        if (!job.bytes.empty()) {
+            out.push_back(job);
+        }
+    }
+    closedir(d);
+    std::sort(out.begin(), out.end(), [](const Job &a, const Job &b) { return a.name < b.name; });
+    return out;
+}
+
+const char *captureMode()
+{
+    const char *env = getenv("DEVICEBRIDGE_CAPTURE");
+    return env ? env : "hwflow";
+}
+
+uint8_t activePorts()
+{
+    const char *env = getenv("DEVICEBRIDGE_PORTS_ACTIVE");
+    unsigned long ports = env && *env ? strtoul(env, nullptr, 10) : COUNT;
+    return (uint8_t)std::max(1UL, std::min(ports, (unsigned long)COUNT));
+}
+
+bool selectCaptureMode(DeviceBridge::Components::ParallelPortManager &manager, const std::string &mode)
+{
+    if (mode == "legacy") {
+        return true;
+    }
+    if (mode == "optimized") {
+        DeviceBridge::Parallel::OptimizedTiming::initialize();
+        return true;
+    }
+    if (mode == "burst") {
+        return manager.setBurstCaptureEnabled(true);
+    }
+    if (mode == "polled") {
+        return manager.setPolledCaptureEnabled(true);
+    }
+    if (mode == "timer") {
+        return manager.setTimedAcknowledgeEnabled(true, DeviceBridge::Common::Timing::ACK_TIMER_PULSE_US);
+    }
+    if (mode == "hwflow" || mode == "predictive") {
+        DeviceBridge::Parallel::OptimizedTiming::initialize();
+        manager.setHardwareFlowControlEnabled(true);
+        manager.setFlowPredictionEnabled(mode == "predictive");
+        return true;
+    }
+    return false;
+}
+
+bool isCaptureRecord(const SdNode &node)
+{
+    const std::string ext = ".CAP";
+    return node.path.size() > ext.size() && node.path.compare(node.path.size() - ext.size(), ext.size(), ext) == 0;
+}
+
+std::string recordText(const SdNode &record, const char *key)
+{
+    std::string text(record.data.begin(), record.data.end());
+    size_t at = text.find(std::string(key) + "=");
+    if (at == std::string::npos) {
+        return "";
+    }
+    at += strlen(key) + 1;
+    return text.substr(at, text.find_first_of("\r\n", at) - at);
+}
+
+/** Data file a capture record describes */
+const SdNode *recordedFile(const SdNode &record, const std::vector<const SdNode *> &files)
+{
+    const std::string path = recordText(record, "file");
+    for (const SdNode *file : files) {
+        if (strcasecmp(file->path.c_str(), path.c_str()) == 0) {
+            return file;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_multi_port_benchmark()
+{
+    std::vector<Job> jobs = loadJobs(imagesDirectory());
+    if (jobs.empty()) {
+        TEST_IGNORE_MESSAGE("No sample captures found (set DEVICEBRIDGE_IMAGES)");
+    }
+    const uint8_t ports = activePorts();
+
+    // Card inserted, not write protected; hosts hold their control lines inactive
+    drivePin(Pins::SD_CD, LOW);
+    drivePin(Pins::SD_WP, LOW);
+    for (uint8_t port = 0; port < COUNT; port++) {
+        for (uint8_t pin : {WIRING[port].autoFeed, WIRING[port].host.init, WIRING[port].selectIn}) {
+            if (pin != Pins::NOT_WIRED) {
+                drivePin(pin, HIGH);
+            }
+        }
+    }
+
+    // Each host starts at a different sample so unlike formats overlap on the card
+    std::vector<std::unique_ptr<LptHostSimulator>> hosts;
+    for (uint8_t port = 0; port < ports; port++) {
+        hosts.emplace_back(new LptHostSimulator(WIRING[port].host, LptHostSimulator::Timing()));
+        for (size_t i = 0; i < jobs.size(); i++) {
+            hosts.back()->addJob(jobs[(i + port * 2) % jobs.size()].bytes);
+        }
+    }
+
+    setup();
+    DeviceBridge::ServiceLocator &services = DeviceBridge::ServiceLocator::getInstance();
+    for (uint8_t port = 0; port < COUNT; port++) {
+        TEST_ASSERT_NOT_NULL(services.getParallelPortManager(port));
+        TEST_ASSERT_TRUE_MESSAGE(selectCaptureMode(*services.getParallelPortManager(port), captureMode()),
+                                 "DEVICEBRIDGE_CAPTURE mode not available on every port");
+    }
+
+    std::vector<uint64_t> busyHighAtStart;
+    for (uint8_t port = 0; port < ports; port++) {
+        attachPeripheral(hosts[port].get());
+        hosts[port]->start(cycles() + microsToCycles(1000 + port * 137));
+        busyHighAtStart.push_back(pinHighCycles(WIRING[port].host.busy));
+    }
+
+    auto allFinished = [&]() {
+        for (const auto &host : hosts) {
+            if (!host->finished()) {
+                return false;
+            }
+        }
+        return true;
+    };
+    const uint64_t limit = (uint64_t)MAX_VIRTUAL_SECONDS * CPU_HZ;
+    while (!allFinished() && cycles() < limit) {
+        loop();
+    }
+    const uint64_t captureEnd = cycles();
+    while (cycles() < captureEnd + (uint64_t)SETTLE_MS * (CPU_HZ / 1000)) {
+        loop();
+    }
+    for (const auto &host : hosts) {
+        detachPeripheral(host.get());
+    }
+    TEST_ASSERT_TRUE_MESSAGE(allFinished(), "Hosts did not finish sending within the time limit");
+
+    std::vector<const SdNode *> files;
+    std::vector<const SdNode *> records;
+    for (const SdNode *node : sdFiles()) {
+        if (node->path != DeviceBridge::Common::Commit::JOURNAL_NAME &&
+            node->path != DeviceBridge::Common::Catalog::FILE_NAME) {
+            (isCaptureRecord(*node) ? records : files).push_back(node);
+        }
+    }
+
+    // A job counts as stored intact when some file not yet matched holds exactly its bytes
+    std::vector<bool> matched(files.size(), false);
+    auto storeIntact = [&](const std::vector<uint8_t> &sent) {
+        for (size_t i = 0; i < files.size(); i++) {
+            if (!matched[i] && files[i]->data == sent) {
+                matched[i] = true;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    uint64_t firstStrobe = UINT64_MAX;
+    uint64_t lastStrobe = 0;
+    uint64_t totalSent = 0;
+    uint32_t totalIntact = 0;
+    uint32_t totalJobs = 0;
+    double minRate = 0;
+    double maxRate = 0;
+    double rateSum = 0;
+    double rateSquares = 0;
+
+    printf("\n=== Multi-port benchmark (%u of %u ports, %u jobs each, %s capture, %u byte chunks) ===\n",
+           (unsigned)ports, (unsigned)COUNT, (unsigned)jobs.size(), captureMode(),
+           (unsigned)DeviceBridge::Common::Buffer::DATA_CHUNK_SIZE);
+    for (uint8_t port = 0; port < ports; port++) {
+        const LptHostSimulator &host = *hosts[port];
+        const LptHostSimulator::Stats &hs = host.stats();
+        auto *manager = services.getParallelPortManager(port);
+
+        uint64_t activeCycles = 0;
+        uint32_t intact = 0;
+        for (size_t i = 0; i < host.jobCount(); i++) {
+            activeCycles += host.jobEndCycle(i) - host.strobeCycle(i, 0);
+            intact += storeIntact(host.job(i)) ? 1 : 0;
+        }
+        const double rate = activeCycles ? hs.bytesSent / cyclesToSeconds(activeCycles) : 0;
+        const double busyDuty =
+            activeCycles
+                ? (double)(pinHighCycles(WIRING[port].host.busy) - busyHighAtStart[port]) / (double)activeCycles
+                : 0;
+        auto queue = manager->getChunkQueueStatistics();
+
+        printf("  LPT%u: %7.0f bytes/s, %u bytes, %u/%u files intact, BUSY %.1f%%, stalled %.1f ms, "
+               "%u ACK / %u BUSY timeouts, %u chunks (queue high-water %u, full %u ms)\n",
+               port + 1, rate, (unsigned)hs.bytesSent, (unsigned)intact, (unsigned)host.jobCount(), busyDuty * 100.0,
+               cyclesToSeconds(hs.busyWaitCycles) * 1000.0, hs.ackTimeouts, hs.busyTimeouts,
+               (unsigned)queue.chunksQueued, queue.highWater, (unsigned)queue.timeFullMs);
+
+        firstStrobe = std::min(firstStrobe, (uint64_t)hs.firstStrobeCycle);
+        lastStrobe = std::max(lastStrobe, (uint64_t)hs.lastStrobeCycle);
+        totalSent += hs.bytesSent;
+        totalIntact += intact;
+        totalJobs += (uint32_t)host.jobCount();
+        minRate = port == 0 ? rate : std::min(minRate, rate);
+        maxRate = std::max(maxRate, rate);
+        rateSum += rate;
+        rateSquares += rate * rate;
+    }
+
+    const double wallSeconds = lastStrobe > firstStrobe ? cyclesToSeconds(lastStrobe - firstStrobe) : 0;
+    const double jain = rateSquares > 0 ? rateSum * rateSum / (ports * rateSquares) : 0;
+    auto *fileSystem = services.getFileSystemManager();
+    const SdStats &sd = sdStats();
+    printf("  Aggregate            : %.0f bytes/s (%llu bytes in %.1f s of overlapping transfers)\n",
+           wallSeconds > 0 ? totalSent / wallSeconds : 0, (unsigned long long)totalSent, wallSeconds);
+    printf("  Files intact         : %u of %u (%u stored)\n", (unsigned)totalIntact, (unsigned)totalJobs,
+           (unsigned)files.size());
+    printf("  Fairness             : slowest port %.0f%% of fastest, Jain index %.3f, %u storage turns yielded\n",
+           maxRate > 0 ? minRate * 100.0 / maxRate : 0, jain, (unsigned)fileSystem->getStorageYields());
+    printf("  SD traffic           : %u data + %u metadata sector writes, %u reads, %u flushes\n",
+           sd.dataSectorWrites, sd.metadataSectorWrites, sd.sectorReads, sd.flushes);
+    printf("  Interrupts serviced  : %u, %.1f ms in ISRs\n\n", interruptsServiced(),
+           cyclesToSeconds(interruptCycles()) * 1000.0);
+
+    TEST_ASSERT_GREATER_THAN(0, files.size());
+
+    // Every stored file has its record, and a record claims lossless exactly for a file some host sent intact
+    TEST_ASSERT_EQUAL_UINT32(files.size(), records.size());
+    for (const SdNode *record : records) {
+        const SdNode *file = recordedFile(*record, files);
+        TEST_ASSERT_TRUE_MESSAGE(file != nullptr, record->path.c_str());
+        bool sent = false;
+        for (const Job &job : jobs) {
+            sent = sent || file->data == job.bytes;
+        }
+        TEST_ASSERT_EQUAL_MESSAGE(sent, recordText(*record, "lossless") == "yes", file->path.c_str());
+        if (sent) {
+            TEST_ASSERT_EQUAL_UINT32(file->data.size(), strtoul(recordText(*record, "captured").c_str(), nullptr, 10));
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    setSerialEcho(getenv("DEVICEBRIDGE_ECHO") != nullptr);
+    UNITY_BEGIN();
+    RUN_TEST(test_multi_port_benchmark);
+    return UNITY_END();
+}
@@ -0,0 +1,376 @@
+// Contiguous SD capture files (Storage::ContiguousFile) against the NativeHal card.
+//
+// Writes captures in the odd-sized chunks the chunk queue hands out and checks
+// the file on the card byte for byte after close: size truncated to the data,
+// nothing lost across an SD library call in the middle of a block, two files
+// sharing the block cache, and a file that outgrows its extent. While data is
+// streaming no FAT or directory sector may be written. Sustained rate and the
+// worst chunk are compared with the File write+flush path the capture used
+// before, on the same simulated card. After a simulated power cut the commit
+// journal has to bring every open file back to its last commit. A card that
+// programs a streamed block in the background shows it in isCardBusy(); a
+// block sent after that costs only its transfer, one sent during it waits.
+//
+//   pio test -e native -f native/test_sd_stream -v
+
+#include <unity.h>
+#include <Arduino.h>
+#include <NativeHal.h>
+#include <SD.h>
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "Common/Config.h"
+#include "Storage/CommitJournal.h"
+#include "Storage/ContiguousFile.h"
+
+using namespace NativeHal;
+using DeviceBridge::Storage::CommitJournal;
+using DeviceBridge::Storage::ContiguousFile;
+namespace Pins = DeviceBridge::Common::Pins;
+using Bytes = std::vector<uint8_t>;
+
+namespace {
+
+const size_t CHUNK_SIZES[] = {512, 77, 1024, 333, 4096, 1, 511, 2048};
+
+struct Run {
+    double bytesPerSecond;
+    double maxChunkUs;
+};
+
+Bytes makeData(size_t size, uint8_t seed)
+{
+    Bytes out(size);
+    for (size_t i = 0; i < size; i++) {
+        out[i] = (uint8_t)(i * 7 + seed + (i >> 9));
+    }
+    return out;
+}
+
+/** Boot with the card as it is; returns the files the journal cut back */
+uint8_t remountCard()
+{
+    TEST_ASSERT_TRUE(SD.begin(Pins::SD_CS));
+    TEST_ASSERT_TRUE(ContiguousFile::begin());
+    const uint8_t recovered = CommitJournal::mount();
+    TEST_ASSERT_TRUE(CommitJournal::isReady());
+    return recovered;
+}
+
+void mountCard()
+{
+    sdReset();
+    TEST_ASSERT_EQUAL_UINT8(0, remountCard());
+    TEST_ASSERT_TRUE(SD.mkdir("/20250101"));
+}
+
+CommitJournal::Entry entry(const char *path, uint32_t size)
+{
+    CommitJournal::Entry out = {};
+    out.size = size;
+    out.reserved = DeviceBridge::Common::FileSystem::EXTENT_BYTES;
+    strncpy(out.path, path, sizeof(out.path) - 1);
+    return out;
+}
+
+void writeAll(ContiguousFile &file, const Bytes &data, size_t from, size_t to)
+{
+    for (size_t at = from; at < to; at += 333) {
+        const size_t length = std::min<size_t>(333, to - at);
+        TEST_ASSERT_EQUAL_UINT32(length, file.write(&data[at], length));
+    }
+}
+
+void assertStored(const char *path, const Bytes &expected)
+{
+    const SdNode *node = sdFind(path);
+    TEST_ASSERT_TRUE_MESSAGE(node != nullptr, path);
+    TEST_ASSERT_EQUAL_UINT32(expected.size(), node->data.size());
+    TEST_ASSERT_TRUE_MESSAGE(node->data == expected, "stored bytes differ");
+}
+
+/** Writes `data` in fixed chunks through `write`, timing each call on the virtual clock */
+template <typename Write> Run timeChunks(const Bytes &data, size_t chunk, Write write)
+{
+    const uint64_t start = cycles();
+    uint64_t worst = 0;
+    for (size_t at = 0; at < data.size(); at += chunk) {
+        const size_t length = std::min(chunk, data.size() - at);
+        const uint64_t before = cycles();
+        TEST_ASSERT_EQUAL_UINT32(length, write(&data[at], length));
+        worst = std::max(worst, cycles() - before);
+    }
+    const double seconds = (double)(cycles() - start) / CPU_HZ;
+    return {data.size() / seconds, (double)worst / CYCLES_PER_US};
+}
+
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_odd_chunks_round_trip()
+{
+    mountCard();
+    const Bytes data = makeData(100000, 3);
+    ContiguousFile file;
+    TEST_ASSERT_TRUE(file.create("/20250101/120000.bin"));
+
+    size_t at = 0;
+    for (size_t i = 0; at < data.size(); i++) {
+        const size_t length = std::min(CHUNK_SIZES[i % 8], data.size() - at);
+        TEST_ASSERT_EQUAL_UINT32(length, file.write(&data[at], length));
+        at += length;
+        if (i == 5) {
+            // A directory listing in the middle of a partial block
+            TEST_ASSERT_TRUE(ContiguousFile::endStream());
+            TEST_ASSERT_TRUE(SD.exists("/20250101"));
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(data.size(), file.size());
+    TEST_ASSERT_TRUE(file.close());
+    TEST_ASSERT_FALSE(file.isOpen());
+    assertStored("/20250101/120000.bin", data);
+}
+
+void test_no_metadata_writes_while_streaming()
+{
+    mountCard();
+    const Bytes data = makeData(200000, 9);
+    ContiguousFile file;
+    TEST_ASSERT_TRUE(file.create("/20250101/120001.bin"));
+
+    const SdStats before = sdStats();
+    for (size_t at = 0; at < data.size(); at += 333) {
+        const size_t length = std::min<size_t>(333, data.size() - at);
+        TEST_ASSERT_EQUAL_UINT32(length, file.write(&data[at], length));
+    }
+    const SdStats &after = sdStats();
+    TEST_ASSERT_EQUAL_UINT32(before.metadataSectorWrites, after.metadataSectorWrites);
+    TEST_ASSERT_EQUAL_UINT32(before.sectorReads, after.sectorReads);
+    TEST_ASSERT_EQUAL_UINT32(before.streams + 1, after.streams);
+    TEST_ASSERT_EQUAL_UINT32(data.size() / 512, after.streamedBlocks - before.streamedBlocks);
+
+    TEST_ASSERT_TRUE(file.close());
+    assertStored("/20250101/120001.bin", data);
+}
+
+void test_two_files_share_the_cache()
+{
+    mountCard();
+    const Bytes first = makeData(30000, 1);
+    const Bytes second = makeData(45000, 2);
+    ContiguousFile a, b;
+    TEST_ASSERT_TRUE(a.create("/20250101/lpt1.bin"));
+    TEST_ASSERT_TRUE(b.create("/20250101/lpt2.bin"));
+
+    // Alternating chunks, as two ports' queues drain
+    size_t atA = 0, atB = 0;
+    for (size_t i = 0; atA < first.size() || atB < second.size(); i++) {
+        const size_t length = CHUNK_SIZES[i % 8];
+        if (atA < first.size()) {
+            const size_t n = std::min(length, first.size() - atA);
+            TEST_ASSERT_EQUAL_UINT32(n, a.write(&first[atA], n));
+            atA += n;
+        }
+        if (atB < second.size()) {
+            const size_t n = std::min(length, second.size() - atB);
+            TEST_ASSERT_EQUAL_UINT32(n, b.write(&second[atB], n));
+            atB += n;
+        }
+    }
+    TEST_ASSERT_TRUE(a.close());
+    TEST_ASSERT_TRUE(b.close());
+    assertStored("/20250101/lpt1.bin", first);
+    assertStored("/20250101/lpt2.bin", second);
+}
+
+void test_extent_overflow_continues_in_fat_chain()
+{
+    mountCard();
+    const uint32_t extent = 512UL * sdTiming().blocksPerCluster; // one cluster
+    const Bytes data = makeData(extent + 10000, 5);
+    ContiguousFile file;
+    TEST_ASSERT_TRUE(file.create("/20250101/120002.bin", extent));
+    for (size_t at = 0; at < data.size(); at += 1000) {
+        const size_t length = std::min<size_t>(1000, data.size() - at);
+        TEST_ASSERT_EQUAL_UINT32(length, file.write(&data[at], length));
+    }
+    TEST_ASSERT_TRUE(file.close());
+    assertStored("/20250101/120002.bin", data);
+}
+
+void test_create_refuses_existing_name()
+{
+    mountCard();
+    File existing = SD.open("/20250101/120003.bin", FILE_WRITE);
+    TEST_ASSERT_TRUE(existing);
+    existing.write((const uint8_t *)"abc", 3);
+    existing.close();
+
+    ContiguousFile file;
+    TEST_ASSERT_FALSE(file.create("/20250101/120003.bin"));
+    TEST_ASSERT_FALSE(file.isOpen());
+    TEST_ASSERT_EQUAL_UINT32(3, sdFind("/20250101/120003.bin")->data.size());
+}
+
+void test_power_loss_cuts_back_to_last_commit()
+{
+    mountCard();
+    const Bytes stream = makeData(60000, 4);
+    const Bytes library = makeData(25000, 6);
+    const Bytes closed = makeData(7000, 8);
+
+    // As FileSystemManager does it: extents named at 0 before create, the library's file not at all
+    CommitJournal::Entry entries[2] = {entry("20250101/stream.bin", 0), entry("20250101/closed.bin", 0)};
+    TEST_ASSERT_TRUE(CommitJournal::record(entries, 2));
+    ContiguousFile contiguous, done;
+    TEST_ASSERT_TRUE(contiguous.create("/20250101/stream.bin"));
+    TEST_ASSERT_TRUE(done.create("/20250101/closed.bin"));
+    File file = SD.open("/20250101/library.bin", FILE_WRITE);
+    TEST_ASSERT_TRUE(file);
+
+    writeAll(done, closed, 0, closed.size());
+    writeAll(contiguous, stream, 0, 40000);
+    TEST_ASSERT_TRUE(ContiguousFile::endStream());
+    file.write(library.data(), 20000);
+    file.flush();
+    entries[0].size = 40000;
+    TEST_ASSERT_TRUE(CommitJournal::record(entries, 2));
+    // Closed with its entry still at 0: the real size in the directory entry marks it finished
+    TEST_ASSERT_TRUE(done.close());
+
+    // Written after the commit, then the power goes
+    writeAll(contiguous, stream, 40000, stream.size());
+    TEST_ASSERT_TRUE(ContiguousFile::endStream());
+    file.write(library.data() + 20000, library.size() - 20000);
+    sdPowerLoss();
+    ContiguousFile::end();
+
+    TEST_ASSERT_EQUAL_UINT32(DeviceBridge::Common::FileSystem::EXTENT_BYTES,
+                             sdFind("/20250101/stream.bin")->data.size());
+    TEST_ASSERT_EQUAL_UINT8(1, remountCard());
+    assertStored("/20250101/stream.bin", Bytes(stream.begin(), stream.begin() + 40000));
+    assertStored("/20250101/library.bin", Bytes(library.begin(), library.begin() + 20000));
+    assertStored("/20250101/closed.bin", closed);
+
+    // The journal was emptied: a second boot changes nothing
+    TEST_ASSERT_EQUAL_UINT8(0, remountCard());
+    assertStored("/20250101/stream.bin", Bytes(stream.begin(), stream.begin() + 40000));
+}
+
+void test_torn_journal_is_ignored()
+{
+    mountCard();
+    const Bytes data = makeData(5000, 7);
+    const CommitJournal::Entry named = entry("20250101/torn.bin", 0);
+    TEST_ASSERT_TRUE(CommitJournal::record(&named, 1));
+    ContiguousFile file;
+    TEST_ASSERT_TRUE(file.create("/20250101/torn.bin"));
+    writeAll(file, data, 0, data.size());
+    TEST_ASSERT_TRUE(ContiguousFile::endStream());
+
+    // A half-written journal block no longer matches its checksum
+    SdNode *journal = const_cast<SdNode *>(sdFind(DeviceBridge::Common::Commit::JOURNAL_NAME));
+    TEST_ASSERT_TRUE(journal != nullptr);
+    journal->data[12] ^= 0x40;
+    sdPowerLoss();
+    ContiguousFile::end();
+    TEST_ASSERT_EQUAL_UINT8(0, remountCard());
+    const SdNode *torn = sdFind("/20250101/torn.bin");
+    TEST_ASSERT_EQUAL_UINT32(DeviceBridge::Common::FileSystem::EXTENT_BYTES, torn->data.size());
+    TEST_ASSERT_EQUAL_MEMORY(data.data(), torn->data.data(), data.size());
+}
+
+void test_bandwidth_and_chunk_latency()
+{
+    const SdTiming &timing = sdTiming();
+    const Bytes data = makeData(DeviceBridge::Common::FileSystem::EXTENT_BYTES, 0);
+    const size_t chunk = 512;
+
+    // Before: File::write + flush per chunk, as FileSystemManager::writeDataChunk did
+    mountCard();
+    File legacy = SD.open("/20250101/legacy.bin", FILE_WRITE);
+    TEST_ASSERT_TRUE(legacy);
+    const Run before = timeChunks(data, chunk, [&](const uint8_t *bytes, size_t length) {
+        const size_t written = legacy.write(bytes, length);
+        legacy.flush();
+        return written;
+    });
+    legacy.close();
+    assertStored("/20250101/legacy.bin", data);
+    const SdStats legacyStats = sdStats();
+
+    mountCard();
+    ContiguousFile file;
+    TEST_ASSERT_TRUE(file.create("/20250101/stream.bin"));
+    const Run after =
+        timeChunks(data, chunk, [&](const uint8_t *bytes, size_t length) { return file.write(bytes, length); });
+    TEST_ASSERT_TRUE(file.close());
+    assertStored("/20250101/stream.bin", data);
+    const SdStats &streamStats = sdStats();
+
+    const double rawRate = 512.0 * 1000000.0 / timing.streamBlockUs;
+    printf("  write+flush : %7.0f bytes/s, worst chunk %6.0f us, %u data + %u metadata writes, %u reads\n",
+           before.bytesPerSecond, before.maxChunkUs, legacyStats.dataSectorWrites, legacyStats.metadataSectorWrites,
+           legacyStats.sectorReads);
+    printf("  contiguous  : %7.0f bytes/s, worst chunk %6.0f us, %u data + %u metadata writes, %u reads\n",
+           after.bytesPerSecond, after.maxChunkUs, streamStats.dataSectorWrites, streamStats.metadataSectorWrites,
+           streamStats.sectorReads);
+    printf("  card rate   : %7.0f bytes/s inside one multi-block write\n", rawRate);
+
+    // Near the card's streaming rate, and no chunk waits on more than the stream start and one block
+    TEST_ASSERT_TRUE_MESSAGE(after.bytesPerSecond > 0.95 * rawRate, "below the multi-block rate");
+    TEST_ASSERT_TRUE_MESSAGE(after.maxChunkUs <= 2 * timing.commandUs + timing.streamBlockUs + 10,
+                             "chunk latency not bounded by one block");
+    TEST_ASSERT_TRUE(after.bytesPerSecond > 2 * before.bytesPerSecond);
+}
+
+void test_card_programs_in_background()
+{
+    const SdTiming timing = sdTiming();
+    const Bytes data = makeData(3 * 512, 0);
+    mountCard();
+    ContiguousFile file;
+    TEST_ASSERT_TRUE(file.create("/20250101/busy.bin"));
+    TEST_ASSERT_FALSE(ContiguousFile::isCardBusy());
+
+    sdTiming().spikeEvery = 1;
+    sdTiming().spikeUs = 3000;
+    TEST_ASSERT_EQUAL_UINT32(512, file.write(&data[0], 512));
+    TEST_ASSERT_TRUE(ContiguousFile::isCardBusy());
+
+    // Programming done while the caller did other work: the next block is only its transfer
+    advanceMicros(3000);
+    TEST_ASSERT_FALSE(ContiguousFile::isCardBusy());
+    uint64_t before = cycles();
+    TEST_ASSERT_EQUAL_UINT32(512, file.write(&data[512], 512));
+    TEST_ASSERT_TRUE(cycles() - before <= microsToCycles(timing.streamBlockUs + 10));
+
+    // Sent straight away, the block waits in the SD library for the one before it
+    before = cycles();
+    TEST_ASSERT_EQUAL_UINT32(512, file.write(&data[1024], 512));
+    TEST_ASSERT_TRUE(cycles() - before >= microsToCycles(timing.streamBlockUs + 3000));
+
+    sdTiming() = timing;
+    TEST_ASSERT_TRUE(file.close());
+    TEST_ASSERT_FALSE(ContiguousFile::isCardBusy());
+    assertStored("/20250101/busy.bin", data);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_odd_chunks_round_trip);
+    RUN_TEST(test_no_metadata_writes_while_streaming);
+    RUN_TEST(test_two_files_share_the_cache);
+    RUN_TEST(test_extent_overflow_continues_in_fat_chain);
+    RUN_TEST(test_create_refuses_existing_name);
+    RUN_TEST(test_power_loss_cuts_back_to_last_commit);
+    RUN_TEST(test_torn_journal_is_ignored);
+    RUN_TEST(test_bandwidth_and_chunk_latency);
+    RUN_TEST(test_card_programs_in_background);
+    return UNITY_END();
+}
@@ -0,0 +1,262 @@
+// Shared SPI bus (Storage::SpiBus) with the W25Q128 flash and the SD card.
+//
+// Runs W25Q128Manager against the NativeHal flash model: data erased,
+// programmed and read back has to match at the flash's own 8MHz clock, with
+// no command sent into a program or erase. Flash traffic between the blocks
+// of an open multi-block SD write must leave the card's file intact and its
+// stream open. Reading and programming 4KB is timed against the driver as it
+// was (digitalWrite chip select plus 1us, one byte per call, at the 4MHz the
+// SD library leaves behind), and the bus statistics have to account for the
+// time the flash held the bus.
+//
+//   pio test -e native -f native/test_spi_bus -v
+
+#include <unity.h>
+#include <Arduino.h>
+#include <NativeHal.h>
+#include <SD.h>
+#include <SPI.h>
+#include <SpiFlash.h>
+#include <stdio.h>
+#include <vector>
+#include "Common/Config.h"
+#include "Components/W25Q128Manager.h"
+#include "Storage/ContiguousFile.h"
+#include "Storage/SpiBus.h"
+
+using namespace NativeHal;
+using DeviceBridge::Components::W25Q128Manager;
+using DeviceBridge::Storage::ContiguousFile;
+using DeviceBridge::Storage::SpiBus;
+namespace Pins = DeviceBridge::Common::Pins;
+using Bytes = std::vector<uint8_t>;
+
+namespace {
+
+constexpr uint32_t SECTOR = 4096;
+constexpr uint32_t PAGE = 256;
+
+Bytes makeData(size_t size, uint8_t seed)
+{
+    Bytes out(size);
+    for (size_t i = 0; i < size; i++) {
+        out[i] = (uint8_t)(i * 13 + seed + (i >> 8));
+    }
+    return out;
+}
+
+/** Fresh board with the flash on EEPROM_CS, its driver initialized */
+void boot(SpiFlash &flash, W25Q128Manager &manager)
+{
+    reset();
+    attachSpiDevice(&flash);
+    SpiBus::begin();
+    TEST_ASSERT_TRUE(manager.initialize());
+}
+
+void programSector(W25Q128Manager &manager, uint32_t address, const Bytes &data)
+{
+    TEST_ASSERT_TRUE(manager.eraseSector(address));
+    for (uint32_t page = 0; page < SECTOR; page += PAGE) {
+        TEST_ASSERT_TRUE(manager.writePage(address + page, &data[page], PAGE));
+    }
+}
+
+// The driver before the bus arbiter: no transaction of its own, so the SD library's rate
+void legacySelect(bool select)
+{
+    digitalWrite(Pins::EEPROM_CS, select ? LOW : HIGH);
+    if (select) {
+        delayMicroseconds(1);
+    }
+}
+
+uint8_t legacyStatus()
+{
+    legacySelect(true);
+    SPI.transfer(0x05);
+    const uint8_t status = SPI.transfer(0x00);
+    legacySelect(false);
+    return status;
+}
+
+void legacyWaitForReady()
+{
+    while (legacyStatus() & 0x01) {
+        delay(1);
+    }
+}
+
+void legacyRead(uint32_t address, uint8_t *buffer, uint32_t length)
+{
+    legacyWaitForReady();
+    legacySelect(true);
+    SPI.transfer(0x03);
+    SPI.transfer((address >> 16) & 0xFF);
+    SPI.transfer((address >> 8) & 0xFF);
+    SPI.transfer(address & 0xFF);
+    for (uint32_t i = 0; i < length; i++) {
+        buffer[i] = SPI.transfer(0x00);
+    }
+    legacySelect(false);
+}
+
+void legacyWritePage(uint32_t address, const uint8_t *buffer, uint32_t length)
+{
+    legacyWaitForReady();
+    legacySelect(true);
+    SPI.transfer(0x06);
+    legacySelect(false);
+    legacyStatus();
+    legacySelect(true);
+    SPI.transfer(0x02);
+    SPI.transfer((address >> 16) & 0xFF);
+    SPI.transfer((address >> 8) & 0xFF);
+    SPI.transfer(address & 0xFF);
+    for (uint32_t i = 0; i < length; i++) {
+        SPI.transfer(buffer[i]);
+    }
+    legacySelect(false);
+    legacyWaitForReady();
+    legacyStatus();
+}
+
+double elapsedUs(uint64_t since) { return (double)(cycles() - since) / CYCLES_PER_US; }
+
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_flash_round_trip_at_full_clock()
+{
+    SpiFlash flash(Pins::EEPROM_CS);
+    W25Q128Manager manager(Pins::EEPROM_CS);
+    boot(flash, manager);
+
+    const Bytes data = makeData(SECTOR, 1);
+    programSector(manager, 3 * SECTOR, data);
+    Bytes readBack(SECTOR);
+    TEST_ASSERT_TRUE(manager.readData(3 * SECTOR, readBack.data(), SECTOR));
+    TEST_ASSERT_TRUE(readBack == data);
+    TEST_ASSERT_TRUE(Bytes(flash.data() + 3 * SECTOR, flash.data() + 4 * SECTOR) == data);
+
+    // Unaligned read across pages, and the rest of the chip untouched
+    TEST_ASSERT_TRUE(manager.readData(3 * SECTOR + 100, readBack.data(), 700));
+    TEST_ASSERT_TRUE(Bytes(readBack.begin(), readBack.begin() + 700) == Bytes(data.begin() + 100, data.begin() + 800));
+    TEST_ASSERT_EQUAL_UINT8(0xFF, flash.data()[2 * SECTOR]);
+    TEST_ASSERT_EQUAL_UINT8(0xFF, flash.data()[4 * SECTOR]);
+
+    TEST_ASSERT_EQUAL_UINT32(DeviceBridge::Common::Spi::FLASH_CLOCK_HZ, flash.stats().maxClockHz);
+    TEST_ASSERT_EQUAL_UINT32(0, flash.stats().ignoredWhileBusy);
+    TEST_ASSERT_EQUAL_UINT32(SECTOR / PAGE, flash.stats().pagesProgrammed);
+    TEST_ASSERT_TRUE(readPin(Pins::EEPROM_CS));
+    detachSpiDevice(&flash);
+}
+
+void test_flash_between_sd_blocks_leaves_card_alone()
+{
+    SpiFlash flash(Pins::EEPROM_CS);
+    W25Q128Manager manager(Pins::EEPROM_CS);
+    boot(flash, manager);
+    TEST_ASSERT_TRUE(SD.begin(Pins::SD_CS));
+    TEST_ASSERT_TRUE(ContiguousFile::begin());
+    TEST_ASSERT_TRUE(SD.mkdir("/20250101"));
+
+    const Bytes capture = makeData(16 * 1024, 2);
+    const Bytes flashData = makeData(SECTOR, 3);
+    TEST_ASSERT_TRUE(manager.eraseSector(0));
+
+    ContiguousFile file;
+    TEST_ASSERT_TRUE(file.create("/20250101/120000.bin"));
+    TEST_ASSERT_EQUAL_UINT32(512, file.write(&capture[0], 512));
+    const uint32_t metadataWrites = sdStats().metadataSectorWrites;
+    const uint32_t readsBefore = sdStats().sectorReads;
+    Bytes readBack(PAGE);
+    for (uint32_t at = 512, page = 0; at + 1024 < capture.size(); at += 1024, page += PAGE) {
+        TEST_ASSERT_EQUAL_UINT32(1024, file.write(&capture[at], 1024));
+        // A page programmed and read back while the card's multi-block write is open
+        TEST_ASSERT_TRUE(manager.writePage(page, &flashData[page], PAGE));
+        TEST_ASSERT_TRUE(manager.readData(page, readBack.data(), PAGE));
+        TEST_ASSERT_TRUE(readBack == Bytes(flashData.begin() + page, flashData.begin() + page + PAGE));
+    }
+    TEST_ASSERT_EQUAL_UINT32(512, file.write(&capture[capture.size() - 512], 512));
+    // Still one stream: no block read back and no FAT or directory sector
+    TEST_ASSERT_EQUAL_UINT32(metadataWrites, sdStats().metadataSectorWrites);
+    TEST_ASSERT_EQUAL_UINT32(readsBefore, sdStats().sectorReads);
+    TEST_ASSERT_TRUE(file.close());
+
+    const SdNode *node = sdFind("/20250101/120000.bin");
+    TEST_ASSERT_TRUE(node != nullptr);
+    TEST_ASSERT_TRUE(node->data == capture);
+    TEST_ASSERT_EQUAL_UINT32(0, flash.stats().ignoredWhileBusy);
+    TEST_ASSERT_EQUAL_UINT32(DeviceBridge::Common::Spi::FLASH_CLOCK_HZ, flash.stats().maxClockHz);
+    detachSpiDevice(&flash);
+}
+
+void test_flash_time_and_bus_statistics()
+{
+    const Bytes data = makeData(SECTOR, 4);
+    Bytes readBack(SECTOR);
+
+    // Before: the SD library's transaction leaves SCK at 4MHz for the flash driver
+    SpiFlash legacyFlash(Pins::EEPROM_CS);
+    W25Q128Manager legacyManager(Pins::EEPROM_CS);
+    boot(legacyFlash, legacyManager);
+    TEST_ASSERT_TRUE(legacyManager.eraseSector(0));
+    SPI.beginTransaction(SPISettings(DeviceBridge::Common::Spi::SD_CLOCK_HZ, MSBFIRST, SPI_MODE0));
+    SPI.endTransaction();
+    uint64_t start = cycles();
+    for (uint32_t page = 0; page < SECTOR; page += PAGE) {
+        legacyWritePage(page, &data[page], PAGE);
+    }
+    const double legacyProgramUs = elapsedUs(start);
+    start = cycles();
+    legacyRead(0, readBack.data(), SECTOR);
+    const double legacyReadUs = elapsedUs(start);
+    TEST_ASSERT_TRUE(readBack == data);
+    detachSpiDevice(&legacyFlash);
+
+    SpiFlash flash(Pins::EEPROM_CS);
+    W25Q128Manager manager(Pins::EEPROM_CS);
+    boot(flash, manager);
+    TEST_ASSERT_TRUE(manager.eraseSector(0));
+    SPI.beginTransaction(SPISettings(DeviceBridge::Common::Spi::SD_CLOCK_HZ, MSBFIRST, SPI_MODE0));
+    SPI.endTransaction();
+    SpiBus::resetStatistics();
+    start = cycles();
+    for (uint32_t page = 0; page < SECTOR; page += PAGE) {
+        TEST_ASSERT_TRUE(manager.writePage(page, &data[page], PAGE));
+    }
+    const double programUs = elapsedUs(start);
+    start = cycles();
+    TEST_ASSERT_TRUE(manager.readData(0, readBack.data(), SECTOR));
+    const double readUs = elapsedUs(start);
+    TEST_ASSERT_TRUE(readBack == data);
+
+    const SpiBus::Statistics &stats = SpiBus::statistics(SpiBus::FLASH);
+    printf("  4KB read    : %7.0f us before, %7.0f us after\n", legacyReadUs, readUs);
+    printf("  4KB program : %7.0f us before, %7.0f us after (16 pages, %u us each in the chip)\n", legacyProgramUs,
+           programUs, (unsigned)flash.timing().pageProgramUs);
+    printf("  flash bus   : %u claims, %u us held, longest %u us\n", (unsigned)stats.claims, (unsigned)stats.busyUs,
+           (unsigned)stats.maxUs);
+
+    TEST_ASSERT_TRUE(readUs < 0.6 * legacyReadUs);
+    TEST_ASSERT_TRUE(programUs < legacyProgramUs);
+    // The bus is held for the transfers, not for the chip's program time
+    TEST_ASSERT_TRUE(stats.claims > 0);
+    TEST_ASSERT_TRUE(stats.busyUs <= programUs + readUs);
+    TEST_ASSERT_TRUE(stats.busyUs < programUs + readUs - 16 * 0.9 * flash.timing().pageProgramUs);
+    TEST_ASSERT_TRUE(stats.maxUs >= readUs * 0.9 && stats.maxUs <= readUs);
+    TEST_ASSERT_EQUAL_UINT32(0, SpiBus::statistics(SpiBus::SD_CARD).claims);
+    detachSpiDevice(&flash);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_flash_round_trip_at_full_clock);
+    RUN_TEST(test_flash_between_sd_blocks_leaves_card_alone);
+    RUN_TEST(test_flash_time_and_bus_statistics);
+    return UNITY_END();
+}
@@ -0,0 +1,206 @@
+// SpscRing (lock-free /STROBE ring) under a concurrent producer.
+//
+// The producer runs on its own thread the way the ISR runs against the main
+// loop: it only ever pushes, the consumer only ever peeks/consumes spans.
+// Sequence numbers are checked on the consumer side so any lost, duplicated
+// or reordered element fails the test.
+//
+//   pio test -e native -f native/test_spsc_ring -v
+
+#include <unity.h>
+#include <Arduino.h>
+#include <stdio.h>
+#include <thread>
+#include "Common/Config.h"
+#include "Parallel/SpscRing.h"
+
+using DeviceBridge::Parallel::SpscRing;
+
+namespace {
+
+const uint32_t STRESS_COUNT = 1000000;
+
+// Returns true when the data wrapped (two spans)
+template <typename Ring> bool drainSpans(Ring &ring, uint32_t &expected, uint16_t max)
+{
+    typename Ring::Span first, second;
+    const uint16_t count = ring.peek(first, second, max);
+    TEST_ASSERT_EQUAL_UINT16(count, first.length + second.length);
+    for (uint16_t i = 0; i < first.length; i++) {
+        if (first.data[i] != expected) {
+            TEST_FAIL_MESSAGE("first span out of sequence");
+        }
+        expected++;
+    }
+    for (uint16_t i = 0; i < second.length; i++) {
+        if (second.data[i] != expected) {
+            TEST_FAIL_MESSAGE("second span out of sequence");
+        }
+        expected++;
+    }
+    ring.consume(count);
+    if (count == 0) {
+        std::this_thread::yield();
+    }
+    return second.length != 0;
+}
+
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_empty_and_full()
+{
+    SpscRing<uint8_t, 8> ring;
+    TEST_ASSERT_TRUE(ring.isEmpty());
+    TEST_ASSERT_EQUAL_UINT16(8, ring.maxSize());
+    for (uint8_t i = 0; i < 8; i++) {
+        TEST_ASSERT_TRUE(ring.push(i));
+    }
+    TEST_ASSERT_TRUE(ring.isFull());
+    TEST_ASSERT_FALSE(ring.push(8));
+    TEST_ASSERT_EQUAL_UINT16(8, ring.size());
+
+    uint8_t value;
+    TEST_ASSERT_TRUE(ring.pop(value));
+    TEST_ASSERT_EQUAL_UINT8(0, value);
+    TEST_ASSERT_TRUE(ring.push(8));
+    ring.clear();
+    TEST_ASSERT_TRUE(ring.isEmpty());
+    TEST_ASSERT_FALSE(ring.pop(value));
+}
+
+void test_spans_split_at_wrap()
+{
+    SpscRing<uint8_t, 8> ring;
+    for (uint8_t i = 0; i < 6; i++) {
+        ring.push(i);
+    }
+    uint8_t out[8];
+    TEST_ASSERT_EQUAL_UINT16(5, ring.read(out, 5));
+    for (uint8_t i = 6; i < 12; i++) {
+        ring.push(i);
+    }
+
+    SpscRing<uint8_t, 8>::Span first, second;
+    TEST_ASSERT_EQUAL_UINT16(7, ring.peek(first, second));
+    TEST_ASSERT_EQUAL_UINT16(3, first.length);  // slots 5..7
+    TEST_ASSERT_EQUAL_UINT16(4, second.length); // slots 0..3
+    TEST_ASSERT_EQUAL_UINT8(5, first.data[0]);
+    TEST_ASSERT_EQUAL_UINT8(8, second.data[0]);
+
+    // peek() releases nothing; a capped read copies across the wrap
+    TEST_ASSERT_EQUAL_UINT16(7, ring.size());
+    TEST_ASSERT_EQUAL_UINT16(5, ring.read(out, 5));
+    for (uint8_t i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL_UINT8(5 + i, out[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT16(2, ring.size());
+}
+
+void test_index_wraps_past_16_bits()
+{
+    SpscRing<uint16_t, 4> ring;
+    uint32_t expected = 0;
+    for (uint32_t i = 0; i < 70000; i++) {
+        TEST_ASSERT_TRUE(ring.push((uint16_t)i));
+        if (ring.size() == 3) {
+            uint16_t out[4];
+            const uint16_t count = ring.read(out, 4);
+            for (uint16_t j = 0; j < count; j++) {
+                TEST_ASSERT_EQUAL_UINT16((uint16_t)expected++, out[j]);
+            }
+        }
+    }
+}
+
+void test_concurrent_producer_loses_nothing()
+{
+    // Producer retries when full: every element must arrive, in order
+    static SpscRing<uint32_t, DeviceBridge::Common::Buffer::RING_BUFFER_SIZE> ring;
+    // Start off a slot boundary so reads straddle the wrap even when the
+    // threads end up taking turns on a single core
+    for (uint16_t i = 0; i < 100; i++) {
+        ring.push(0);
+    }
+    ring.consume(100);
+
+    std::thread producer([] {
+        for (uint32_t i = 0; i < STRESS_COUNT;) {
+            if (ring.push(i)) {
+                i++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint32_t expected = 0;
+    uint32_t wrapped = 0;
+    while (expected < STRESS_COUNT) {
+        wrapped += drainSpans(ring, expected, DeviceBridge::Common::Buffer::DATA_CHUNK_SIZE / 3);
+    }
+    producer.join();
+
+    printf("  %u elements in order, %u reads split across the wrap\n", (unsigned)expected, (unsigned)wrapped);
+    TEST_ASSERT_EQUAL_UINT32(STRESS_COUNT, expected);
+    TEST_ASSERT_TRUE(ring.isEmpty());
+    TEST_ASSERT_TRUE(wrapped > 0);
+}
+
+void test_concurrent_isr_style_producer_accounts_for_every_byte()
+{
+    // Producer drops on full like the ISR does: received + rejected == sent,
+    // and what was received is strictly increasing
+    static SpscRing<uint32_t, 64> ring;
+    static volatile bool done = false;
+    static uint32_t rejected = 0;
+    std::thread producer([] {
+        for (uint32_t i = 0; i < STRESS_COUNT; i++) {
+            if (!ring.push(i)) {
+                rejected++;
+            }
+            if ((i & 0x3F) == 0) {
+                std::this_thread::yield(); // let the consumer in between "strobes"
+            }
+        }
+        __atomic_store_n(&done, true, __ATOMIC_RELEASE);
+    });
+
+    uint32_t received = 0;
+    int64_t last = -1;
+    uint32_t out[24];
+    for (;;) {
+        const bool finished = __atomic_load_n(&done, __ATOMIC_ACQUIRE);
+        const uint16_t count = ring.read(out, 24);
+        for (uint16_t i = 0; i < count; i++) {
+            if ((int64_t)out[i] <= last) {
+                TEST_FAIL_MESSAGE("element duplicated or reordered");
+            }
+            last = out[i];
+        }
+        received += count;
+        if (finished && ring.isEmpty()) {
+            break;
+        }
+        if (count == 0) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    printf("  %u received, %u rejected while full\n", (unsigned)received, (unsigned)rejected);
+    TEST_ASSERT_EQUAL_UINT32(STRESS_COUNT, received + rejected);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_and_full);
+    RUN_TEST(test_spans_split_at_wrap);
+    RUN_TEST(test_index_wraps_past_16_bits);
+    RUN_TEST(test_concurrent_producer_loses_nothing);
+    RUN_TEST(test_concurrent_isr_style_producer_accounts_for_every_byte);
+    return UNITY_END();
+}